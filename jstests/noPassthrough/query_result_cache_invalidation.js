@@ -0,0 +1,90 @@
+/**
+ * Tests that every kind of write to a collection with the query result cache enabled invalidates
+ * the cached results, so that a find never returns results which a write has made stale.
+ *
+ * @tags: [uses_transactions]
+ */
+
+(function() {
+    'use strict';
+
+    const rst = new ReplSetTest({nodes: 1});
+    rst.startSet();
+    rst.initiate();
+
+    const dbName = 'test';
+    const collName = 'query_result_cache_invalidation';
+    const testDB = rst.getPrimary().getDB(dbName);
+    const coll = testDB[collName];
+
+    assert.commandWorked(coll.insert([{_id: 0, x: 0}, {_id: 1, x: 1}]));
+    assert.commandWorked(testDB.runCommand({queryResultCache: collName, enabled: true}));
+
+    function cacheStats() {
+        return assert.commandWorked(testDB.runCommand({queryResultCache: collName}));
+    }
+
+    function findAll() {
+        return assert.commandWorked(testDB.runCommand({find: collName, sort: {_id: 1}}))
+            .cursor.firstBatch;
+    }
+
+    /**
+     * Runs the find twice, checking that the second run is answered from the cache, and that both
+     * return 'expected'.
+     */
+    function assertCachedResults(expected) {
+        assert.eq(expected, findAll());
+        const hits = cacheStats().hits;
+        assert.eq(expected, findAll());
+        const stats = cacheStats();
+        assert.eq(hits + 1, stats.hits, tojson(stats));
+        assert.eq(1, stats.numEntries, tojson(stats));
+    }
+
+    /**
+     * Runs 'write' and checks that it emptied the cache.
+     */
+    function assertWriteInvalidates(write) {
+        const invalidations = cacheStats().invalidations;
+        write();
+        const stats = cacheStats();
+        assert.gt(stats.invalidations, invalidations, tojson(stats));
+        assert.eq(0, stats.numEntries, tojson(stats));
+    }
+
+    assertCachedResults([{_id: 0, x: 0}, {_id: 1, x: 1}]);
+
+    // Insert.
+    assertWriteInvalidates(() => assert.commandWorked(coll.insert({_id: 2, x: 2})));
+    assertCachedResults([{_id: 0, x: 0}, {_id: 1, x: 1}, {_id: 2, x: 2}]);
+
+    // Update.
+    assertWriteInvalidates(() => assert.commandWorked(coll.update({_id: 1}, {$set: {x: 10}})));
+    assertCachedResults([{_id: 0, x: 0}, {_id: 1, x: 10}, {_id: 2, x: 2}]);
+
+    // Delete.
+    assertWriteInvalidates(() => assert.commandWorked(coll.remove({_id: 0})));
+    assertCachedResults([{_id: 1, x: 10}, {_id: 2, x: 2}]);
+
+    // Transaction. The results cached by a find which runs while the transaction is open do not
+    // include its writes, so committing it must invalidate them again.
+    const session = testDB.getMongo().startSession();
+    const sessionColl = session.getDatabase(dbName)[collName];
+    session.startTransaction();
+    assert.commandWorked(sessionColl.insert({_id: 3, x: 3}));
+    assert.commandWorked(sessionColl.update({_id: 2}, {$set: {x: 20}}));
+    assertCachedResults([{_id: 1, x: 10}, {_id: 2, x: 2}]);
+
+    assertWriteInvalidates(() => session.commitTransaction());
+    assertCachedResults([{_id: 1, x: 10}, {_id: 2, x: 20}, {_id: 3, x: 3}]);
+
+    // An aborted transaction leaves the cached results correct either way.
+    session.startTransaction();
+    assert.commandWorked(sessionColl.remove({_id: 1}));
+    session.abortTransaction();
+    assertCachedResults([{_id: 1, x: 10}, {_id: 2, x: 20}, {_id: 3, x: 3}]);
+
+    session.endSession();
+    rst.stopSet();
+})();
@@ -206,19 +206,23 @@ Future<Message> AsyncDBClient::_call(Message request, const transport::BatonHand
 
     return _session->asyncSinkMessage(request, baton)
         .then([this, baton] { return _session->asyncSourceMessage(baton); })
-        .then([this, msgId](Message response) -> StatusWith<Message> {
-            uassert(50787,
-                    "ResponseId did not match sent message ID.",
-                    response.header().getResponseToMsgId() == msgId);
-
-            if (response.operation() == dbCompressed) {
-                return _compressorManager.decompressMessage(response);
-            } else {
-                return response;
-            }
+        .then([this, msgId](Message response) {
+            return _decodeResponse(std::move(response), msgId);
         });
 }
 
+StatusWith<Message> AsyncDBClient::_decodeResponse(Message response, int32_t msgId) {
+    uassert(50787,
+            "ResponseId did not match sent message ID.",
+            response.header().getResponseToMsgId() == msgId);
+
+    if (response.operation() == dbCompressed) {
+        return _compressorManager.decompressMessage(response);
+    } else {
+        return response;
+    }
+}
+
 Future<rpc::UniqueReply> AsyncDBClient::runCommand(OpMsgRequest request,
                                                    const transport::BatonHandle& baton) {
     invariant(_negotiatedProtocol);
@@ -246,6 +250,104 @@ Future<executor::RemoteCommandResponse> AsyncDBClient::runCommandRequest(
         });
 }
 
+Message AsyncDBClient::_buildRequestMessage(executor::RemoteCommandRequest request,
+                                            int32_t* msgId) {
+    invariant(_negotiatedProtocol);
+    auto opMsgRequest = OpMsgRequest::fromDBAndBody(
+        std::move(request.dbname), std::move(request.cmdObj), std::move(request.metadata));
+    auto message = uassertStatusOK(_compressorManager.compressMessage(
+        rpc::messageFromOpMsgRequest(*_negotiatedProtocol, std::move(opMsgRequest))));
+
+    *msgId = nextMessageId();
+    message.header().setId(*msgId);
+    message.header().setResponseToMsgId(0);
+    return message;
+}
+
+std::vector<Future<executor::RemoteCommandResponse>> AsyncDBClient::runCommandRequests(
+    std::vector<executor::RemoteCommandRequest> requests, const transport::BatonHandle& baton) {
+    auto clkSource = _svcCtx->getPreciseClockSource();
+    auto start = clkSource->now();
+
+    std::vector<Future<executor::RemoteCommandResponse>> responses;
+    auto pending = std::make_shared<PendingResponses>();
+    std::vector<Message> messages;
+    for (auto& request : requests) {
+        auto pf = makePromiseFuture<Message>();
+        int32_t msgId = 0;
+        auto swMessage = [&]() -> StatusWith<Message> {
+            try {
+                return _buildRequestMessage(std::move(request), &msgId);
+            } catch (const DBException& ex) {
+                return ex.toStatus();
+            }
+        }();
+        if (swMessage.isOK()) {
+            messages.push_back(std::move(swMessage.getValue()));
+            pending->emplace_back(msgId, std::move(pf.promise));
+        } else {
+            pf.promise.setError(swMessage.getStatus());
+        }
+
+        responses.push_back(
+            std::move(pf.future)
+                .then([start, clkSource](Message response) {
+                    auto reply = rpc::makeReply(&response);
+                    auto duration = duration_cast<Milliseconds>(clkSource->now() - start);
+                    return executor::RemoteCommandResponse(*reply, duration);
+                })
+                .onError([start, clkSource](Status status) {
+                    auto duration = duration_cast<Milliseconds>(clkSource->now() - start);
+                    return executor::RemoteCommandResponse(status, duration);
+                }));
+    }
+
+    if (pending->empty()) {
+        return responses;
+    }
+
+    _session->asyncSinkMessages(std::move(messages), baton)
+        .getAsync([ self = shared_from_this(), pending, baton ](Status status) {
+            if (!status.isOK()) {
+                for (auto& entry : *pending) {
+                    entry.second.setError(status);
+                }
+                return;
+            }
+            self->_sourceResponses(pending, 0, baton);
+        });
+
+    return responses;
+}
+
+void AsyncDBClient::_sourceResponses(std::shared_ptr<PendingResponses> pending,
+                                     size_t index,
+                                     const transport::BatonHandle& baton) {
+    if (index == pending->size()) {
+        return;
+    }
+
+    // The remote host answers the requests in the order they were sent, so each response is for
+    // the next request still waiting for one.
+    _session->asyncSourceMessage(baton)
+        .then([ this, msgId = (*pending)[index].first ](Message response) {
+            return _decodeResponse(std::move(response), msgId);
+        })
+        .getAsync([ self = shared_from_this(), pending, index, baton ](
+            StatusWith<Message> swResponse) {
+            if (!swResponse.isOK()) {
+                // The session can not be trusted to be at the start of the next response anymore.
+                for (size_t i = index; i < pending->size(); ++i) {
+                    (*pending)[i].second.setError(swResponse.getStatus());
+                }
+                return;
+            }
+
+            (*pending)[index].second.emplaceValue(std::move(swResponse.getValue()));
+            self->_sourceResponses(pending, index + 1, baton);
+        });
+}
+
 void AsyncDBClient::cancel(const transport::BatonHandle& baton) {
     _session->cancelAsyncOperations(baton);
 }
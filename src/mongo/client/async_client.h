@@ -31,6 +31,7 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include "mongo/client/authenticate.h"
 #include "mongo/db/service_context.h"
@@ -66,6 +67,15 @@ public:
     Future<rpc::UniqueReply> runCommand(OpMsgRequest request,
                                         const transport::BatonHandle& baton = nullptr);
 
+    /**
+     * Sends all of 'requests' to the remote host with a single write, and returns a future for the
+     * response to each of them, in the same order. The remote host runs the commands one after
+     * another, so a slow command delays the responses to the commands following it.
+     */
+    std::vector<Future<executor::RemoteCommandResponse>> runCommandRequests(
+        std::vector<executor::RemoteCommandRequest> requests,
+        const transport::BatonHandle& baton = nullptr);
+
     Future<void> authenticate(const BSONObj& params);
 
     Future<void> authenticateInternal(boost::optional<std::string> mechanismHint);
@@ -83,7 +93,15 @@ public:
     const HostAndPort& local() const;
 
 private:
+    // The id of each request sent by runCommandRequests() with the promise for its response.
+    using PendingResponses = std::vector<std::pair<int32_t, Promise<Message>>>;
+
     Future<Message> _call(Message request, const transport::BatonHandle& baton = nullptr);
+    StatusWith<Message> _decodeResponse(Message response, int32_t msgId);
+    Message _buildRequestMessage(executor::RemoteCommandRequest request, int32_t* msgId);
+    void _sourceResponses(std::shared_ptr<PendingResponses> pending,
+                          size_t index,
+                          const transport::BatonHandle& baton);
     BSONObj _buildIsMasterRequest(const std::string& appName,
                                   executor::NetworkConnectionHook* hook);
     void _parseIsMasterResponse(BSONObj request,
@@ -135,7 +135,13 @@ Message DBClientCursor::_assembleInit() {
                 // QueryRequest doesn't handle $readPreference.
                 cmd = BSONObjBuilder(std::move(cmd)).append(readPref).obj();
             }
-            return assembleCommandRequest(_client, ns.db(), opts, std::move(cmd));
+            auto msg = assembleCommandRequest(_client, ns.db(), opts, std::move(cmd));
+            // Ask the server to start streaming batches right after the 'find', so that no
+            // 'getMore' round trip is needed. Servers which only stream 'getMore' ignore the flag.
+            if (opts & QueryOption_Exhaust && msg.operation() == dbMsg) {
+                OpMsg::setFlag(&msg, OpMsg::kExhaustSupported);
+            }
+            return msg;
         }
         // else use legacy OP_QUERY request.
         // Legacy OP_QUERY request does not support UUIDs.
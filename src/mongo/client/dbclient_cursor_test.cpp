@@ -165,7 +165,7 @@ TEST_F(DBClientCursorTest, DBClientCursorHandlesOpMsgExhaustCorrectly) {
     auto m = conn.getLastSentMessage();
     ASSERT(!m.empty());
     auto msg = OpMsg::parse(m);
-    ASSERT_EQ(OpMsg::flags(m), 0U);
+    ASSERT_EQ(OpMsg::flags(m), OpMsg::kExhaustSupported);
     ASSERT_EQ(msg.body.getStringField("find"), nss.coll());
     ASSERT_EQ(msg.body["batchSize"].number(), 0);
 
@@ -209,6 +209,47 @@ TEST_F(DBClientCursorTest, DBClientCursorHandlesOpMsgExhaustCorrectly) {
     ASSERT(cursor.isDead());
 }
 
+TEST_F(DBClientCursorTest, DBClientCursorHandlesOpMsgExhaustStartedByFind) {
+
+    // Set up the DBClientCursor and a mock client connection.
+    DBClientConnectionForTest conn;
+    const NamespaceString nss("test", "coll");
+    DBClientCursor cursor(
+        &conn, NamespaceStringOrUUID(nss), Query().obj, 0, 0, nullptr, QueryOption_Exhaust, 0);
+    cursor.setBatchSize(2);
+
+    // Set up a mock 'find' response with the 'moreToCome' flag set, as sent by a server which
+    // starts the exhaust stream directly from the 'find' command.
+    const long long cursorId = 42;
+    Message findResponseMsg = mockFindResponse(nss, cursorId, {docObj(1), docObj(2)});
+    OpMsg::setFlag(&findResponseMsg, OpMsg::kMoreToCome);
+
+    conn.setCallResponse(findResponseMsg);
+    ASSERT(cursor.init());
+
+    // Verify that the initial 'find' request was sent with the exhaust flag.
+    auto m = conn.getLastSentMessage();
+    ASSERT(!m.empty());
+    auto msg = OpMsg::parse(m);
+    ASSERT(OpMsg::isFlagSet(m, OpMsg::kExhaustSupported));
+    ASSERT_EQ(msg.body.getStringField("find"), nss.coll());
+    ASSERT_BSONOBJ_EQ(docObj(1), cursor.next());
+    ASSERT_BSONOBJ_EQ(docObj(2), cursor.next());
+
+    // Set a terminal 'getMore' response as the next message streamed by the server.
+    auto terminalDoc = BSON("_id"
+                            << "terminal");
+    conn.setRecvResponse(mockGetMoreResponse(nss, 0, {terminalDoc}));
+
+    // Requesting more results must not send a 'getMore', since the server is already streaming
+    // batches to us.
+    conn.clearLastSentMessage();
+    ASSERT(cursor.more());
+    ASSERT(conn.getLastSentMessage().empty());
+    ASSERT_BSONOBJ_EQ(terminalDoc, cursor.next());
+    ASSERT(cursor.isDead());
+}
+
 TEST_F(DBClientCursorTest, DBClientCursorResendsGetMoreIfMoreToComeFlagIsOmittedInExhaustMessage) {
 
     // Set up the DBClientCursor and a mock client connection.
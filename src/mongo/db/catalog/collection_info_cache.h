@@ -30,8 +30,12 @@
 
 #pragma once
 
+#include <memory>
+
 #include "mongo/db/collection_index_usage_tracker.h"
+#include "mongo/db/query/collection_statistics.h"
 #include "mongo/db/query/plan_cache.h"
+#include "mongo/db/query/query_result_cache.h"
 #include "mongo/db/query/query_settings.h"
 #include "mongo/db/update_index_data.h"
 
@@ -63,6 +67,23 @@ public:
      */
     virtual QuerySettings* getQuerySettings() const = 0;
 
+    /**
+     * Get the cache of query results for this collection. It is disabled unless the collection
+     * has opted in, and is invalidated by every write to the collection.
+     */
+    virtual QueryResultCache* getResultCache() const = 0;
+
+    /**
+     * Returns the statistics most recently gathered for this collection by the 'analyze' command,
+     * or nullptr if it has not been analyzed.
+     */
+    virtual std::shared_ptr<const CollectionStatistics> getCollectionStatistics() const = 0;
+
+    /**
+     * Replaces the statistics used to estimate the cost of query plans over this collection.
+     */
+    virtual void setCollectionStatistics(std::shared_ptr<const CollectionStatistics> stats) = 0;
+
     /* get set of index keys for this namespace.  handy to quickly check if a given
        field is indexed (Note it might be a secondary component of a compound index.)
     */
@@ -58,6 +58,7 @@ CollectionInfoCacheImpl::CollectionInfoCacheImpl(Collection* collection, const N
       _keysComputed(false),
       _planCache(stdx::make_unique<PlanCache>(ns.ns())),
       _querySettings(stdx::make_unique<QuerySettings>()),
+      _resultCache(stdx::make_unique<QueryResultCache>()),
       _indexUsageTracker(getGlobalServiceContext()->getPreciseClockSource()) {}
 
 CollectionInfoCacheImpl::~CollectionInfoCacheImpl() {
@@ -187,6 +188,29 @@ QuerySettings* CollectionInfoCacheImpl::getQuerySettings() const {
     return _querySettings.get();
 }
 
+QueryResultCache* CollectionInfoCacheImpl::getResultCache() const {
+    return _resultCache.get();
+}
+
+std::shared_ptr<const CollectionStatistics> CollectionInfoCacheImpl::getCollectionStatistics()
+    const {
+    stdx::lock_guard<stdx::mutex> lk(_collectionStatsMutex);
+    return _collectionStats;
+}
+
+void CollectionInfoCacheImpl::setCollectionStatistics(
+    std::shared_ptr<const CollectionStatistics> stats) {
+    stdx::lock_guard<stdx::mutex> lk(_collectionStatsMutex);
+    _collectionStats = std::move(stats);
+}
+
+void CollectionInfoCacheImpl::dropIndexStatistics(StringData indexName) {
+    stdx::lock_guard<stdx::mutex> lk(_collectionStatsMutex);
+    if (_collectionStats) {
+        _collectionStats = _collectionStats->withoutIndex(indexName);
+    }
+}
+
 void CollectionInfoCacheImpl::updatePlanCacheIndexEntries(OperationContext* opCtx) {
     std::vector<IndexEntry> indexEntries;
 
@@ -224,6 +248,7 @@ void CollectionInfoCacheImpl::addedIndex(OperationContext* opCtx, const IndexDes
     invariant(desc);
 
     rebuildIndexData(opCtx);
+    dropIndexStatistics(desc->indexName());
 
     _indexUsageTracker.registerIndex(desc->indexName(), desc->keyPattern());
 }
@@ -233,12 +258,17 @@ void CollectionInfoCacheImpl::droppedIndex(OperationContext* opCtx, StringData i
     invariant(opCtx->lockState()->isCollectionLockedForMode(_collection->ns().ns(), MODE_X));
 
     rebuildIndexData(opCtx);
+    dropIndexStatistics(indexName);
     _indexUsageTracker.unregisterIndex(indexName);
 }
 
 void CollectionInfoCacheImpl::rebuildIndexData(OperationContext* opCtx) {
     clearQueryCache();
 
+    // A cached result may depend on an index which no longer exists, for instance if the query
+    // hinted it.
+    _resultCache->invalidate();
+
     _keysComputed = false;
     computeIndexKeys(opCtx);
     updatePlanCacheIndexEntries(opCtx);
@@ -254,6 +284,9 @@ void CollectionInfoCacheImpl::setNs(NamespaceString ns) {
 
     _planCache->setNs(_ns);
 
+    // Cached results are keyed by queries which name the old namespace.
+    _resultCache->invalidate();
+
     // Update the TTL collection cache.
     if (_hasTTLIndex) {
         auto& ttlCollectionCache = TTLCollectionCache::get(getGlobalServiceContext());
@@ -34,8 +34,10 @@
 
 #include "mongo/db/collection_index_usage_tracker.h"
 #include "mongo/db/query/plan_cache.h"
+#include "mongo/db/query/query_result_cache.h"
 #include "mongo/db/query/query_settings.h"
 #include "mongo/db/update_index_data.h"
+#include "mongo/stdx/mutex.h"
 
 namespace mongo {
 
@@ -63,6 +65,15 @@ public:
      */
     QuerySettings* getQuerySettings() const;
 
+    QueryResultCache* getResultCache() const override;
+
+    /**
+     * Get the statistics gathered for this collection by the 'analyze' command, if any.
+     */
+    std::shared_ptr<const CollectionStatistics> getCollectionStatistics() const override;
+
+    void setCollectionStatistics(std::shared_ptr<const CollectionStatistics> stats) override;
+
     /* get set of index keys for this namespace.  handy to quickly check if a given
        field is indexed (Note it might be a secondary component of a compound index.)
     */
@@ -121,6 +132,12 @@ private:
      */
     void rebuildIndexData(OperationContext* opCtx);
 
+    /**
+     * Forgets any statistics gathered for the index named 'indexName', which no longer describe
+     * the index once it has been dropped or rebuilt.
+     */
+    void dropIndexStatistics(StringData indexName);
+
     Collection* _collection;  // not owned
 
     NamespaceString _ns;
@@ -136,9 +153,17 @@ private:
     // Includes index filters.
     std::unique_ptr<QuerySettings> _querySettings;
 
+    // A cache for query results, which writes to the collection invalidate.
+    std::unique_ptr<QueryResultCache> _resultCache;
+
     // Tracks index usage statistics for this collection.
     CollectionIndexUsageTracker _indexUsageTracker;
 
+    // Statistics from the 'analyze' command. Replaced by the command while queries may be
+    // planning against the previous statistics, so guarded by its own mutex.
+    mutable stdx::mutex _collectionStatsMutex;
+    std::shared_ptr<const CollectionStatistics> _collectionStats;
+
     bool _hasTTLIndex = false;
 };
 
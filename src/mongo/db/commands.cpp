@@ -54,11 +54,14 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/server_parameters.h"
+#include "mongo/db/stats/operation_phase_latencies.h"
+#include "mongo/db/stats/sharded_latency_histogram.h"
 #include "mongo/rpc/factory.h"
 #include "mongo/rpc/op_msg_rpc_impls.h"
 #include "mongo/rpc/protocol.h"
 #include "mongo/rpc/write_concern_error_detail.h"
 #include "mongo/s/stale_exception.h"
+#include "mongo/stdx/memory.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/invariant.h"
 #include "mongo/util/log.h"
@@ -607,7 +610,44 @@ private:
     const std::string _dbName;
 };
 
-Command::~Command() = default;
+struct Command::LatencyHistograms {
+    ShardedLatencyHistogram total;
+    OperationPhaseLatencies phases{OperationPhaseLatencies::kNumCommandPhases};
+};
+
+Command::~Command() {
+    delete _latencyHistograms.load();
+}
+
+Command::LatencyHistograms* Command::_getOrCreateLatencyHistograms() const {
+    auto histograms = _latencyHistograms.load();
+    if (!histograms) {
+        auto newHistograms = stdx::make_unique<LatencyHistograms>();
+        histograms = _latencyHistograms.compareAndSwap(nullptr, newHistograms.get());
+        if (!histograms) {
+            histograms = newHistograms.release();
+        }
+    }
+    return histograms;
+}
+
+void Command::recordLatency(Microseconds latency) const {
+    _getOrCreateLatencyHistograms()->total.record(latency);
+}
+
+void Command::recordPhaseLatency(OperationPhase phase, Microseconds latency) const {
+    _getOrCreateLatencyHistograms()->phases.record(phase, latency);
+}
+
+const ShardedLatencyHistogram* Command::getLatencyHistogram() const {
+    auto histograms = _latencyHistograms.load();
+    return histograms ? &histograms->total : nullptr;
+}
+
+const OperationPhaseLatencies* Command::getPhaseLatencies() const {
+    auto histograms = _latencyHistograms.load();
+    return histograms ? &histograms->phases : nullptr;
+}
 
 void Command::snipForLogging(mutablebson::Document* cmdObj) const {
     StringData sensitiveField = sensitiveFieldName();
@@ -47,9 +47,11 @@
 #include "mongo/db/query/explain.h"
 #include "mongo/db/repl/read_concern_args.h"
 #include "mongo/db/write_concern.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/rpc/op_msg.h"
 #include "mongo/rpc/reply_builder_interface.h"
 #include "mongo/stdx/functional.h"
+#include "mongo/util/duration.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/string_map.h"
 
@@ -60,6 +62,9 @@ MONGO_FAIL_POINT_DECLARE(failCommand);
 class Command;
 class CommandInvocation;
 class OperationContext;
+class OperationPhaseLatencies;
+class ShardedLatencyHistogram;
+enum class OperationPhase;
 
 namespace mutablebson {
 class Document;
@@ -421,6 +426,29 @@ public:
         _commandsFailed.increment();
     }
 
+    /**
+     * Records the end-to-end latency of one execution of this command. The histograms are allocated
+     * the first time the command completes, so commands which never run cost nothing.
+     */
+    void recordLatency(Microseconds latency) const;
+
+    /**
+     * Records the time one execution of this command spent in 'phase', which must be one of the
+     * first OperationPhaseLatencies::kNumCommandPhases phases.
+     */
+    void recordPhaseLatency(OperationPhase phase, Microseconds latency) const;
+
+    /**
+     * Returns the latency histogram of this command, or nullptr if no latency was ever recorded.
+     */
+    const ShardedLatencyHistogram* getLatencyHistogram() const;
+
+    /**
+     * Returns the phase latency histograms of this command, or nullptr if no latency was ever
+     * recorded.
+     */
+    const OperationPhaseLatencies* getPhaseLatencies() const;
+
     /**
      * Generates a reply from the 'help' information associated with a command. The state of
      * the passed ReplyBuilder will be in kOutputDocs after calling this method.
@@ -439,6 +467,13 @@ private:
     // Pointers to hold the metrics tree references
     ServerStatusMetricField<Counter64> _commandsExecutedMetric;
     ServerStatusMetricField<Counter64> _commandsFailedMetric;
+
+    struct LatencyHistograms;
+
+    LatencyHistograms* _getOrCreateLatencyHistograms() const;
+
+    // Owned, lazily created by recordLatency() or recordPhaseLatency().
+    mutable AtomicWord<LatencyHistograms*> _latencyHistograms{nullptr};
 };
 
 /**
@@ -0,0 +1,229 @@
+
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kCommand
+
+#include "mongo/platform/basic.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/index_names.h"
+#include "mongo/db/query/collection_statistics.h"
+#include "mongo/db/query/internal_plans.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace {
+
+const char kNumBucketsField[] = "numBuckets";
+const long long kDefaultNumBuckets = 100;
+const long long kMaxNumBuckets = 10000;
+
+/**
+ * Builds a histogram over the leading field of the keys in the index described by 'descriptor',
+ * walking the index in ascending order of that field.
+ */
+ValueHistogram buildLeadingFieldHistogram(OperationContext* opCtx,
+                                          Collection* collection,
+                                          const IndexDescriptor* descriptor,
+                                          long long valuesPerBucket) {
+    // Bounds covering the whole index, in index order.
+    BSONObjBuilder indexStartBuilder;
+    BSONObjBuilder indexEndBuilder;
+    for (auto&& field : descriptor->keyPattern()) {
+        if (field.number() < 0) {
+            indexStartBuilder.appendMaxKey("");
+            indexEndBuilder.appendMinKey("");
+        } else {
+            indexStartBuilder.appendMinKey("");
+            indexEndBuilder.appendMaxKey("");
+        }
+    }
+    const BSONObj indexStart = indexStartBuilder.obj();
+    const BSONObj indexEnd = indexEndBuilder.obj();
+
+    const bool isLeadingFieldDescending = descriptor->keyPattern().firstElement().number() < 0;
+    auto exec = InternalPlanner::indexScan(
+        opCtx,
+        collection,
+        descriptor,
+        isLeadingFieldDescending ? indexEnd : indexStart,
+        isLeadingFieldDescending ? indexStart : indexEnd,
+        BoundInclusion::kIncludeBothStartAndEndKeys,
+        PlanExecutor::YIELD_AUTO,
+        isLeadingFieldDescending ? InternalPlanner::BACKWARD : InternalPlanner::FORWARD);
+
+    ValueHistogram::Builder builder(valuesPerBucket);
+    BSONObj key;
+    PlanExecutor::ExecState state;
+    while (PlanExecutor::ADVANCED == (state = exec->getNext(&key, nullptr))) {
+        builder.addValue(key.firstElement());
+    }
+
+    if (PlanExecutor::IS_EOF != state) {
+        uassertStatusOK(WorkingSetCommon::getMemberObjectStatus(key).withContext(
+            str::stream() << "Executor error while analyzing index " << descriptor->indexName()));
+    }
+
+    return builder.done();
+}
+
+/**
+ * Gathers statistics describing the distribution of values in a collection's indexes, from which
+ * the query planner estimates the cost of candidate plans. The statistics are kept in memory
+ * with the collection's plan cache and replace any gathered previously.
+ *
+ * {analyze: <collection>, numBuckets: <int>}
+ */
+class CmdAnalyze : public BasicCommand {
+public:
+    CmdAnalyze() : BasicCommand("analyze") {}
+
+    AllowedOnSecondary secondaryAllowed(ServiceContext*) const override {
+        return AllowedOnSecondary::kOptIn;
+    }
+
+    bool supportsWriteConcern(const BSONObj& cmd) const override {
+        return false;
+    }
+
+    std::string help() const override {
+        return "Gathers index statistics used by the query planner to estimate plan costs.\n"
+               "{ analyze: <collection>, numBuckets: <int> }";
+    }
+
+    void addRequiredPrivileges(const std::string& dbname,
+                               const BSONObj& cmdObj,
+                               std::vector<Privilege>* out) const override {
+        ActionSet actions;
+        actions.addAction(ActionType::planCacheWrite);
+        out->push_back(Privilege(parseResourcePattern(dbname, cmdObj), actions));
+    }
+
+    bool run(OperationContext* opCtx,
+             const std::string& dbname,
+             const BSONObj& cmdObj,
+             BSONObjBuilder& result) override {
+        const NamespaceString nss(CommandHelpers::parseNsCollectionRequired(dbname, cmdObj));
+
+        long long numBuckets = kDefaultNumBuckets;
+        if (auto numBucketsElem = cmdObj[kNumBucketsField]) {
+            uassert(ErrorCodes::TypeMismatch,
+                    str::stream() << "'" << kNumBucketsField << "' must be a number",
+                    numBucketsElem.isNumber());
+            numBuckets = numBucketsElem.safeNumberLong();
+            uassert(ErrorCodes::BadValue,
+                    str::stream() << "'" << kNumBucketsField << "' must be between 1 and "
+                                  << kMaxNumBuckets,
+                    numBuckets >= 1 && numBuckets <= kMaxNumBuckets);
+        }
+
+        AutoGetCollectionForReadCommand ctx(opCtx, nss);
+        Collection* collection = ctx.getCollection();
+        uassert(ErrorCodes::NamespaceNotFound,
+                str::stream() << "collection " << nss.ns() << " does not exist",
+                collection);
+
+        const long long numRecords = collection->numRecords(opCtx);
+        const long long valuesPerBucket = std::max(1LL, numRecords / numBuckets);
+
+        // Each index scan may yield, so look up the descriptor of every index by name just
+        // before it is scanned.
+        std::vector<std::string> indexNames;
+        std::unique_ptr<IndexCatalog::IndexIterator> ii =
+            collection->getIndexCatalog()->getIndexIterator(opCtx, false);
+        while (ii->more()) {
+            const IndexDescriptor* desc = ii->next()->descriptor();
+            if (desc->getAccessMethodName() == IndexNames::BTREE) {
+                indexNames.push_back(desc->indexName());
+            }
+        }
+
+        CollectionStatistics::IndexStatisticsMap indexStats;
+        std::map<std::string, BSONObj> scannedIndexSpecs;
+        for (auto&& indexName : indexNames) {
+            const IndexDescriptor* desc =
+                collection->getIndexCatalog()->findIndexByName(opCtx, indexName);
+            if (!desc) {
+                continue;
+            }
+            scannedIndexSpecs[indexName] = desc->infoObj().getOwned();
+            indexStats[indexName] = IndexStatistics{
+                desc->keyPattern().getOwned(),
+                buildLeadingFieldHistogram(opCtx, collection, desc, valuesPerBucket)};
+        }
+
+        // An index scanned before a later scan yielded may since have been dropped, or rebuilt
+        // with different options. The collection lock is held from here on, so only keep the
+        // statistics of indexes which are still as they were scanned.
+        for (auto it = indexStats.begin(); it != indexStats.end();) {
+            const IndexDescriptor* desc =
+                collection->getIndexCatalog()->findIndexByName(opCtx, it->first);
+            if (!desc || !desc->infoObj().binaryEqual(scannedIndexSpecs[it->first])) {
+                LOG(1) << "analyze " << nss.ns() << ": index " << it->first
+                       << " changed while it was analyzed, discarding its statistics";
+                it = indexStats.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        BSONObjBuilder indexesBuilder(result.subobjStart("indexes"));
+        for (auto&& entry : indexStats) {
+            BSONObjBuilder indexBuilder(indexesBuilder.subobjStart(entry.first));
+            indexBuilder.appendNumber("numKeys", entry.second.histogram.getTotalCount());
+            indexBuilder.appendNumber("numDistinct", entry.second.histogram.getNumDistinct());
+            indexBuilder.appendNumber(
+                "numBuckets", static_cast<long long>(entry.second.histogram.getBuckets().size()));
+        }
+        indexesBuilder.doneFast();
+        result.append("ns", nss.ns());
+        result.appendNumber("numRecords", numRecords);
+
+        LOG(1) << "analyze " << nss.ns() << ": gathered statistics for " << indexStats.size()
+               << " indexes";
+        collection->infoCache()->setCollectionStatistics(
+            std::make_shared<CollectionStatistics>(numRecords, std::move(indexStats)));
+        return true;
+    }
+
+} cmdAnalyze;
+
+}  // namespace
+}  // namespace mongo
@@ -34,9 +34,11 @@
 
 #include "mongo/db/auth/authorization_session.h"
 #include "mongo/db/client.h"
+#include "mongo/db/catalog/collection.h"
 #include "mongo/db/clientcursor.h"
 #include "mongo/db/commands.h"
 #include "mongo/db/commands/run_aggregate.h"
+#include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/curop_failpoint_helpers.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/exec/working_set_common.h"
@@ -46,8 +48,13 @@
 #include "mongo/db/query/find.h"
 #include "mongo/db/query/find_common.h"
 #include "mongo/db/query/get_executor.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/db/query/query_planner_common.h"
+#include "mongo/db/query/query_result_cache.h"
+#include "mongo/db/repl/read_concern_args.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/s/collection_sharding_state.h"
+#include "mongo/db/s/operation_sharding_state.h"
 #include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/stats/counters.h"
@@ -60,6 +67,115 @@ namespace {
 
 const auto kTermField = "term"_sd;
 
+// The plan summary reported for a query answered from the collection's result cache.
+const auto kResultCachePlanSummary = "RESULT_CACHE"_sd;
+
+Counter64 resultCacheHits;
+Counter64 resultCacheMisses;
+Counter64 resultCacheInserts;
+Counter64 resultCacheEvictions;
+ServerStatusMetricField<Counter64> displayResultCacheHits("query.resultCache.hits",
+                                                          &resultCacheHits);
+ServerStatusMetricField<Counter64> displayResultCacheMisses("query.resultCache.misses",
+                                                            &resultCacheMisses);
+ServerStatusMetricField<Counter64> displayResultCacheInserts("query.resultCache.inserts",
+                                                             &resultCacheInserts);
+ServerStatusMetricField<Counter64> displayResultCacheEvictions("query.resultCache.evictions",
+                                                               &resultCacheEvictions);
+
+/**
+ * Returns whether the results of 'cq' may be served from, and added to, the result cache of
+ * 'collection'. Only reads of the latest data on a node which accepts writes are cached, since
+ * every write such a node makes passes through the OpObserver that invalidates the cache.
+ */
+bool canUseResultCache(OperationContext* opCtx,
+                       const NamespaceString& nss,
+                       Collection* collection,
+                       const CanonicalQuery& cq) {
+    if (!collection || !collection->infoCache()->getResultCache()->isEnabled()) {
+        return false;
+    }
+
+    // Capped collections delete their oldest documents without notifying the OpObserver.
+    if (collection->isCapped()) {
+        return false;
+    }
+
+    const auto& qr = cq.getQueryRequest();
+    if (qr.isTailable() || QueryPlannerCommon::hasNode(cq.root(), MatchExpression::WHERE)) {
+        return false;
+    }
+
+    const auto readConcernLevel = repl::ReadConcernArgs::get(opCtx).getLevel();
+    if (readConcernLevel != repl::ReadConcernLevel::kLocalReadConcern &&
+        readConcernLevel != repl::ReadConcernLevel::kAvailableReadConcern) {
+        return false;
+    }
+
+    const auto txnParticipant = TransactionParticipant::get(opCtx);
+    if (txnParticipant && txnParticipant->inMultiDocumentTransaction()) {
+        return false;
+    }
+
+    // A versioned read filters out orphaned documents according to the routing table.
+    if (OperationShardingState::get(opCtx).hasShardVersion()) {
+        return false;
+    }
+
+    return repl::ReplicationCoordinator::get(opCtx)->canAcceptWritesFor(opCtx, nss);
+}
+
+/**
+ * Returns the key under which the results of 'qr' are cached: the find command itself, with its
+ * read concern and without the options which do not affect its results.
+ */
+std::string makeResultCacheKey(OperationContext* opCtx, const QueryRequest& qr) {
+    BSONObjBuilder keyBuilder;
+    for (auto&& elem : qr.asFindCommand()) {
+        const auto fieldName = elem.fieldNameStringData();
+        if (fieldName == "comment"_sd || fieldName == QueryRequest::cmdOptionMaxTimeMS ||
+            fieldName == "noCursorTimeout"_sd || fieldName == kTermField ||
+            fieldName == repl::ReadConcernArgs::kReadConcernFieldName) {
+            continue;
+        }
+        keyBuilder.append(elem);
+    }
+
+    const bool isAvailable = repl::ReadConcernArgs::get(opCtx).getLevel() ==
+        repl::ReadConcernLevel::kAvailableReadConcern;
+    keyBuilder.append(repl::ReadConcernArgs::kReadConcernFieldName,
+                      BSON(repl::ReadConcernArgs::kLevelFieldName
+                           << (isAvailable ? "available" : "local")));
+
+    const BSONObj key = keyBuilder.done();
+    return std::string(key.objdata(), key.objsize());
+}
+
+/**
+ * Replies to a find command with the results cached for it, which all fit in the first batch.
+ */
+void replyFromResultCache(OperationContext* opCtx,
+                          const NamespaceString& nss,
+                          const QueryResultCache::Results& cachedResults,
+                          rpc::ReplyBuilderInterface* result) {
+    auto curOp = CurOp::get(opCtx);
+    {
+        stdx::lock_guard<Client> lk(*opCtx->getClient());
+        curOp->setPlanSummary_inlock(kResultCachePlanSummary.toString());
+    }
+    curOp->debug().nreturned = cachedResults.size();
+    curOp->debug().cursorid = -1;
+    curOp->debug().cursorExhausted = true;
+
+    CursorResponseBuilder::Options options;
+    options.isInitialResponse = true;
+    CursorResponseBuilder firstBatch(result, options);
+    for (auto&& obj : cachedResults) {
+        firstBatch.append(obj);
+    }
+    firstBatch.done(0, nss.ns());
+}
+
 /**
  * A command for running .find() queries.
  */
@@ -205,12 +321,26 @@ public:
             // execution tree with an EOFStage.
             Collection* const collection = ctx->getCollection();
 
+            // Note whether the query would be answered from the collection's result cache.
+            const bool resultCacheEnabled =
+                collection && collection->infoCache()->getResultCache()->isEnabled();
+            const bool resultCacheEligible = canUseResultCache(opCtx, nss, collection, *cq);
+            const bool resultCached = resultCacheEligible &&
+                collection->infoCache()->getResultCache()->contains(
+                    makeResultCacheKey(opCtx, cq->getQueryRequest()));
+
             // We have a parsed query. Time to get the execution plan for it.
             auto exec = uassertStatusOK(getExecutorFind(opCtx, collection, nss, std::move(cq)));
 
             auto bodyBuilder = result->getBodyBuilder();
             // Got the execution tree. Explain it.
             Explain::explainStages(exec.get(), collection, verbosity, &bodyBuilder);
+
+            if (resultCacheEnabled) {
+                BSONObjBuilder resultCacheBob(bodyBuilder.subobjStart("resultCache"));
+                resultCacheBob.append("eligible", resultCacheEligible);
+                resultCacheBob.append("cached", resultCached);
+            }
         }
 
         /**
@@ -315,6 +445,24 @@ public:
                 opCtx->recoveryUnit()->setReadOnce(true);
             }
 
+            // Answer the query from the collection's result cache if it can. Otherwise, the
+            // results are offered to the cache once the query completes, unless a write has
+            // invalidated the cache since this generation was read.
+            QueryResultCache* resultCache = nullptr;
+            std::string resultCacheKey;
+            std::uint64_t resultCacheGeneration = 0;
+            if (canUseResultCache(opCtx, nss, collection, *cq)) {
+                resultCache = collection->infoCache()->getResultCache();
+                resultCacheKey = makeResultCacheKey(opCtx, cq->getQueryRequest());
+                resultCacheGeneration = resultCache->getGeneration();
+                if (auto cachedResults = resultCache->get(resultCacheKey)) {
+                    resultCacheHits.increment();
+                    replyFromResultCache(opCtx, nss, *cachedResults, result);
+                    return;
+                }
+                resultCacheMisses.increment();
+            }
+
             // Get the execution plan for the query.
             auto exec = uassertStatusOK(getExecutorFind(opCtx, collection, nss, std::move(cq)));
 
@@ -346,6 +494,8 @@ public:
             BSONObj obj;
             PlanExecutor::ExecState state = PlanExecutor::ADVANCED;
             std::uint64_t numResults = 0;
+            QueryResultCache::Results resultsToCache;
+            const long long maxResultCacheEntryBytes = internalQueryResultCacheMaxEntryBytes.load();
             while (!FindCommon::enoughForFirstBatch(originalQR, numResults) &&
                    PlanExecutor::ADVANCED == (state = exec->getNext(&obj, nullptr))) {
                 // If we can't fit this result inside the current batch, then we stash it for later.
@@ -357,6 +507,15 @@ public:
                 // Add result to output buffer.
                 firstBatch.append(obj);
                 numResults++;
+
+                if (resultCache) {
+                    if (firstBatch.bytesUsed() > maxResultCacheEntryBytes) {
+                        resultCache = nullptr;
+                        resultsToCache.clear();
+                    } else {
+                        resultsToCache.push_back(obj.getOwned());
+                    }
+                }
             }
 
             // Throw an assertion if query execution fails for any reason.
@@ -375,6 +534,20 @@ public:
             auto css = CollectionShardingState::get(opCtx, nss);
             css->checkShardVersionOrThrow(opCtx);
 
+            // Only a complete set of results, returned in the first batch, can be cached.
+            if (resultCache && PlanExecutor::IS_EOF == state) {
+                std::size_t numEvicted = 0;
+                if (resultCache->add(resultCacheKey,
+                                     resultCacheGeneration,
+                                     std::move(resultsToCache),
+                                     internalQueryResultCacheMaxBytesPerCollection.load(),
+                                     internalQueryResultCacheMaxBytesTotal.load(),
+                                     &numEvicted)) {
+                    resultCacheInserts.increment();
+                }
+                resultCacheEvictions.increment(numEvicted);
+            }
+
             // Set up the cursor for getMore.
             CursorId cursorId = 0;
             if (shouldSaveCursor(opCtx, collection, state, exec.get())) {
@@ -0,0 +1,138 @@
+
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kCommand
+
+#include "mongo/platform/basic.h"
+
+#include <string>
+#include <vector>
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog_raii.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/query/query_result_cache.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace {
+
+const char kEnabledField[] = "enabled";
+
+/**
+ * Enables or disables the cache of query results for a collection, and reports its state. The
+ * cache suits collections which are read far more often than they are written, since every write
+ * to the collection discards all of the cached results.
+ *
+ * The setting is held in memory only, on the node which receives the command. It is not stored in
+ * the collection's options nor replicated, and is lost when the node restarts.
+ *
+ * {queryResultCache: <collection>, enabled: <bool>}
+ */
+class CmdQueryResultCache : public BasicCommand {
+public:
+    CmdQueryResultCache() : BasicCommand("queryResultCache") {}
+
+    AllowedOnSecondary secondaryAllowed(ServiceContext*) const override {
+        return AllowedOnSecondary::kOptIn;
+    }
+
+    bool supportsWriteConcern(const BSONObj& cmd) const override {
+        return false;
+    }
+
+    std::string help() const override {
+        return "Enables or disables the cache of query results for a collection, and reports "
+               "its state. The setting applies to this node only and is not persisted: it is "
+               "lost when the node restarts, and is not replicated.\n"
+               "{ queryResultCache: <collection>, enabled: <bool> }";
+    }
+
+    void addRequiredPrivileges(const std::string& dbname,
+                               const BSONObj& cmdObj,
+                               std::vector<Privilege>* out) const override {
+        ActionSet actions;
+        actions.addAction(cmdObj.hasField(kEnabledField) ? ActionType::planCacheWrite
+                                                         : ActionType::planCacheRead);
+        out->push_back(Privilege(parseResourcePattern(dbname, cmdObj), actions));
+    }
+
+    bool run(OperationContext* opCtx,
+             const std::string& dbname,
+             const BSONObj& cmdObj,
+             BSONObjBuilder& result) override {
+        const NamespaceString nss(CommandHelpers::parseNsCollectionRequired(dbname, cmdObj));
+
+        boost::optional<bool> enabled;
+        if (auto enabledElem = cmdObj[kEnabledField]) {
+            uassert(ErrorCodes::TypeMismatch,
+                    str::stream() << "'" << kEnabledField << "' must be a boolean",
+                    enabledElem.isBoolean());
+            enabled = enabledElem.boolean();
+        }
+
+        // Enabling the cache must wait for any write in progress, which would not invalidate the
+        // cache when it commits, since the cache was disabled when the write was made.
+        AutoGetCollection autoColl(
+            opCtx, nss, enabled ? MODE_IX : MODE_IS, enabled ? MODE_X : MODE_IS);
+        Collection* collection = autoColl.getCollection();
+        uassert(ErrorCodes::NamespaceNotFound,
+                str::stream() << "collection " << nss.ns() << " does not exist",
+                collection);
+
+        QueryResultCache* resultCache = collection->infoCache()->getResultCache();
+        if (enabled) {
+            uassert(ErrorCodes::InvalidOptions,
+                    "cannot cache the results of queries over a capped collection",
+                    !*enabled || !collection->isCapped());
+            resultCache->setEnabled(*enabled);
+            LOG(1) << "queryResultCache " << nss.ns() << ": "
+                   << (*enabled ? "enabled" : "disabled");
+        }
+
+        const auto stats = resultCache->getStats();
+        result.append("ns", nss.ns());
+        result.append("enabled", stats.enabled);
+        result.appendNumber("numEntries", stats.numEntries);
+        result.appendNumber("bytesUsed", stats.bytesUsed);
+        result.appendNumber("hits", stats.hits);
+        result.appendNumber("misses", stats.misses);
+        result.appendNumber("inserts", stats.inserts);
+        result.appendNumber("evictions", stats.evictions);
+        result.appendNumber("invalidations", stats.invalidations);
+        result.appendNumber("totalBytesUsed", QueryResultCache::getTotalBytesUsed());
+        return true;
+    }
+
+} cmdQueryResultCache;
+
+}  // namespace
+}  // namespace mongo
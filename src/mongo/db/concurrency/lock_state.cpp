@@ -37,6 +37,7 @@
 
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/wait_event_stats.h"
 #include "mongo/platform/compiler.h"
 #include "mongo/stdx/new.h"
 #include "mongo/util/background.h"
@@ -337,11 +338,15 @@ LockResult LockerImpl::_acquireTicket(OperationContext* opCtx, LockMode mode, Da
         // If the ticket wait is interrupted, restore the state of the client.
         auto restoreStateOnErrorGuard = MakeGuard([&] { _clientState.store(kInactive); });
 
-        OperationContext* interruptible = _uninterruptibleLocksRequested ? nullptr : opCtx;
-        if (deadline == Date_t::max()) {
-            holder->waitForTicket(interruptible);
-        } else if (!holder->waitForTicketUntil(interruptible, deadline)) {
-            return LOCK_TIMEOUT;
+        // Only account a wait event when no ticket is immediately available.
+        if (!holder->tryAcquire()) {
+            ScopedWaitEvent ticketWait(opCtx, WaitEventClass::kTicket);
+            OperationContext* interruptible = _uninterruptibleLocksRequested ? nullptr : opCtx;
+            if (deadline == Date_t::max()) {
+                holder->waitForTicket(interruptible);
+            } else if (!holder->waitForTicketUntil(interruptible, deadline)) {
+                return LOCK_TIMEOUT;
+            }
         }
         restoreStateOnErrorGuard.Dismiss();
     }
@@ -837,6 +842,8 @@ LockResult LockerImpl::lockComplete(OperationContext* opCtx,
 
         globalStats.recordWaitTime(_id, resId, mode, elapsedTimeMicros);
         _stats.recordWaitTime(resId, mode, elapsedTimeMicros);
+        WaitEventStats::record(
+            opCtx, WaitEventClass::kLockManager, Microseconds(int64_t(elapsedTimeMicros)));
 
         if (result == LOCK_OK)
             break;
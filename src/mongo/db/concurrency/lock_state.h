@@ -187,6 +187,10 @@ public:
     virtual boost::optional<LockerInfo> getLockerInfo(
         const boost::optional<SingleThreadedLockStats> lockStatsBase) const final;
 
+    virtual int64_t getCombinedLockWaitTimeMicros() const {
+        return _stats.getCombinedWaitTimeMicros();
+    }
+
     virtual bool saveLockStateAndUnlock(LockSnapshot* stateOut);
 
     virtual void restoreLockState(OperationContext* opCtx, const LockSnapshot& stateToRestore);
@@ -70,6 +70,9 @@ TEST(LockStats, Wait) {
         // Sleep 1 millisecond so the wait time passes
         ASSERT_EQUALS(LOCK_TIMEOUT,
                       lockerConflict.lockComplete(resId, MODE_S, Date_t::now() + Milliseconds(5)));
+
+        ASSERT_GREATER_THAN(lockerConflict.getCombinedLockWaitTimeMicros(), 0);
+        ASSERT_EQUALS(0, locker.getCombinedLockWaitTimeMicros());
     }
 
     // Make sure that the waits/blocks are non-zero
@@ -83,6 +86,10 @@ TEST(LockStats, Wait) {
     ASSERT_EQUALS(1, stats.get(resId, MODE_S).numAcquisitions);
     ASSERT_EQUALS(1, stats.get(resId, MODE_S).numWaits);
     ASSERT_GREATER_THAN(stats.get(resId, MODE_S).combinedWaitTimeMicros, 0);
+
+    // The only wait was for the collection lock in MODE_S.
+    ASSERT_EQUALS(stats.get(resId, MODE_S).combinedWaitTimeMicros,
+                  stats.getCombinedWaitTimeMicros());
 }
 
 TEST(LockStats, Reporting) {
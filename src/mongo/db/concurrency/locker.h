@@ -335,6 +335,12 @@ public:
     virtual boost::optional<LockerInfo> getLockerInfo(
         const boost::optional<SingleThreadedLockStats> lockStatsBase) const = 0;
 
+    /**
+     * Returns the time this locker has spent waiting for lock acquisitions, summed over all
+     * resources and modes. Cheaper than getLockerInfo() when only the wait time is needed.
+     */
+    virtual int64_t getCombinedLockWaitTimeMicros() const = 0;
+
     /**
      * LockSnapshot captures the state of all resources that are locked, what modes they're
      * locked in, and how many times they've been locked in that mode.
@@ -176,6 +176,10 @@ public:
         return boost::none;
     }
 
+    virtual int64_t getCombinedLockWaitTimeMicros() const {
+        return 0;
+    }
+
     virtual bool saveLockStateAndUnlock(LockSnapshot* stateOut) {
         MONGO_UNREACHABLE;
     }
@@ -48,6 +48,7 @@
 #include "mongo/db/json.h"
 #include "mongo/db/query/getmore_request.h"
 #include "mongo/db/query/plan_summary_stats.h"
+#include "mongo/db/wait_event_stats.h"
 #include "mongo/rpc/metadata/client_metadata.h"
 #include "mongo/rpc/metadata/client_metadata_ismaster.h"
 #include "mongo/rpc/metadata/impersonated_user_metadata.h"
@@ -293,9 +294,28 @@ void CurOp::reportCurrentOpForClient(OperationContext* opCtx,
         }
 
         CurOp::get(clientOpCtx)->reportState(infoBuilder, truncateOps);
+
+        const auto& waitEvents = WaitEventStats::get(clientOpCtx);
+        if (!waitEvents.empty()) {
+            BSONObjBuilder waitEventsBuilder(infoBuilder->subobjStart("waitEvents"));
+            waitEvents.append(&waitEventsBuilder);
+        }
     }
 }
 
+Microseconds CurOp::getLockWaitTime(OperationContext* opCtx) const {
+    return _swappedOutLockWaitTime +
+        Microseconds(opCtx->lockState()->getCombinedLockWaitTimeMicros() -
+                     _lockWaitTimeBaseMicros);
+}
+
+std::unique_ptr<Locker> CurOp::swapLockState(OperationContext* opCtx,
+                                             std::unique_ptr<Locker> locker) {
+    _swappedOutLockWaitTime = getLockWaitTime(opCtx);
+    _lockWaitTimeBaseMicros = locker->getCombinedLockWaitTimeMicros();
+    return opCtx->swapLockState(std::move(locker));
+}
+
 void CurOp::setGenericCursor_inlock(GenericCursor gc) {
     _genericCursor = std::move(gc);
 }
@@ -305,6 +325,7 @@ CurOp::CurOp(OperationContext* opCtx) : CurOp(opCtx, &_curopStack(opCtx)) {
     // current operation.
     if (_parent != nullptr)
         _lockStatsBase = opCtx->lockState()->getLockerInfo(boost::none)->stats;
+    _lockWaitTimeBaseMicros = opCtx->lockState()->getCombinedLockWaitTimeMicros();
 }
 
 CurOp::CurOp(OperationContext* opCtx, CurOpStack* stack) : _stack(stack) {
@@ -657,6 +678,15 @@ string OpDebug::report(Client* client,
         s << " locks:" << locks.obj().toString();
     }
 
+    if (auto opCtx = client->getOperationContext()) {
+        const auto& waitEvents = WaitEventStats::get(opCtx);
+        if (!waitEvents.empty()) {
+            BSONObjBuilder waitEventsBuilder;
+            waitEvents.append(&waitEventsBuilder);
+            s << " waitEvents:" << waitEventsBuilder.obj().toString();
+        }
+    }
+
     if (iscommand) {
         s << " protocol:" << getProtoString(networkOp);
     }
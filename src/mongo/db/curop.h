@@ -194,6 +194,9 @@ public:
     // Details of any error (whether from an exception or a command returning failure).
     Status errInfo = Status::OK();
 
+    // Time spent choosing a plan, including multi-planning and cached plan trial periods.
+    long long planningTimeMicros{0};
+
     // response info
     long long executionTimeMicros{0};
     long long nreturned{-1};
@@ -575,6 +578,20 @@ public:
         return _lockStatsBase;
     }
 
+    /**
+     * Returns the time this operation has spent waiting to acquire locks. Lock statistics
+     * accumulate in the Locker, which can outlive the operation, as for the statements of a
+     * multi-document transaction, so only the waits since this operation started are counted.
+     */
+    Microseconds getLockWaitTime(OperationContext* opCtx) const;
+
+    /**
+     * Replaces the Locker of 'opCtx' and returns the previous one. Waits of the previous Locker
+     * stay counted by getLockWaitTime(), and waits the new Locker accumulated before it was swapped
+     * in are not. Lockers must be swapped through this function while the operation runs.
+     */
+    std::unique_ptr<Locker> swapLockState(OperationContext* opCtx, std::unique_ptr<Locker> locker);
+
 private:
     class CurOpStack;
 
@@ -621,6 +638,11 @@ private:
     std::string _planSummary;
     boost::optional<SingleThreadedLockStats>
         _lockStatsBase;  // This is the snapshot of lock stats taken when curOp is constructed.
+
+    // The combined lock wait time of the operation's Locker when this CurOp was constructed or the
+    // Locker was swapped in, and the lock wait time of the Lockers swapped out since.
+    long long _lockWaitTimeBaseMicros{0};
+    Microseconds _swappedOutLockWaitTime{0};
 };
 
 /**
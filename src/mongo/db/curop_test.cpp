@@ -33,8 +33,10 @@
 #include <boost/optional/optional_io.hpp>
 
 #include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/concurrency/locker_noop.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/query/query_test_service_context.h"
+#include "mongo/stdx/memory.h"
 #include "mongo/unittest/unittest.h"
 
 namespace mongo {
@@ -208,5 +210,47 @@ TEST(CurOpTest, OptionalAdditiveMetricsNotDisplayedIfUninitialized) {
 
     ASSERT_EQ(reportString, expectedReportString);
 }
+
+/**
+ * A Locker whose combined lock wait time is set by the test.
+ */
+class LockerWithWaitTime : public LockerNoop {
+public:
+    explicit LockerWithWaitTime(int64_t waitTimeMicros) : waitTimeMicros(waitTimeMicros) {}
+
+    int64_t getCombinedLockWaitTimeMicros() const override {
+        return waitTimeMicros;
+    }
+
+    int64_t waitTimeMicros;
+};
+
+TEST(CurOpTest, LockWaitTimeOnlyCountsWaitsSinceTheLockerWasSwappedIn) {
+    QueryTestServiceContext serviceContext;
+    auto opCtx = serviceContext.makeOperationContext();
+    auto curop = CurOp::get(*opCtx);
+
+    auto freshLocker = stdx::make_unique<LockerWithWaitTime>(0);
+    auto fresh = freshLocker.get();
+    curop->swapLockState(opCtx.get(), std::move(freshLocker));
+    fresh->waitTimeMicros = 5;
+    ASSERT_EQ(Microseconds(5), curop->getLockWaitTime(opCtx.get()));
+
+    // A locker stashed by earlier statements of a transaction brings its own wait time.
+    auto stashedLocker = stdx::make_unique<LockerWithWaitTime>(1000);
+    auto stashed = stashedLocker.get();
+    auto swappedOut = curop->swapLockState(opCtx.get(), std::move(stashedLocker));
+    ASSERT_EQ(fresh, swappedOut.get());
+    ASSERT_EQ(Microseconds(5), curop->getLockWaitTime(opCtx.get()));
+
+    stashed->waitTimeMicros = 1020;
+    ASSERT_EQ(Microseconds(25), curop->getLockWaitTime(opCtx.get()));
+
+    // Stashing the locker again keeps the waits of this operation.
+    auto stashedAgain = curop->swapLockState(opCtx.get(), stdx::make_unique<LockerNoop>());
+    ASSERT_EQ(stashed, stashedAgain.get());
+    ASSERT_EQ(Microseconds(25), curop->getLockWaitTime(opCtx.get()));
+}
+
 }  // namespace
 }  // namespace mongo
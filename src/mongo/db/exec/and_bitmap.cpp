@@ -0,0 +1,189 @@
+
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/and_bitmap.h"
+
+#include "mongo/db/exec/scoped_timer.h"
+#include "mongo/db/exec/working_set.h"
+#include "mongo/db/exec/working_set_common.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+namespace {
+
+// Upper limit for the memory held by the bitmaps. Stage execution will fail once it is exceeded.
+const size_t kDefaultMaxMemUsageBytes = 32 * 1024 * 1024;
+
+// Measuring memory usage walks every container, so it is only done once per this many record ids.
+const size_t kMemUsageCheckInterval = 4096;
+
+}  // namespace
+
+using std::unique_ptr;
+using stdx::make_unique;
+
+// static
+const char* AndBitmapStage::kStageType = "AND_BITMAP";
+
+AndBitmapStage::AndBitmapStage(OperationContext* opCtx, WorkingSet* ws)
+    : AndBitmapStage(opCtx, ws, kDefaultMaxMemUsageBytes) {}
+
+AndBitmapStage::AndBitmapStage(OperationContext* opCtx, WorkingSet* ws, size_t maxMemUsage)
+    : PlanStage(kStageType, opCtx), _ws(ws), _maxMemUsage(maxMemUsage) {}
+
+void AndBitmapStage::addChild(PlanStage* child) {
+    _children.emplace_back(child);
+}
+
+bool AndBitmapStage::isEOF() {
+    return _isEOF;
+}
+
+PlanStage::StageState AndBitmapStage::doWork(WorkingSetID* out) {
+    if (isEOF()) {
+        return PlanStage::IS_EOF;
+    }
+
+    if (_currentChild < _children.size()) {
+        return readChild(out);
+    }
+
+    // Every child has been read. Return the intersection in RecordId order.
+    invariant(_cursor);
+    auto recordId = _cursor->next();
+    if (!recordId) {
+        _isEOF = true;
+        return PlanStage::IS_EOF;
+    }
+
+    WorkingSetID id = _ws->allocate();
+    WorkingSetMember* member = _ws->get(id);
+    member->recordId = *recordId;
+    _ws->transitionToRecordIdAndIdx(id);
+
+    *out = id;
+    return PlanStage::ADVANCED;
+}
+
+PlanStage::StageState AndBitmapStage::readChild(WorkingSetID* out) {
+    WorkingSetID id = WorkingSet::INVALID_ID;
+    StageState childStatus = _children[_currentChild]->work(&id);
+
+    if (PlanStage::ADVANCED == childStatus) {
+        WorkingSetMember* member = _ws->get(id);
+
+        // The child must give us a WorkingSetMember with a record id, since we intersect index keys
+        // based on the record id. The planner ensures that the child stage can never produce an
+        // WSM with no record id.
+        invariant(member->hasRecordId());
+
+        bool added;
+        if (0 == _currentChild) {
+            added = _intersection.add(member->recordId);
+        } else {
+            // Only record ids which every previous child produced can be in the intersection.
+            added = _intersection.contains(member->recordId) &&
+                _childRecordIds.add(member->recordId);
+        }
+        _ws->free(id);
+
+        const size_t numBuffered = _intersection.size() + _childRecordIds.size();
+        if (added && 0 == numBuffered % kMemUsageCheckInterval) {
+            _specificStats.memUsage = _intersection.getMemUsage() + _childRecordIds.getMemUsage();
+            if (_specificStats.memUsage > _maxMemUsage) {
+                mongoutils::str::stream ss;
+                ss << "bitmap AND stage buffered data usage of " << _specificStats.memUsage
+                   << " bytes exceeds internal limit of " << _maxMemUsage << " bytes";
+                Status status(ErrorCodes::Overflow, ss);
+                *out = WorkingSetCommon::allocateStatusMember(_ws, status);
+                return PlanStage::FAILURE;
+            }
+        }
+
+        return PlanStage::NEED_TIME;
+    } else if (PlanStage::IS_EOF == childStatus) {
+        // Finished with a child. '_intersection' becomes the intersection of the children read
+        // so far.
+        if (_currentChild > 0) {
+            _intersection = std::move(_childRecordIds);
+            _childRecordIds.clear();
+        }
+        _specificStats.intersectionAfterChild.push_back(_intersection.size());
+        _specificStats.memUsage = _intersection.getMemUsage();
+        ++_currentChild;
+
+        // If we have nothing to AND with after finishing any child, stop.
+        if (_intersection.empty()) {
+            _isEOF = true;
+            return PlanStage::IS_EOF;
+        }
+
+        if (_currentChild == _children.size()) {
+            _cursor.emplace(_intersection);
+        }
+        return PlanStage::NEED_TIME;
+    } else if (PlanStage::FAILURE == childStatus || PlanStage::DEAD == childStatus) {
+        // The stage which produces a failure is responsible for allocating a working set member
+        // with error details.
+        invariant(WorkingSet::INVALID_ID != id);
+        *out = id;
+        return childStatus;
+    } else {
+        if (PlanStage::NEED_YIELD == childStatus) {
+            *out = id;
+        }
+
+        return childStatus;
+    }
+}
+
+unique_ptr<PlanStageStats> AndBitmapStage::getStats() {
+    _commonStats.isEOF = isEOF();
+
+    _specificStats.memLimit = _maxMemUsage;
+
+    unique_ptr<PlanStageStats> ret = make_unique<PlanStageStats>(_commonStats, STAGE_AND_BITMAP);
+    ret->specific = make_unique<AndBitmapStats>(_specificStats);
+    for (size_t i = 0; i < _children.size(); ++i) {
+        ret->children.emplace_back(_children[i]->getStats());
+    }
+
+    return ret;
+}
+
+const SpecificStats* AndBitmapStage::getSpecificStats() const {
+    return &_specificStats;
+}
+
+}  // namespace mongo
@@ -0,0 +1,104 @@
+
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/db/exec/plan_stage.h"
+#include "mongo/db/exec/record_id_bitmap.h"
+#include "mongo/db/record_id.h"
+
+namespace mongo {
+
+/**
+ * Reads from N children, each of which must have a valid RecordId. Collects the record ids of
+ * each child into a compressed bitmap, intersecting it with those of the children before it, and
+ * once all children are exhausted outputs the intersection in RecordId order.
+ *
+ * Only the RecordIds are kept, so the output members carry neither index keys nor documents and
+ * must be fetched. In exchange the stage holds a few bits per record id rather than a
+ * WorkingSetMember, and reads the collection in RecordId order.
+ *
+ * Preconditions: Valid RecordId. More than one child.
+ */
+class AndBitmapStage final : public PlanStage {
+public:
+    AndBitmapStage(OperationContext* opCtx, WorkingSet* ws);
+
+    /**
+     * For testing only. Allows tests to set memory usage threshold.
+     */
+    AndBitmapStage(OperationContext* opCtx, WorkingSet* ws, size_t maxMemUsage);
+
+    void addChild(PlanStage* child);
+
+    StageState doWork(WorkingSetID* out) final;
+    bool isEOF() final;
+
+    StageType stageType() const final {
+        return STAGE_AND_BITMAP;
+    }
+
+    std::unique_ptr<PlanStageStats> getStats() final;
+
+    const SpecificStats* getSpecificStats() const final;
+
+    static const char* kStageType;
+
+private:
+    StageState readChild(WorkingSetID* out);
+
+    // Not owned by us.
+    WorkingSet* _ws;
+
+    // The intersection of the record ids of the children read so far.
+    RecordIdBitmap _intersection;
+
+    // The record ids of the child being read which are also in '_intersection'.
+    RecordIdBitmap _childRecordIds;
+
+    // Which child are we currently reading? Equal to the number of children once the
+    // intersection is complete.
+    size_t _currentChild = 0;
+
+    // Iterates over '_intersection' once it is complete.
+    boost::optional<RecordIdBitmap::Cursor> _cursor;
+
+    // True once every record id in the intersection has been returned, or the intersection is
+    // known to be empty.
+    bool _isEOF = false;
+
+    // Stats
+    AndBitmapStats _specificStats;
+
+    // Upper limit for the memory held by the bitmaps.
+    size_t _maxMemUsage;
+};
+
+}  // namespace mongo
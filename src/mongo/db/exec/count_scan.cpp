@@ -32,6 +32,7 @@
 
 #include "mongo/db/catalog/index_catalog.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/exec/filter.h"
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/index/index_access_method.h"
 #include "mongo/stdx/memory.h"
@@ -74,10 +75,14 @@ const char* CountScan::kStageType = "COUNT_SCAN";
 // When building the CountScan stage we take the keyPattern, index name, and multikey details from
 // the CountScanParams rather than resolving them via the IndexDescriptor, since these may differ
 // from the descriptor's contents.
-CountScan::CountScan(OperationContext* opCtx, CountScanParams params, WorkingSet* workingSet)
+CountScan::CountScan(OperationContext* opCtx,
+                     CountScanParams params,
+                     WorkingSet* workingSet,
+                     const MatchExpression* filter)
     : RequiresIndexStage(kStageType, opCtx, params.indexDescriptor),
       _workingSet(workingSet),
       _keyPattern(std::move(params.keyPattern)),
+      _filter(filter),
       _shouldDedup(params.isMultiKey),
       _startKey(std::move(params.startKey)),
       _startKeyInclusive(params.startKeyInclusive),
@@ -108,17 +113,18 @@ PlanStage::StageState CountScan::doWork(WorkingSetID* out) {
     boost::optional<IndexKeyEntry> entry;
     const bool needInit = !_cursor;
     try {
-        // We don't care about the keys.
-        const auto kWantLoc = SortedDataInterface::Cursor::kWantLoc;
+        // We only care about the keys if there is a filter to apply to them.
+        const auto parts = _filter ? SortedDataInterface::Cursor::kKeyAndLoc
+                                   : SortedDataInterface::Cursor::kWantLoc;
 
         if (needInit) {
             // First call to work().  Perform cursor init.
             _cursor = indexAccessMethod()->newCursor(getOpCtx());
             _cursor->setEndPosition(_endKey, _endKeyInclusive);
 
-            entry = _cursor->seek(_startKey, _startKeyInclusive, kWantLoc);
+            entry = _cursor->seek(_startKey, _startKeyInclusive, parts);
         } else {
-            entry = _cursor->next(kWantLoc);
+            entry = _cursor->next(parts);
         }
     } catch (const WriteConflictException&) {
         if (needInit) {
@@ -137,6 +143,11 @@ PlanStage::StageState CountScan::doWork(WorkingSetID* out) {
         return PlanStage::IS_EOF;
     }
 
+    // Filter before deduplicating, so that a document is counted if any of its keys pass.
+    if (_filter && !Filter::passes(entry->key, _keyPattern, _filter)) {
+        return PlanStage::NEED_TIME;
+    }
+
     if (_shouldDedup && !_returned.insert(entry->loc).second) {
         // *loc was already in _returned.
         return PlanStage::NEED_TIME;
@@ -173,6 +184,13 @@ void CountScan::doReattachToOperationContext() {
 }
 
 unique_ptr<PlanStageStats> CountScan::getStats() {
+    // Add a BSON representation of the filter to the stats tree, if there is one.
+    if (_filter && _commonStats.filter.isEmpty()) {
+        BSONObjBuilder bob;
+        _filter->serialize(&bob);
+        _commonStats.filter = bob.obj();
+    }
+
     unique_ptr<PlanStageStats> ret = make_unique<PlanStageStats>(_commonStats, STAGE_COUNT_SCAN);
 
     unique_ptr<CountScanStats> countStats = make_unique<CountScanStats>(_specificStats);
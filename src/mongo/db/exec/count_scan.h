@@ -82,12 +82,18 @@ struct CountScanParams {
  * empty object with a null snapshot id rather than real data. Returning real data is unnecessary
  * since all we need is the count.
  *
+ * If a filter is given, it is applied to each index key within the range, and keys which do not
+ * pass it are not counted. The filter must only refer to fields of the index key pattern.
+ *
  * Only created through the getExecutorCount() path, as count is the only operation that doesn't
  * care about its data.
  */
 class CountScan final : public RequiresIndexStage {
 public:
-    CountScan(OperationContext* opCtx, CountScanParams params, WorkingSet* workingSet);
+    CountScan(OperationContext* opCtx,
+              CountScanParams params,
+              WorkingSet* workingSet,
+              const MatchExpression* filter = nullptr);
 
     StageState doWork(WorkingSetID* out) final;
     bool isEOF() final;
@@ -115,6 +121,9 @@ private:
 
     const BSONObj _keyPattern;
 
+    // The filter applied to each index key, or nullptr if every key counts. Not owned by us.
+    const MatchExpression* const _filter;
+
     const bool _shouldDedup;
 
     const BSONObj _startKey;
@@ -92,11 +92,18 @@ struct DistinctParams {
  * for that field, so there is no point in examining all keys with the same value for that
  * field.
  *
+ * If a filter is given, it is applied to the index keys, and the scan only skips ahead once it
+ * has found a key for the current value which passes the filter. Keys which fail it are stepped
+ * over one distinct key at a time. The filter must only refer to fields of the index key pattern.
+ *
  * Only created through the getExecutorDistinct path.  See db/query/get_executor.cpp
  */
 class DistinctScan final : public RequiresIndexStage {
 public:
-    DistinctScan(OperationContext* opCtx, DistinctParams params, WorkingSet* workingSet);
+    DistinctScan(OperationContext* opCtx,
+                 DistinctParams params,
+                 WorkingSet* workingSet,
+                 const MatchExpression* filter = nullptr);
 
     StageState doWork(WorkingSetID* out) final;
     bool isEOF() final;
@@ -130,6 +137,9 @@ private:
 
     const int _fieldNo = 0;
 
+    // The filter applied to each index key, or nullptr if there is none. Not owned by us.
+    const MatchExpression* const _filter;
+
     // The cursor we use to navigate the tree.
     std::unique_ptr<SortedDataInterface::Cursor> _cursor;
 
@@ -32,11 +32,14 @@
 
 #include "mongo/db/exec/fetch.h"
 
+#include <algorithm>
+
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/exec/filter.h"
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/mongoutils/str.h"
@@ -58,7 +61,8 @@ FetchStage::FetchStage(OperationContext* opCtx,
     : RequiresCollectionStage(kStageType, opCtx, collection),
       _ws(ws),
       _filter(filter),
-      _idRetrying(WorkingSet::INVALID_ID) {
+      _idRetrying(WorkingSet::INVALID_ID),
+      _maxPrefetchBatchSize(internalQueryExecFetchPrefetchBatchSize.load()) {
     _children.emplace_back(child);
 }
 
@@ -70,6 +74,11 @@ bool FetchStage::isEOF() {
         return false;
     }
 
+    if (!_batch.empty() || !_prefetched.empty()) {
+        // We have read ahead results which have not been returned yet.
+        return false;
+    }
+
     return child()->isEOF();
 }
 
@@ -78,6 +87,10 @@ PlanStage::StageState FetchStage::doWork(WorkingSetID* out) {
         return PlanStage::IS_EOF;
     }
 
+    if (_maxPrefetchBatchSize > 1) {
+        return doWorkPrefetching(out);
+    }
+
     // Either retry the last WSM we worked on or get a new one from our child.
     WorkingSetID id;
     StageState status;
@@ -132,6 +145,104 @@ PlanStage::StageState FetchStage::doWork(WorkingSetID* out) {
     return status;
 }
 
+PlanStage::StageState FetchStage::doWorkPrefetching(WorkingSetID* out) {
+    if (!_prefetched.empty()) {
+        WorkingSetID id = _prefetched.front();
+        _prefetched.pop_front();
+        return returnIfMatches(_ws->get(id), id, out);
+    }
+
+    // Read ahead until the batch is full or the child runs out of results.
+    if (_batch.size() < _prefetchBatchSize && !child()->isEOF()) {
+        WorkingSetID id = WorkingSet::INVALID_ID;
+        StageState status = child()->work(&id);
+
+        if (PlanStage::ADVANCED == status) {
+            // A document which the child already fetched may point into the child's cursor, which
+            // moves before we return it.
+            _ws->get(id)->makeObjOwnedIfNeeded();
+            _batch.push_back({id});
+            if (_batch.size() < _prefetchBatchSize) {
+                return PlanStage::NEED_TIME;
+            }
+        } else if (PlanStage::IS_EOF == status) {
+            if (_batch.empty()) {
+                return PlanStage::IS_EOF;
+            }
+        } else if (PlanStage::FAILURE == status || PlanStage::DEAD == status) {
+            // The stage which produces a failure is responsible for allocating a working set
+            // member with error details.
+            invariant(WorkingSet::INVALID_ID != id);
+            *out = id;
+            return status;
+        } else {
+            if (PlanStage::NEED_YIELD == status) {
+                *out = id;
+            }
+            return status;
+        }
+    }
+
+    return fetchBatch(out);
+}
+
+PlanStage::StageState FetchStage::fetchBatch(WorkingSetID* out) {
+    // Fetching in record id order reads the record store front to back rather than jumping
+    // around it in index order.
+    std::vector<PrefetchEntry*> toFetch;
+    for (auto& entry : _batch) {
+        if (!entry.fetched) {
+            toFetch.push_back(&entry);
+        }
+    }
+    std::sort(toFetch.begin(), toFetch.end(), [this](PrefetchEntry* lhs, PrefetchEntry* rhs) {
+        return _ws->get(lhs->id)->recordId < _ws->get(rhs->id)->recordId;
+    });
+
+    try {
+        if (!_cursor)
+            _cursor = collection()->getCursor(getOpCtx());
+
+        for (auto entry : toFetch) {
+            WorkingSetMember* member = _ws->get(entry->id);
+
+            // If there's an obj there, there is no fetching to perform.
+            if (member->hasObj()) {
+                ++_specificStats.alreadyHasObj;
+            } else {
+                // We need a valid RecordId to fetch from and this is the only state that has one.
+                verify(WorkingSetMember::RID_AND_IDX == member->getState());
+                verify(member->hasRecordId());
+
+                entry->found = WorkingSetCommon::fetch(getOpCtx(), _ws, entry->id, _cursor);
+
+                // The next fetch moves the cursor, so the document must not point into it.
+                if (entry->found) {
+                    member->makeObjOwnedIfNeeded();
+                }
+            }
+            entry->fetched = true;
+        }
+    } catch (const WriteConflictException&) {
+        // The members fetched so far own their documents, and the rest are still in RID_AND_IDX
+        // state. Finish the batch once we have yielded.
+        *out = WorkingSet::INVALID_ID;
+        return NEED_YIELD;
+    }
+
+    for (const auto& entry : _batch) {
+        if (entry.found) {
+            _prefetched.push_back(entry.id);
+        } else {
+            _ws->free(entry.id);
+        }
+    }
+    _batch.clear();
+    _prefetchBatchSize = std::min(_prefetchBatchSize * 2, _maxPrefetchBatchSize);
+
+    return NEED_TIME;
+}
+
 void FetchStage::doSaveStateRequiresCollection() {
     if (_cursor) {
         _cursor->saveUnpositioned();
@@ -30,7 +30,9 @@
 
 #pragma once
 
+#include <deque>
 #include <memory>
+#include <vector>
 
 #include "mongo/db/exec/requires_collection_stage.h"
 #include "mongo/db/jsobj.h"
@@ -87,6 +89,19 @@ private:
      */
     StageState returnIfMatches(WorkingSetMember* member, WorkingSetID memberID, WorkingSetID* out);
 
+    /**
+     * doWork() when reading ahead. Gathers a batch of results from the child, fetches them all in
+     * record id order, and then returns them in the order the child produced them.
+     */
+    StageState doWorkPrefetching(WorkingSetID* out);
+
+    /**
+     * Fetches every member of '_batch' which has not been fetched yet, then queues the members
+     * which still exist onto '_prefetched'. Returns NEED_YIELD if fetching hit a write conflict,
+     * in which case the rest of the batch is fetched on the next call.
+     */
+    StageState fetchBatch(WorkingSetID* out);
+
     // Used to fetch Records from _collection.
     std::unique_ptr<SeekableRecordCursor> _cursor;
 
@@ -99,6 +114,27 @@ private:
     // If not Null, we use this rather than asking our child what to do next.
     WorkingSetID _idRetrying;
 
+    // The largest batch read ahead from the child. Read-ahead is disabled if this is at most 1.
+    const size_t _maxPrefetchBatchSize;
+
+    // The size of the next batch. It starts at one and doubles with each batch up to
+    // '_maxPrefetchBatchSize', so that a plan which only needs its first few results does not
+    // fetch many more documents than it returns.
+    size_t _prefetchBatchSize = 1;
+
+    struct PrefetchEntry {
+        WorkingSetID id;
+        bool fetched = false;
+        // False if the document no longer exists, or no longer matches its index keys.
+        bool found = true;
+    };
+
+    // The results read ahead from the child and not yet fetched, in the child's order.
+    std::vector<PrefetchEntry> _batch;
+
+    // Fetched results waiting to be filtered and returned, in the child's order.
+    std::deque<WorkingSetID> _prefetched;
+
     // Stats
     FetchStats _specificStats;
 };
@@ -84,6 +84,8 @@ IndexScan::IndexScan(OperationContext* opCtx,
     _specificStats.isSparse = params.indexDescriptor->isSparse();
     _specificStats.isPartial = params.indexDescriptor->isPartial();
     _specificStats.indexVersion = static_cast<int>(params.indexDescriptor->version());
+    _specificStats.estimatedKeysExamined = params.estimatedKeysExamined;
+    _specificStats.isSkipScan = params.isSkipScan;
     _specificStats.collation = params.indexDescriptor->infoObj()
                                    .getObjectField(IndexDescriptor::kCollationFieldName)
                                    .getOwned();
@@ -30,6 +30,8 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
+
 #include "mongo/db/exec/requires_index_stage.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/jsobj.h"
@@ -81,6 +83,12 @@ struct IndexScanParams {
 
     // Do we want to add the key as metadata?
     bool addKeyMetadata{false};
+
+    // The planner's estimate of the number of keys the scan will examine, if any.
+    boost::optional<double> estimatedKeysExamined;
+
+    // Whether the planner chose the scan to skip over the values of the leading index field.
+    bool isSkipScan{false};
 };
 
 /**
@@ -47,6 +47,7 @@
 #include "mongo/db/query/explain.h"
 #include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/plan_ranker.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
@@ -205,12 +206,20 @@ Status MultiPlanStage::pickBestPlan(PlanYieldPolicy* yieldPolicy) {
     size_t numResults = getTrialPeriodNumToReturn(*_query);
 
     // Work the plans, stopping when a plan hits EOF or returns some
-    // fixed number of results.
+    // fixed number of results. Each time the number of rounds doubles, plans which have fallen far
+    // behind may be set aside so that the rest of the trial is spent on the contenders.
+    const double eliminationRatio = internalQueryPlanEvaluationEliminationRatio.load();
     for (size_t ix = 0; ix < numWorks; ++ix) {
         bool moreToDo = workAllPlans(numResults, yieldPolicy);
         if (!moreToDo) {
             break;
         }
+
+        const size_t numRounds = ix + 1;
+        if (eliminationRatio > 0 && numRounds >= kMinRoundsBeforeElimination &&
+            (numRounds & (numRounds - 1)) == 0) {
+            eliminateUnproductivePlans(eliminationRatio, numResults);
+        }
     }
 
     if (_failure) {
@@ -337,7 +346,7 @@ bool MultiPlanStage::workAllPlans(size_t numResults, PlanYieldPolicy* yieldPolic
 
     for (size_t ix = 0; ix < _candidates.size(); ++ix) {
         CandidatePlan& candidate = _candidates[ix];
-        if (candidate.failed) {
+        if (candidate.failed || candidate.eliminated) {
             continue;
         }
 
@@ -394,12 +403,54 @@ bool MultiPlanStage::workAllPlans(size_t numResults, PlanYieldPolicy* yieldPolic
                 _failure = true;
                 return false;
             }
+
+            // If every plan still being worked has now failed, resume the eliminated ones.
+            const bool anyActive =
+                std::any_of(_candidates.begin(), _candidates.end(), [](const CandidatePlan& other) {
+                    return !other.failed && !other.eliminated;
+                });
+            if (!anyActive) {
+                for (auto&& other : _candidates) {
+                    other.eliminated = false;
+                }
+            }
         }
     }
 
     return !doneWorking;
 }
 
+void MultiPlanStage::eliminateUnproductivePlans(double eliminationRatio, size_t numResults) {
+    size_t mostResults = 0;
+    for (auto&& candidate : _candidates) {
+        if (!candidate.failed && !candidate.eliminated) {
+            mostResults = std::max(mostResults, candidate.results.size());
+        }
+    }
+
+    // Until the leader has produced a fair share of the results needed to end the trial, the
+    // difference between the plans may be noise.
+    if (mostResults < std::max(size_t(1), numResults / 4)) {
+        return;
+    }
+
+    for (size_t ix = 0; ix < _candidates.size(); ++ix) {
+        CandidatePlan& candidate = _candidates[ix];
+        // A plan with a blocking stage produces nothing until it unblocks, so its results so far
+        // say nothing about its productivity.
+        if (candidate.failed || candidate.eliminated || candidate.solution->hasBlockingStage) {
+            continue;
+        }
+
+        if (candidate.results.size() * eliminationRatio < mostResults) {
+            LOG(5) << "Eliminating candidate " << ix << " from the trial period after it produced "
+                   << candidate.results.size() << " results, versus " << mostResults
+                   << " from the most productive candidate";
+            candidate.eliminated = true;
+        }
+    }
+}
+
 bool MultiPlanStage::hasBackupPlan() const {
     return kNoSuchPlan != _backupPlanIdx;
 }
@@ -173,6 +173,14 @@ private:
      */
     bool workAllPlans(size_t numResults, PlanYieldPolicy* yieldPolicy);
 
+    /**
+     * Stops working each candidate which is not blocking and has produced fewer than
+     * 1 / 'eliminationRatio' times as many results as the most productive candidate, once that
+     * candidate has produced a meaningful fraction of the 'numResults' results which end the
+     * trial period.
+     */
+    void eliminateUnproductivePlans(double eliminationRatio, size_t numResults);
+
     /**
      * Checks whether we need to perform either a timing-based yield or a yield for a document
      * fetch. If so, then uses 'yieldPolicy' to actually perform the yield.
@@ -183,6 +191,9 @@ private:
 
     static const int kNoSuchPlan = -1;
 
+    // Plans are not considered for elimination before every plan has been worked this many times.
+    static const size_t kMinRoundsBeforeElimination = 16;
+
     // Describes the cases in which we should write an entry for the winning plan to the plan cache.
     const CachingMode _cachingMode;
 
@@ -33,6 +33,7 @@
 #include "mongo/db/exec/filter.h"
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/mongoutils/str.h"
 
@@ -46,7 +47,11 @@ using stdx::make_unique;
 const char* OrStage::kStageType = "OR";
 
 OrStage::OrStage(OperationContext* opCtx, WorkingSet* ws, bool dedup, const MatchExpression* filter)
-    : PlanStage(kStageType, opCtx), _ws(ws), _filter(filter), _currentChild(0), _dedup(dedup) {}
+    : PlanStage(kStageType, opCtx), _ws(ws), _filter(filter), _currentChild(0), _dedup(dedup) {
+    if (_dedup && internalQueryPlannerEnableBitmapIntersection.load()) {
+        _seenBitmap.emplace();
+    }
+}
 
 void OrStage::addChild(PlanStage* child) {
     _children.emplace_back(child);
@@ -77,15 +82,13 @@ PlanStage::StageState OrStage::doWork(WorkingSetID* out) {
         if (_dedup && member->hasRecordId()) {
             ++_specificStats.dupsTested;
 
-            // ...and we've seen the RecordId before
-            if (_seen.end() != _seen.find(member->recordId)) {
-                // ...drop it.
+            // ...and we've seen the RecordId before, drop it. Otherwise, note that we've seen it.
+            const bool firstTimeSeen = _seenBitmap ? _seenBitmap->add(member->recordId)
+                                                   : _seen.insert(member->recordId).second;
+            if (!firstTimeSeen) {
                 ++_specificStats.dupsDropped;
                 _ws->free(id);
                 return PlanStage::NEED_TIME;
-            } else {
-                // Otherwise, note that we've seen it.
-                _seen.insert(member->recordId);
             }
         }
 
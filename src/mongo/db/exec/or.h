@@ -30,7 +30,10 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
+
 #include "mongo/db/exec/plan_stage.h"
+#include "mongo/db/exec/record_id_bitmap.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/record_id.h"
@@ -78,8 +81,10 @@ private:
     // True if we dedup on RecordId, false otherwise.
     const bool _dedup;
 
-    // Which RecordIds have we returned?
+    // Which RecordIds have we returned? Recorded in '_seenBitmap' instead if bitmap intersection
+    // was enabled when this stage was constructed.
     stdx::unordered_set<RecordId, RecordId::Hasher> _seen;
+    boost::optional<RecordIdBitmap> _seenBitmap;
 
     // Stats
     OrStats _specificStats;
@@ -30,6 +30,7 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
 #include <cstdint>
 #include <cstdlib>
 #include <string>
@@ -160,6 +161,24 @@ struct AndHashStats : public SpecificStats {
     size_t memLimit = 0u;
 };
 
+struct AndBitmapStats : public SpecificStats {
+    AndBitmapStats() = default;
+
+    SpecificStats* clone() const final {
+        AndBitmapStats* specific = new AndBitmapStats(*this);
+        return specific;
+    }
+
+    // How many record ids are in the intersection after each child?
+    std::vector<size_t> intersectionAfterChild;
+
+    // How much memory do the bitmaps use, as of the last measurement?
+    size_t memUsage = 0u;
+
+    // What's our memory limit?
+    size_t memLimit = 0u;
+};
+
 struct AndSortedStats : public SpecificStats {
     AndSortedStats() = default;
 
@@ -418,6 +437,13 @@ struct IndexScanStats : public SpecificStats {
     // Number of entries retrieved from the index during the scan.
     size_t keysExamined;
 
+    // The planner's estimate of 'keysExamined', if the collection has statistics.
+    boost::optional<double> estimatedKeysExamined;
+
+    // Whether the scan skips over the values of the leading index field. Such scans report each
+    // skip in 'seeks'.
+    bool isSkipScan = false;
+
     // Number of times the index cursor is re-positioned during the execution of the scan.
     size_t seeks;
 };
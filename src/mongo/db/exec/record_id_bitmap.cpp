@@ -0,0 +1,282 @@
+
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/record_id_bitmap.h"
+
+#include <algorithm>
+#include <bitset>
+#include <iterator>
+
+#include "mongo/platform/bits.h"
+
+namespace mongo {
+
+namespace {
+
+// The number of 64-bit words in a bitset container.
+const size_t kBitsetWords = (1 << 16) / 64;
+
+// Rough per-container overhead of the map node holding it.
+const size_t kContainerOverheadBytes = 64;
+
+// RecordIds are split after flipping the sign bit, so that unsigned order matches RecordId order.
+const uint64_t kSignBit = 1ULL << 63;
+
+uint64_t highBits(const RecordId& recordId) {
+    return (static_cast<uint64_t>(recordId.repr()) ^ kSignBit) >> 16;
+}
+
+uint16_t lowBits(const RecordId& recordId) {
+    return static_cast<uint16_t>(recordId.repr());
+}
+
+RecordId makeRecordId(uint64_t high, uint32_t low) {
+    return RecordId(static_cast<int64_t>(((high << 16) | low) ^ kSignBit));
+}
+
+bool testBit(const std::vector<uint64_t>& bits, uint16_t low) {
+    return bits[low >> 6] & (1ULL << (low & 63));
+}
+
+}  // namespace
+
+bool RecordIdBitmap::Container::add(uint16_t low) {
+    if (isBitset()) {
+        uint64_t& word = bits[low >> 6];
+        const uint64_t mask = 1ULL << (low & 63);
+        if (word & mask) {
+            return false;
+        }
+        word |= mask;
+        ++cardinality;
+        return true;
+    }
+
+    auto it = std::lower_bound(array.begin(), array.end(), low);
+    if (it != array.end() && *it == low) {
+        return false;
+    }
+    array.insert(it, low);
+    ++cardinality;
+    if (cardinality > kMaxArraySize) {
+        convertToBitset();
+    }
+    return true;
+}
+
+bool RecordIdBitmap::Container::contains(uint16_t low) const {
+    if (isBitset()) {
+        return testBit(bits, low);
+    }
+    return std::binary_search(array.begin(), array.end(), low);
+}
+
+void RecordIdBitmap::Container::intersectWith(const Container& other) {
+    if (isBitset() && other.isBitset()) {
+        for (size_t i = 0; i < kBitsetWords; ++i) {
+            bits[i] &= other.bits[i];
+        }
+        recount();
+    } else if (isBitset()) {
+        // Keep the values of the other array which are set here.
+        std::vector<uint16_t> result;
+        std::copy_if(other.array.begin(),
+                     other.array.end(),
+                     std::back_inserter(result),
+                     [this](uint16_t low) { return testBit(bits, low); });
+        bits.clear();
+        bits.shrink_to_fit();
+        array = std::move(result);
+        cardinality = array.size();
+    } else if (other.isBitset()) {
+        array.erase(std::remove_if(array.begin(),
+                                   array.end(),
+                                   [&other](uint16_t low) { return !testBit(other.bits, low); }),
+                    array.end());
+        cardinality = array.size();
+    } else {
+        std::vector<uint16_t> result;
+        std::set_intersection(array.begin(),
+                              array.end(),
+                              other.array.begin(),
+                              other.array.end(),
+                              std::back_inserter(result));
+        array = std::move(result);
+        cardinality = array.size();
+    }
+}
+
+void RecordIdBitmap::Container::unionWith(const Container& other) {
+    if (!isBitset() && !other.isBitset()) {
+        std::vector<uint16_t> result;
+        std::set_union(array.begin(),
+                       array.end(),
+                       other.array.begin(),
+                       other.array.end(),
+                       std::back_inserter(result));
+        array = std::move(result);
+        cardinality = array.size();
+        if (cardinality > kMaxArraySize) {
+            convertToBitset();
+        }
+        return;
+    }
+
+    if (!isBitset()) {
+        convertToBitset();
+    }
+    if (other.isBitset()) {
+        for (size_t i = 0; i < kBitsetWords; ++i) {
+            bits[i] |= other.bits[i];
+        }
+    } else {
+        for (auto low : other.array) {
+            bits[low >> 6] |= 1ULL << (low & 63);
+        }
+    }
+    recount();
+}
+
+void RecordIdBitmap::Container::convertToBitset() {
+    bits.assign(kBitsetWords, 0);
+    for (auto low : array) {
+        bits[low >> 6] |= 1ULL << (low & 63);
+    }
+    array.clear();
+    array.shrink_to_fit();
+}
+
+void RecordIdBitmap::Container::convertToArray() {
+    array.clear();
+    array.reserve(cardinality);
+    for (size_t i = 0; i < kBitsetWords; ++i) {
+        uint64_t word = bits[i];
+        while (word) {
+            array.push_back(static_cast<uint16_t>(i * 64 + countTrailingZeros64(word)));
+            word &= word - 1;
+        }
+    }
+    bits.clear();
+    bits.shrink_to_fit();
+}
+
+void RecordIdBitmap::Container::recount() {
+    cardinality = 0;
+    for (auto word : bits) {
+        cardinality += std::bitset<64>(word).count();
+    }
+    if (cardinality <= kMaxArraySize) {
+        convertToArray();
+    }
+}
+
+bool RecordIdBitmap::add(const RecordId& recordId) {
+    if (!_containers[highBits(recordId)].add(lowBits(recordId))) {
+        return false;
+    }
+    ++_size;
+    return true;
+}
+
+bool RecordIdBitmap::contains(const RecordId& recordId) const {
+    auto it = _containers.find(highBits(recordId));
+    return it != _containers.end() && it->second.contains(lowBits(recordId));
+}
+
+void RecordIdBitmap::intersectWith(const RecordIdBitmap& other) {
+    _size = 0;
+    auto it = _containers.begin();
+    while (it != _containers.end()) {
+        auto otherIt = other._containers.find(it->first);
+        if (otherIt != other._containers.end()) {
+            it->second.intersectWith(otherIt->second);
+        }
+        if (otherIt == other._containers.end() || 0 == it->second.cardinality) {
+            it = _containers.erase(it);
+            continue;
+        }
+        _size += it->second.cardinality;
+        ++it;
+    }
+}
+
+void RecordIdBitmap::unionWith(const RecordIdBitmap& other) {
+    for (auto&& otherContainer : other._containers) {
+        Container& container = _containers[otherContainer.first];
+        _size -= container.cardinality;
+        container.unionWith(otherContainer.second);
+        _size += container.cardinality;
+    }
+}
+
+void RecordIdBitmap::clear() {
+    _containers.clear();
+    _size = 0;
+}
+
+size_t RecordIdBitmap::getMemUsage() const {
+    size_t memUsage = sizeof(*this);
+    for (auto&& container : _containers) {
+        memUsage += kContainerOverheadBytes + container.second.array.capacity() * sizeof(uint16_t) +
+            container.second.bits.capacity() * sizeof(uint64_t);
+    }
+    return memUsage;
+}
+
+RecordIdBitmap::Cursor::Cursor(const RecordIdBitmap& bitmap)
+    : _bitmap(&bitmap), _container(bitmap._containers.begin()) {}
+
+boost::optional<RecordId> RecordIdBitmap::Cursor::next() {
+    for (; _container != _bitmap->_containers.end(); ++_container, _position = 0) {
+        const Container& container = _container->second;
+        if (!container.isBitset()) {
+            if (_position < container.array.size()) {
+                return makeRecordId(_container->first, container.array[_position++]);
+            }
+            continue;
+        }
+
+        while (_position < (1 << 16)) {
+            // Mask off the bits below '_position' in its word.
+            const uint64_t word = container.bits[_position >> 6] & (~0ULL << (_position & 63));
+            if (word) {
+                const uint32_t low = (_position & ~63u) + countTrailingZeros64(word);
+                _position = low + 1;
+                return makeRecordId(_container->first, low);
+            }
+            _position = (_position & ~63u) + 64;
+        }
+    }
+    return boost::none;
+}
+
+}  // namespace mongo
@@ -0,0 +1,146 @@
+
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include <boost/optional.hpp>
+
+#include "mongo/db/record_id.h"
+
+namespace mongo {
+
+/**
+ * A compressed set of RecordIds, laid out in the manner of a roaring bitmap.
+ *
+ * RecordIds are split into a high part, which selects a container, and the low 16 bits, which
+ * the container holds. A container stores its values as a sorted array while it holds at most
+ * kMaxArraySize of them, and as a 64Kbit bitset once it holds more, so that each value takes at
+ * most two bytes and dense ranges of RecordIds take one bit per value.
+ *
+ * Iteration is in ascending RecordId order.
+ */
+class RecordIdBitmap {
+public:
+    // The number of values beyond which a container is stored as a bitset. At this size the
+    // array and the bitset take the same space.
+    static constexpr size_t kMaxArraySize = 4096;
+
+    class Cursor;
+
+    /**
+     * Adds 'recordId' to the set. Returns false if it was already present.
+     */
+    bool add(const RecordId& recordId);
+
+    bool contains(const RecordId& recordId) const;
+
+    /**
+     * Removes every RecordId which is not also in 'other'.
+     */
+    void intersectWith(const RecordIdBitmap& other);
+
+    /**
+     * Adds every RecordId in 'other'.
+     */
+    void unionWith(const RecordIdBitmap& other);
+
+    void clear();
+
+    size_t size() const {
+        return _size;
+    }
+
+    bool empty() const {
+        return 0 == _size;
+    }
+
+    /**
+     * Returns the approximate number of bytes used to hold the set.
+     */
+    size_t getMemUsage() const;
+
+private:
+    friend class Cursor;
+
+    struct Container {
+        bool isBitset() const {
+            return !bits.empty();
+        }
+
+        bool add(uint16_t low);
+        bool contains(uint16_t low) const;
+        void intersectWith(const Container& other);
+        void unionWith(const Container& other);
+
+        void convertToBitset();
+        void convertToArray();
+
+        // Sets 'cardinality' from the bitset, and falls back to an array if it is sparse enough.
+        void recount();
+
+        // The low 16 bits of each value in ascending order, while the container is an array.
+        std::vector<uint16_t> array;
+
+        // One bit per possible low 16-bit value, once the container is a bitset.
+        std::vector<uint64_t> bits;
+
+        uint32_t cardinality = 0;
+    };
+
+    std::map<uint64_t, Container> _containers;
+    size_t _size = 0;
+};
+
+/**
+ * Iterates over the RecordIds of a bitmap in ascending order. The bitmap must not be modified
+ * while a cursor over it is in use.
+ */
+class RecordIdBitmap::Cursor {
+public:
+    explicit Cursor(const RecordIdBitmap& bitmap);
+
+    /**
+     * Returns the next RecordId, or boost::none once all of them have been returned.
+     */
+    boost::optional<RecordId> next();
+
+private:
+    const RecordIdBitmap* _bitmap;
+
+    // The container being iterated, and the next array index or bit to look at within it.
+    std::map<uint64_t, Container>::const_iterator _container;
+    uint32_t _position = 0;
+};
+
+}  // namespace mongo
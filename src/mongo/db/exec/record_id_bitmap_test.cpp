@@ -0,0 +1,187 @@
+
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <set>
+
+#include "mongo/db/exec/record_id_bitmap.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+std::vector<RecordId> drain(const RecordIdBitmap& bitmap) {
+    std::vector<RecordId> out;
+    RecordIdBitmap::Cursor cursor(bitmap);
+    while (auto recordId = cursor.next()) {
+        out.push_back(*recordId);
+    }
+    return out;
+}
+
+TEST(RecordIdBitmapTest, AddAndContains) {
+    RecordIdBitmap bitmap;
+    ASSERT_TRUE(bitmap.empty());
+
+    ASSERT_TRUE(bitmap.add(RecordId(5)));
+    ASSERT_TRUE(bitmap.add(RecordId(70000)));
+    ASSERT_FALSE(bitmap.add(RecordId(5)));
+
+    ASSERT_EQ(2U, bitmap.size());
+    ASSERT_TRUE(bitmap.contains(RecordId(5)));
+    ASSERT_TRUE(bitmap.contains(RecordId(70000)));
+    ASSERT_FALSE(bitmap.contains(RecordId(6)));
+    ASSERT_FALSE(bitmap.contains(RecordId(4464)));
+
+    bitmap.clear();
+    ASSERT_TRUE(bitmap.empty());
+    ASSERT_FALSE(bitmap.contains(RecordId(5)));
+}
+
+TEST(RecordIdBitmapTest, CursorReturnsAscendingOrderAcrossContainers) {
+    RecordIdBitmap bitmap;
+    std::set<RecordId> expected;
+    for (long long repr : {3LL, -2LL, 1LL << 40, 65536LL, -(1LL << 33), 65535LL, 0LL}) {
+        bitmap.add(RecordId(repr));
+        expected.insert(RecordId(repr));
+    }
+
+    auto actual = drain(bitmap);
+    ASSERT_EQ(expected.size(), actual.size());
+    ASSERT_TRUE(std::equal(expected.begin(), expected.end(), actual.begin()));
+}
+
+TEST(RecordIdBitmapTest, DenseContainerBecomesBitset) {
+    RecordIdBitmap bitmap;
+    const size_t count = RecordIdBitmap::kMaxArraySize * 4;
+    for (size_t i = 1; i <= count; ++i) {
+        ASSERT_TRUE(bitmap.add(RecordId(i)));
+    }
+    ASSERT_FALSE(bitmap.add(RecordId(1)));
+    ASSERT_EQ(count, bitmap.size());
+
+    // A dense run of RecordIds should take well under two bytes per value.
+    ASSERT_LT(bitmap.getMemUsage(), count * 2);
+
+    auto actual = drain(bitmap);
+    ASSERT_EQ(count, actual.size());
+    for (size_t i = 0; i < count; ++i) {
+        ASSERT_EQ(RecordId(i + 1), actual[i]);
+    }
+}
+
+TEST(RecordIdBitmapTest, IntersectBitsetWithArray) {
+    RecordIdBitmap dense;
+    for (long long i = 0; i < 20000; ++i) {
+        dense.add(RecordId(i));
+    }
+
+    RecordIdBitmap sparse;
+    sparse.add(RecordId(7));
+    sparse.add(RecordId(19999));
+    sparse.add(RecordId(20000));
+    sparse.add(RecordId(1 << 20));
+
+    RecordIdBitmap result = dense;
+    result.intersectWith(sparse);
+    ASSERT_EQ(2U, result.size());
+    ASSERT_TRUE(result.contains(RecordId(7)));
+    ASSERT_TRUE(result.contains(RecordId(19999)));
+    ASSERT_FALSE(result.contains(RecordId(20000)));
+
+    sparse.intersectWith(dense);
+    ASSERT_EQ(2U, sparse.size());
+    ASSERT_TRUE(drain(sparse) == drain(result));
+}
+
+TEST(RecordIdBitmapTest, IntersectBitsetsCanBecomeArray) {
+    RecordIdBitmap evens;
+    RecordIdBitmap multiplesOfThree;
+    for (long long i = 0; i < 60000; ++i) {
+        if (i % 2 == 0) {
+            evens.add(RecordId(i));
+        }
+        if (i % 3 == 0) {
+            multiplesOfThree.add(RecordId(i));
+        }
+    }
+
+    evens.intersectWith(multiplesOfThree);
+    ASSERT_EQ(10000U, evens.size());
+    for (long long i = 0; i < 60000; ++i) {
+        ASSERT_EQ(i % 6 == 0, evens.contains(RecordId(i)));
+    }
+
+    // Intersecting down to a few values should leave a small array container.
+    RecordIdBitmap few;
+    few.add(RecordId(0));
+    few.add(RecordId(6));
+    few.add(RecordId(7));
+    evens.intersectWith(few);
+    ASSERT_EQ(2U, evens.size());
+    ASSERT_LT(evens.getMemUsage(), 1024U);
+}
+
+TEST(RecordIdBitmapTest, IntersectWithEmptyClearsEverything) {
+    RecordIdBitmap bitmap;
+    bitmap.add(RecordId(1));
+    bitmap.add(RecordId(1LL << 32));
+
+    bitmap.intersectWith(RecordIdBitmap());
+    ASSERT_TRUE(bitmap.empty());
+    ASSERT_FALSE(RecordIdBitmap::Cursor(bitmap).next());
+}
+
+TEST(RecordIdBitmapTest, Union) {
+    RecordIdBitmap left;
+    RecordIdBitmap right;
+    std::set<RecordId> expected;
+    for (long long i = 0; i < 10000; i += 2) {
+        left.add(RecordId(i));
+        expected.insert(RecordId(i));
+    }
+    for (long long i = 5000; i < 15000; i += 3) {
+        right.add(RecordId(i));
+        expected.insert(RecordId(i));
+    }
+    right.add(RecordId(-10));
+    expected.insert(RecordId(-10));
+
+    left.unionWith(right);
+    ASSERT_EQ(expected.size(), left.size());
+
+    auto actual = drain(left);
+    ASSERT_EQ(expected.size(), actual.size());
+    ASSERT_TRUE(std::equal(expected.begin(), expected.end(), actual.begin()));
+}
+
+}  // namespace
+}  // namespace mongo
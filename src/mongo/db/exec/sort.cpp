@@ -43,6 +43,7 @@
 #include "mongo/db/query/find_common.h"
 #include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_planner.h"
+#include "mongo/db/storage/key_string.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
 
@@ -56,12 +57,15 @@ using stdx::make_unique;
 // static
 const char* SortStage::kStageType = "SORT";
 
-SortStage::WorkingSetComparator::WorkingSetComparator(BSONObj p) : pattern(p) {}
+SortStage::WorkingSetComparator::WorkingSetComparator(BSONObj p, bool encoded)
+    : pattern(p), encoded(encoded) {}
 
 bool SortStage::WorkingSetComparator::operator()(const SortableDataItem& lhs,
                                                  const SortableDataItem& rhs) const {
-    // False means ignore field names.
-    int result = lhs.sortKey.woCompare(rhs.sortKey, pattern, false);
+    // KeyString encodings order the same way as the keys they encode. False means ignore field
+    // names.
+    int result = encoded ? lhs.encodedSortKey.compare(rhs.encodedSortKey)
+                         : lhs.sortKey.woCompare(rhs.sortKey, pattern, false);
     if (0 != result) {
         return result < 0;
     }
@@ -83,14 +87,15 @@ SortStage::SortStage(OperationContext* opCtx,
     _children.emplace_back(child);
 
     BSONObj sortComparator = FindCommon::transformSortSpec(_pattern);
-    _sortKeyComparator = stdx::make_unique<WorkingSetComparator>(sortComparator);
 
-    // If limit > 1, we need to initialize _dataSet here to maintain ordered set of data items while
-    // fetching from the child stage.
-    if (_limit > 1) {
-        const WorkingSetComparator& cmp = *_sortKeyComparator;
-        _dataSet.reset(new SortableDataItemSet(cmp));
+    // An Ordering can only describe a limited number of fields. Sorts on more fields than that
+    // compare their keys as BSON.
+    const bool encoded =
+        static_cast<size_t>(sortComparator.nFields()) <= Ordering::kMaxCompoundIndexKeys;
+    if (encoded) {
+        _sortKeyOrdering = Ordering::make(sortComparator);
     }
+    _sortKeyComparator = stdx::make_unique<WorkingSetComparator>(sortComparator, encoded);
 }
 
 SortStage::~SortStage() {}
@@ -136,12 +141,18 @@ PlanStage::StageState SortStage::doWork(WorkingSetID* out) {
                 static_cast<const SortKeyComputedData*>(member->getComputed(WSM_SORT_KEY));
             item.sortKey = sortKeyComputedData->getSortKey();
 
+            // Encode the key once here, rather than on each of the comparisons it takes part in.
+            if (_sortKeyOrdering) {
+                KeyString ks(KeyString::kLatestVersion, item.sortKey, *_sortKeyOrdering);
+                item.encodedSortKey.assign(ks.getBuffer(), ks.getSize());
+            }
+
             if (member->hasRecordId()) {
                 // The RecordId breaks ties when sorting two WSMs with the same sort key.
                 item.recordId = member->recordId;
             }
 
-            addToBuffer(item);
+            addToBuffer(std::move(item));
 
             return PlanStage::NEED_TIME;
         } else if (PlanStage::IS_EOF == code) {
@@ -200,71 +211,46 @@ const SpecificStats* SortStage::getSpecificStats() const {
  * limit == 0:
  *     addToBuffer() - Adds item to vector.
  *     sortBuffer() - Sorts vector.
- * limit == 1:
- *     addToBuffer() - Replaces first item in vector with max of
- *                     current and new item.
- *                     Updates memory usage if item was replaced.
- *     sortBuffer() - Does nothing.
- * limit > 1:
- *     addToBuffer() - Does not update vector. Adds item to set.
- *                     If size of set exceeds limit, remove item from set
- *                     with lowest key. Updates memory usage accordingly.
- *     sortBuffer() - Copies items from set to vectors.
+ * limit > 0:
+ *     addToBuffer() - Adds item to a max-heap of at most limit items.
+ *                     Once the heap is full, a new item replaces the
+ *                     item with the highest key if its own key is lower,
+ *                     and is dropped otherwise. Updates memory usage
+ *                     accordingly.
+ *     sortBuffer() - Sorts the heap in place.
  */
-void SortStage::addToBuffer(const SortableDataItem& item) {
+void SortStage::addToBuffer(SortableDataItem item) {
     // Holds ID of working set member to be freed at end of this function.
     WorkingSetID wsidToFree = WorkingSet::INVALID_ID;
 
     WorkingSetMember* member = _ws->get(item.wsid);
+    const WorkingSetComparator& cmp = *_sortKeyComparator;
     if (_limit == 0) {
         // Ensure that the BSONObj underlying the WorkingSetMember is owned in case we yield.
         member->makeObjOwnedIfNeeded();
-        _data.push_back(item);
-        _memUsage += member->getMemUsage();
-    } else if (_limit == 1) {
-        if (_data.empty()) {
-            member->makeObjOwnedIfNeeded();
-            _data.push_back(item);
-            _memUsage = member->getMemUsage();
-            return;
-        }
-        wsidToFree = item.wsid;
-        const WorkingSetComparator& cmp = *_sortKeyComparator;
-        // Compare new item with existing item in vector.
-        if (cmp(item, _data[0])) {
-            wsidToFree = _data[0].wsid;
-            member->makeObjOwnedIfNeeded();
-            _data[0] = item;
-            _memUsage = member->getMemUsage();
-        }
-    } else {
-        // Update data item set instead of vector
+        _memUsage += member->getMemUsage() + item.encodedSortKey.size();
+        _data.push_back(std::move(item));
+    } else if (_data.size() < _limit) {
         // Limit not reached - insert and return
-        vector<SortableDataItem>::size_type limit(_limit);
-        if (_dataSet->size() < limit) {
-            member->makeObjOwnedIfNeeded();
-            _dataSet->insert(item);
-            _memUsage += member->getMemUsage();
-            return;
-        }
-        // Limit will be exceeded - compare with item with lowest key
-        // If new item does not have a lower key value than last item,
-        // do nothing.
+        member->makeObjOwnedIfNeeded();
+        _memUsage += member->getMemUsage() + item.encodedSortKey.size();
+        _data.push_back(std::move(item));
+        std::push_heap(_data.begin(), _data.end(), cmp);
+        return;
+    } else {
+        // Limit will be exceeded - compare with the item with the highest key, at the top of the
+        // heap. If new item does not have a lower key value than that item, do nothing.
         wsidToFree = item.wsid;
-        SortableDataItemSet::const_iterator lastItemIt = --(_dataSet->end());
-        const SortableDataItem& lastItem = *lastItemIt;
-        const WorkingSetComparator& cmp = *_sortKeyComparator;
-        if (cmp(item, lastItem)) {
-            _memUsage -= _ws->get(lastItem.wsid)->getMemUsage();
-            _memUsage += member->getMemUsage();
-            wsidToFree = lastItem.wsid;
-            // According to std::set iterator validity rules,
-            // it does not matter which of erase()/insert() happens first.
-            // Here, we choose to erase first to release potential resources
-            // used by the last item and to keep the scope of the iterator to a minimum.
-            _dataSet->erase(lastItemIt);
+        if (cmp(item, _data.front())) {
+            wsidToFree = _data.front().wsid;
+            _memUsage -= _ws->get(wsidToFree)->getMemUsage() + _data.front().encodedSortKey.size();
+            _memUsage += member->getMemUsage() + item.encodedSortKey.size();
+
+            // Move the highest item to the back of the vector, overwrite it, and restore the heap.
+            std::pop_heap(_data.begin(), _data.end(), cmp);
             member->makeObjOwnedIfNeeded();
-            _dataSet->insert(item);
+            _data.back() = std::move(item);
+            std::push_heap(_data.begin(), _data.end(), cmp);
         }
     }
 
@@ -277,19 +263,12 @@ void SortStage::addToBuffer(const SortableDataItem& item) {
 }
 
 void SortStage::sortBuffer() {
+    const WorkingSetComparator& cmp = *_sortKeyComparator;
     if (_limit == 0) {
-        const WorkingSetComparator& cmp = *_sortKeyComparator;
         std::sort(_data.begin(), _data.end(), cmp);
-    } else if (_limit == 1) {
-        // Buffer contains either 0 or 1 item so it is already in a sorted state.
-        return;
     } else {
-        // Set already contains items in sorted order, so we simply copy the items
-        // from the set to the vector.
-        // Release the memory for the set after the copy.
-        vector<SortableDataItem> newData(_dataSet->begin(), _dataSet->end());
-        _data.swap(newData);
-        _dataSet.reset();
+        // The buffer is a heap, which can be sorted in place.
+        std::sort_heap(_data.begin(), _data.end(), cmp);
     }
 }
 
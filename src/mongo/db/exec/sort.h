@@ -30,9 +30,11 @@
 
 #pragma once
 
-#include <set>
+#include <boost/optional.hpp>
+#include <string>
 #include <vector>
 
+#include "mongo/bson/ordering.h"
 #include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/exec/sort_key_generator.h"
 #include "mongo/db/exec/working_set.h"
@@ -112,37 +114,41 @@ private:
     struct SortableDataItem {
         WorkingSetID wsid;
         BSONObj sortKey;
+        // The KeyString encoding of 'sortKey' under the sort pattern's ordering, so that keys
+        // can be compared with memcmp. Empty if the pattern has too many fields to be encoded.
+        std::string encodedSortKey;
         // Since we must replicate the behavior of a covered sort as much as possible we use the
         // RecordId to break sortKey ties.
         // See sorta.js.
         RecordId recordId;
     };
 
-    // Comparison object for data buffers (vector and set). Items are compared on (sortKey, loc).
-    // This is also how the items are ordered in the indices. Keys are compared using
-    // BSONObj::woCompare() with RecordId as a tie-breaker.
+    // Comparison object for the data buffer. Items are compared on (sortKey, loc). This is also
+    // how the items are ordered in the indices. Keys are compared by their KeyString encodings,
+    // or using BSONObj::woCompare() if they could not be encoded, with RecordId as a tie-breaker.
     //
     // We are comparing keys generated by the SortKeyGenerator, which are already ordered with
     // respect the collation. Therefore, we explicitly avoid comparing using a collator here.
     struct WorkingSetComparator {
-        explicit WorkingSetComparator(BSONObj p);
+        WorkingSetComparator(BSONObj p, bool encoded);
 
         bool operator()(const SortableDataItem& lhs, const SortableDataItem& rhs) const;
 
         BSONObj pattern;
+
+        // Whether the items carry an encoded sort key.
+        bool encoded;
     };
 
     /**
-     * Inserts one item into data buffer (vector or set).
-     * If limit is exceeded, remove item with lowest key.
+     * Inserts one item into the data buffer.
+     * If limit is exceeded, remove item with highest key.
      */
-    void addToBuffer(const SortableDataItem& item);
+    void addToBuffer(SortableDataItem item);
 
     /**
      * Sorts data buffer.
      * Assumes no more items will be added to buffer.
-     * If data is stored in set, copy set
-     * contents to vector and clear set.
      */
     void sortBuffer();
 
@@ -150,23 +156,24 @@ private:
     // Initialization follows sort key generator
     std::unique_ptr<WorkingSetComparator> _sortKeyComparator;
 
+    // The ordering used to encode sort keys, if '_sortKeyComparator' compares encoded keys.
+    boost::optional<Ordering> _sortKeyOrdering;
+
     // The data we buffer and sort.
     // _data will contain sorted data when all data is gathered
     // and sorted.
-    // When _limit is greater than 1 and not all data has been gathered from child stage,
-    // _dataSet is used instead to maintain an ordered set of the incomplete data set.
-    // When the data set is complete, we copy the items from _dataSet to _data which will
-    // be used to provide the results of this stage through _resultIterator.
+    // When _limit is nonzero and not all data has been gathered from child stage, _data is a
+    // binary heap of at most _limit items whose top is the item with the highest key, so that it
+    // can be evicted cheaply when a lower key arrives.
     std::vector<SortableDataItem> _data;
-    typedef std::set<SortableDataItem, WorkingSetComparator> SortableDataItemSet;
-    std::unique_ptr<SortableDataItemSet> _dataSet;
 
     // Iterates through _data post-sort returning it.
     std::vector<SortableDataItem>::iterator _resultIterator;
 
     SortStats _specificStats;
 
-    // The usage in bytes of all buffered data that we're sorting.
+    // The usage in bytes of all buffered data that we're sorting: the working set members and the
+    // encoded sort keys.
     size_t _memUsage;
 };
 
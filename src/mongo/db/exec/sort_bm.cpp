@@ -0,0 +1,242 @@
+
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/bson/ordering.h"
+#include "mongo/db/client.h"
+#include "mongo/db/exec/queued_data_stage.h"
+#include "mongo/db/exec/sort.h"
+#include "mongo/db/exec/sort_key_generator.h"
+#include "mongo/db/exec/working_set.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/storage/key_string.h"
+#include "mongo/platform/random.h"
+#include "mongo/stdx/memory.h"
+
+namespace mongo {
+namespace {
+
+const int kNumKeys = 100 * 1000;
+
+const BSONObj kSortPattern = BSON("a" << 1 << "b" << -1);
+
+/**
+ * Generates sort keys in random order, in the shape produced by the SortKeyGenerator for
+ * 'kSortPattern'.
+ */
+std::vector<BSONObj> makeSortKeys() {
+    PseudoRandom random(kNumKeys);
+
+    std::vector<BSONObj> keys;
+    keys.reserve(kNumKeys);
+    for (int i = 0; i < kNumKeys; ++i) {
+        keys.push_back(BSON("" << random.nextInt32(1000) << ""
+                               << std::string(8, 'a' + random.nextInt32(26))));
+    }
+    return keys;
+}
+
+/**
+ * Keeps the top 'limit' keys in a std::set ordered with BSONObj::woCompare(), which is how the
+ * SORT stage used to handle a sort with a limit.
+ */
+void BM_TopKWithSetOverBSON(benchmark::State& state) {
+    const auto keys = makeSortKeys();
+    const size_t limit = state.range(0);
+
+    auto less = [](const BSONObj& lhs, const BSONObj& rhs) {
+        return lhs.woCompare(rhs, kSortPattern, false) < 0;
+    };
+
+    for (auto keepRunning : state) {
+        std::set<BSONObj, decltype(less)> topK(less);
+        for (const auto& key : keys) {
+            if (topK.size() < limit) {
+                topK.insert(key);
+            } else if (less(key, *topK.rbegin())) {
+                topK.erase(std::prev(topK.end()));
+                topK.insert(key);
+            }
+        }
+        benchmark::DoNotOptimize(topK);
+    }
+
+    state.SetItemsProcessed(state.iterations() * kNumKeys);
+}
+
+/**
+ * Keeps the top 'limit' keys in a bounded max-heap over their KeyString encodings, as the SORT
+ * stage does. Each key is encoded once as it arrives, so encoding is part of the measured work.
+ */
+void BM_TopKWithHeapOverKeyString(benchmark::State& state) {
+    const auto keys = makeSortKeys();
+    const size_t limit = state.range(0);
+    const auto ordering = Ordering::make(kSortPattern);
+
+    for (auto keepRunning : state) {
+        std::vector<std::string> heap;
+        heap.reserve(limit);
+        for (const auto& key : keys) {
+            KeyString ks(KeyString::kLatestVersion, key, ordering);
+            std::string encoded(ks.getBuffer(), ks.getSize());
+            if (heap.size() < limit) {
+                heap.push_back(std::move(encoded));
+                std::push_heap(heap.begin(), heap.end());
+            } else if (encoded < heap.front()) {
+                std::pop_heap(heap.begin(), heap.end());
+                heap.back() = std::move(encoded);
+                std::push_heap(heap.begin(), heap.end());
+            }
+        }
+        std::sort_heap(heap.begin(), heap.end());
+        benchmark::DoNotOptimize(heap);
+    }
+
+    state.SetItemsProcessed(state.iterations() * kNumKeys);
+}
+
+/**
+ * Sorts every key by comparing them with BSONObj::woCompare().
+ */
+void BM_FullSortOverBSON(benchmark::State& state) {
+    const auto keys = makeSortKeys();
+
+    for (auto keepRunning : state) {
+        auto sorted = keys;
+        std::sort(sorted.begin(), sorted.end(), [](const BSONObj& lhs, const BSONObj& rhs) {
+            return lhs.woCompare(rhs, kSortPattern, false) < 0;
+        });
+        benchmark::DoNotOptimize(sorted);
+    }
+
+    state.SetItemsProcessed(state.iterations() * kNumKeys);
+}
+
+/**
+ * Encodes every key into a KeyString and sorts the encodings.
+ */
+void BM_FullSortOverKeyString(benchmark::State& state) {
+    const auto keys = makeSortKeys();
+    const auto ordering = Ordering::make(kSortPattern);
+
+    for (auto keepRunning : state) {
+        std::vector<std::string> sorted;
+        sorted.reserve(keys.size());
+        for (const auto& key : keys) {
+            KeyString ks(KeyString::kLatestVersion, key, ordering);
+            sorted.emplace_back(ks.getBuffer(), ks.getSize());
+        }
+        std::sort(sorted.begin(), sorted.end());
+        benchmark::DoNotOptimize(sorted);
+    }
+
+    state.SetItemsProcessed(state.iterations() * kNumKeys);
+}
+
+/**
+ * Sorts documents through a SORT stage fed by a SortKeyGeneratorStage, as in a query plan, with
+ * the limit given as the argument (0 for none). Measures the stage as a whole: sort key
+ * generation and encoding, buffering and memory accounting, and returning the results.
+ */
+void BM_SortStage(benchmark::State& state) {
+    const auto keys = makeSortKeys();
+    std::vector<BSONObj> docs;
+    docs.reserve(keys.size());
+    for (const auto& key : keys) {
+        BSONObjIterator it(key);
+        const BSONElement a = it.next();
+        const BSONElement b = it.next();
+        BSONObjBuilder bob;
+        bob.appendAs(a, "a");
+        bob.appendAs(b, "b");
+        docs.push_back(bob.obj());
+    }
+
+    auto client = getGlobalServiceContext()->makeClient("sort_bm");
+    auto opCtx = client->makeOperationContext();
+
+    SortStageParams params;
+    params.pattern = kSortPattern;
+    params.limit = state.range(0);
+
+    for (auto keepRunning : state) {
+        state.PauseTiming();
+        auto ws = stdx::make_unique<WorkingSet>();
+        auto queuedDataStage = stdx::make_unique<QueuedDataStage>(opCtx.get(), ws.get());
+        for (const auto& doc : docs) {
+            WorkingSetID id = ws->allocate();
+            WorkingSetMember* member = ws->get(id);
+            member->obj = Snapshotted<BSONObj>(SnapshotId(), doc);
+            member->transitionToOwnedObj();
+            queuedDataStage->pushBack(id);
+        }
+        auto sortKeyGen = stdx::make_unique<SortKeyGeneratorStage>(
+            opCtx.get(), queuedDataStage.release(), ws.get(), params.pattern, nullptr);
+        auto sort =
+            stdx::make_unique<SortStage>(opCtx.get(), params, ws.get(), sortKeyGen.release());
+        state.ResumeTiming();
+
+        size_t numResults = 0;
+        WorkingSetID id = WorkingSet::INVALID_ID;
+        PlanStage::StageState stageState;
+        while ((stageState = sort->work(&id)) != PlanStage::IS_EOF) {
+            invariant(stageState == PlanStage::ADVANCED || stageState == PlanStage::NEED_TIME);
+            if (stageState == PlanStage::ADVANCED) {
+                ++numResults;
+            }
+        }
+        benchmark::DoNotOptimize(numResults);
+
+        // Freeing the stages and the working set is not part of the sort.
+        state.PauseTiming();
+        sort.reset();
+        ws.reset();
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(state.iterations() * kNumKeys);
+}
+
+BENCHMARK(BM_TopKWithSetOverBSON)->Arg(1)->Arg(10)->Arg(100)->Arg(1000)->Arg(10000);
+BENCHMARK(BM_TopKWithHeapOverKeyString)->Arg(1)->Arg(10)->Arg(100)->Arg(1000)->Arg(10000);
+BENCHMARK(BM_FullSortOverBSON);
+BENCHMARK(BM_FullSortOverKeyString);
+BENCHMARK(BM_SortStage)->Arg(0)->Arg(10)->Arg(1000);
+
+}  // namespace
+}  // namespace mongo
@@ -36,12 +36,14 @@
 
 #include <boost/optional.hpp>
 
+#include "mongo/bson/ordering.h"
 #include "mongo/db/exec/queued_data_stage.h"
 #include "mongo/db/json.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/query/collation/collator_factory_mock.h"
 #include "mongo/db/query/collation/collator_interface_mock.h"
 #include "mongo/db/service_context_d_test_fixture.h"
+#include "mongo/db/storage/key_string.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/clock_source_mock.h"
@@ -274,6 +276,50 @@ TEST_F(SortStageTest, SortDescendingWithLimitOfOne) {
     testWork("{a: -1}", nullptr, 1, "{input: [{a: 2}, {a: 1}, {a: 3}]}", "{output: [{a: 3}]}");
 }
 
+//
+// Sort keys are compared by their KeyString encodings, which must order the same way as the
+// BSON values they encode.
+//
+
+TEST_F(SortStageTest, SortCompoundKeyAcrossTypesWithLimit) {
+    testWork("{a: 1, b: -1}",
+             nullptr,
+             4,
+             "{input: [{a: 'x', b: 1}, {a: 2.5, b: 1}, {a: null, b: 0}, {a: 2, b: 'y'},"
+             " {a: NumberLong(2), b: 3}, {a: -Infinity, b: 1}, {a: {c: 1}, b: 1}]}",
+             "{output: [{a: null, b: 0}, {a: -Infinity, b: 1}, {a: 2, b: 'y'},"
+             " {a: NumberLong(2), b: 3}]}");
+}
+
+/**
+ * Sorts documents which only differ in their last field on 'numFields' fields, the last one
+ * descending.
+ */
+void testSortOnManyFields(SortStageTest* test, int numFields) {
+    std::string pattern = "{";
+    std::string prefix;
+    for (int i = 0; i < numFields - 1; ++i) {
+        pattern += "f" + std::to_string(i) + ": 1, ";
+        prefix += "f" + std::to_string(i) + ": 0, ";
+    }
+    pattern += "a: -1}";
+
+    const std::string input = "{input: [{" + prefix + "a: 1}, {" + prefix + "a: 3}, {" + prefix +
+        "a: 2}]}";
+    const std::string expected = "{output: [{" + prefix + "a: 3}, {" + prefix + "a: 2}]}";
+    test->testWork(pattern.c_str(), nullptr, 2, input.c_str(), expected.c_str());
+}
+
+TEST_F(SortStageTest, SortOnAsManyFieldsAsAnOrderingCanDescribe) {
+    // An Ordering can describe at most 32 fields, so these keys are compared as KeyStrings.
+    testSortOnManyFields(this, static_cast<int>(Ordering::kMaxCompoundIndexKeys));
+}
+
+TEST_F(SortStageTest, SortOnMoreFieldsThanAnOrderingCanDescribe) {
+    // These keys are compared as BSON.
+    testSortOnManyFields(this, 41);
+}
+
 TEST_F(SortStageTest, SortAscendingWithCollation) {
     CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kReverseString);
     testWork("{a: 1}",
@@ -291,4 +337,58 @@ TEST_F(SortStageTest, SortDescendingWithCollation) {
              "{input: [{a: 'ba'}, {a: 'aa'}, {a: 'ab'}]}",
              "{output: [{a: 'ab'}, {a: 'ba'}, {a: 'aa'}]}");
 }
+
+/**
+ * Sorts documents {a: 0} through {a: numDocs - 1} descending with the given limit, and checks that
+ * the memory usage reported by the stage is that of the returned working set members and of the
+ * encodings of their sort keys, and only of those.
+ */
+void testMemUsage(OperationContext* opCtx, int numDocs, size_t limit) {
+    WorkingSet ws;
+    auto queuedDataStage = stdx::make_unique<QueuedDataStage>(opCtx, &ws);
+    for (int i = 0; i < numDocs; ++i) {
+        WorkingSetID id = ws.allocate();
+        WorkingSetMember* wsm = ws.get(id);
+        wsm->obj = Snapshotted<BSONObj>(SnapshotId(), BSON("a" << i << "b" << std::string(i, 'x')));
+        wsm->transitionToOwnedObj();
+        queuedDataStage->pushBack(id);
+    }
+
+    SortStageParams params;
+    params.pattern = BSON("a" << -1);
+    params.limit = limit;
+    auto sortKeyGen = stdx::make_unique<SortKeyGeneratorStage>(
+        opCtx, queuedDataStage.release(), &ws, params.pattern, nullptr);
+    SortStage sort(opCtx, params, &ws, sortKeyGen.release());
+
+    const Ordering ordering = Ordering::make(params.pattern);
+    size_t expectedMemUsage = 0;
+    size_t numResults = 0;
+    WorkingSetID id = WorkingSet::INVALID_ID;
+    PlanStage::StageState state;
+    while ((state = sort.work(&id)) != PlanStage::IS_EOF) {
+        if (state != PlanStage::ADVANCED) {
+            continue;
+        }
+        WorkingSetMember* member = ws.get(id);
+        KeyString ks(KeyString::kLatestVersion,
+                     BSON("" << member->obj.value()["a"].numberInt()),
+                     ordering);
+        expectedMemUsage += member->getMemUsage() + ks.getSize();
+        ++numResults;
+    }
+
+    ASSERT_EQ(numResults, limit ? std::min(limit, size_t(numDocs)) : size_t(numDocs));
+    auto stats = sort.getStats();
+    ASSERT_EQ(static_cast<const SortStats*>(stats->specific.get())->memUsage, expectedMemUsage);
+}
+
+TEST_F(SortStageTest, MemUsageCountsEncodedSortKeys) {
+    testMemUsage(getOpCtx(), 10, 0);
+}
+
+TEST_F(SortStageTest, MemUsageOfEvictedItemsIsReleased) {
+    testMemUsage(getOpCtx(), 10, 3);
+    testMemUsage(getOpCtx(), 10, 1);
+}
 }  // namespace
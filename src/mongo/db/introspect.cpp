@@ -43,6 +43,7 @@
 #include "mongo/db/curop.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/jsobj.h"
+#include "mongo/db/wait_event_stats.h"
 #include "mongo/rpc/metadata/client_metadata.h"
 #include "mongo/rpc/metadata/client_metadata_ismaster.h"
 #include "mongo/util/log.h"
@@ -96,6 +97,12 @@ void profile(OperationContext* opCtx, NetworkOp op) {
         CurOp::get(opCtx)->debug().append(*CurOp::get(opCtx), lockerInfo.stats, b);
     }
 
+    const auto& waitEvents = WaitEventStats::get(opCtx);
+    if (!waitEvents.empty()) {
+        BSONObjBuilder waitEventsBuilder(b.subobjStart("waitEvents"));
+        waitEvents.append(&waitEventsBuilder);
+    }
+
     b.appendDate("ts", jsTime());
     b.append("client", opCtx->getClient()->clientAddress());
 
@@ -48,6 +48,7 @@
 #include "mongo/db/logical_time_validator.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/query/query_result_cache.h"
 #include "mongo/db/repl/oplog.h"
 #include "mongo/db/repl/oplog_entry_gen.h"
 #include "mongo/db/repl/replication_coordinator.h"
@@ -324,6 +325,30 @@ OpTimeBundle replLogApplyOps(OperationContext* opCtx,
     return times;
 }
 
+/**
+ * Discards the query results cached for the collection 'nss', if it has enabled its result cache.
+ * The cache is invalidated again once the write commits, so that a query which reads the
+ * collection in between cannot cache results that are missing the write.
+ */
+void invalidateQueryResultCache(OperationContext* opCtx, const NamespaceString& nss) {
+    if (!QueryResultCache::anyEnabled()) {
+        return;
+    }
+
+    Database* db = DatabaseHolder::getDatabaseHolder().get(opCtx, nss.db());
+    Collection* collection = db ? db->getCollection(opCtx, nss) : nullptr;
+    if (!collection || !collection->infoCache()->getResultCache()->isEnabled()) {
+        return;
+    }
+
+    // The collection outlives the write's unit of work: dropping it needs an exclusive lock, and
+    // a drop within the same unit of work frees the collection after this callback has run.
+    QueryResultCache* resultCache = collection->infoCache()->getResultCache();
+    resultCache->invalidate();
+    opCtx->recoveryUnit()->onCommit(
+        [resultCache](boost::optional<Timestamp>) { resultCache->invalidate(); });
+}
+
 }  // namespace
 
 BSONObj OpObserverImpl::getDocumentKey(OperationContext* opCtx,
@@ -416,6 +441,8 @@ void OpObserverImpl::onInserts(OperationContext* opCtx,
         shardObserveInsertOp(opCtx, nss, it->doc, opTime, fromMigrate, inMultiDocumentTransaction);
     }
 
+    invalidateQueryResultCache(opCtx, nss);
+
     if (nss.coll() == "system.js") {
         Scope::storedFuncMod(opCtx);
     } else if (nss.coll() == DurableViewCatalog::viewsCollectionName()) {
@@ -486,6 +513,8 @@ void OpObserverImpl::onUpdate(OperationContext* opCtx, const OplogUpdateEntryArg
         }
     }
 
+    invalidateQueryResultCache(opCtx, args.nss);
+
     if (args.nss.coll() == "system.js") {
         Scope::storedFuncMod(opCtx);
     } else if (args.nss.coll() == DurableViewCatalog::viewsCollectionName()) {
@@ -550,6 +579,8 @@ void OpObserverImpl::onDelete(OperationContext* opCtx,
         }
     }
 
+    invalidateQueryResultCache(opCtx, nss);
+
     if (nss.coll() == "system.js") {
         Scope::storedFuncMod(opCtx);
     } else if (nss.coll() == DurableViewCatalog::viewsCollectionName()) {
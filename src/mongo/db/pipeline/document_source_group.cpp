@@ -188,7 +188,7 @@ DocumentSource::GetNextResult DocumentSourceGroup::getNextSpilled() {
         _firstPartOfNextGroup = _sorterIterator->next();
     }
 
-    return makeDocument(_currentId, _currentAccumulators, pExpCtx->needsMerge);
+    return makeDocument(_currentId, _currentAccumulators, producesMergeableOutput());
 }
 
 DocumentSource::GetNextResult DocumentSourceGroup::getNextStandard() {
@@ -196,7 +196,8 @@ DocumentSource::GetNextResult DocumentSourceGroup::getNextStandard() {
     if (_groups->empty())
         return GetNextResult::makeEOF();
 
-    Document out = makeDocument(groupsIterator->first, groupsIterator->second, pExpCtx->needsMerge);
+    Document out =
+        makeDocument(groupsIterator->first, groupsIterator->second, producesMergeableOutput());
 
     if (++groupsIterator == _groups->end())
         dispose();
@@ -236,7 +237,7 @@ DocumentSource::GetNextResult DocumentSourceGroup::getNextStreaming() {
         id = computeId(*_firstDocOfNextGroup);
     } while (pExpCtx->getValueComparator().evaluate(_currentId == id));
 
-    Document out = makeDocument(_currentId, _currentAccumulators, pExpCtx->needsMerge);
+    Document out = makeDocument(_currentId, _currentAccumulators, producesMergeableOutput());
     _currentId = std::move(id);
 
     return std::move(out);
@@ -299,6 +300,10 @@ Value DocumentSourceGroup::serialize(boost::optional<ExplainOptions::Verbosity>
         insides["$doingMerge"] = Value(true);
     }
 
+    if (!_willBeMerged) {
+        insides["$willBeMerged"] = Value(false);
+    }
+
     if (explain && findRelevantInputSort()) {
         return Value(DOC("$streamingGroup" << insides.freeze()));
     }
@@ -455,6 +460,12 @@ intrusive_ptr<DocumentSource> DocumentSourceGroup::createFromBson(
             massert(17030, "$doingMerge should be true if present", groupField.Bool());
 
             pGroup->setDoingMerge(true);
+        } else if (str::equals(pFieldName, "$willBeMerged")) {
+            uassert(51037,
+                    "$willBeMerged must be a boolean if present",
+                    groupField.type() == BSONType::Bool);
+
+            pGroup->setWillBeMerged(groupField.Bool());
         } else {
             // Any other field will be treated as an accumulator specification.
             pGroup->addAccumulator(
@@ -153,6 +153,21 @@ public:
         _doingMerge = doingMerge;
     }
 
+    /**
+     * Returns false if this $group stage produces final results when running on a shard, because
+     * all the documents of each of its groups are on the same shard.
+     */
+    bool willBeMerged() const {
+        return _willBeMerged;
+    }
+
+    /**
+     * Tell this source if its results will be merged by a merging $group. Defaults to true.
+     */
+    void setWillBeMerged(bool willBeMerged) {
+        _willBeMerged = willBeMerged;
+    }
+
     bool isStreaming() const {
         return _streaming;
     }
@@ -241,10 +256,18 @@ private:
      */
     bool pathIncludedInGroupKeys(const std::string& dottedPath) const;
 
+    /**
+     * Returns true if the accumulators should output partial results for a merging $group.
+     */
+    bool producesMergeableOutput() const {
+        return pExpCtx->needsMerge && _willBeMerged;
+    }
+
     std::vector<AccumulationStatement> _accumulatedFields;
 
     bool _usedDisk;  // Keeps track of whether this $group spilled to disk.
     bool _doingMerge;
+    bool _willBeMerged = true;
     size_t _memoryUsageBytes = 0;
     size_t _maxMemoryUsageBytes;
     std::string _fileName;
@@ -229,6 +229,29 @@ TEST_F(DocumentSourceGroupTest, ShouldNotReportDottedGroupKeyAsARename) {
     ASSERT_EQ(modifiedPathsRet.renames.size(), 0UL);
 }
 
+TEST_F(DocumentSourceGroupTest, ShouldProduceFinalResultsWhenNeedingMergeIfNotMerged) {
+    auto expCtx = getExpCtx();
+    expCtx->inMongos = true;  // Disallow external sort.
+    expCtx->needsMerge = true;
+    const auto spec = fromjson("{$group: {_id: '$a', avg: {$avg: '$b'}, $willBeMerged: false}}");
+    auto group = DocumentSourceGroup::createFromBson(spec.firstElement(), expCtx);
+    auto mock =
+        DocumentSourceMock::create({Document{{"a", 1}, {"b", 2}}, Document{{"a", 1}, {"b", 4}}});
+    group->setSource(mock.get());
+
+    // The average is output as such, rather than as the partial sum and count a merging $group
+    // would need.
+    auto result = group->getNext();
+    ASSERT_TRUE(result.isAdvanced());
+    ASSERT_DOCUMENT_EQ(result.releaseDocument(), (Document{{"_id", 1}, {"avg", 3.0}}));
+    ASSERT_TRUE(group->getNext().isEOF());
+
+    // The flag is serialized so that it is sent to the shards.
+    vector<Value> serialized;
+    group->serializeToArray(serialized);
+    ASSERT_VALUE_EQ(serialized[0]["$group"]["$willBeMerged"], Value(false));
+}
+
 BSONObj toBson(const intrusive_ptr<DocumentSource>& source) {
     vector<Value> arr;
     source->serializeToArray(arr);
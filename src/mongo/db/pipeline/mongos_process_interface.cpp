@@ -419,7 +419,15 @@ MongoSInterface::DispatchShardPipelineResults MongoSInterface::dispatchShardPipe
     boost::optional<cluster_aggregation_planner::SplitPipeline> splitPipeline;
 
     if (needsSplit) {
-        splitPipeline = cluster_aggregation_planner::splitPipeline(std::move(pipeline));
+        // Change streams read from the oplog rather than from the documents of the collection,
+        // so they are not partitioned by its shard key.
+        const ShardKeyPattern* shardKeyPattern =
+            (executionNsRoutingInfo && executionNsRoutingInfo->cm() &&
+             !liteParsedPipeline.hasChangeStream())
+            ? &executionNsRoutingInfo->cm()->getShardKeyPattern()
+            : nullptr;
+        splitPipeline =
+            cluster_aggregation_planner::splitPipeline(std::move(pipeline), shardKeyPattern);
 
         exchangeSpec = cluster_aggregation_planner::checkIfEligibleForExchange(
             opCtx, splitPipeline->mergePipeline.get());
@@ -58,6 +58,7 @@
 #include "mongo/db/repl/replication_coordinator_mock.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/s/query/cluster_aggregation_planner.h"
+#include "mongo/s/shard_key_pattern.h"
 #include "mongo/unittest/death_test.h"
 #include "mongo/unittest/temp_dir.h"
 
@@ -1773,6 +1774,11 @@ public:
     virtual string shardPipeJson() = 0;
     virtual string mergePipeJson() = 0;
 
+    // The shard key of the collection the pipeline reads from, if it is sharded.
+    virtual BSONObj shardKey() {
+        return BSONObj();
+    }
+
     BSONObj pipelineFromJsonArray(const string& array) {
         return fromjson("{pipeline: " + array + "}");
     }
@@ -1802,7 +1808,13 @@ public:
         mergePipe = uassertStatusOK(Pipeline::parse(request.getPipeline(), ctx));
         mergePipe->optimizePipeline();
 
-        auto splitPipeline = cluster_aggregation_planner::splitPipeline(std::move(mergePipe));
+        boost::optional<ShardKeyPattern> shardKeyPattern;
+        if (!shardKey().isEmpty()) {
+            shardKeyPattern.emplace(shardKey());
+        }
+
+        auto splitPipeline = cluster_aggregation_planner::splitPipeline(std::move(mergePipe),
+                                                                        shardKeyPattern.get_ptr());
 
         ASSERT_VALUE_EQ(Value(splitPipeline.shardsPipeline->writeExplainOps(
                             ExplainOptions::Verbosity::kQueryPlanner)),
@@ -2249,6 +2261,117 @@ class ShouldNotCoalesceUnwindNotOnAs : public Base {
 
 }  // namespace coalesceLookUpAndUnwind
 
+namespace pushGroupOnShardKeyToShards {
+
+class GroupOnShardKey : public Base {
+    BSONObj shardKey() {
+        return BSON("a" << 1);
+    }
+    string inputPipeJson() {
+        return "[{$match: {x: {$eq: 1}}}"
+               ",{$group: {_id: '$a', total: {$sum: '$x'}}}"
+               "]";
+    }
+    string shardPipeJson() {
+        return "[{$match: {x: {$eq: 1}}}"
+               ",{$group: {_id: '$a', total: {$sum: '$x'}, $willBeMerged: false}}"
+               "]";
+    }
+    string mergePipeJson() {
+        return "[]";
+    }
+};
+
+class GroupOnHashedShardKey : public Base {
+    BSONObj shardKey() {
+        return BSON("a" << "hashed");
+    }
+    string inputPipeJson() {
+        return "[{$group: {_id: '$a', avg: {$avg: '$x'}}}]";
+    }
+    string shardPipeJson() {
+        return "[{$group: {_id: '$a', avg: {$avg: '$x'}, $willBeMerged: false}}]";
+    }
+    string mergePipeJson() {
+        return "[]";
+    }
+};
+
+class GroupOnAllShardKeyFieldsThenSort : public Base {
+    BSONObj shardKey() {
+        return BSON("a" << 1 << "b" << 1);
+    }
+    string inputPipeJson() {
+        return "[{$group: {_id: {b: '$b', c: '$c', a: '$a'}, total: {$sum: '$x'}}}"
+               ",{$sort: {total: -1}}"
+               "]";
+    }
+    string shardPipeJson() {
+        return "[{$group: {_id: {b: '$b', c: '$c', a: '$a'}, total: {$sum: '$x'}, "
+               "$willBeMerged: false}}"
+               ",{$sort: {sortKey: {total: -1}}}"
+               "]";
+    }
+    string mergePipeJson() {
+        return "[]";
+    }
+};
+
+class GroupOnShardKeyPrefixIsSplit : public Base {
+    BSONObj shardKey() {
+        return BSON("a" << 1 << "b" << 1);
+    }
+    string inputPipeJson() {
+        return "[{$group: {_id: '$a', total: {$sum: '$x'}}}]";
+    }
+    string shardPipeJson() {
+        return "[{$group: {_id: '$a', total: {$sum: '$x'}}}]";
+    }
+    string mergePipeJson() {
+        return "[{$group: {_id: '$$ROOT._id', total: {$sum: '$$ROOT.total'}, $doingMerge: true}}]";
+    }
+};
+
+class GroupAfterShardKeyIsModifiedIsSplit : public Base {
+    BSONObj shardKey() {
+        return BSON("a" << 1);
+    }
+    string inputPipeJson() {
+        return "[{$addFields: {a: '$y'}}"
+               ",{$group: {_id: '$a'}}"
+               "]";
+    }
+    string shardPipeJson() {
+        return "[{$addFields: {a: '$y'}}"
+               ",{$group: {_id: '$a'}}"
+               "]";
+    }
+    string mergePipeJson() {
+        return "[{$group: {_id: '$$ROOT._id', $doingMerge: true}}]";
+    }
+};
+
+class OnlyFirstGroupIsPushedToShards : public Base {
+    BSONObj shardKey() {
+        return BSON("a" << 1);
+    }
+    string inputPipeJson() {
+        return "[{$group: {_id: '$a', total: {$sum: '$x'}}}"
+               ",{$group: {_id: '$total', count: {$sum: {$const: 1}}}}"
+               "]";
+    }
+    string shardPipeJson() {
+        return "[{$group: {_id: '$a', total: {$sum: '$x'}, $willBeMerged: false}}"
+               ",{$group: {_id: '$total', count: {$sum: {$const: 1}}}}"
+               "]";
+    }
+    string mergePipeJson() {
+        return "[{$group: {_id: '$$ROOT._id', count: {$sum: '$$ROOT.count'}, $doingMerge: true}}]";
+    }
+};
+
+}  // namespace pushGroupOnShardKeyToShards
+
 namespace needsPrimaryShardMerger {
 
 class needsPrimaryShardMergerBase : public Base {
@@ -3040,6 +3163,14 @@ public:
     All() : Suite("PipelineOptimizations") {}
     void setupTests() {
         add<Optimizations::Sharded::Empty>();
+        add<Optimizations::Sharded::pushGroupOnShardKeyToShards::GroupOnShardKey>();
+        add<Optimizations::Sharded::pushGroupOnShardKeyToShards::GroupOnHashedShardKey>();
+        add<Optimizations::Sharded::pushGroupOnShardKeyToShards::
+                GroupOnAllShardKeyFieldsThenSort>();
+        add<Optimizations::Sharded::pushGroupOnShardKeyToShards::GroupOnShardKeyPrefixIsSplit>();
+        add<Optimizations::Sharded::pushGroupOnShardKeyToShards::
+                GroupAfterShardKeyIsModifiedIsSplit>();
+        add<Optimizations::Sharded::pushGroupOnShardKeyToShards::OnlyFirstGroupIsPushedToShards>();
         add<Optimizations::Sharded::coalesceLookUpAndUnwind::ShouldCoalesceUnwindOnAs>();
         add<Optimizations::Sharded::coalesceLookUpAndUnwind::
                 ShouldCoalesceUnwindOnAsWithPreserveEmpty>();
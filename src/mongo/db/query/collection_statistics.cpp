@@ -0,0 +1,287 @@
+
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/collection_statistics.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "mongo/bson/simple_bsonobj_comparator.h"
+
+namespace mongo {
+
+namespace {
+
+int compareValues(const BSONElement& lhs, const BSONElement& rhs) {
+    return lhs.woCompare(rhs, false);
+}
+
+/**
+ * Estimates the fraction of the range [lower, upper] covered by [lo, hi]. Interpolates linearly
+ * when all of the values involved are numbers, and otherwise assumes half of the range.
+ */
+double estimateCoveredFraction(const BSONElement& lower,
+                               const BSONElement& upper,
+                               const BSONElement& lo,
+                               const BSONElement& hi) {
+    const BSONElement clippedLo = compareValues(lo, lower) < 0 ? lower : lo;
+    const BSONElement clippedHi = compareValues(hi, upper) > 0 ? upper : hi;
+    if (lower.isNumber() && upper.isNumber() && clippedLo.isNumber() && clippedHi.isNumber()) {
+        const double fraction = (clippedHi.numberDouble() - clippedLo.numberDouble()) /
+            (upper.numberDouble() - lower.numberDouble());
+        if (std::isfinite(fraction)) {
+            return std::max(0.0, std::min(1.0, fraction));
+        }
+    }
+    return 0.5;
+}
+
+/**
+ * Returns whether 'oil' holds every value of its field, in either direction.
+ */
+bool isFullRange(const OrderedIntervalList& oil) {
+    if (oil.intervals.size() != 1) {
+        return false;
+    }
+    const Interval& interval = oil.intervals.front();
+    return interval.isMinToMax() ||
+        (interval.start.type() == BSONType::MaxKey && interval.end.type() == BSONType::MinKey);
+}
+
+}  // namespace
+
+ValueHistogram::Builder::Builder(long long valuesPerBucket)
+    : _valuesPerBucket(std::max(1LL, valuesPerBucket)) {}
+
+void ValueHistogram::Builder::addValue(const BSONElement& value) {
+    if (_lastValueObj.isEmpty()) {
+        _histogram._minValueObj = value.wrap("");
+    } else {
+        const int cmp = compareValues(value, _lastValueObj.firstElement());
+        uassert(51038, "values must be added to a histogram in ascending order", cmp >= 0);
+
+        if (cmp == 0) {
+            ++_current.count;
+            ++_current.upperBoundCount;
+            ++_histogram._totalCount;
+            return;
+        }
+
+        if (_current.count >= _valuesPerBucket) {
+            _closeBucket();
+        }
+    }
+
+    _lastValueObj = value.wrap("");
+    ++_current.count;
+    ++_current.numDistinct;
+    _current.upperBoundCount = 1;
+    ++_histogram._totalCount;
+    ++_histogram._numDistinct;
+}
+
+void ValueHistogram::Builder::_closeBucket() {
+    _current.upperBoundObj = _lastValueObj;
+    _histogram._buckets.push_back(std::move(_current));
+    _current = Bucket();
+}
+
+ValueHistogram ValueHistogram::Builder::done() {
+    if (_current.count > 0) {
+        _closeBucket();
+    }
+    return std::move(_histogram);
+}
+
+double ValueHistogram::estimateCount(const Interval& interval) const {
+    if (_buckets.empty() || interval.isEmpty()) {
+        return 0;
+    }
+
+    BSONElement lo = interval.start;
+    bool loInclusive = interval.startInclusive;
+    BSONElement hi = interval.end;
+    bool hiInclusive = interval.endInclusive;
+    if (compareValues(lo, hi) > 0) {
+        std::swap(lo, hi);
+        std::swap(loInclusive, hiInclusive);
+    }
+
+    double estimate = 0;
+    for (size_t i = 0; i < _buckets.size(); ++i) {
+        const Bucket& bucket = _buckets[i];
+
+        // The lower bound is exclusive except for the first bucket. Once the interval ends below
+        // a bucket, no later bucket can overlap it either.
+        const BSONElement lower =
+            i == 0 ? _minValueObj.firstElement() : _buckets[i - 1].upperBound();
+        const int hiVsLower = compareValues(hi, lower);
+        if (hiVsLower < 0 || (hiVsLower == 0 && (i > 0 || !hiInclusive))) {
+            break;
+        }
+
+        const int loVsUpper = compareValues(lo, bucket.upperBound());
+        if (loVsUpper > 0 || (loVsUpper == 0 && !loInclusive)) {
+            continue;
+        }
+
+        const int hiVsUpper = compareValues(hi, bucket.upperBound());
+        if (hiVsUpper > 0 || (hiVsUpper == 0 && hiInclusive)) {
+            estimate += bucket.upperBoundCount;
+        }
+        estimate += _estimateInteriorCount(i, lo, loInclusive, hi, hiInclusive);
+    }
+    return estimate;
+}
+
+double ValueHistogram::_estimateInteriorCount(size_t bucketIndex,
+                                              const BSONElement& lo,
+                                              bool loInclusive,
+                                              const BSONElement& hi,
+                                              bool hiInclusive) const {
+    const Bucket& bucket = _buckets[bucketIndex];
+    const long long interiorCount = bucket.count - bucket.upperBoundCount;
+    const long long interiorDistinct = bucket.numDistinct - 1;
+    if (interiorCount <= 0 || interiorDistinct <= 0) {
+        return 0;
+    }
+
+    // The interior of the first bucket also includes the smallest value seen.
+    const bool isFirstBucket = bucketIndex == 0;
+    const BSONElement lower =
+        isFirstBucket ? _minValueObj.firstElement() : _buckets[bucketIndex - 1].upperBound();
+    const BSONElement upper = bucket.upperBound();
+
+    const int loVsLower = compareValues(lo, lower);
+    const bool coversLowEnd = loVsLower < 0 || (loVsLower == 0 && (!isFirstBucket || loInclusive));
+    if (coversLowEnd && compareValues(hi, upper) >= 0) {
+        return interiorCount;
+    }
+
+    if (compareValues(lo, hi) == 0) {
+        // A point interval matches one of the interior's distinct values, if it lies within it.
+        const bool isInterior = compareValues(lo, upper) < 0 &&
+            (loVsLower > 0 || (loVsLower == 0 && isFirstBucket));
+        return (isInterior && loInclusive && hiInclusive)
+            ? static_cast<double>(interiorCount) / interiorDistinct
+            : 0;
+    }
+
+    return interiorCount * estimateCoveredFraction(lower, upper, lo, hi);
+}
+
+BSONObj ValueHistogram::toBSON() const {
+    BSONObjBuilder bob;
+    bob.appendNumber("numValues", _totalCount);
+    bob.appendNumber("numDistinct", _numDistinct);
+    BSONArrayBuilder bucketsBuilder(bob.subarrayStart("buckets"));
+    for (auto&& bucket : _buckets) {
+        BSONObjBuilder bucketBuilder(bucketsBuilder.subobjStart());
+        bucketBuilder.appendAs(bucket.upperBound(), "upperBound");
+        bucketBuilder.appendNumber("count", bucket.count);
+        bucketBuilder.appendNumber("numDistinct", bucket.numDistinct);
+        bucketBuilder.appendNumber("upperBoundCount", bucket.upperBoundCount);
+    }
+    bucketsBuilder.doneFast();
+    return bob.obj();
+}
+
+CollectionStatistics::CollectionStatistics(long long numRecords, IndexStatisticsMap indexStats)
+    : _numRecords(numRecords), _indexStats(std::move(indexStats)) {}
+
+const IndexStatistics* CollectionStatistics::getIndexStatistics(StringData indexName) const {
+    auto it = _indexStats.find(indexName.toString());
+    return it == _indexStats.end() ? nullptr : &it->second;
+}
+
+boost::optional<double> CollectionStatistics::estimateKeysExamined(
+    StringData indexName,
+    const BSONObj& keyPattern,
+    const IndexBounds& bounds,
+    long long currentNumRecords) const {
+    const IndexStatistics* indexStats = getIndexStatistics(indexName);
+    if (!indexStats || _numRecords <= 0 ||
+        SimpleBSONObjComparator::kInstance.evaluate(indexStats->keyPattern != keyPattern)) {
+        return boost::none;
+    }
+
+    // Only the leading field is described by the histogram, so the estimate is the number of
+    // keys whose leading field falls within the bounds. That is only the number of keys examined
+    // if the other fields are unconstrained: bounds on them let the scan skip keys, and an
+    // estimate ignoring that would overstate the cost of a selective compound index scan.
+    double keys = 0;
+    if (bounds.isSimpleRange) {
+        if (bounds.startKey.isEmpty() || bounds.endKey.isEmpty()) {
+            return boost::none;
+        }
+        BSONObjBuilder intervalBuilder;
+        intervalBuilder.appendAs(bounds.startKey.firstElement(), "");
+        intervalBuilder.appendAs(bounds.endKey.firstElement(), "");
+        keys = indexStats->histogram.estimateCount(Interval(intervalBuilder.obj(), true, true));
+    } else {
+        if (bounds.fields.empty()) {
+            return boost::none;
+        }
+        for (size_t i = 1; i < bounds.fields.size(); ++i) {
+            if (!isFullRange(bounds.fields[i])) {
+                return boost::none;
+            }
+        }
+        for (auto&& interval : bounds.fields[0].intervals) {
+            keys += indexStats->histogram.estimateCount(interval);
+        }
+    }
+
+    return keys * static_cast<double>(currentNumRecords) / _numRecords;
+}
+
+std::shared_ptr<const CollectionStatistics> CollectionStatistics::withoutIndex(
+    StringData indexName) const {
+    IndexStatisticsMap indexStats = _indexStats;
+    indexStats.erase(indexName.toString());
+    return std::make_shared<CollectionStatistics>(_numRecords, std::move(indexStats));
+}
+
+BSONObj CollectionStatistics::toBSON() const {
+    BSONObjBuilder bob;
+    bob.appendNumber("numRecords", _numRecords);
+    BSONObjBuilder indexesBuilder(bob.subobjStart("indexes"));
+    for (auto&& entry : _indexStats) {
+        BSONObjBuilder indexBuilder(indexesBuilder.subobjStart(entry.first));
+        indexBuilder.append("keyPattern", entry.second.keyPattern);
+        indexBuilder.append("histogram", entry.second.histogram.toBSON());
+    }
+    indexesBuilder.doneFast();
+    return bob.obj();
+}
+
+}  // namespace mongo
@@ -0,0 +1,199 @@
+
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/base/string_data.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/query/index_bounds.h"
+#include "mongo/db/query/interval.h"
+
+namespace mongo {
+
+/**
+ * An equi-depth histogram over the values of a single field. The histogram is built from values
+ * presented in ascending order, typically by walking an index whose leading field is the field
+ * being described.
+ *
+ * Each bucket covers the values in the range (previous bucket's upper bound, upper bound], where
+ * the first bucket additionally includes the smallest value seen. A value never straddles two
+ * buckets, so a very frequent value may produce a bucket deeper than requested.
+ */
+class ValueHistogram {
+public:
+    struct Bucket {
+        BSONElement upperBound() const {
+            return upperBoundObj.firstElement();
+        }
+
+        // Single-element object owning the (inclusive) upper bound of the bucket.
+        BSONObj upperBoundObj;
+
+        // Number of values in the bucket, including those equal to the upper bound.
+        long long count = 0;
+
+        // Number of distinct values in the bucket, including the upper bound.
+        long long numDistinct = 0;
+
+        // Number of values equal to the upper bound.
+        long long upperBoundCount = 0;
+    };
+
+    class Builder;
+
+    ValueHistogram() = default;
+
+    /**
+     * Estimates how many of the described values fall within 'interval'. The interval may be
+     * oriented in either direction.
+     */
+    double estimateCount(const Interval& interval) const;
+
+    long long getTotalCount() const {
+        return _totalCount;
+    }
+
+    long long getNumDistinct() const {
+        return _numDistinct;
+    }
+
+    const std::vector<Bucket>& getBuckets() const {
+        return _buckets;
+    }
+
+    BSONObj toBSON() const;
+
+private:
+    // Estimates the number of values in the bucket at 'bucketIndex' which lie strictly between its
+    // lower and upper bounds and also within [lo, hi].
+    double _estimateInteriorCount(size_t bucketIndex,
+                                  const BSONElement& lo,
+                                  bool loInclusive,
+                                  const BSONElement& hi,
+                                  bool hiInclusive) const;
+
+    std::vector<Bucket> _buckets;
+
+    // Single-element object owning the smallest value seen.
+    BSONObj _minValueObj;
+
+    long long _totalCount = 0;
+    long long _numDistinct = 0;
+};
+
+/**
+ * Accumulates a stream of ascending values into buckets of roughly 'valuesPerBucket' values.
+ */
+class ValueHistogram::Builder {
+public:
+    explicit Builder(long long valuesPerBucket);
+
+    /**
+     * Adds the next value. Must compare greater than or equal to the previously added value.
+     */
+    void addValue(const BSONElement& value);
+
+    ValueHistogram done();
+
+private:
+    void _closeBucket();
+
+    const long long _valuesPerBucket;
+
+    ValueHistogram _histogram;
+    Bucket _current;
+    BSONObj _lastValueObj;
+};
+
+/**
+ * Statistics about one index: a histogram over the values of its leading field, as found in
+ * the index keys.
+ */
+struct IndexStatistics {
+    BSONObj keyPattern;
+    ValueHistogram histogram;
+};
+
+/**
+ * A snapshot of the statistics gathered for a collection by the 'analyze' command. Instances are
+ * immutable once built and are shared between the collection's info cache and the planner.
+ *
+ * Estimates are derived from the fraction of the collection a predicate selects at the time the
+ * statistics were gathered, scaled to the collection's current size, so that they follow the
+ * collection as it grows or shrinks between analyses.
+ */
+class CollectionStatistics {
+public:
+    using IndexStatisticsMap = std::map<std::string, IndexStatistics>;
+
+    CollectionStatistics(long long numRecords, IndexStatisticsMap indexStats);
+
+    /**
+     * Returns the statistics for the index named 'indexName', or nullptr if there are none.
+     */
+    const IndexStatistics* getIndexStatistics(StringData indexName) const;
+
+    /**
+     * Estimates how many keys an index scan of 'indexName' over 'bounds' would examine, given
+     * that the collection currently holds 'currentNumRecords' records. Returns boost::none if
+     * there are no statistics for the index, or if they were gathered for a different key
+     * pattern, or if the bounds constrain a field other than the leading one, which the
+     * statistics do not describe.
+     */
+    boost::optional<double> estimateKeysExamined(StringData indexName,
+                                                 const BSONObj& keyPattern,
+                                                 const IndexBounds& bounds,
+                                                 long long currentNumRecords) const;
+
+    /**
+     * Returns a copy of these statistics without any entry for 'indexName'.
+     */
+    std::shared_ptr<const CollectionStatistics> withoutIndex(StringData indexName) const;
+
+    long long getNumRecords() const {
+        return _numRecords;
+    }
+
+    BSONObj toBSON() const;
+
+private:
+    // Number of records in the collection when the statistics were gathered.
+    const long long _numRecords;
+
+    const IndexStatisticsMap _indexStats;
+};
+
+}  // namespace mongo
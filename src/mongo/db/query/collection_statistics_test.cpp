@@ -0,0 +1,205 @@
+
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/collection_statistics.h"
+
+#include "mongo/db/jsobj.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Builds a histogram over the values 'first' through 'last', each occurring once.
+ */
+ValueHistogram buildRangeHistogram(int first, int last, long long valuesPerBucket) {
+    ValueHistogram::Builder builder(valuesPerBucket);
+    for (int i = first; i <= last; ++i) {
+        builder.addValue(BSON("" << i).firstElement());
+    }
+    return builder.done();
+}
+
+Interval makeInterval(const BSONObj& bounds, bool startInclusive, bool endInclusive) {
+    return Interval(bounds, startInclusive, endInclusive);
+}
+
+TEST(ValueHistogramTest, BuildsEquiDepthBuckets) {
+    auto histogram = buildRangeHistogram(0, 99, 10);
+
+    ASSERT_EQ(histogram.getTotalCount(), 100);
+    ASSERT_EQ(histogram.getNumDistinct(), 100);
+    ASSERT_EQ(histogram.getBuckets().size(), 10U);
+    for (auto&& bucket : histogram.getBuckets()) {
+        ASSERT_EQ(bucket.count, 10);
+        ASSERT_EQ(bucket.numDistinct, 10);
+        ASSERT_EQ(bucket.upperBoundCount, 1);
+    }
+    ASSERT_EQ(histogram.getBuckets()[0].upperBound().numberInt(), 9);
+    ASSERT_EQ(histogram.getBuckets()[9].upperBound().numberInt(), 99);
+}
+
+TEST(ValueHistogramTest, FrequentValueIsNotSplitAcrossBuckets) {
+    ValueHistogram::Builder builder(50);
+    for (int i = 0; i < 100; ++i) {
+        builder.addValue(BSON("" << i).firstElement());
+        if (i == 7) {
+            for (int j = 0; j < 1000; ++j) {
+                builder.addValue(BSON("" << i).firstElement());
+            }
+        }
+    }
+    auto histogram = builder.done();
+
+    ASSERT_EQ(histogram.getTotalCount(), 1100);
+    ASSERT_EQ(histogram.getNumDistinct(), 100);
+    const auto& firstBucket = histogram.getBuckets()[0];
+    ASSERT_EQ(firstBucket.upperBound().numberInt(), 7);
+    ASSERT_EQ(firstBucket.upperBoundCount, 1001);
+    ASSERT_EQ(firstBucket.count, 1008);
+    ASSERT_EQ(firstBucket.numDistinct, 8);
+
+    ASSERT_EQ(histogram.estimateCount(makeInterval(BSON("" << 7 << "" << 7), true, true)), 1001);
+}
+
+TEST(ValueHistogramTest, EstimatesPointIntervals) {
+    auto histogram = buildRangeHistogram(0, 99, 10);
+
+    ASSERT_EQ(histogram.estimateCount(makeInterval(BSON("" << 0 << "" << 0), true, true)), 1);
+    ASSERT_EQ(histogram.estimateCount(makeInterval(BSON("" << 5 << "" << 5), true, true)), 1);
+    ASSERT_EQ(histogram.estimateCount(makeInterval(BSON("" << 19 << "" << 19), true, true)), 1);
+    ASSERT_EQ(histogram.estimateCount(makeInterval(BSON("" << 99 << "" << 99), true, true)), 1);
+    ASSERT_EQ(histogram.estimateCount(makeInterval(BSON("" << 500 << "" << 500), true, true)),
+              0);
+    ASSERT_EQ(histogram.estimateCount(makeInterval(BSON("" << -1 << "" << -1), true, true)), 0);
+}
+
+TEST(ValueHistogramTest, EstimatesRangeIntervals) {
+    auto histogram = buildRangeHistogram(0, 99, 10);
+
+    ASSERT_APPROX_EQUAL(
+        histogram.estimateCount(makeInterval(BSON("" << 10 << "" << 29), true, true)), 20, 1.0);
+    ASSERT_APPROX_EQUAL(
+        histogram.estimateCount(makeInterval(BSON("" << 0 << "" << 49), true, false)), 49, 1.0);
+    ASSERT_APPROX_EQUAL(
+        histogram.estimateCount(makeInterval(BSON("" << 50 << "" << 1000), true, true)), 50, 1.0);
+    ASSERT_EQ(
+        histogram.estimateCount(makeInterval(BSON("" << MINKEY << "" << MAXKEY), true, true)), 100);
+    ASSERT_EQ(histogram.estimateCount(makeInterval(BSON("" << "a" << "" << "z"), true, true)), 0);
+}
+
+TEST(ValueHistogramTest, DescendingIntervalEstimatesMatchAscending) {
+    auto histogram = buildRangeHistogram(0, 99, 10);
+
+    ASSERT_EQ(histogram.estimateCount(makeInterval(BSON("" << 29 << "" << 10), true, true)),
+              histogram.estimateCount(makeInterval(BSON("" << 10 << "" << 29), true, true)));
+    ASSERT_EQ(histogram.estimateCount(makeInterval(BSON("" << 50 << "" << 20), false, true)),
+              histogram.estimateCount(makeInterval(BSON("" << 20 << "" << 50), true, false)));
+}
+
+TEST(ValueHistogramTest, EmptyHistogramEstimatesNothing) {
+    ValueHistogram::Builder builder(10);
+    auto histogram = builder.done();
+
+    ASSERT_EQ(histogram.getTotalCount(), 0);
+    ASSERT_EQ(
+        histogram.estimateCount(makeInterval(BSON("" << MINKEY << "" << MAXKEY), true, true)), 0);
+}
+
+TEST(ValueHistogramTest, ValuesMustBeAscending) {
+    ValueHistogram::Builder builder(10);
+    builder.addValue(BSON("" << 5).firstElement());
+    ASSERT_THROWS_CODE(
+        builder.addValue(BSON("" << 4).firstElement()), AssertionException, 51038);
+}
+
+TEST(CollectionStatisticsTest, EstimatesScaleWithCollectionSize) {
+    CollectionStatistics::IndexStatisticsMap indexStats;
+    indexStats["a_1"] = IndexStatistics{BSON("a" << 1), buildRangeHistogram(0, 99, 10)};
+    CollectionStatistics stats(100, std::move(indexStats));
+
+    OrderedIntervalList oil("a");
+    oil.intervals.push_back(makeInterval(BSON("" << 0 << "" << 49), true, true));
+    IndexBounds bounds;
+    bounds.fields.push_back(oil);
+
+    auto estimate = stats.estimateKeysExamined("a_1", BSON("a" << 1), bounds, 100);
+    ASSERT(estimate);
+    ASSERT_EQ(*estimate, 50);
+
+    estimate = stats.estimateKeysExamined("a_1", BSON("a" << 1), bounds, 200);
+    ASSERT(estimate);
+    ASSERT_EQ(*estimate, 100);
+}
+
+TEST(CollectionStatisticsTest, NoEstimateWithoutMatchingIndexStatistics) {
+    CollectionStatistics::IndexStatisticsMap indexStats;
+    indexStats["a_1"] = IndexStatistics{BSON("a" << 1), buildRangeHistogram(0, 99, 10)};
+    CollectionStatistics stats(100, std::move(indexStats));
+
+    IndexBounds bounds;
+    bounds.fields.push_back(OrderedIntervalList("a"));
+
+    ASSERT_FALSE(stats.estimateKeysExamined("b_1", BSON("b" << 1), bounds, 100));
+    ASSERT_FALSE(stats.estimateKeysExamined("a_1", BSON("a" << -1), bounds, 100));
+    ASSERT(stats.estimateKeysExamined("a_1", BSON("a" << 1), bounds, 100));
+
+    auto withoutA = stats.withoutIndex("a_1");
+    ASSERT_FALSE(withoutA->getIndexStatistics("a_1"));
+    ASSERT_FALSE(withoutA->estimateKeysExamined("a_1", BSON("a" << 1), bounds, 100));
+}
+
+TEST(CollectionStatisticsTest, NoEstimateWhenNonLeadingFieldIsConstrained) {
+    CollectionStatistics::IndexStatisticsMap indexStats;
+    indexStats["a_1_b_-1"] =
+        IndexStatistics{BSON("a" << 1 << "b" << -1), buildRangeHistogram(0, 99, 10)};
+    CollectionStatistics stats(100, std::move(indexStats));
+    const BSONObj keyPattern = BSON("a" << 1 << "b" << -1);
+
+    OrderedIntervalList aOil("a");
+    aOil.intervals.push_back(makeInterval(BSON("" << 0 << "" << 49), true, true));
+    OrderedIntervalList bOil("b");
+    bOil.intervals.push_back(makeInterval(BSON("" << MAXKEY << "" << MINKEY), true, true));
+    IndexBounds bounds;
+    bounds.fields.push_back(aOil);
+    bounds.fields.push_back(bOil);
+
+    auto estimate = stats.estimateKeysExamined("a_1_b_-1", keyPattern, bounds, 100);
+    ASSERT(estimate);
+    ASSERT_EQ(*estimate, 50);
+
+    bounds.fields[1].intervals.front() = makeInterval(BSON("" << 5 << "" << 5), true, true);
+    ASSERT_FALSE(stats.estimateKeysExamined("a_1_b_-1", keyPattern, bounds, 100));
+}
+
+}  // namespace
+}  // namespace mongo
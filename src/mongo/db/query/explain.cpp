@@ -32,6 +32,8 @@
 
 #include "mongo/db/query/explain.h"
 
+#include <cmath>
+
 #include "mongo/base/owned_pointer_vector.h"
 #include "mongo/bson/util/builder.h"
 #include "mongo/db/exec/cached_plan.h"
@@ -348,6 +350,18 @@ void Explain::statsToBSON(const PlanStageStats& stats,
                                   spec->mapAfterChild[i]);
             }
         }
+    } else if (STAGE_AND_BITMAP == stats.stageType) {
+        AndBitmapStats* spec = static_cast<AndBitmapStats*>(stats.specific.get());
+
+        if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
+            bob->appendNumber("memUsage", spec->memUsage);
+            bob->appendNumber("memLimit", spec->memLimit);
+
+            for (size_t i = 0; i < spec->intersectionAfterChild.size(); ++i) {
+                bob->appendNumber(string(stream() << "intersectionAfterChild_" << i),
+                                  spec->intersectionAfterChild[i]);
+            }
+        }
     } else if (STAGE_AND_SORTED == stats.stageType) {
         AndSortedStats* spec = static_cast<AndSortedStats*>(stats.specific.get());
 
@@ -495,6 +509,15 @@ void Explain::statsToBSON(const PlanStageStats& stats,
             bob->append("indexBounds", spec->indexBounds);
         }
 
+        if (spec->estimatedKeysExamined) {
+            bob->appendNumber("estimatedKeysExamined",
+                              static_cast<long long>(std::llround(*spec->estimatedKeysExamined)));
+        }
+
+        if (spec->isSkipScan) {
+            bob->appendBool("isSkipScan", true);
+        }
+
         if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
             bob->appendNumber("keysExamined", spec->keysExamined);
             bob->appendNumber("seeks", spec->seeks);
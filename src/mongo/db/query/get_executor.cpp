@@ -250,6 +250,12 @@ void fillOutPlannerParams(OperationContext* opCtx,
             opCtx, collection, canonicalQuery->getQueryRequest().isTailable())) {
         plannerParams->options |= QueryPlannerParams::OPLOG_SCAN_WAIT_FOR_VISIBLE;
     }
+
+    // If the collection has been analyzed, the planner can estimate the cost of its solutions.
+    plannerParams->collectionStats = collection->infoCache()->getCollectionStatistics();
+    if (plannerParams->collectionStats) {
+        plannerParams->numRecords = collection->numRecords(opCtx);
+    }
 }
 
 bool shouldWaitForOplogVisibility(OperationContext* opCtx,
@@ -408,6 +414,23 @@ StatusWith<PrepareExecutionResult> prepareExecution(OperationContext* opCtx,
         CurOp::get(opCtx)->debug().planCacheKey =
             canonical_query_encoder::computeHash(planCacheKey.toString());
 
+        // Queries of a shape the planner answers with a single solution may be answered from a
+        // solution template instead of being planned.
+        if (auto querySolution = collection->infoCache()->getPlanCache()->getSolutionFromTemplate(
+                planCacheKey, *canonicalQuery, plannerParams)) {
+            PlanStage* rawRoot;
+            verify(StageBuilder::build(
+                opCtx, collection, *canonicalQuery, *querySolution, ws, &rawRoot));
+            root.reset(rawRoot);
+
+            LOG(2) << "Using solution template for query: "
+                   << redact(canonicalQuery->toStringShort())
+                   << ", planSummary: " << Explain::getPlanSummary(root.get());
+
+            return PrepareExecutionResult(
+                std::move(canonicalQuery), std::move(querySolution), std::move(root));
+        }
+
         // Try to look up a cached solution for the query.
         if (auto cs =
                 collection->infoCache()->getPlanCache()->getCacheEntryIfActive(planCacheKey)) {
@@ -488,6 +511,11 @@ StatusWith<PrepareExecutionResult> prepareExecution(OperationContext* opCtx,
 
     if (1 == solutions.size()) {
         // Only one possible plan.  Run it.  Build the stages from the solution.
+        if (PlanCache::shouldCacheQuery(*canonicalQuery)) {
+            collection->infoCache()->getPlanCache()->setSolutionTemplate(
+                *canonicalQuery, plannerParams, *solutions[0]);
+        }
+
         PlanStage* rawRoot;
         verify(
             StageBuilder::build(opCtx, collection, *canonicalQuery, *solutions[0], ws, &rawRoot));
@@ -1064,6 +1092,9 @@ namespace {
  * Returns 'true' if the provided solution 'soln' can be rewritten to use
  * a fast counting stage.  Mutates the tree in 'soln->root'.
  *
+ * A filter on the index scan is evaluated against the index keys by the counting stage, so
+ * counts with residual predicates over the index's fields still avoid fetching documents.
+ *
  * Otherwise, returns 'false'.
  */
 bool turnIxscanIntoCount(QuerySolution* soln) {
@@ -1087,11 +1118,9 @@ bool turnIxscanIntoCount(QuerySolution* soln) {
         ? static_cast<IndexScanNode*>(root->children[0])
         : static_cast<IndexScanNode*>(root);
 
-    // No filters allowed and side-stepping isSimpleRange for now.  TODO: do we ever see
-    // isSimpleRange here?  because we could well use it.  I just don't think we ever do see
-    // it.
-
-    if (NULL != isn->filter.get() || isn->bounds.isSimpleRange) {
+    // Side-stepping isSimpleRange for now.  TODO: do we ever see isSimpleRange here?  because we
+    // could well use it.  I just don't think we ever do see it.
+    if (isn->bounds.isSimpleRange) {
         return false;
     }
 
@@ -1112,6 +1141,8 @@ bool turnIxscanIntoCount(QuerySolution* soln) {
     csn->startKeyInclusive = startKeyInclusive;
     csn->endKey = endKey;
     csn->endKeyInclusive = endKeyInclusive;
+    // The filter only refers to index fields, so the count scan can apply it to the keys.
+    csn->filter = std::move(isn->filter);
     // Takes ownership of 'cn' and deletes the old root.
     soln->root.reset(csn);
     return true;
@@ -1383,13 +1414,6 @@ bool turnIxscanIntoDistinctIxscan(QuerySolution* soln,
         }
     }
 
-    // An additional filter must be applied to the data in the key, so we can't just skip
-    // all the keys with a given value; we must examine every one to find the one that (may)
-    // pass the filter.
-    if (indexScanNode->filter) {
-        return false;
-    }
-
     // We only set this when we have special query modifiers (.max() or .min()) or other
     // special cases.  Don't want to handle the interactions between those and distinct.
     // Don't think this will ever really be true but if it somehow is, just ignore this
@@ -1448,6 +1472,11 @@ bool turnIxscanIntoDistinctIxscan(QuerySolution* soln,
     distinctNode->queryCollator = indexScanNode->queryCollator;
     distinctNode->fieldNo = fieldNo;
 
+    // An additional filter must be applied to the data in the key, so we can't just skip all the
+    // keys with a given value. The distinct scan examines keys of each value until one passes the
+    // filter, and only then skips to the next value.
+    distinctNode->filter = std::move(indexScanNode->filter);
+
     if (fetchNode) {
         // If there is a fetch node, then there is no need for the projection. The fetch node should
         // become the new root, with the distinct as its child. The PROJECT=>FETCH=>IXSCAN tree
@@ -340,6 +340,10 @@ std::string SolutionCacheData::toString() const {
                                  << "tree=" << this->tree->toString() << ")";
         case COLLSCAN_SOLN:
             return "(collection scan)";
+        case SKIP_SCAN_SOLN:
+            verify(this->tree.get());
+            return str::stream() << "(skip scan solution: "
+                                 << "tree=" << this->tree->toString() << ")";
         case USE_INDEX_TAGS_SOLN:
             verify(this->tree.get());
             return str::stream() << "(index-tagged expression tree: "
@@ -354,9 +358,12 @@ std::string SolutionCacheData::toString() const {
 
 PlanCache::PlanCache() : PlanCache(internalQueryCacheSize.load()) {}
 
-PlanCache::PlanCache(size_t size) : _cache(size) {}
+PlanCache::PlanCache(size_t size) : _cache(size), _solutionTemplates(size) {}
 
-PlanCache::PlanCache(const std::string& ns) : _cache(internalQueryCacheSize.load()), _ns(ns) {}
+PlanCache::PlanCache(const std::string& ns)
+    : _cache(internalQueryCacheSize.load()),
+      _solutionTemplates(internalQueryCacheSize.load()),
+      _ns(ns) {}
 
 PlanCache::~PlanCache() {}
 
@@ -602,13 +609,39 @@ Status PlanCache::feedback(const CanonicalQuery& cq, double score) {
 }
 
 Status PlanCache::remove(const CanonicalQuery& canonicalQuery) {
+    const PlanCacheKey key = computeKey(canonicalQuery);
     stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
-    return _cache.remove(computeKey(canonicalQuery));
+    _solutionTemplates.remove(key).ignore();
+    return _cache.remove(key);
 }
 
 void PlanCache::clear() {
     stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
     _cache.clear();
+    _solutionTemplates.clear();
+}
+
+void PlanCache::setSolutionTemplate(const CanonicalQuery& query,
+                                    const QueryPlannerParams& params,
+                                    const QuerySolution& soln) {
+    auto solutionTemplate = SolutionTemplate::make(query, params, soln);
+    if (!solutionTemplate) {
+        return;
+    }
+
+    const PlanCacheKey key = computeKey(query);
+    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
+    _solutionTemplates.add(key, solutionTemplate.release());
+}
+
+std::unique_ptr<QuerySolution> PlanCache::getSolutionFromTemplate(
+    const PlanCacheKey& key, const CanonicalQuery& query, const QueryPlannerParams& params) const {
+    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
+    SolutionTemplate* solutionTemplate;
+    if (!_solutionTemplates.get(key, &solutionTemplate).isOK()) {
+        return nullptr;
+    }
+    return solutionTemplate->instantiate(query, params);
 }
 
 PlanCacheKey PlanCache::computeKey(const CanonicalQuery& cq) const {
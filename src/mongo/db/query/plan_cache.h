@@ -39,6 +39,7 @@
 #include "mongo/db/query/lru_key_value.h"
 #include "mongo/db/query/plan_cache_indexability.h"
 #include "mongo/db/query/query_planner_params.h"
+#include "mongo/db/query/solution_template.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/mutex.h"
 
@@ -221,6 +222,10 @@ struct SolutionCacheData {
         // The cached plan is a collection scan.
         COLLSCAN_SOLN,
 
+        // The cached plan skip-scans the index
+        // stored in 'tree'.
+        SKIP_SCAN_SOLN,
+
         // Build the solution by using 'tree'
         // to tag the match expression.
         USE_INDEX_TAGS_SOLN
@@ -469,6 +474,23 @@ public:
      */
     Status feedback(const CanonicalQuery& cq, double score);
 
+    /**
+     * Remembers 'soln', the only solution the planner produced for 'query' given 'params', as a
+     * template for answering later queries of the same shape without planning them, if the query
+     * and solution qualify. See SolutionTemplate.
+     */
+    void setSolutionTemplate(const CanonicalQuery& query,
+                             const QueryPlannerParams& params,
+                             const QuerySolution& soln);
+
+    /**
+     * Returns the solution for 'query' instantiated from the template cached under 'key', or
+     * nullptr if there is no such template or it cannot be used for 'query' given 'params'.
+     */
+    std::unique_ptr<QuerySolution> getSolutionFromTemplate(const PlanCacheKey& key,
+                                                           const CanonicalQuery& query,
+                                                           const QueryPlannerParams& params) const;
+
     /**
      * Remove the entry corresponding to 'ck' from the cache.  Returns Status::OK() if the plan
      * was present and removed and an error status otherwise.
@@ -476,7 +498,7 @@ public:
     Status remove(const CanonicalQuery& canonicalQuery);
 
     /**
-     * Remove *all* cached plans.  Does not clear index information.
+     * Remove *all* cached plans and solution templates.  Does not clear index information.
      */
     void clear();
 
@@ -546,7 +568,11 @@ private:
 
     LRUKeyValue<PlanCacheKey, PlanCacheEntry, PlanCacheKeyHasher> _cache;
 
-    // Protects _cache.
+    // Solution templates for query shapes which the planner answers with a single solution.
+    // These shapes never make it into '_cache', as there is no plan ranking to remember.
+    LRUKeyValue<PlanCacheKey, SolutionTemplate, PlanCacheKeyHasher> _solutionTemplates;
+
+    // Protects _cache and _solutionTemplates.
     mutable stdx::mutex _cacheMutex;
 
     // Full namespace of collection.
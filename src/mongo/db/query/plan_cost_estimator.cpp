@@ -0,0 +1,179 @@
+
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kQuery
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/plan_cost_estimator.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/collection_statistics.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/db/query/query_planner_params.h"
+#include "mongo/db/query/query_solution.h"
+#include "mongo/util/log.h"
+
+namespace mongo {
+
+namespace {
+
+struct NodeEstimate {
+    // Estimated number of keys and documents examined by the node and its descendants.
+    double cost = 0;
+
+    // Estimated number of results the node produces.
+    double numResults = 0;
+};
+
+boost::optional<NodeEstimate> estimateNode(const CollectionStatistics& stats,
+                                           long long numRecords,
+                                           QuerySolutionNode* node) {
+    switch (node->getType()) {
+        case STAGE_COLLSCAN: {
+            NodeEstimate estimate;
+            estimate.cost = estimate.numResults = numRecords;
+            return estimate;
+        }
+        case STAGE_IXSCAN: {
+            IndexScanNode* ixn = static_cast<IndexScanNode*>(node);
+            if (ixn->isSkipScan) {
+                // The statistics do not say how many keys are skipped over.
+                return boost::none;
+            }
+            ixn->estimatedKeysExamined = stats.estimateKeysExamined(
+                ixn->index.identifier.catalogName, ixn->index.keyPattern, ixn->bounds, numRecords);
+            if (!ixn->estimatedKeysExamined) {
+                return boost::none;
+            }
+            NodeEstimate estimate;
+            estimate.cost = estimate.numResults = *ixn->estimatedKeysExamined;
+            return estimate;
+        }
+        default:
+            break;
+    }
+
+    if (node->children.empty()) {
+        return boost::none;
+    }
+
+    // Keep walking after a child which cannot be estimated so that every index scan in the tree
+    // is annotated.
+    const bool isIntersection = node->getType() == STAGE_AND_HASH ||
+        node->getType() == STAGE_AND_SORTED || node->getType() == STAGE_AND_BITMAP;
+    bool isKnown = true;
+    NodeEstimate estimate;
+    for (size_t i = 0; i < node->children.size(); ++i) {
+        auto childEstimate = estimateNode(stats, numRecords, node->children[i]);
+        if (!childEstimate) {
+            isKnown = false;
+            continue;
+        }
+        estimate.cost += childEstimate->cost;
+        estimate.numResults = (isIntersection && i > 0)
+            ? std::min(estimate.numResults, childEstimate->numResults)
+            : estimate.numResults + childEstimate->numResults;
+    }
+    if (!isKnown) {
+        return boost::none;
+    }
+
+    if (node->getType() == STAGE_FETCH) {
+        estimate.cost += estimate.numResults;
+    }
+    return estimate;
+}
+
+}  // namespace
+
+boost::optional<double> PlanCostEstimator::estimateCost(const CollectionStatistics& stats,
+                                                        long long numRecords,
+                                                        QuerySolution* soln) {
+    invariant(soln->root);
+    auto estimate = estimateNode(stats, numRecords, soln->root.get());
+    if (!estimate) {
+        return boost::none;
+    }
+    return estimate->cost;
+}
+
+void PlanCostEstimator::pruneSolutions(const CanonicalQuery& query,
+                                       const QueryPlannerParams& params,
+                                       std::vector<std::unique_ptr<QuerySolution>>* solutions) {
+    if (!params.collectionStats) {
+        return;
+    }
+
+    std::vector<boost::optional<double>> costs;
+    for (auto&& soln : *solutions) {
+        costs.push_back(estimateCost(*params.collectionStats, params.numRecords, soln.get()));
+    }
+
+    const double pruningRatio = internalQueryPlannerCostPruningRatio.load();
+    const auto& qr = query.getQueryRequest();
+    if (solutions->size() < 2 || pruningRatio <= 0 || !qr.getSort().isEmpty() || qr.getLimit() ||
+        qr.getNToReturn()) {
+        return;
+    }
+
+    // Solutions whose cost cannot be estimated, such as skip scans, are left for the multi-planner
+    // to judge. The others are only compared with each other.
+    size_t numKnownCosts = 0;
+    double minCost = std::numeric_limits<double>::max();
+    for (auto&& cost : costs) {
+        if (cost) {
+            ++numKnownCosts;
+            minCost = std::min(minCost, *cost);
+        }
+    }
+    if (numKnownCosts < 2) {
+        return;
+    }
+
+    // Estimates near zero are the least reliable, so never prune relative to less than one key.
+    const double maxCost = pruningRatio * std::max(minCost, 1.0);
+    std::vector<std::unique_ptr<QuerySolution>> kept;
+    for (size_t i = 0; i < solutions->size(); ++i) {
+        if (!costs[i] || *costs[i] <= maxCost) {
+            kept.push_back(std::move((*solutions)[i]));
+        } else {
+            LOG(5) << "Planner: pruning solution with estimated cost " << *costs[i]
+                   << ", cheapest is " << minCost << ":" << std::endl
+                   << redact((*solutions)[i]->toString());
+        }
+    }
+    *solutions = std::move(kept);
+}
+
+}  // namespace mongo
@@ -0,0 +1,75 @@
+
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <memory>
+#include <vector>
+
+namespace mongo {
+
+class CanonicalQuery;
+class CollectionStatistics;
+struct QueryPlannerParams;
+class QuerySolution;
+
+/**
+ * Estimates the cost of candidate query solutions from the statistics gathered by the 'analyze'
+ * command, so that the planner can discard candidates which are clearly more expensive than the
+ * best one before they are raced against each other by the MultiPlanStage.
+ *
+ * The cost of a solution is the estimated number of index keys and documents it examines.
+ */
+class PlanCostEstimator {
+public:
+    /**
+     * Annotates each index scan in 'soln' with the estimated number of keys it examines and
+     * returns the estimated cost of the whole solution, given that the collection currently holds
+     * 'numRecords' records. Returns boost::none if the solution has a leaf whose cost cannot be
+     * estimated.
+     */
+    static boost::optional<double> estimateCost(const CollectionStatistics& stats,
+                                                long long numRecords,
+                                                QuerySolution* soln);
+
+    /**
+     * If 'params' carries collection statistics, annotates 'solutions' with estimates and removes
+     * those whose estimated cost exceeds internalQueryPlannerCostPruningRatio times that of the
+     * cheapest. Solutions which cannot be estimated are always kept. Nothing is removed unless the
+     * query runs to completion, since the estimates take neither limits nor index-provided sorts
+     * into account.
+     */
+    static void pruneSolutions(const CanonicalQuery& query,
+                               const QueryPlannerParams& params,
+                               std::vector<std::unique_ptr<QuerySolution>>* solutions);
+};
+
+}  // namespace mongo
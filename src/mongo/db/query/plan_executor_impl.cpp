@@ -60,6 +60,7 @@
 #include "mongo/util/log.h"
 #include "mongo/util/scopeguard.h"
 #include "mongo/util/stacktrace.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -251,11 +252,20 @@ PlanExecutorImpl::PlanExecutorImpl(OperationContext* opCtx,
 Status PlanExecutorImpl::_pickBestPlan() {
     invariant(_currentState == kUsable);
 
+    // Charges the time spent running plan selection trials to the operation's planning time.
+    Timer planningTimer;
+    auto recordPlanningTime = [&](Status status) {
+        if (_opCtx) {
+            CurOp::get(_opCtx)->debug().planningTimeMicros += planningTimer.micros();
+        }
+        return status;
+    };
+
     // First check if we need to do subplanning.
     PlanStage* foundStage = getStageByType(_root.get(), STAGE_SUBPLAN);
     if (foundStage) {
         SubplanStage* subplan = static_cast<SubplanStage*>(foundStage);
-        return subplan->pickBestPlan(_yieldPolicy.get());
+        return recordPlanningTime(subplan->pickBestPlan(_yieldPolicy.get()));
     }
 
     // If we didn't have to do subplanning, we might still have to do regular
@@ -263,7 +273,7 @@ Status PlanExecutorImpl::_pickBestPlan() {
     foundStage = getStageByType(_root.get(), STAGE_MULTI_PLAN);
     if (foundStage) {
         MultiPlanStage* mps = static_cast<MultiPlanStage*>(foundStage);
-        return mps->pickBestPlan(_yieldPolicy.get());
+        return recordPlanningTime(mps->pickBestPlan(_yieldPolicy.get()));
     }
 
     // ...or, we might have to run a plan from the cache for a trial period, falling back on
@@ -271,7 +281,7 @@ Status PlanExecutorImpl::_pickBestPlan() {
     foundStage = getStageByType(_root.get(), STAGE_CACHED_PLAN);
     if (foundStage) {
         CachedPlanStage* cachedPlan = static_cast<CachedPlanStage*>(foundStage);
-        return cachedPlan->pickBestPlan(_yieldPolicy.get());
+        return recordPlanningTime(cachedPlan->pickBestPlan(_yieldPolicy.get()));
     }
 
     // Finally, we might have an explicit TrialPhase. This specifies exactly two candidate plans,
@@ -279,7 +289,7 @@ Status PlanExecutorImpl::_pickBestPlan() {
     foundStage = getStageByType(_root.get(), STAGE_TRIAL);
     if (foundStage) {
         TrialStage* trialStage = static_cast<TrialStage*>(foundStage);
-        return trialStage->pickBestPlan(_yieldPolicy.get());
+        return recordPlanningTime(trialStage->pickBestPlan(_yieldPolicy.get()));
     }
 
     // Either we chose a plan, or no plan selection was required. In both cases,
@@ -82,6 +82,10 @@ struct CandidatePlan {
     std::queue<WorkingSetID> results;
 
     bool failed;
+
+    // Set when the plan fell far enough behind the others during the trial period that it is no
+    // longer worked. Its results and stats so far are retained for ranking.
+    bool eliminated = false;
 };
 
 /**
@@ -43,7 +43,9 @@
 #include "mongo/db/bson/dotted_path_support.h"
 #include "mongo/db/matcher/expression_array.h"
 #include "mongo/db/matcher/expression_geo.h"
+#include "mongo/db/matcher/expression_leaf.h"
 #include "mongo/db/matcher/expression_text.h"
+#include "mongo/db/query/collation/collator_interface.h"
 #include "mongo/db/query/index_bounds_builder.h"
 #include "mongo/db/query/index_tag.h"
 #include "mongo/db/query/indexability.h"
@@ -1004,7 +1006,7 @@ std::unique_ptr<QuerySolutionNode> QueryPlannerAccess::buildIndexedAnd(
             return nullptr;
         }
 
-        // Figure out if we want AndHashNode or AndSortedNode.
+        // Figure out if we want AndHashNode, AndBitmapNode or AndSortedNode.
         bool allSortedByDiskLoc = true;
         for (size_t i = 0; i < ixscanNodes.size(); ++i) {
             if (!ixscanNodes[i]->sortedByDiskLoc()) {
@@ -1034,11 +1036,17 @@ std::unique_ptr<QuerySolutionNode> QueryPlannerAccess::buildIndexedAnd(
                     break;
                 }
             }
+        } else if (internalQueryPlannerEnableBitmapIntersection.load()) {
+            // The AndBitmapNode outputs record ids in RecordId order rather than in the order of
+            // any of its children.
+            auto abn = stdx::make_unique<AndBitmapNode>();
+            abn->addChildren(std::move(ixscanNodes));
+            andResult = std::move(abn);
         } else {
-            // We can't use sort-based intersection, and hash-based intersection is disabled.
-            // Clean up the index scans and bail out by returning NULL.
+            // We can't use sort-based intersection, and hash- and bitmap-based intersection are
+            // disabled. Clean up the index scans and bail out by returning NULL.
             LOG(5) << "Can't build index intersection solution: "
-                   << "AND_SORTED is not possible and AND_HASH is disabled.";
+                   << "AND_SORTED is not possible and AND_HASH and AND_BITMAP are disabled.";
             return nullptr;
         }
     }
@@ -1048,7 +1056,8 @@ std::unique_ptr<QuerySolutionNode> QueryPlannerAccess::buildIndexedAnd(
         return andResult;
     }
 
-    if (andResult->getType() == STAGE_AND_HASH || andResult->getType() == STAGE_AND_SORTED) {
+    if (andResult->getType() == STAGE_AND_HASH || andResult->getType() == STAGE_AND_SORTED ||
+        andResult->getType() == STAGE_AND_BITMAP) {
         // We got an index intersection solution, so we aren't allowed to answer predicates exactly
         // using the index. This is because the index intersection stage finds documents that match
         // each index's predicate, but the document isn't guaranteed to be in a state where it
@@ -1293,6 +1302,93 @@ std::unique_ptr<QuerySolutionNode> QueryPlannerAccess::scanWholeIndex(
     return solnRoot;
 }
 
+std::unique_ptr<QuerySolutionNode> QueryPlannerAccess::makeSkipScan(
+    const IndexEntry& index, const CanonicalQuery& query, const QueryPlannerParams& params) {
+    // The index must hold a key for every document, ordered by the query's collation.
+    if (INDEX_BTREE != index.type || index.sparse || index.filterExpr ||
+        index.keyPattern.nFields() < 2 ||
+        !CollatorInterface::collatorsMatch(index.collator, query.getCollator())) {
+        return nullptr;
+    }
+
+    BSONObjIterator keyPatternIt(index.keyPattern);
+    const StringData leadingField = keyPatternIt.next().fieldNameStringData();
+    const StringData skipToField = keyPatternIt.next().fieldNameStringData();
+
+    std::vector<const MatchExpression*> predicates;
+    const MatchExpression* root = query.root();
+    if (MatchExpression::AND == root->matchType()) {
+        for (size_t i = 0; i < root->numChildren(); ++i) {
+            predicates.push_back(root->getChild(i));
+        }
+    } else {
+        predicates.push_back(root);
+    }
+
+    std::vector<const MatchExpression*> skipToPredicates;
+    for (auto&& predicate : predicates) {
+        if (predicate->path() == leadingField) {
+            // The index can be used without skipping.
+            return nullptr;
+        }
+        if (predicate->path() != skipToField) {
+            continue;
+        }
+
+        switch (predicate->matchType()) {
+            case MatchExpression::EQ:
+            case MatchExpression::LT:
+            case MatchExpression::LTE:
+            case MatchExpression::GT:
+            case MatchExpression::GTE: {
+                const BSONElement value =
+                    static_cast<const ComparisonMatchExpression*>(predicate)->getData();
+                if (Array != value.type() && Object != value.type()) {
+                    skipToPredicates.push_back(predicate);
+                }
+                break;
+            }
+            default:
+                break;
+        }
+    }
+    if (skipToPredicates.empty()) {
+        return nullptr;
+    }
+
+    auto isn = make_unique<IndexScanNode>(index);
+    isn->addKeyMetadata = query.getQueryRequest().returnKey();
+    isn->queryCollator = query.getCollator();
+    isn->isSkipScan = true;
+
+    for (auto&& field : index.keyPattern) {
+        OrderedIntervalList oil(field.fieldName());
+        if (field.fieldNameStringData() != skipToField) {
+            IndexBoundsBuilder::allValuesForField(field, &oil);
+        } else {
+            IndexBoundsBuilder::BoundsTightness tightness;
+            IndexBoundsBuilder::translate(skipToPredicates[0], field, index, &oil, &tightness);
+
+            // Bounds on a multikey field may only be intersected when their predicates are
+            // joined by $elemMatch. The fetch applies the predicates which are left out.
+            if (!index.multikey) {
+                for (size_t i = 1; i < skipToPredicates.size(); ++i) {
+                    IndexBoundsBuilder::translateAndIntersect(
+                        skipToPredicates[i], field, index, &oil, &tightness);
+                }
+            }
+        }
+        isn->bounds.fields.push_back(std::move(oil));
+    }
+    IndexBoundsBuilder::alignBounds(&isn->bounds, index.keyPattern);
+
+    // The bounds need not be exact, so the whole query is applied to the fetched documents.
+    auto fetch = make_unique<FetchNode>();
+    fetch->filter = query.root()->shallowClone();
+    fetch->children.push_back(isn.release());
+    return std::move(fetch);
+}
+
 void QueryPlannerAccess::addFilterToSolutionNode(QuerySolutionNode* node,
                                                  MatchExpression* match,
                                                  MatchExpression::MatchType type) {
@@ -111,6 +111,16 @@ public:
                                                              const QueryPlannerParams& params,
                                                              int direction = 1);
 
+    /**
+     * Return a plan that skip-scans the provided index: every value of its leading field is
+     * visited, and for each the scan seeks to the bounds which the top-level predicates of
+     * 'query' place on the second field. Returns nullptr if the query constrains the leading
+     * field or has no such predicates, or if the index cannot be scanned this way.
+     */
+    static std::unique_ptr<QuerySolutionNode> makeSkipScan(const IndexEntry& index,
+                                                           const CanonicalQuery& query,
+                                                           const QueryPlannerParams& params);
+
     /**
      * Return a plan that scans the provided index from [startKey to endKey).
      */
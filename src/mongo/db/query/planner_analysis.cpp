@@ -669,9 +669,10 @@ std::unique_ptr<QuerySolution> QueryPlannerAnalysis::analyzeDataAccess(
     }
 
     // A solution can be blocking if it has a blocking sort stage or
-    // a hashed AND stage.
+    // a hashed or bitmap AND stage.
     bool hasAndHashStage = hasNode(solnRoot.get(), STAGE_AND_HASH);
-    soln->hasBlockingStage = hasSortStage || hasAndHashStage;
+    bool hasAndBitmapStage = hasNode(solnRoot.get(), STAGE_AND_BITMAP);
+    soln->hasBlockingStage = hasSortStage || hasAndHashStage || hasAndBitmapStage;
 
     const QueryRequest& qr = query.getQueryRequest();
 
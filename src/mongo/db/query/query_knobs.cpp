@@ -42,6 +42,15 @@ MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlanEvaluationCollFraction, double, 0
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlanEvaluationMaxResults, int, 101);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlanEvaluationEliminationRatio, double, 0.0)
+    ->withValidator([](const double& newVal) {
+        if (newVal != 0.0 && newVal < 1.0) {
+            return Status(ErrorCodes::BadValue,
+                          "internalQueryPlanEvaluationEliminationRatio must be 0 or >= 1.0");
+        }
+        return Status::OK();
+    });
+
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryCacheSize, int, 5000);
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryCacheFeedbacksStored, int, 20);
@@ -61,6 +70,37 @@ MONGO_EXPORT_SERVER_PARAMETER(internalQueryCacheDisableInactiveEntries, bool, fa
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryCacheListPlansNewOutput, bool, false);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryResultCacheMaxBytesPerCollection,
+                              long long,
+                              16 * 1024 * 1024)
+    ->withValidator([](const long long& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "internalQueryResultCacheMaxBytesPerCollection must be >= 0");
+        }
+        return Status::OK();
+    });
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryResultCacheMaxBytesTotal,
+                              long long,
+                              128 * 1024 * 1024)
+    ->withValidator([](const long long& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "internalQueryResultCacheMaxBytesTotal must be >= 0");
+        }
+        return Status::OK();
+    });
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryResultCacheMaxEntryBytes, long long, 1024 * 1024)
+    ->withValidator([](const long long& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "internalQueryResultCacheMaxEntryBytes must be >= 0");
+        }
+        return Status::OK();
+    });
+
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlannerMaxIndexedSolutions, int, 64);
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryEnumerationMaxOrSolutions, int, 10);
@@ -73,6 +113,8 @@ MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlannerEnableIndexIntersection, bool,
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlannerEnableHashIntersection, bool, false);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlannerEnableBitmapIntersection, bool, false);
+
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlanOrChildrenIndependently, bool, true);
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryMaxScansToExplode, int, 200);
@@ -83,6 +125,15 @@ MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecMaxBlockingSortBytes, int, 32 * 1
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecYieldIterations, int, 128);
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecYieldPeriodMS, int, 10);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecFetchPrefetchBatchSize, int, 0)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "internalQueryExecFetchPrefetchBatchSize must be >= 0");
+        }
+        return Status::OK();
+    });
+
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryFacetBufferSizeBytes, int, 100 * 1024 * 1024);
 
 MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceSortMaxBlockingSortBytes,
@@ -129,6 +180,24 @@ MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceLookupCacheSizeBytes, int, 1
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlannerGenerateCoveredWholeIndexScans, bool, false);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlannerCostPruningRatio, double, 10.0)
+    ->withValidator([](const double& newVal) {
+        if (newVal < 0.0) {
+            return Status(ErrorCodes::BadValue,
+                          "internalQueryPlannerCostPruningRatio must be >= 0.0");
+        }
+        return Status::OK();
+    });
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlannerSkipScanMaxPrefixRatio, double, 0.1)
+    ->withValidator([](const double& newVal) {
+        if (newVal < 0.0 || newVal > 1.0) {
+            return Status(ErrorCodes::BadValue,
+                          "internalQueryPlannerSkipScanMaxPrefixRatio must be between 0.0 and 1.0");
+        }
+        return Status::OK();
+    });
+
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryIgnoreUnknownJSONSchemaKeywords, bool, false);
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryProhibitBlockingMergeOnMongoS, bool, false);
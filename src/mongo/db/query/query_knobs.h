@@ -50,6 +50,11 @@ extern AtomicDouble internalQueryPlanEvaluationCollFraction;
 // Stop working plans once a plan returns this many results.
 extern AtomicInt32 internalQueryPlanEvaluationMaxResults;
 
+// During the trial period, stop working any plan whose results fall this many times short of the
+// most productive plan's. Zero disables early elimination, so that every plan is worked for the
+// whole trial period.
+extern AtomicDouble internalQueryPlanEvaluationEliminationRatio;
+
 // Do we give a big ranking bonus to intersection plans?
 extern AtomicBool internalQueryForceIntersectionPlans;
 
@@ -59,6 +64,11 @@ extern AtomicBool internalQueryPlannerEnableIndexIntersection;
 // Do we use hash-based intersection for rooted $and queries?
 extern AtomicBool internalQueryPlannerEnableHashIntersection;
 
+// Do we use bitmap-based intersection for rooted $and queries when hash-based intersection is
+// disabled? Off by default, like hash-based intersection: enabling it adds blocking candidate
+// plans to the multi-plan trial of every query which could use index intersection.
+extern AtomicBool internalQueryPlannerEnableBitmapIntersection;
+
 //
 // plan cache
 //
@@ -84,6 +94,20 @@ extern AtomicBool internalQueryCacheDisableInactiveEntries;
 // Whether or not planCacheListPlans uses the new output format.
 extern AtomicBool internalQueryCacheListPlansNewOutput;
 
+//
+// query result cache
+//
+
+// How many bytes of query results may be cached for each collection with the result cache
+// enabled?
+extern AtomicInt64 internalQueryResultCacheMaxBytesPerCollection;
+
+// How many bytes of query results may be cached for all collections together?
+extern AtomicInt64 internalQueryResultCacheMaxBytesTotal;
+
+// Results larger than this many bytes are not cached.
+extern AtomicInt64 internalQueryResultCacheMaxEntryBytes;
+
 //
 // Planning and enumeration.
 //
@@ -107,6 +131,16 @@ extern AtomicInt32 internalQueryMaxScansToExplode;
 // Allow the planner to generate covered whole index scans, rather than falling back to a COLLSCAN.
 extern AtomicBool internalQueryPlannerGenerateCoveredWholeIndexScans;
 
+// Candidate solutions whose cost, estimated from the statistics gathered by the 'analyze'
+// command, exceeds this many times that of the cheapest candidate are discarded before the plans
+// are raced. Zero disables pruning.
+extern AtomicDouble internalQueryPlannerCostPruningRatio;
+
+// An index whose leading field is unconstrained by the query may be skip-scanned for predicates
+// on its second field if, according to the statistics gathered by the 'analyze' command, its
+// leading field has at most this many distinct values per index key. Zero disables skip scans.
+extern AtomicDouble internalQueryPlannerSkipScanMaxPrefixRatio;
+
 // Ignore unknown JSON Schema keywords.
 extern AtomicBool internalQueryIgnoreUnknownJSONSchemaKeywords;
 
@@ -122,6 +156,10 @@ extern AtomicInt32 internalQueryExecYieldIterations;
 // Yield if it's been at least this many milliseconds since we last yielded.
 extern AtomicInt32 internalQueryExecYieldPeriodMS;
 
+// The largest number of record ids a FETCH stage reads ahead from its child and fetches together,
+// in record id order. 0 or 1 disables read-ahead.
+extern AtomicInt32 internalQueryExecFetchPrefetchBatchSize;
+
 // Limit the size that we write without yielding to 16MB / 64 (max expected number of indexes)
 const int64_t insertVectorMaxBytes = 256 * 1024;
 
@@ -39,6 +39,7 @@
 
 #include "mongo/base/string_data.h"
 #include "mongo/bson/simple_bsonelement_comparator.h"
+#include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/db/bson/dotted_path_support.h"
 #include "mongo/db/index/wildcard_key_generator.h"
 #include "mongo/db/index_names.h"
@@ -48,11 +49,14 @@
 #include "mongo/db/query/canonical_query.h"
 #include "mongo/db/query/collation/collation_index_key.h"
 #include "mongo/db/query/collation/collator_interface.h"
+#include "mongo/db/query/collection_statistics.h"
 #include "mongo/db/query/plan_cache.h"
+#include "mongo/db/query/plan_cost_estimator.h"
 #include "mongo/db/query/plan_enumerator.h"
 #include "mongo/db/query/planner_access.h"
 #include "mongo/db/query/planner_analysis.h"
 #include "mongo/db/query/planner_ixselect.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_planner_common.h"
 #include "mongo/db/query/query_solution.h"
 #include "mongo/util/log.h"
@@ -281,6 +285,39 @@ std::unique_ptr<QuerySolution> buildCollscanSoln(const CanonicalQuery& query,
     return QueryPlannerAnalysis::analyzeDataAccess(query, params, std::move(solnRoot));
 }
 
+std::unique_ptr<QuerySolution> buildSkipScanSoln(const IndexEntry& index,
+                                                 const CanonicalQuery& query,
+                                                 const QueryPlannerParams& params) {
+    std::unique_ptr<QuerySolutionNode> solnRoot(
+        QueryPlannerAccess::makeSkipScan(index, query, params));
+    if (!solnRoot) {
+        return nullptr;
+    }
+    return QueryPlannerAnalysis::analyzeDataAccess(query, params, std::move(solnRoot));
+}
+
+/**
+ * Returns true if the statistics in 'params' show that the leading field of 'index' has few
+ * enough distinct values for skip scans of the index to be considered.
+ */
+bool hasFewLeadingValues(const IndexEntry& index, const QueryPlannerParams& params) {
+    const double maxPrefixRatio = internalQueryPlannerSkipScanMaxPrefixRatio.load();
+    if (!params.collectionStats || maxPrefixRatio <= 0) {
+        return false;
+    }
+
+    const IndexStatistics* indexStats =
+        params.collectionStats->getIndexStatistics(index.identifier.catalogName);
+    if (!indexStats ||
+        SimpleBSONObjComparator::kInstance.evaluate(indexStats->keyPattern != index.keyPattern)) {
+        return false;
+    }
+
+    const ValueHistogram& histogram = indexStats->histogram;
+    return histogram.getTotalCount() > 0 &&
+        histogram.getNumDistinct() <= maxPrefixRatio * histogram.getTotalCount();
+}
+
 std::unique_ptr<QuerySolution> buildWholeIXSoln(const IndexEntry& index,
                                                 const CanonicalQuery& query,
                                                 const QueryPlannerParams& params,
@@ -459,6 +496,13 @@ StatusWith<std::unique_ptr<QuerySolution>> QueryPlanner::planFromCache(
         } else {
             return {std::move(soln)};
         }
+    } else if (SolutionCacheData::SKIP_SCAN_SOLN == winnerCacheData.solnType) {
+        auto soln = buildSkipScanSoln(*winnerCacheData.tree->entry, query, params);
+        if (!soln) {
+            return Status(ErrorCodes::BadValue, "plan cache error: soln that skip-scans an index");
+        } else {
+            return {std::move(soln)};
+        }
     } else if (SolutionCacheData::COLLSCAN_SOLN == winnerCacheData.solnType) {
         // The cached solution is a collection scan. We don't cache collscans
         // with tailable==true, hence the false below.
@@ -1007,6 +1051,31 @@ StatusWith<std::vector<std::unique_ptr<QuerySolution>>> QueryPlanner::plan(
     // No indexed plans?  We must provide a collscan if possible or else we can't run the query.
     bool collscanNeeded = (0 == out.size() && canTableScan);
 
+    // An index whose leading field is left unconstrained can still serve predicates on its second
+    // field by skipping from each leading value to the next, which pays off when there are few of
+    // them. Such plans are offered in addition to the others, including any needed collscan.
+    if (possibleToCollscan) {
+        for (auto&& index : fullIndexList) {
+            if (!hasFewLeadingValues(index, params)) {
+                continue;
+            }
+
+            auto soln = buildSkipScanSoln(index, query, params);
+            if (soln) {
+                LOG(5) << "Planner: outputting a skip scan:" << endl << redact(soln->toString());
+                PlanCacheIndexTree* indexTree = new PlanCacheIndexTree();
+                indexTree->setIndexEntry(index);
+
+                SolutionCacheData* scd = new SolutionCacheData();
+                scd->tree.reset(indexTree);
+                scd->solnType = SolutionCacheData::SKIP_SCAN_SOLN;
+                soln->cacheData.reset(scd);
+
+                out.push_back(std::move(soln));
+            }
+        }
+    }
+
     if (possibleToCollscan && (collscanRequested || collscanNeeded)) {
         auto collscan = buildCollscanSoln(query, isTailable, params);
         if (collscan) {
@@ -1018,6 +1087,8 @@ StatusWith<std::vector<std::unique_ptr<QuerySolution>>> QueryPlanner::plan(
         }
     }
 
+    PlanCostEstimator::pruneSolutions(query, params, &out);
+
     return {std::move(out)};
 }
 
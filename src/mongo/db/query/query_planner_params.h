@@ -30,6 +30,7 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 
 #include "mongo/db/jsobj.h"
@@ -38,6 +39,8 @@
 
 namespace mongo {
 
+class CollectionStatistics;
+
 struct QueryPlannerParams {
     QueryPlannerParams()
         : options(DEFAULT),
@@ -118,6 +121,12 @@ struct QueryPlannerParams {
     // plans via the MultiPlanStage, and the set of possible plans is very large for certain
     // index+query combinations.
     size_t maxIndexedSolutions;
+
+    // Statistics gathered for the collection by the 'analyze' command, if any, along with the
+    // number of records the collection currently holds. Used to estimate the cost of candidate
+    // solutions.
+    std::shared_ptr<const CollectionStatistics> collectionStats;
+    long long numRecords = 0;
 };
 
 }  // namespace mongo
@@ -0,0 +1,245 @@
+
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+/**
+ * This file contains tests for planning with collection statistics: pruning candidate solutions
+ * by their estimated cost, and offering skip scans of indexes with few leading values.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/collection_statistics.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/db/query/query_planner_test_fixture.h"
+#include "mongo/util/scopeguard.h"
+
+namespace {
+
+using namespace mongo;
+
+/**
+ * Statistics for a collection of 1000 documents in which every document has a distinct value of
+ * 'a' but the same value, 5, for 'b'.
+ */
+std::shared_ptr<const CollectionStatistics> makeSkewedStatistics() {
+    ValueHistogram::Builder aBuilder(100);
+    ValueHistogram::Builder bBuilder(100);
+    for (int i = 0; i < 1000; ++i) {
+        aBuilder.addValue(BSON("" << i).firstElement());
+        bBuilder.addValue(BSON("" << 5).firstElement());
+    }
+
+    CollectionStatistics::IndexStatisticsMap indexStats;
+    indexStats["a_1"] = IndexStatistics{BSON("a" << 1), aBuilder.done()};
+    indexStats["b_1"] = IndexStatistics{BSON("b" << 1), bBuilder.done()};
+    return std::make_shared<CollectionStatistics>(1000, std::move(indexStats));
+}
+
+class QueryPlannerStatisticsTest : public QueryPlannerTest {
+protected:
+    void setUp() final {
+        QueryPlannerTest::setUp();
+        addIndex(BSON("a" << 1), nullptr, "a_1");
+        addIndex(BSON("b" << 1), nullptr, "b_1");
+        params.numRecords = 1000;
+    }
+};
+
+TEST_F(QueryPlannerStatisticsTest, AllSolutionsKeptWithoutStatistics) {
+    runQuery(fromjson("{a: 5, b: 5}"));
+
+    assertNumSolutions(3U);
+}
+
+TEST_F(QueryPlannerStatisticsTest, ExpensiveSolutionsArePruned) {
+    params.collectionStats = makeSkewedStatistics();
+
+    runQuery(fromjson("{a: 5, b: 5}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists("{fetch: {filter: {b: 5}, node: {ixscan: {pattern: {a: 1}}}}}");
+}
+
+TEST_F(QueryPlannerStatisticsTest, SolutionsOfSimilarCostAreKept) {
+    params.collectionStats = makeSkewedStatistics();
+
+    runQuery(fromjson("{a: {$lt: 900}, b: 5}"));
+
+    assertNumSolutions(3U);
+}
+
+TEST_F(QueryPlannerStatisticsTest, NoPruningWhenQueryHasSort) {
+    params.collectionStats = makeSkewedStatistics();
+
+    runQuerySortProj(fromjson("{a: 5, b: 5}"), fromjson("{b: 1}"), BSONObj());
+
+    assertNumSolutions(3U);
+}
+
+TEST_F(QueryPlannerStatisticsTest, NoPruningWhenDisabled) {
+    const double oldRatio = internalQueryPlannerCostPruningRatio.load();
+    ON_BLOCK_EXIT([oldRatio] { internalQueryPlannerCostPruningRatio.store(oldRatio); });
+    internalQueryPlannerCostPruningRatio.store(0.0);
+    params.collectionStats = makeSkewedStatistics();
+
+    runQuery(fromjson("{a: 5, b: 5}"));
+
+    assertNumSolutions(3U);
+}
+
+TEST_F(QueryPlannerStatisticsTest, CompoundIndexScanConstrainingNonLeadingFieldIsNotPruned) {
+    addIndex(BSON("b" << 1 << "a" << 1), nullptr, "b_1_a_1");
+    ValueHistogram::Builder aBuilder(100);
+    ValueHistogram::Builder bBuilder(100);
+    ValueHistogram::Builder bABuilder(100);
+    for (int i = 0; i < 1000; ++i) {
+        aBuilder.addValue(BSON("" << i).firstElement());
+        bBuilder.addValue(BSON("" << 5).firstElement());
+        bABuilder.addValue(BSON("" << 5).firstElement());
+    }
+    CollectionStatistics::IndexStatisticsMap indexStats;
+    indexStats["a_1"] = IndexStatistics{BSON("a" << 1), aBuilder.done()};
+    indexStats["b_1"] = IndexStatistics{BSON("b" << 1), bBuilder.done()};
+    indexStats["b_1_a_1"] = IndexStatistics{BSON("b" << 1 << "a" << 1), bABuilder.done()};
+    params.collectionStats = std::make_shared<CollectionStatistics>(1000, std::move(indexStats));
+
+    // Every key of {b: 1, a: 1} has b = 5, but its bounds on 'a' make it as selective as {a: 1}.
+    // Its leading field alone cannot tell, so its scan is kept. The scan of {b: 1} is still
+    // pruned relative to the scan of {a: 1}.
+    runQuery(fromjson("{a: 5, b: 5}"));
+
+    assertSolutionExists("{fetch: {filter: null, node: {ixscan: {pattern: {b: 1, a: 1}}}}}");
+    assertSolutionExists("{fetch: {filter: {b: 5}, node: {ixscan: {pattern: {a: 1}}}}}");
+    ASSERT_EQ(0U, numSolutionMatches("{fetch: {node: {ixscan: {pattern: {b: 1}}}}}"));
+}
+
+/**
+ * Statistics for a collection of 1000 documents whose index {a: 1, b: 1} holds 'numLeadingValues'
+ * distinct values of 'a'.
+ */
+std::shared_ptr<const CollectionStatistics> makeCompoundIndexStatistics(int numLeadingValues) {
+    ValueHistogram::Builder builder(100);
+    for (int i = 0; i < 1000; ++i) {
+        builder.addValue(BSON("" << i * numLeadingValues / 1000).firstElement());
+    }
+
+    CollectionStatistics::IndexStatisticsMap indexStats;
+    indexStats["a_1_b_1"] = IndexStatistics{BSON("a" << 1 << "b" << 1), builder.done()};
+    return std::make_shared<CollectionStatistics>(1000, std::move(indexStats));
+}
+
+class QueryPlannerSkipScanTest : public QueryPlannerTest {
+protected:
+    void setUp() final {
+        QueryPlannerTest::setUp();
+        addIndex(BSON("a" << 1 << "b" << 1), nullptr, "a_1_b_1");
+        params.numRecords = 1000;
+    }
+};
+
+TEST_F(QueryPlannerSkipScanTest, SkipScanOfferedForFewLeadingValues) {
+    params.collectionStats = makeCompoundIndexStatistics(5);
+
+    runQuery(fromjson("{b: {$gte: 5, $lt: 10}}"));
+
+    assertNumSolutions(2U);
+    assertSolutionExists("{cscan: {dir: 1}}");
+    assertSolutionExists(
+        "{fetch: {filter: {b: {$gte: 5, $lt: 10}}, node: {ixscan: {pattern: {a: 1, b: 1}, "
+        "bounds: {a: [['MinKey', 'MaxKey', true, true]], b: [[5, 10, true, false]]}}}}}");
+}
+
+TEST_F(QueryPlannerSkipScanTest, NoSkipScanForManyLeadingValues) {
+    params.collectionStats = makeCompoundIndexStatistics(500);
+
+    runQuery(fromjson("{b: 5}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists("{cscan: {dir: 1}}");
+}
+
+TEST_F(QueryPlannerSkipScanTest, NoSkipScanWithoutStatistics) {
+    runQuery(fromjson("{b: 5}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists("{cscan: {dir: 1}}");
+}
+
+TEST_F(QueryPlannerSkipScanTest, NoSkipScanWhenLeadingFieldIsConstrained) {
+    params.collectionStats = makeCompoundIndexStatistics(5);
+
+    runQuery(fromjson("{a: {$gt: 1}, b: 5}"));
+
+    assertNumSolutions(2U);
+    assertSolutionExists("{cscan: {dir: 1}}");
+    assertSolutionExists(
+        "{fetch: {filter: null, node: {ixscan: {pattern: {a: 1, b: 1}, "
+        "bounds: {a: [[1, Infinity, false, true]], b: [[5, 5, true, true]]}}}}}");
+}
+
+TEST_F(QueryPlannerSkipScanTest, SkipScanDoesNotPreventPruningOtherSolutions) {
+    addIndex(BSON("c" << 1), nullptr, "c_1");
+    addIndex(BSON("d" << 1), nullptr, "d_1");
+    ValueHistogram::Builder abBuilder(100);
+    ValueHistogram::Builder cBuilder(100);
+    ValueHistogram::Builder dBuilder(100);
+    for (int i = 0; i < 1000; ++i) {
+        abBuilder.addValue(BSON("" << i * 5 / 1000).firstElement());
+        cBuilder.addValue(BSON("" << i).firstElement());
+        dBuilder.addValue(BSON("" << 5).firstElement());
+    }
+    CollectionStatistics::IndexStatisticsMap indexStats;
+    indexStats["a_1_b_1"] = IndexStatistics{BSON("a" << 1 << "b" << 1), abBuilder.done()};
+    indexStats["c_1"] = IndexStatistics{BSON("c" << 1), cBuilder.done()};
+    indexStats["d_1"] = IndexStatistics{BSON("d" << 1), dBuilder.done()};
+    params.collectionStats = std::make_shared<CollectionStatistics>(1000, std::move(indexStats));
+
+    // The cost of the skip scan cannot be estimated, so it is kept, but the scan of {d: 1} is
+    // still pruned relative to the scan of {c: 1}.
+    runQuery(fromjson("{b: 5, c: 5, d: 5}"));
+
+    assertSolutionExists("{fetch: {node: {ixscan: {pattern: {a: 1, b: 1}}}}}");
+    assertSolutionExists("{fetch: {node: {ixscan: {pattern: {c: 1}}}}}");
+    ASSERT_EQ(0U, numSolutionMatches("{fetch: {node: {ixscan: {pattern: {d: 1}}}}}"));
+}
+
+TEST_F(QueryPlannerSkipScanTest, NoSkipScanWhenDisabled) {
+    const double oldRatio = internalQueryPlannerSkipScanMaxPrefixRatio.load();
+    ON_BLOCK_EXIT([oldRatio] { internalQueryPlannerSkipScanMaxPrefixRatio.store(oldRatio); });
+    internalQueryPlannerSkipScanMaxPrefixRatio.store(0.0);
+    params.collectionStats = makeCompoundIndexStatistics(5);
+
+    runQuery(fromjson("{b: 5}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists("{cscan: {dir: 1}}");
+}
+
+}  // namespace
@@ -3703,9 +3703,11 @@ TEST_F(QueryPlannerTest, IntersectCanBeVeryBig) {
 // Ensure that disabling AND_HASH intersection works properly.
 TEST_F(QueryPlannerTest, IntersectDisableAndHash) {
     bool oldEnableHashIntersection = internalQueryPlannerEnableHashIntersection.load();
+    bool oldEnableBitmapIntersection = internalQueryPlannerEnableBitmapIntersection.load();
 
-    // Turn index intersection on but disable hash-based intersection.
+    // Turn index intersection on but disable hash- and bitmap-based intersection.
     internalQueryPlannerEnableHashIntersection.store(false);
+    internalQueryPlannerEnableBitmapIntersection.store(false);
     params.options = QueryPlannerParams::NO_TABLE_SCAN | QueryPlannerParams::INDEX_INTERSECTION;
 
     addIndex(BSON("a" << 1));
@@ -3732,6 +3734,44 @@ TEST_F(QueryPlannerTest, IntersectDisableAndHash) {
 
     // Restore the old value of the has intersection switch.
     internalQueryPlannerEnableHashIntersection.store(oldEnableHashIntersection);
+    internalQueryPlannerEnableBitmapIntersection.store(oldEnableBitmapIntersection);
+}
+
+// Ensure that AND_BITMAP takes the place of AND_HASH when hash-based intersection is disabled.
+TEST_F(QueryPlannerTest, IntersectAndBitmapWhenAndHashDisabled) {
+    bool oldEnableHashIntersection = internalQueryPlannerEnableHashIntersection.load();
+    bool oldEnableBitmapIntersection = internalQueryPlannerEnableBitmapIntersection.load();
+    internalQueryPlannerEnableHashIntersection.store(false);
+    internalQueryPlannerEnableBitmapIntersection.store(true);
+    params.options = QueryPlannerParams::NO_TABLE_SCAN | QueryPlannerParams::INDEX_INTERSECTION;
+
+    addIndex(BSON("a" << 1));
+    addIndex(BSON("b" << 1));
+
+    runQuery(fromjson("{a: {$gt: 1}, b: {$lt: 5}}"));
+
+    assertSolutionExists(
+        "{fetch: {filter: {a: {$gt: 1}, b: {$lt: 5}}, node: {andBitmap: {nodes: ["
+        "{ixscan: {filter: null, pattern: {a: 1}}},"
+        "{ixscan: {filter: null, pattern: {b: 1}}}]}}}}");
+
+    internalQueryPlannerEnableHashIntersection.store(oldEnableHashIntersection);
+    internalQueryPlannerEnableBitmapIntersection.store(oldEnableBitmapIntersection);
+}
+
+// Ensure that AND_BITMAP is not used unless it is enabled.
+TEST_F(QueryPlannerTest, IntersectAndBitmapDisabledByDefault) {
+    ASSERT_FALSE(internalQueryPlannerEnableBitmapIntersection.load());
+    params.options = QueryPlannerParams::NO_TABLE_SCAN | QueryPlannerParams::INDEX_INTERSECTION;
+
+    addIndex(BSON("a" << 1));
+    addIndex(BSON("b" << 1));
+
+    runQuery(fromjson("{a: {$gt: 1}, b: {$lt: 5}}"));
+
+    assertNumSolutions(2U);
+    assertSolutionExists("{fetch: {filter: {b: {$lt: 5}}, node: {ixscan: {pattern: {a: 1}}}}}");
+    assertSolutionExists("{fetch: {filter: {a: {$gt: 1}}, node: {ixscan: {pattern: {b: 1}}}}}");
 }
 
 //
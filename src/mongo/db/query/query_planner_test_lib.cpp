@@ -545,6 +545,16 @@ bool QueryPlannerTestLib::solutionMatches(const BSONObj& testSoln,
         }
 
         return childrenMatch(andHashObj, ahn, relaxBoundsCheck);
+    } else if (STAGE_AND_BITMAP == trueSoln->getType()) {
+        const AndBitmapNode* abn = static_cast<const AndBitmapNode*>(trueSoln);
+        BSONElement el = testSoln["andBitmap"];
+        if (el.eoo() || !el.isABSONObj()) {
+            return false;
+        }
+        BSONObj andBitmapObj = el.Obj();
+        invariant(bsonObjFieldsAreInSet(andBitmapObj, {"nodes"}));
+
+        return childrenMatch(andBitmapObj, abn, relaxBoundsCheck);
     } else if (STAGE_AND_SORTED == trueSoln->getType()) {
         const AndSortedNode* asn = static_cast<const AndSortedNode*>(trueSoln);
         BSONElement el = testSoln["andSorted"];
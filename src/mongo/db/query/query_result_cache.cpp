@@ -0,0 +1,192 @@
+
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/query_result_cache.h"
+
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+AtomicWord<long long> QueryResultCache::_numEnabled;
+AtomicWord<long long> QueryResultCache::_totalBytesUsed;
+
+QueryResultCache::~QueryResultCache() {
+    if (_enabled) {
+        _numEnabled.subtractAndFetch(1);
+    }
+    _totalBytesUsed.subtractAndFetch(static_cast<long long>(_bytesUsed));
+}
+
+bool QueryResultCache::anyEnabled() {
+    return _numEnabled.load() > 0;
+}
+
+long long QueryResultCache::getTotalBytesUsed() {
+    return _totalBytesUsed.load();
+}
+
+bool QueryResultCache::isEnabled() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _enabled;
+}
+
+void QueryResultCache::setEnabled(bool enabled) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (enabled == _enabled) {
+        return;
+    }
+
+    _enabled = enabled;
+    if (enabled) {
+        _numEnabled.addAndFetch(1);
+    } else {
+        _numEnabled.subtractAndFetch(1);
+        ++_generation;
+        clear_inlock();
+    }
+}
+
+std::uint64_t QueryResultCache::getGeneration() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _generation;
+}
+
+std::shared_ptr<const QueryResultCache::Results> QueryResultCache::get(const std::string& key) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto it = _entriesByKey.find(key);
+    if (it == _entriesByKey.end()) {
+        ++_misses;
+        return nullptr;
+    }
+
+    ++_hits;
+    _entries.splice(_entries.begin(), _entries, it->second);
+    return it->second->results;
+}
+
+bool QueryResultCache::contains(const std::string& key) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _entriesByKey.count(key) > 0;
+}
+
+bool QueryResultCache::add(const std::string& key,
+                           std::uint64_t generation,
+                           Results results,
+                           std::size_t maxBytes,
+                           std::size_t maxTotalBytes,
+                           std::size_t* numEvicted) {
+    *numEvicted = 0;
+
+    std::size_t bytes = key.size();
+    for (auto&& result : results) {
+        invariant(result.isOwned());
+        bytes += result.objsize();
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (!_enabled || generation != _generation || bytes > maxBytes) {
+        return false;
+    }
+
+    // A concurrent query of the same shape may have cached its results first. They were read at
+    // the same generation, so keep them.
+    if (_entriesByKey.count(key)) {
+        return false;
+    }
+
+    // Evicting only makes room in the shared budget up to the bytes this cache holds, so results
+    // which would not fit even then are refused without discarding anything.
+    const long long otherCachesBytes =
+        _totalBytesUsed.load() - static_cast<long long>(_bytesUsed);
+    if (otherCachesBytes + static_cast<long long>(bytes) > static_cast<long long>(maxTotalBytes)) {
+        return false;
+    }
+
+    while (!_entries.empty() &&
+           (_bytesUsed + bytes > maxBytes ||
+            _totalBytesUsed.load() + static_cast<long long>(bytes) >
+                static_cast<long long>(maxTotalBytes))) {
+        evictOne_inlock();
+        ++*numEvicted;
+    }
+    _evictions += *numEvicted;
+
+    // Another cache may have taken the room in the meantime.
+    if (_totalBytesUsed.addAndFetch(bytes) > static_cast<long long>(maxTotalBytes)) {
+        _totalBytesUsed.subtractAndFetch(bytes);
+        return false;
+    }
+
+    _entries.push_front(Entry{key, std::make_shared<const Results>(std::move(results)), bytes});
+    _entriesByKey.emplace(key, _entries.begin());
+    _bytesUsed += bytes;
+    ++_inserts;
+    return true;
+}
+
+void QueryResultCache::invalidate() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    ++_generation;
+    ++_invalidations;
+    clear_inlock();
+}
+
+QueryResultCache::Stats QueryResultCache::getStats() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    Stats stats;
+    stats.enabled = _enabled;
+    stats.numEntries = static_cast<long long>(_entries.size());
+    stats.bytesUsed = static_cast<long long>(_bytesUsed);
+    stats.hits = _hits;
+    stats.misses = _misses;
+    stats.inserts = _inserts;
+    stats.evictions = _evictions;
+    stats.invalidations = _invalidations;
+    return stats;
+}
+
+void QueryResultCache::evictOne_inlock() {
+    const Entry& lru = _entries.back();
+    _bytesUsed -= lru.bytes;
+    _totalBytesUsed.subtractAndFetch(static_cast<long long>(lru.bytes));
+    _entriesByKey.erase(lru.key);
+    _entries.pop_back();
+}
+
+void QueryResultCache::clear_inlock() {
+    _entriesByKey.clear();
+    _entries.clear();
+    _totalBytesUsed.subtractAndFetch(static_cast<long long>(_bytesUsed));
+    _bytesUsed = 0;
+}
+
+}  // namespace mongo
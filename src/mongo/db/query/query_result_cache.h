@@ -0,0 +1,184 @@
+
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/unordered_map.h"
+
+namespace mongo {
+
+/**
+ * Caches the complete results of queries over a single collection, for collections which are read
+ * far more often than they are written. Each entry maps a key describing a query to the documents
+ * it returned. The entries are kept within a byte budget by evicting the least recently used.
+ *
+ * Any write to the collection must invalidate the whole cache. A query which runs concurrently
+ * with a write could otherwise cache a result read before the write, so the caller reads the
+ * cache's generation before it executes the query and hands it to add(), which refuses the
+ * result if the cache has been invalidated in the meantime.
+ *
+ * Besides its own byte budget, each cache counts its entries against a budget shared by the
+ * caches of every collection. A cache can only evict its own entries, so results which would take
+ * the total over the shared budget are refused once that cache has no entry left to evict.
+ *
+ * The cache is disabled until enabled for its collection, and a disabled cache holds no entries.
+ * All methods are thread-safe.
+ */
+class QueryResultCache {
+    MONGO_DISALLOW_COPYING(QueryResultCache);
+
+public:
+    using Results = std::vector<BSONObj>;
+
+    struct Stats {
+        bool enabled = false;
+        long long numEntries = 0;
+        long long bytesUsed = 0;
+        long long hits = 0;
+        long long misses = 0;
+        long long inserts = 0;
+        long long evictions = 0;
+        long long invalidations = 0;
+    };
+
+    QueryResultCache() = default;
+
+    ~QueryResultCache();
+
+    /**
+     * Returns whether the result cache of any collection is enabled. Writers check this before
+     * looking up the cache of the collection they write.
+     */
+    static bool anyEnabled();
+
+    /**
+     * Returns the bytes used by the result caches of every collection together.
+     */
+    static long long getTotalBytesUsed();
+
+    bool isEnabled() const;
+
+    /**
+     * Enables or disables the cache. Disabling it discards every entry.
+     */
+    void setEnabled(bool enabled);
+
+    /**
+     * Returns the number of times the cache has been invalidated. Read before executing a query
+     * whose results are to be passed to add().
+     */
+    std::uint64_t getGeneration() const;
+
+    /**
+     * Returns the results cached for 'key' and marks them most recently used, or nullptr if there
+     * are none.
+     */
+    std::shared_ptr<const Results> get(const std::string& key);
+
+    /**
+     * Returns whether results are cached for 'key', without counting a hit or a miss or marking
+     * them used.
+     */
+    bool contains(const std::string& key) const;
+
+    /**
+     * Caches 'results', whose documents must be owned, under 'key', unless the cache is disabled
+     * or has been invalidated since 'generation' was read. Evicts the least recently used entries
+     * until all of them fit within 'maxBytes', and the entries of every cache fit within
+     * 'maxTotalBytes'. Refuses results which do not fit even after evicting every entry.
+     *
+     * Returns whether the results were cached, and the number of entries evicted to make room
+     * for them in 'numEvicted'.
+     */
+    bool add(const std::string& key,
+             std::uint64_t generation,
+             Results results,
+             std::size_t maxBytes,
+             std::size_t maxTotalBytes,
+             std::size_t* numEvicted);
+
+    /**
+     * Discards every entry, and refuses results read before this call.
+     */
+    void invalidate();
+
+    Stats getStats() const;
+
+private:
+    struct Entry {
+        std::string key;
+        std::shared_ptr<const Results> results;
+        std::size_t bytes;
+    };
+
+    using EntryList = std::list<Entry>;
+
+    void clear_inlock();
+
+    /**
+     * Discards the least recently used entry.
+     */
+    void evictOne_inlock();
+
+    // The number of enabled caches, across every collection.
+    static AtomicWord<long long> _numEnabled;
+
+    // The bytes used by the caches of every collection.
+    static AtomicWord<long long> _totalBytesUsed;
+
+    mutable stdx::mutex _mutex;
+
+    bool _enabled = false;
+    std::uint64_t _generation = 0;
+
+    // Entries from the most to the least recently used, and an index of them by key.
+    EntryList _entries;
+    stdx::unordered_map<std::string, EntryList::iterator> _entriesByKey;
+    std::size_t _bytesUsed = 0;
+
+    long long _hits = 0;
+    long long _misses = 0;
+    long long _inserts = 0;
+    long long _evictions = 0;
+    long long _invalidations = 0;
+};
+
+}  // namespace mongo
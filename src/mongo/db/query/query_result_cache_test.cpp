@@ -0,0 +1,243 @@
+
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/query_result_cache.h"
+
+#include "mongo/db/jsobj.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const std::size_t kUnbounded = 1024 * 1024;
+
+QueryResultCache::Results makeResults(int first, int last) {
+    QueryResultCache::Results results;
+    for (int i = first; i <= last; ++i) {
+        results.push_back(BSON("_id" << i));
+    }
+    return results;
+}
+
+std::size_t resultsBytes(const std::string& key, const QueryResultCache::Results& results) {
+    std::size_t bytes = key.size();
+    for (auto&& result : results) {
+        bytes += result.objsize();
+    }
+    return bytes;
+}
+
+TEST(QueryResultCacheTest, DisabledCacheDoesNotCacheResults) {
+    QueryResultCache cache;
+    std::size_t numEvicted;
+
+    ASSERT_FALSE(cache.add(
+        "q", cache.getGeneration(), makeResults(0, 2), kUnbounded, kUnbounded, &numEvicted));
+    ASSERT_FALSE(cache.get("q"));
+    ASSERT_EQ(cache.getStats().numEntries, 0);
+}
+
+TEST(QueryResultCacheTest, ReturnsCachedResults) {
+    QueryResultCache cache;
+    cache.setEnabled(true);
+    std::size_t numEvicted;
+
+    ASSERT_FALSE(cache.get("q"));
+    ASSERT_TRUE(cache.add(
+        "q", cache.getGeneration(), makeResults(0, 2), kUnbounded, kUnbounded, &numEvicted));
+    ASSERT_EQ(numEvicted, 0U);
+    ASSERT_TRUE(cache.contains("q"));
+
+    auto results = cache.get("q");
+    ASSERT(results);
+    ASSERT_EQ(results->size(), 3U);
+    ASSERT_BSONOBJ_EQ((*results)[2], BSON("_id" << 2));
+    ASSERT_FALSE(cache.get("other"));
+
+    auto stats = cache.getStats();
+    ASSERT_EQ(stats.numEntries, 1);
+    ASSERT_EQ(stats.hits, 1);
+    ASSERT_EQ(stats.misses, 2);
+    ASSERT_EQ(stats.inserts, 1);
+}
+
+TEST(QueryResultCacheTest, InvalidateDiscardsEntries) {
+    QueryResultCache cache;
+    cache.setEnabled(true);
+    std::size_t numEvicted;
+
+    ASSERT_TRUE(cache.add(
+        "q", cache.getGeneration(), makeResults(0, 2), kUnbounded, kUnbounded, &numEvicted));
+    cache.invalidate();
+
+    ASSERT_FALSE(cache.get("q"));
+    auto stats = cache.getStats();
+    ASSERT_EQ(stats.numEntries, 0);
+    ASSERT_EQ(stats.bytesUsed, 0);
+    ASSERT_EQ(stats.invalidations, 1);
+}
+
+TEST(QueryResultCacheTest, RefusesResultsReadBeforeAnInvalidation) {
+    QueryResultCache cache;
+    cache.setEnabled(true);
+    std::size_t numEvicted;
+
+    const auto generation = cache.getGeneration();
+    cache.invalidate();
+    ASSERT_FALSE(cache.add(
+        "q", generation, makeResults(0, 2), kUnbounded, kUnbounded, &numEvicted));
+    ASSERT_FALSE(cache.get("q"));
+
+    ASSERT_TRUE(cache.add(
+        "q", cache.getGeneration(), makeResults(0, 2), kUnbounded, kUnbounded, &numEvicted));
+    ASSERT(cache.get("q"));
+}
+
+TEST(QueryResultCacheTest, EvictsLeastRecentlyUsedEntries) {
+    QueryResultCache cache;
+    cache.setEnabled(true);
+    std::size_t numEvicted;
+
+    // Room for exactly two entries of the same size.
+    const std::size_t maxBytes = 2 * resultsBytes("a", makeResults(0, 9));
+    ASSERT_TRUE(cache.add(
+        "a", cache.getGeneration(), makeResults(0, 9), maxBytes, kUnbounded, &numEvicted));
+    ASSERT_TRUE(cache.add(
+        "b", cache.getGeneration(), makeResults(0, 9), maxBytes, kUnbounded, &numEvicted));
+    ASSERT_EQ(numEvicted, 0U);
+
+    // Using "a" leaves "b" as the least recently used.
+    ASSERT(cache.get("a"));
+    ASSERT_TRUE(cache.add(
+        "c", cache.getGeneration(), makeResults(0, 9), maxBytes, kUnbounded, &numEvicted));
+    ASSERT_EQ(numEvicted, 1U);
+
+    ASSERT(cache.get("a"));
+    ASSERT_FALSE(cache.get("b"));
+    ASSERT(cache.get("c"));
+
+    auto stats = cache.getStats();
+    ASSERT_EQ(stats.numEntries, 2);
+    ASSERT_EQ(stats.bytesUsed, static_cast<long long>(maxBytes));
+    ASSERT_EQ(stats.evictions, 1);
+}
+
+TEST(QueryResultCacheTest, RefusesResultsLargerThanTheBudget) {
+    QueryResultCache cache;
+    cache.setEnabled(true);
+    std::size_t numEvicted;
+
+    const std::size_t maxBytes = resultsBytes("a", makeResults(0, 9));
+    ASSERT_TRUE(cache.add(
+        "a", cache.getGeneration(), makeResults(0, 9), maxBytes, kUnbounded, &numEvicted));
+    ASSERT_FALSE(cache.add(
+        "b", cache.getGeneration(), makeResults(0, 10), maxBytes, kUnbounded, &numEvicted));
+
+    // The refused results did not displace the cached ones.
+    ASSERT(cache.get("a"));
+    ASSERT_EQ(cache.getStats().evictions, 0);
+}
+
+TEST(QueryResultCacheTest, DisablingDiscardsEntries) {
+    QueryResultCache cache;
+    cache.setEnabled(true);
+    ASSERT_TRUE(QueryResultCache::anyEnabled());
+    std::size_t numEvicted;
+
+    const auto generation = cache.getGeneration();
+    ASSERT_TRUE(cache.add("q", generation, makeResults(0, 2), kUnbounded, kUnbounded, &numEvicted));
+    cache.setEnabled(false);
+    ASSERT_FALSE(QueryResultCache::anyEnabled());
+    ASSERT_FALSE(cache.get("q"));
+
+    // Results read while the cache was enabled are refused once it is enabled again.
+    cache.setEnabled(true);
+    ASSERT_FALSE(cache.add(
+        "q", generation, makeResults(0, 2), kUnbounded, kUnbounded, &numEvicted));
+}
+
+TEST(QueryResultCacheTest, CachesOfAllCollectionsShareTotalBudget) {
+    QueryResultCache first;
+    QueryResultCache second;
+    first.setEnabled(true);
+    second.setEnabled(true);
+    std::size_t numEvicted;
+
+    // Room for exactly two entries of the same size across both caches.
+    const std::size_t entryBytes = resultsBytes("a", makeResults(0, 9));
+    const std::size_t maxTotalBytes = 2 * entryBytes;
+    ASSERT_TRUE(first.add(
+        "a", first.getGeneration(), makeResults(0, 9), kUnbounded, maxTotalBytes, &numEvicted));
+    ASSERT_TRUE(second.add(
+        "a", second.getGeneration(), makeResults(0, 9), kUnbounded, maxTotalBytes, &numEvicted));
+    ASSERT_EQ(QueryResultCache::getTotalBytesUsed(), static_cast<long long>(maxTotalBytes));
+
+    // A cache makes room in the shared budget by evicting its own entries.
+    ASSERT_TRUE(first.add(
+        "b", first.getGeneration(), makeResults(0, 9), kUnbounded, maxTotalBytes, &numEvicted));
+    ASSERT_EQ(numEvicted, 1U);
+    ASSERT_FALSE(first.get("a"));
+    ASSERT(first.get("b"));
+    ASSERT(second.get("a"));
+
+    // Results which would not fit even after evicting its own entries are refused, and the
+    // entries stay.
+    ASSERT_FALSE(first.add(
+        "c", first.getGeneration(), makeResults(0, 19), kUnbounded, maxTotalBytes, &numEvicted));
+    ASSERT_EQ(numEvicted, 0U);
+    ASSERT(first.get("b"));
+    ASSERT_EQ(QueryResultCache::getTotalBytesUsed(), static_cast<long long>(maxTotalBytes));
+}
+
+TEST(QueryResultCacheTest, TotalBytesUsedIsReleased) {
+    std::size_t numEvicted;
+    {
+        QueryResultCache cache;
+        cache.setEnabled(true);
+        ASSERT_TRUE(cache.add(
+            "a", cache.getGeneration(), makeResults(0, 9), kUnbounded, kUnbounded, &numEvicted));
+        ASSERT_TRUE(cache.add(
+            "b", cache.getGeneration(), makeResults(0, 9), kUnbounded, kUnbounded, &numEvicted));
+        ASSERT_EQ(QueryResultCache::getTotalBytesUsed(), cache.getStats().bytesUsed);
+
+        cache.invalidate();
+        ASSERT_EQ(QueryResultCache::getTotalBytesUsed(), 0);
+
+        ASSERT_TRUE(cache.add(
+            "a", cache.getGeneration(), makeResults(0, 9), kUnbounded, kUnbounded, &numEvicted));
+        ASSERT_GT(QueryResultCache::getTotalBytesUsed(), 0);
+    }
+    ASSERT_EQ(QueryResultCache::getTotalBytesUsed(), 0);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -309,6 +309,34 @@ QuerySolutionNode* AndHashNode::clone() const {
     return copy;
 }
 
+//
+// AndBitmapNode
+//
+
+AndBitmapNode::AndBitmapNode() : _sort(SimpleBSONObjComparator::kInstance.makeBSONObjSet()) {}
+
+AndBitmapNode::~AndBitmapNode() {}
+
+void AndBitmapNode::appendToString(mongoutils::str::stream* ss, int indent) const {
+    addIndent(ss, indent);
+    *ss << "AND_BITMAP\n";
+    addCommon(ss, indent);
+    for (size_t i = 0; i < children.size(); ++i) {
+        addIndent(ss, indent + 1);
+        *ss << "Child " << i << ":\n";
+        children[i]->appendToString(ss, indent + 1);
+    }
+}
+
+QuerySolutionNode* AndBitmapNode::clone() const {
+    AndBitmapNode* copy = new AndBitmapNode();
+    cloneBaseData(copy);
+
+    copy->_sort = this->_sort;
+
+    return copy;
+}
+
 //
 // AndSortedNode
 //
@@ -536,6 +564,10 @@ void IndexScanNode::appendToString(mongoutils::str::stream* ss, int indent) cons
     }
     addIndent(ss, indent + 1);
     *ss << "direction = " << direction << '\n';
+    if (isSkipScan) {
+        addIndent(ss, indent + 1);
+        *ss << "skipScan = true\n";
+    }
     addIndent(ss, indent + 1);
     *ss << "bounds = " << bounds.toString() << '\n';
     addCommon(ss, indent);
@@ -823,7 +855,10 @@ QuerySolutionNode* IndexScanNode::clone() const {
     copy->direction = this->direction;
     copy->addKeyMetadata = this->addKeyMetadata;
     copy->bounds = this->bounds;
+    copy->shouldDedup = this->shouldDedup;
     copy->queryCollator = this->queryCollator;
+    copy->estimatedKeysExamined = this->estimatedKeysExamined;
+    copy->isSkipScan = this->isSkipScan;
 
     return copy;
 }
@@ -1118,6 +1153,10 @@ void DistinctNode::appendToString(mongoutils::str::stream* ss, int indent) const
     *ss << "direction = " << direction << '\n';
     addIndent(ss, indent + 1);
     *ss << "bounds = " << bounds.toString() << '\n';
+    if (NULL != filter) {
+        addIndent(ss, indent + 1);
+        *ss << "filter = " << filter->toString();
+    }
 }
 
 QuerySolutionNode* DistinctNode::clone() const {
@@ -1156,6 +1195,10 @@ void CountScanNode::appendToString(mongoutils::str::stream* ss, int indent) cons
     *ss << "startKey = " << startKey << '\n';
     addIndent(ss, indent + 1);
     *ss << "endKey = " << endKey << '\n';
+    if (NULL != filter) {
+        addIndent(ss, indent + 1);
+        *ss << "filter = " << filter->toString();
+    }
 }
 
 QuerySolutionNode* CountScanNode::clone() const {
@@ -30,6 +30,7 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
 #include <memory>
 
 #include "mongo/bson/bsonobj_comparator_interface.h"
@@ -349,6 +350,35 @@ struct AndHashNode : public QuerySolutionNode {
     BSONObjSet _sort;
 };
 
+struct AndBitmapNode : public QuerySolutionNode {
+    AndBitmapNode();
+    virtual ~AndBitmapNode();
+
+    virtual StageType getType() const {
+        return STAGE_AND_BITMAP;
+    }
+
+    virtual void appendToString(mongoutils::str::stream* ss, int indent) const;
+
+    // Only record ids are output, so nothing the children provide survives the intersection.
+    bool fetched() const {
+        return false;
+    }
+    bool hasField(const std::string& field) const {
+        return false;
+    }
+    bool sortedByDiskLoc() const {
+        return true;
+    }
+    const BSONObjSet& getSort() const {
+        return _sort;
+    }
+
+    QuerySolutionNode* clone() const;
+
+    BSONObjSet _sort;
+};
+
 struct AndSortedNode : public QuerySolutionNode {
     AndSortedNode();
     virtual ~AndSortedNode();
@@ -518,6 +548,14 @@ struct IndexScanNode : public QuerySolutionNode {
     //
     // The correct set of paths is computed and stored here by computeProperties().
     std::set<StringData> multikeyFields;
+
+    // The number of keys this scan is expected to examine, if the collection has statistics
+    // from which to estimate it.
+    boost::optional<double> estimatedKeysExamined;
+
+    // True if the scan leaves the leading field of the index unconstrained, relying on the bounds
+    // checker to seek from each of its values to the bounds on the following fields.
+    bool isSkipScan = false;
 };
 
 struct ProjectionNode : public QuerySolutionNode {
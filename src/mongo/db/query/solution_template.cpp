@@ -0,0 +1,286 @@
+
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/solution_template.h"
+
+#include <map>
+
+#include "mongo/bson/simple_bsonobj_comparator.h"
+#include "mongo/db/matcher/expression_leaf.h"
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/index_bounds_builder.h"
+#include "mongo/db/query/query_planner_params.h"
+#include "mongo/db/query/query_solution.h"
+#include "mongo/stdx/memory.h"
+
+namespace mongo {
+
+namespace {
+
+using EqualityConstants = std::map<std::string, BSONElement>;
+
+/**
+ * Returns true if 'value' is a constant which the planner turns into a single point interval
+ * and nothing else.
+ */
+bool isRebindableConstant(const BSONElement& value) {
+    switch (value.type()) {
+        case NumberInt:
+        case NumberLong:
+        case NumberDouble:
+        case NumberDecimal:
+        case String:
+        case Date:
+        case jstOID:
+        case Bool:
+        case bsonTimestamp:
+        case BinData:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * Returns the constants of the equality predicates of 'query', keyed by path, or boost::none if
+ * the query is not a conjunction of equalities to rebindable constants on distinct paths, or has
+ * anything else which the planner would bake into its solutions.
+ */
+boost::optional<EqualityConstants> getEqualityConstants(const CanonicalQuery& query) {
+    const QueryRequest& qr = query.getQueryRequest();
+    if (query.getProj() || query.getCollator() || qr.getSkip() || qr.getLimit() ||
+        qr.getNToReturn() || qr.returnKey() || qr.showRecordId()) {
+        return boost::none;
+    }
+
+    std::vector<const MatchExpression*> predicates;
+    const MatchExpression* root = query.root();
+    if (MatchExpression::AND == root->matchType()) {
+        for (size_t i = 0; i < root->numChildren(); ++i) {
+            predicates.push_back(root->getChild(i));
+        }
+    } else {
+        predicates.push_back(root);
+    }
+
+    EqualityConstants constants;
+    for (auto&& predicate : predicates) {
+        if (MatchExpression::EQ != predicate->matchType()) {
+            return boost::none;
+        }
+        auto eq = static_cast<const EqualityMatchExpression*>(predicate);
+        if (!isRebindableConstant(eq->getData()) ||
+            !constants.emplace(eq->path().toString(), eq->getData()).second) {
+            return boost::none;
+        }
+    }
+    return constants;
+}
+
+bool isFullRange(const Interval& interval) {
+    return interval.isMinToMax() ||
+        (interval.start.type() == MaxKey && interval.end.type() == MinKey);
+}
+
+/**
+ * Returns true if the constants of the query appear in the tree rooted at 'node' only as single
+ * point bounds of plain btree index scans, adding the paths so bound to 'boundPaths'.
+ */
+bool collectBoundPaths(const QuerySolutionNode* node,
+                       const EqualityConstants& constants,
+                       std::set<std::string>* boundPaths) {
+    if (node->filter) {
+        return false;
+    }
+
+    switch (node->getType()) {
+        case STAGE_IXSCAN: {
+            auto ixn = static_cast<const IndexScanNode*>(node);
+            if (INDEX_BTREE != ixn->index.type || ixn->index.filterExpr || ixn->index.collator ||
+                ixn->bounds.isSimpleRange) {
+                return false;
+            }
+            for (auto&& oil : ixn->bounds.fields) {
+                if (oil.intervals.size() != 1) {
+                    return false;
+                }
+                const Interval& interval = oil.intervals[0];
+                if (isFullRange(interval)) {
+                    continue;
+                }
+                auto constant = constants.find(oil.name);
+                if (!interval.isPoint() || constant == constants.end() ||
+                    interval.start.woCompare(constant->second, false) != 0) {
+                    return false;
+                }
+                boundPaths->insert(oil.name);
+            }
+            break;
+        }
+        case STAGE_COLLSCAN:
+        case STAGE_FETCH:
+        case STAGE_SHARDING_FILTER:
+        case STAGE_AND_BITMAP:
+        case STAGE_AND_HASH:
+        case STAGE_AND_SORTED:
+        case STAGE_SORT:
+        case STAGE_SORT_KEY_GENERATOR:
+        case STAGE_ENSURE_SORTED:
+            break;
+        default:
+            return false;
+    }
+
+    for (auto&& child : node->children) {
+        if (!collectBoundPaths(child, constants, boundPaths)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Replaces the point bounds on the equality paths of the index scans in the tree rooted at
+ * 'node' with points on the corresponding values of 'constants'.
+ */
+void rebindPointBounds(QuerySolutionNode* node, const EqualityConstants& constants) {
+    if (STAGE_IXSCAN == node->getType()) {
+        auto ixn = static_cast<IndexScanNode*>(node);
+        for (auto&& oil : ixn->bounds.fields) {
+            auto constant = constants.find(oil.name);
+            if (constant != constants.end() && oil.intervals[0].isPoint()) {
+                oil.intervals[0] = IndexBoundsBuilder::makePointInterval(constant->second.wrap());
+            }
+        }
+    }
+
+    for (auto&& child : node->children) {
+        rebindPointBounds(child, constants);
+    }
+}
+
+}  // namespace
+
+SolutionTemplate::IndexState::IndexState(const IndexEntry& entry)
+    : identifier(entry.identifier),
+      keyPattern(entry.keyPattern.getOwned()),
+      multikey(entry.multikey),
+      multikeyPaths(entry.multikeyPaths),
+      multikeyPathSet(entry.multikeyPathSet) {}
+
+bool SolutionTemplate::IndexState::matches(const IndexEntry& entry) const {
+    return identifier == entry.identifier && multikey == entry.multikey &&
+        multikeyPaths == entry.multikeyPaths && multikeyPathSet == entry.multikeyPathSet &&
+        SimpleBSONObjComparator::kInstance.evaluate(keyPattern == entry.keyPattern);
+}
+
+SolutionTemplate::SolutionTemplate(std::unique_ptr<QuerySolutionNode> root,
+                                   bool hasBlockingStage,
+                                   size_t plannerOptions,
+                                   BSONObj shardKey,
+                                   std::vector<IndexState> indexes,
+                                   std::set<std::string> boundPaths)
+    : _root(std::move(root)),
+      _hasBlockingStage(hasBlockingStage),
+      _plannerOptions(plannerOptions),
+      _shardKey(std::move(shardKey)),
+      _indexes(std::move(indexes)),
+      _boundPaths(std::move(boundPaths)) {}
+
+SolutionTemplate::~SolutionTemplate() = default;
+
+std::unique_ptr<SolutionTemplate> SolutionTemplate::make(const CanonicalQuery& query,
+                                                         const QueryPlannerParams& params,
+                                                         const QuerySolution& soln) {
+    // Index filters and collection statistics make the planner's choice depend on more than the
+    // shape of the query.
+    if (params.indexFiltersApplied || params.collectionStats || !soln.root) {
+        return nullptr;
+    }
+
+    auto constants = getEqualityConstants(query);
+    if (!constants) {
+        return nullptr;
+    }
+
+    std::set<std::string> boundPaths;
+    if (!collectBoundPaths(soln.root.get(), *constants, &boundPaths) ||
+        boundPaths.size() != constants->size()) {
+        return nullptr;
+    }
+
+    std::vector<IndexState> indexes;
+    for (auto&& entry : params.indices) {
+        indexes.emplace_back(entry);
+    }
+
+    return std::unique_ptr<SolutionTemplate>(
+        new SolutionTemplate(std::unique_ptr<QuerySolutionNode>(soln.root->clone()),
+                             soln.hasBlockingStage,
+                             params.options,
+                             params.shardKey.getOwned(),
+                             std::move(indexes),
+                             std::move(boundPaths)));
+}
+
+std::unique_ptr<QuerySolution> SolutionTemplate::instantiate(
+    const CanonicalQuery& query, const QueryPlannerParams& params) const {
+    if (params.options != _plannerOptions || params.indexFiltersApplied ||
+        params.collectionStats ||
+        SimpleBSONObjComparator::kInstance.evaluate(params.shardKey != _shardKey) ||
+        params.indices.size() != _indexes.size()) {
+        return nullptr;
+    }
+    for (size_t i = 0; i < _indexes.size(); ++i) {
+        if (!_indexes[i].matches(params.indices[i])) {
+            return nullptr;
+        }
+    }
+
+    auto constants = getEqualityConstants(query);
+    if (!constants || constants->size() != _boundPaths.size()) {
+        return nullptr;
+    }
+    for (auto&& constant : *constants) {
+        if (!_boundPaths.count(constant.first)) {
+            return nullptr;
+        }
+    }
+
+    auto soln = stdx::make_unique<QuerySolution>();
+    soln->root.reset(_root->clone());
+    soln->hasBlockingStage = _hasBlockingStage;
+    rebindPointBounds(soln->root.get(), *constants);
+    return soln;
+}
+
+}  // namespace mongo
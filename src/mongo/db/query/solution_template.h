@@ -0,0 +1,121 @@
+
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/query/index_entry.h"
+
+namespace mongo {
+
+class CanonicalQuery;
+struct QueryPlannerParams;
+struct QuerySolution;
+struct QuerySolutionNode;
+
+/**
+ * A query solution stripped of the constants of the query it was planned for, so that it can be
+ * reused for later queries of the same shape without planning them.
+ *
+ * Only the simplest queries qualify: a conjunction of equalities to scalar constants on distinct
+ * paths, with no projection, skip or limit, for which the planner produced a single solution
+ * that answers every predicate with point bounds on non-partial, non-collated btree indexes. The
+ * constants then appear nowhere in the solution but in those point bounds, and the planner
+ * would reach the same solution for any other constants. Instantiating the template rebinds the
+ * point bounds to the constants of the new query.
+ *
+ * The solution also depends on which paths of the indexes are multikey, through the bounds and
+ * deduplication of its index scans, so a template is only instantiated while the indexes are
+ * exactly those it was planned with, in the same multikey state.
+ */
+class SolutionTemplate {
+public:
+    /**
+     * Returns a template built from 'soln', which the planner produced as the only solution for
+     * 'query' given 'params', or nullptr if the query or solution does not qualify.
+     */
+    static std::unique_ptr<SolutionTemplate> make(const CanonicalQuery& query,
+                                                  const QueryPlannerParams& params,
+                                                  const QuerySolution& soln);
+
+    ~SolutionTemplate();
+
+    /**
+     * Returns the solution for 'query', a query of the shape this template was built for, or
+     * nullptr if the template cannot be used for it with 'params'.
+     */
+    std::unique_ptr<QuerySolution> instantiate(const CanonicalQuery& query,
+                                               const QueryPlannerParams& params) const;
+
+private:
+    /**
+     * The parts of an index entry which the planner's solution depends on, besides the index
+     * type and options which the index name and key pattern already determine.
+     */
+    struct IndexState {
+        explicit IndexState(const IndexEntry& entry);
+
+        bool matches(const IndexEntry& entry) const;
+
+        IndexEntry::Identifier identifier;
+        BSONObj keyPattern;
+        bool multikey;
+        MultikeyPaths multikeyPaths;
+        std::set<FieldRef> multikeyPathSet;
+    };
+
+    SolutionTemplate(std::unique_ptr<QuerySolutionNode> root,
+                     bool hasBlockingStage,
+                     size_t plannerOptions,
+                     BSONObj shardKey,
+                     std::vector<IndexState> indexes,
+                     std::set<std::string> boundPaths);
+
+    std::unique_ptr<QuerySolutionNode> _root;
+    const bool _hasBlockingStage;
+
+    // The planner options and shard key the solution was planned with. The solution is only
+    // reused when planning would have the same inputs.
+    const size_t _plannerOptions;
+    const BSONObj _shardKey;
+
+    // The indexes the solution was planned with, in the order the planner was given them.
+    const std::vector<IndexState> _indexes;
+
+    // The paths of the equality predicates whose constants are bound into index scan bounds.
+    const std::set<std::string> _boundPaths;
+};
+
+}  // namespace mongo
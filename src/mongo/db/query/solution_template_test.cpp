@@ -0,0 +1,193 @@
+
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+/**
+ * This file contains tests for reusing query solutions through solution templates.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/solution_template.h"
+
+#include "mongo/db/query/query_planner_test_fixture.h"
+
+namespace {
+
+using namespace mongo;
+
+class SolutionTemplateTest : public QueryPlannerTest {
+protected:
+    void setUp() final {
+        QueryPlannerTest::setUp();
+        params.options = QueryPlannerParams::DEFAULT;
+    }
+
+    /**
+     * Plans 'query', which must have a single solution, and returns a template built from it.
+     */
+    std::unique_ptr<SolutionTemplate> makeTemplate(const BSONObj& query) {
+        runQuery(query);
+        assertNumSolutions(1U);
+        return SolutionTemplate::make(*cq, params, *solns[0]);
+    }
+
+    /**
+     * Plans 'query' and checks that instantiating 'solutionTemplate' for it yields the solution
+     * the planner produced.
+     */
+    void assertInstantiatesAsPlanned(const SolutionTemplate& solutionTemplate,
+                                     const BSONObj& query) {
+        runQuery(query);
+        assertNumSolutions(1U);
+        auto soln = solutionTemplate.instantiate(*cq, params);
+        ASSERT(soln);
+        ASSERT_EQ(solns[0]->root->toString(), soln->root->toString());
+        ASSERT_EQ(solns[0]->hasBlockingStage, soln->hasBlockingStage);
+    }
+};
+
+TEST_F(SolutionTemplateTest, InstantiatesSingleFieldEquality) {
+    addIndex(BSON("a" << 1));
+
+    auto solutionTemplate = makeTemplate(fromjson("{a: 5}"));
+    ASSERT(solutionTemplate);
+
+    assertInstantiatesAsPlanned(*solutionTemplate, fromjson("{a: 7}"));
+    assertSolutionExists("{fetch: {filter: null, node: {ixscan: {pattern: {a: 1}, "
+                         "bounds: {a: [[7, 7, true, true]]}}}}}");
+}
+
+TEST_F(SolutionTemplateTest, InstantiatesCompoundEqualityOnDescendingIndex) {
+    addIndex(BSON("a" << 1 << "b" << -1));
+
+    auto solutionTemplate = makeTemplate(fromjson("{a: 5, b: 'x'}"));
+    ASSERT(solutionTemplate);
+
+    assertInstantiatesAsPlanned(*solutionTemplate, fromjson("{a: 3, b: 'y'}"));
+}
+
+TEST_F(SolutionTemplateTest, InstantiatesEqualityWithSort) {
+    addIndex(BSON("a" << 1));
+
+    runQuerySortProj(fromjson("{a: 5}"), fromjson("{b: 1}"), BSONObj());
+    assertNumSolutions(1U);
+    auto solutionTemplate = SolutionTemplate::make(*cq, params, *solns[0]);
+    ASSERT(solutionTemplate);
+
+    runQuerySortProj(fromjson("{a: 8}"), fromjson("{b: 1}"), BSONObj());
+    auto soln = solutionTemplate->instantiate(*cq, params);
+    ASSERT(soln);
+    ASSERT_EQ(solns[0]->root->toString(), soln->root->toString());
+    ASSERT(soln->hasBlockingStage);
+}
+
+TEST_F(SolutionTemplateTest, NoTemplateForRangePredicate) {
+    addIndex(BSON("a" << 1));
+
+    ASSERT_FALSE(makeTemplate(fromjson("{a: {$gt: 5}}")));
+}
+
+TEST_F(SolutionTemplateTest, NoTemplateWhenConstantIsInFilter) {
+    addIndex(BSON("a" << 1));
+
+    ASSERT_FALSE(makeTemplate(fromjson("{a: 5, b: 6}")));
+}
+
+TEST_F(SolutionTemplateTest, NoTemplateForNullConstant) {
+    addIndex(BSON("a" << 1));
+
+    ASSERT_FALSE(makeTemplate(fromjson("{a: null}")));
+}
+
+TEST_F(SolutionTemplateTest, NoTemplateWithProjection) {
+    addIndex(BSON("a" << 1));
+
+    runQuerySortProj(fromjson("{a: 5}"), BSONObj(), fromjson("{_id: 0, a: 1}"));
+    assertNumSolutions(1U);
+    ASSERT_FALSE(SolutionTemplate::make(*cq, params, *solns[0]));
+}
+
+TEST_F(SolutionTemplateTest, NotInstantiatedWithDifferentPlannerOptions) {
+    addIndex(BSON("a" << 1));
+
+    auto solutionTemplate = makeTemplate(fromjson("{a: 5}"));
+    ASSERT(solutionTemplate);
+
+    params.options = QueryPlannerParams::INCLUDE_SHARD_FILTER;
+    runQuery(fromjson("{a: 7}"));
+    ASSERT_FALSE(solutionTemplate->instantiate(*cq, params));
+}
+
+TEST_F(SolutionTemplateTest, NotInstantiatedForDifferentEqualityPaths) {
+    addIndex(BSON("a" << 1 << "b" << 1));
+
+    auto solutionTemplate = makeTemplate(fromjson("{a: 5, b: 5}"));
+    ASSERT(solutionTemplate);
+
+    runQuery(fromjson("{a: 5, c: 5}"));
+    ASSERT_FALSE(solutionTemplate->instantiate(*cq, params));
+}
+
+TEST_F(SolutionTemplateTest, NotInstantiatedOnceIndexBecomesMultikey) {
+    addIndex(BSON("a" << 1 << "b" << 1));
+
+    auto solutionTemplate = makeTemplate(fromjson("{a: 5, b: 5}"));
+    ASSERT(solutionTemplate);
+
+    params.indices[0].multikey = true;
+    runQuery(fromjson("{a: 7, b: 7}"));
+    ASSERT_FALSE(solutionTemplate->instantiate(*cq, params));
+}
+
+TEST_F(SolutionTemplateTest, NotInstantiatedWhenMultikeyPathsChange) {
+    addIndex(BSON("a" << 1 << "b" << 1), MultikeyPaths{{}, {0U}});
+
+    auto solutionTemplate = makeTemplate(fromjson("{a: 5, b: 5}"));
+    ASSERT(solutionTemplate);
+    assertInstantiatesAsPlanned(*solutionTemplate, fromjson("{a: 6, b: 6}"));
+
+    params.indices[0].multikeyPaths = MultikeyPaths{{0U}, {0U}};
+    runQuery(fromjson("{a: 7, b: 7}"));
+    ASSERT_FALSE(solutionTemplate->instantiate(*cq, params));
+}
+
+TEST_F(SolutionTemplateTest, NotInstantiatedWhenIndexesChange) {
+    addIndex(BSON("a" << 1));
+
+    auto solutionTemplate = makeTemplate(fromjson("{a: 5}"));
+    ASSERT(solutionTemplate);
+
+    params.indices.clear();
+    addIndex(BSON("a" << -1));
+    runQuery(fromjson("{a: 7}"));
+    ASSERT_FALSE(solutionTemplate->instantiate(*cq, params));
+}
+
+}  // namespace
@@ -38,6 +38,7 @@
 #include "mongo/db/catalog/database.h"
 #include "mongo/db/catalog/index_catalog.h"
 #include "mongo/db/client.h"
+#include "mongo/db/exec/and_bitmap.h"
 #include "mongo/db/exec/and_hash.h"
 #include "mongo/db/exec/and_sorted.h"
 #include "mongo/db/exec/collection_scan.h"
@@ -107,6 +108,8 @@ PlanStage* buildStages(OperationContext* opCtx,
             params.direction = ixn->direction;
             params.addKeyMetadata = ixn->addKeyMetadata;
             params.shouldDedup = ixn->shouldDedup;
+            params.estimatedKeysExamined = ixn->estimatedKeysExamined;
+            params.isSkipScan = ixn->isSkipScan;
             return new IndexScan(opCtx, std::move(params), ws, ixn->filter.get());
         }
         case STAGE_FETCH: {
@@ -206,6 +209,19 @@ PlanStage* buildStages(OperationContext* opCtx,
             }
             return ret.release();
         }
+        case STAGE_AND_BITMAP: {
+            const AndBitmapNode* abn = static_cast<const AndBitmapNode*>(root);
+            auto ret = make_unique<AndBitmapStage>(opCtx, ws);
+            for (size_t i = 0; i < abn->children.size(); ++i) {
+                PlanStage* childStage =
+                    buildStages(opCtx, collection, cq, qsol, abn->children[i], ws);
+                if (nullptr == childStage) {
+                    return nullptr;
+                }
+                ret->addChild(childStage);
+            }
+            return ret.release();
+        }
         case STAGE_AND_SORTED: {
             const AndSortedNode* asn = static_cast<const AndSortedNode*>(root);
             auto ret = make_unique<AndSortedStage>(opCtx, ws);
@@ -326,7 +342,7 @@ PlanStage* buildStages(OperationContext* opCtx,
             params.scanDirection = dn->direction;
             params.bounds = dn->bounds;
             params.fieldNo = dn->fieldNo;
-            return new DistinctScan(opCtx, std::move(params), ws);
+            return new DistinctScan(opCtx, std::move(params), ws, dn->filter.get());
         }
         case STAGE_COUNT_SCAN: {
             const CountScanNode* csn = static_cast<const CountScanNode*>(root);
@@ -352,7 +368,7 @@ PlanStage* buildStages(OperationContext* opCtx,
             params.startKeyInclusive = csn->startKeyInclusive;
             params.endKey = csn->endKey;
             params.endKeyInclusive = csn->endKeyInclusive;
-            return new CountScan(opCtx, std::move(params), ws);
+            return new CountScan(opCtx, std::move(params), ws, csn->filter.get());
         }
         case STAGE_ENSURE_SORTED: {
             const EnsureSortedNode* esn = static_cast<const EnsureSortedNode*>(root);
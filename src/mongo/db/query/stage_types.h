@@ -36,6 +36,7 @@ namespace mongo {
  * These map to implementations of the PlanStage interface, all of which live in db/exec/
  */
 enum StageType {
+    STAGE_AND_BITMAP,
     STAGE_AND_HASH,
     STAGE_AND_SORTED,
     STAGE_CACHED_PLAN,
@@ -569,12 +569,17 @@ int Balancer::_moveChunks(OperationContext* opCtx,
         return 0;
     }
 
+    // When balancing by data size, the donor must have deleted the documents of a moved chunk
+    // before the next round, otherwise they would still be accounted for in its data size
+    const bool waitForDelete = balancerConfig->waitForDelete() ||
+        balancerConfig->getBalancingPolicy() == BalancerSettingsType::kDataSize;
+
     auto migrationStatuses =
         _migrationManager.executeMigrationsForAutoBalance(opCtx,
                                                           candidateChunks,
                                                           balancerConfig->getMaxChunkSizeBytes(),
                                                           balancerConfig->getSecondaryThrottle(),
-                                                          balancerConfig->waitForDelete());
+                                                          waitForDelete);
 
     int numChunksProcessed = 0;
 
@@ -39,10 +39,13 @@
 
 #include "mongo/base/status_with.h"
 #include "mongo/bson/bsonobj_comparator_interface.h"
+#include "mongo/client/read_preference.h"
+#include "mongo/s/balancer_configuration.h"
 #include "mongo/s/catalog/type_chunk.h"
 #include "mongo/s/catalog/type_collection.h"
 #include "mongo/s/catalog/type_tags.h"
 #include "mongo/s/catalog_cache.h"
+#include "mongo/s/client/shard_registry.h"
 #include "mongo/s/grid.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
@@ -111,6 +114,49 @@ StatusWith<DistributionStatus> createCollectionDistributionStatus(
     return {std::move(distribution)};
 }
 
+/**
+ * Retrieves the size of the collection's data on each of the specified shards using collStats and
+ * records it in the distribution. Shards which do not have the collection hold no data.
+ */
+Status retrieveCollectionDataSizes(OperationContext* opCtx,
+                                   const ShardStatisticsVector& allShards,
+                                   DistributionStatus* distribution) {
+    const auto& nss = distribution->nss();
+    const auto shardRegistry = Grid::get(opCtx)->shardRegistry();
+
+    for (const auto& stat : allShards) {
+        auto shardStatus = shardRegistry->getShard(opCtx, stat.shardId);
+        if (!shardStatus.isOK()) {
+            return shardStatus.getStatus();
+        }
+
+        auto commandResponse = shardStatus.getValue()->runCommandWithFixedRetryAttempts(
+            opCtx,
+            ReadPreferenceSetting{ReadPreference::PrimaryOnly},
+            nss.db().toString(),
+            BSON("collStats" << nss.coll()),
+            Shard::RetryPolicy::kIdempotent);
+        if (!commandResponse.isOK()) {
+            return commandResponse.getStatus();
+        }
+
+        const auto& commandStatus = commandResponse.getValue().commandStatus;
+        if (commandStatus == ErrorCodes::NamespaceNotFound) {
+            distribution->setDataSizeInShard(stat.shardId, 0);
+            continue;
+        }
+        if (!commandStatus.isOK()) {
+            return commandStatus.withContext(str::stream() << "Unable to obtain size of "
+                                                           << nss.ns() << " on " << stat.shardId);
+        }
+
+        distribution->setDataSizeInShard(
+            stat.shardId, commandResponse.getValue().response["size"].safeNumberLong());
+    }
+
+    return Status::OK();
+}
+
 /**
  * Helper class used to accumulate the split points for the same chunk together so they can be
  * submitted to the shard as a single call versus multiple. This is necessary in order to avoid
@@ -426,12 +472,12 @@ StatusWith<MigrateInfoVector> BalancerChunkSelectionPolicyImpl::_getMigrateCandi
 
     const auto& shardKeyPattern = cm->getShardKeyPattern().getKeyPattern();
 
-    const auto collInfoStatus = createCollectionDistributionStatus(opCtx, shardStats, cm);
+    auto collInfoStatus = createCollectionDistributionStatus(opCtx, shardStats, cm);
     if (!collInfoStatus.isOK()) {
         return collInfoStatus.getStatus();
     }
 
-    const DistributionStatus& distribution = collInfoStatus.getValue();
+    DistributionStatus& distribution = collInfoStatus.getValue();
 
     for (const auto& tagRangeEntry : distribution.tagRanges()) {
         const auto& tagRange = tagRangeEntry.second;
@@ -472,6 +518,15 @@ StatusWith<MigrateInfoVector> BalancerChunkSelectionPolicyImpl::_getMigrateCandi
         }
     }
 
+    if (Grid::get(opCtx)->getBalancerConfiguration()->getBalancingPolicy() ==
+        BalancerSettingsType::kDataSize) {
+        auto status = retrieveCollectionDataSizes(opCtx, shardStats, &distribution);
+        if (!status.isOK()) {
+            warning() << "Unable to obtain data sizes for collection " << nss.ns()
+                      << ", balancing it by number of chunks" << causedBy(status);
+        }
+    }
+
     return BalancerPolicy::balance(shardStats, distribution, usedShards);
 }
 
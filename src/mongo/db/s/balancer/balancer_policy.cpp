@@ -107,6 +107,28 @@ const vector<ChunkType>& DistributionStatus::getChunks(const ShardId& shardId) c
     return i->second;
 }
 
+void DistributionStatus::setDataSizeInShard(const ShardId& shardId, long long dataSizeBytes) {
+    invariant(_shardChunks.count(shardId));
+    _shardDataSizes[shardId] = std::max(dataSizeBytes, 0LL);
+}
+
+bool DistributionStatus::hasDataSizes() const {
+    return !_shardDataSizes.empty() && _shardDataSizes.size() == _shardChunks.size();
+}
+
+long long DistributionStatus::dataSizeInShardWithTag(const ShardId& shardId,
+                                                     const string& tag) const {
+    return averageChunkSizeInShard(shardId) * numberOfChunksInShardWithTag(shardId, tag);
+}
+
+long long DistributionStatus::averageChunkSizeInShard(const ShardId& shardId) const {
+    const auto it = _shardDataSizes.find(shardId);
+    invariant(it != _shardDataSizes.end());
+
+    const size_t numChunks = numberOfChunksInShard(shardId);
+    return numChunks ? it->second / static_cast<long long>(numChunks) : 0;
+}
+
 Status DistributionStatus::addRangeToZone(const ZoneRange& range) {
     const auto minIntersect = _zoneRanges.upper_bound(range.min);
     const auto maxIntersect = _zoneRanges.upper_bound(range.max);
@@ -183,6 +205,11 @@ void DistributionStatus::report(BSONObjBuilder* builder) const {
         BSONObjBuilder shardEntry(shardArr.subobjStart());
         shardEntry.append("name", shardChunk.first.toString());
 
+        const auto dataSizeIt = _shardDataSizes.find(shardChunk.first);
+        if (dataSizeIt != _shardDataSizes.end()) {
+            shardEntry.append("dataSize", dataSizeIt->second);
+        }
+
         BSONArrayBuilder chunkArr(shardEntry.subarrayStart("chunks"));
         for (const auto& chunk : shardChunk.second) {
             chunkArr.append(chunk.toConfigBSON());
@@ -416,6 +443,13 @@ vector<MigrateInfo> BalancerPolicy::balance(const ShardStatisticsVector& shardSt
             continue;
         }
 
+        if (distribution.hasDataSizes()) {
+            while (_singleZoneBalanceByDataSize(
+                shardStats, distribution, tag, &migrations, usedShards))
+                ;
+            continue;
+        }
+
         // Calculate the rounded optimal number of chunks per shard
         const size_t idealNumberOfChunksPerShardForTag =
             (size_t)std::roundf(totalNumberOfChunksWithTag / (float)totalNumberOfShardsWithTag);
@@ -518,6 +552,98 @@ bool BalancerPolicy::_singleZoneBalance(const ShardStatisticsVector& shardStats,
     return false;
 }
 
+bool BalancerPolicy::_singleZoneBalanceByDataSize(const ShardStatisticsVector& shardStats,
+                                                  const DistributionStatus& distribution,
+                                                  const string& tag,
+                                                  vector<MigrateInfo>* migrations,
+                                                  set<ShardId>* usedShards) {
+    ShardId from;
+    long long maxDataSize = 0;
+
+    for (const auto& stat : shardStats) {
+        if (usedShards->count(stat.shardId))
+            continue;
+
+        const long long dataSize = distribution.dataSizeInShardWithTag(stat.shardId, tag);
+        if (dataSize <= maxDataSize)
+            continue;
+
+        from = stat.shardId;
+        maxDataSize = dataSize;
+    }
+
+    if (!from.isValid())
+        return false;
+
+    ShardId to;
+    long long minDataSize = numeric_limits<long long>::max();
+    double minOpsPerSecond = numeric_limits<double>::max();
+
+    for (const auto& stat : shardStats) {
+        if (usedShards->count(stat.shardId) || stat.shardId == from)
+            continue;
+
+        if (!isShardSuitableReceiver(stat, tag).isOK())
+            continue;
+
+        const long long dataSize = distribution.dataSizeInShardWithTag(stat.shardId, tag);
+        if (dataSize > minDataSize ||
+            (dataSize == minDataSize && stat.opsPerSecond >= minOpsPerSecond))
+            continue;
+
+        to = stat.shardId;
+        minDataSize = dataSize;
+        minOpsPerSecond = stat.opsPerSecond;
+    }
+
+    if (!to.isValid()) {
+        if (migrations->empty()) {
+            log() << "No available shards to take chunks for zone [" << tag << "]";
+        }
+        return false;
+    }
+
+    const long long chunkSize = distribution.averageChunkSizeInShard(from);
+
+    LOG(1) << "collection : " << distribution.nss().ns();
+    LOG(1) << "zone       : " << tag;
+    LOG(1) << "donor      : " << from << " bytes on " << maxDataSize;
+    LOG(1) << "receiver   : " << to << " bytes on " << minDataSize;
+    LOG(1) << "chunk size : " << chunkSize;
+
+    // Moving a chunk narrows the difference between the two shards by twice its size, so only do
+    // it if the difference does not grow again in the opposite direction
+    if (chunkSize == 0 || maxDataSize - minDataSize < 2 * chunkSize)
+        return false;
+
+    const vector<ChunkType>& chunks = distribution.getChunks(from);
+
+    unsigned numJumboChunks = 0;
+
+    for (const auto& chunk : chunks) {
+        if (distribution.getTagForChunk(chunk) != tag)
+            continue;
+
+        if (chunk.getJumbo()) {
+            numJumboChunks++;
+            continue;
+        }
+
+        migrations->emplace_back(to, chunk);
+        invariant(usedShards->insert(chunk.getShard()).second);
+        invariant(usedShards->insert(to).second);
+        return true;
+    }
+
+    if (numJumboChunks) {
+        warning() << "Shard: " << from << ", collection: " << distribution.nss().ns()
+                  << " has only jumbo chunks for zone \'" << tag
+                  << "\' and cannot be balanced. Jumbo chunks count: " << numJumboChunks;
+    }
+
+    return false;
+}
+
 ZoneRange::ZoneRange(const BSONObj& a_min, const BSONObj& a_max, const std::string& _zone)
     : min(a_min.getOwned()), max(a_max.getOwned()), zone(_zone) {}
 
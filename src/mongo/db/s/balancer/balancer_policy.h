@@ -30,6 +30,7 @@
 
 #pragma once
 
+#include <map>
 #include <set>
 #include <vector>
 
@@ -122,6 +123,31 @@ public:
      */
     const std::vector<ChunkType>& getChunks(const ShardId& shardId) const;
 
+    /**
+     * Records the number of bytes of the collection's data stored on the specified shard. Once the
+     * data sizes of all the shards are known, the collection is balanced by data size instead of
+     * by number of chunks.
+     */
+    void setDataSizeInShard(const ShardId& shardId, long long dataSizeBytes);
+
+    /**
+     * Returns true if the data size of the collection on every shard has been recorded.
+     */
+    bool hasDataSizes() const;
+
+    /**
+     * Returns the estimated number of bytes in the chunks of the specified shard, which have the
+     * given tag. The chunks of a shard are assumed to all be of its average chunk size. Must only
+     * be called if hasDataSizes() is true.
+     */
+    long long dataSizeInShardWithTag(const ShardId& shardId, const std::string& tag) const;
+
+    /**
+     * Returns the average size in bytes of the chunks of the specified shard or zero if the shard
+     * has no chunks. Must only be called if hasDataSizes() is true.
+     */
+    long long averageChunkSizeInShard(const ShardId& shardId) const;
+
     /**
      * Returns all tag ranges defined for the collection.
      */
@@ -155,6 +181,9 @@ private:
     // Map of what chunks are owned by each shard
     ShardToChunksMap _shardChunks;
 
+    // Number of bytes of the collection's data stored on each shard, if known
+    std::map<ShardId, long long> _shardDataSizes;
+
     // Map of zone max key to the zone description
     BSONObjIndexedMap<ZoneRange> _zoneRanges;
 
@@ -181,7 +210,8 @@ public:
      *
      * The balancing logic calculates the optimum number of chunks per shard for each zone and if
      * any of the shards have chunks, which are sufficiently higher than this number, suggests
-     * moving chunks to shards, which are under this number.
+     * moving chunks to shards, which are under this number. If the distribution contains the data
+     * sizes of the collection on all shards, the amount of data in each zone is evened out instead.
      *
      * The usedShards parameter is in/out and it contains the set of shards, which have already been
      * used for migrations. Used so we don't return multiple conflicting migrations for the same
@@ -236,6 +266,18 @@ private:
                                    size_t idealNumberOfChunksPerShardForTag,
                                    std::vector<MigrateInfo>* migrations,
                                    std::set<ShardId>* usedShards);
+
+    /**
+     * Same as _singleZoneBalance, but selects a chunk to move from the shard with the most data in
+     * the specified zone to the shard with the least, as long as the move reduces the difference
+     * between them. Among recipients with equally little data, the one serving the lowest rate of
+     * operations is chosen.
+     */
+    static bool _singleZoneBalanceByDataSize(const ShardStatisticsVector& shardStats,
+                                             const DistributionStatus& distribution,
+                                             const std::string& tag,
+                                             std::vector<MigrateInfo>* migrations,
+                                             std::set<ShardId>* usedShards);
 };
 
 }  // namespace mongo
@@ -610,6 +610,71 @@ TEST(BalancerPolicy, BalancerHandlesNoShardsWithTag) {
     ASSERT(balanceChunks(cluster.first, distribution, false).empty());
 }
 
+TEST(BalancerPolicy, BalanceByDataSizeWithEvenChunkCounts) {
+    auto cluster = generateCluster(
+        {{ShardStatistics(kShardId0, kNoMaxSize, 0, false, emptyTagSet, emptyShardVersion), 4},
+         {ShardStatistics(kShardId1, kNoMaxSize, 0, false, emptyTagSet, emptyShardVersion), 4},
+         {ShardStatistics(kShardId2, kNoMaxSize, 0, false, emptyTagSet, emptyShardVersion), 4}});
+
+    DistributionStatus distribution(kNamespace, cluster.second);
+    ASSERT(balanceChunks(cluster.first, distribution, false).empty());
+
+    distribution.setDataSizeInShard(kShardId0, 400 * 1024 * 1024);
+    distribution.setDataSizeInShard(kShardId1, 100 * 1024 * 1024);
+    distribution.setDataSizeInShard(kShardId2, 250 * 1024 * 1024);
+    ASSERT(distribution.hasDataSizes());
+
+    const auto migrations(balanceChunks(cluster.first, distribution, false));
+    ASSERT_EQ(1U, migrations.size());
+    ASSERT_EQ(kShardId0, migrations[0].from);
+    ASSERT_EQ(kShardId1, migrations[0].to);
+    ASSERT_BSONOBJ_EQ(cluster.second[kShardId0][0].getMin(), migrations[0].minKey);
+    ASSERT_BSONOBJ_EQ(cluster.second[kShardId0][0].getMax(), migrations[0].maxKey);
+}
+
+TEST(BalancerPolicy, BalanceByDataSizeDoesNotMoveChunkLargerThanImbalance) {
+    auto cluster = generateCluster(
+        {{ShardStatistics(kShardId0, kNoMaxSize, 0, false, emptyTagSet, emptyShardVersion), 2},
+         {ShardStatistics(kShardId1, kNoMaxSize, 0, false, emptyTagSet, emptyShardVersion), 1}});
+
+    DistributionStatus distribution(kNamespace, cluster.second);
+    distribution.setDataSizeInShard(kShardId0, 200 * 1024 * 1024);
+    distribution.setDataSizeInShard(kShardId1, 150 * 1024 * 1024);
+
+    ASSERT(balanceChunks(cluster.first, distribution, false).empty());
+}
+
+TEST(BalancerPolicy, BalanceByDataSizePrefersLeastLoadedReceiver) {
+    auto cluster = generateCluster(
+        {{ShardStatistics(kShardId0, kNoMaxSize, 0, false, emptyTagSet, emptyShardVersion), 4},
+         {ShardStatistics(kShardId1, kNoMaxSize, 0, false, emptyTagSet, emptyShardVersion), 0},
+         {ShardStatistics(kShardId2, kNoMaxSize, 0, false, emptyTagSet, emptyShardVersion), 0}});
+    cluster.first[1].opsPerSecond = 1000;
+    cluster.first[2].opsPerSecond = 10;
+
+    DistributionStatus distribution(kNamespace, cluster.second);
+    distribution.setDataSizeInShard(kShardId0, 400 * 1024 * 1024);
+    distribution.setDataSizeInShard(kShardId1, 0);
+    distribution.setDataSizeInShard(kShardId2, 0);
+
+    const auto migrations(balanceChunks(cluster.first, distribution, false));
+    ASSERT_EQ(1U, migrations.size());
+    ASSERT_EQ(kShardId0, migrations[0].from);
+    ASSERT_EQ(kShardId2, migrations[0].to);
+}
+
+TEST(BalancerPolicy, BalanceByChunkCountWhenDataSizesAreIncomplete) {
+    auto cluster = generateCluster(
+        {{ShardStatistics(kShardId0, kNoMaxSize, 0, false, emptyTagSet, emptyShardVersion), 4},
+         {ShardStatistics(kShardId1, kNoMaxSize, 0, false, emptyTagSet, emptyShardVersion), 4}});
+
+    DistributionStatus distribution(kNamespace, cluster.second);
+    distribution.setDataSizeInShard(kShardId0, 400 * 1024 * 1024);
+    ASSERT(!distribution.hasDataSizes());
+
+    ASSERT(balanceChunks(cluster.first, distribution, false).empty());
+}
+
 TEST(DistributionStatus, AddTagRangeOverlap) {
     DistributionStatus d(kNamespace, ShardToChunksMap{});
 
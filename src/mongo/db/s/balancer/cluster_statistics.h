@@ -94,6 +94,10 @@ public:
 
         // Version of mongod, which runs on this shard's primary
         std::string mongoVersion;
+
+        // Rate of CRUD operations served by this shard's primary since the previous statistics
+        // snapshot. Zero if it is not known.
+        double opsPerSecond{0};
     };
 
     virtual ~ClusterStatistics();
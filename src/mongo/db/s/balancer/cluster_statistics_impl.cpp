@@ -50,16 +50,20 @@ namespace mongo {
 namespace {
 
 const char kVersionField[] = "version";
+const char kOpCountersField[] = "opcounters";
+
+// The operation counters from the serverStatus opcounters section, which are summed in order to
+// calculate the load of a shard. Commands are left out because they include the balancer's own
+// statistics gathering.
+const char* const kCrudOpCounters[] = {"insert", "query", "update", "delete", "getmore"};
 
 /**
- * Executes the serverStatus command against the specified shard and obtains the version of the
- * running MongoD service.
+ * Executes the serverStatus command against the specified shard and returns its response.
  *
- * Returns the MongoD version in strig format or an error. Known error codes are:
+ * Known error codes are:
  *  ShardNotFound if shard by that id is not available on the registry
- *  NoSuchKey if the version could not be retrieved
  */
-StatusWith<std::string> retrieveShardMongoDVersion(OperationContext* opCtx, ShardId shardId) {
+StatusWith<BSONObj> retrieveShardServerStatus(OperationContext* opCtx, ShardId shardId) {
     auto shardRegistry = Grid::get(opCtx)->shardRegistry();
     auto shardStatus = shardRegistry->getShard(opCtx, shardId);
     if (!shardStatus.isOK()) {
@@ -80,15 +84,28 @@ StatusWith<std::string> retrieveShardMongoDVersion(OperationContext* opCtx, Shar
         return commandResponse.getValue().commandStatus;
     }
 
-    BSONObj serverStatus = std::move(commandResponse.getValue().response);
+    return std::move(commandResponse.getValue().response);
+}
 
-    std::string version;
-    Status status = bsonExtractStringField(serverStatus, kVersionField, &version);
+/**
+ * Returns the total number of CRUD operations reported in a serverStatus response or NoSuchKey if
+ * the response does not contain operation counters.
+ */
+StatusWith<long long> extractNumOps(const BSONObj& serverStatus) {
+    BSONElement opCountersElem;
+    Status status = bsonExtractTypedField(serverStatus, kOpCountersField, Object, &opCountersElem);
     if (!status.isOK()) {
         return status;
     }
 
-    return version;
+    const BSONObj opCounters = opCountersElem.Obj();
+
+    long long numOps = 0;
+    for (const auto opCounter : kCrudOpCounters) {
+        numOps += opCounters[opCounter].safeNumberLong();
+    }
+
+    return numOps;
 }
 
 }  // namespace
@@ -135,15 +152,29 @@ StatusWith<std::vector<ShardStatistics>> ClusterStatisticsImpl::getStats(Operati
         }
 
         std::string mongoDVersion;
+        double opsPerSecond = 0;
+
+        // Since the mongod version and the operation rate are only used for reporting and for
+        // choosing between otherwise equivalent recipients, there is no need to fail the entire
+        // round if they cannot be retrieved, so just leave them empty
+        auto serverStatusStatus = retrieveShardServerStatus(opCtx, shard.getName());
+        if (serverStatusStatus.isOK()) {
+            const auto& serverStatus = serverStatusStatus.getValue();
+
+            Status status = bsonExtractStringField(serverStatus, kVersionField, &mongoDVersion);
+            if (!status.isOK()) {
+                log() << "Unable to obtain shard version for " << shard.getName()
+                      << causedBy(status);
+            }
 
-        auto mongoDVersionStatus = retrieveShardMongoDVersion(opCtx, shard.getName());
-        if (mongoDVersionStatus.isOK()) {
-            mongoDVersion = std::move(mongoDVersionStatus.getValue());
+            auto numOpsStatus = extractNumOps(serverStatus);
+            if (numOpsStatus.isOK()) {
+                opsPerSecond =
+                    _updateOpsPerSecond(shard.getName(), numOpsStatus.getValue(), Date_t::now());
+            }
         } else {
-            // Since the mongod version is only used for reporting, there is no need to fail the
-            // entire round if it cannot be retrieved, so just leave it empty
             log() << "Unable to obtain shard version for " << shard.getName()
-                  << causedBy(mongoDVersionStatus.getStatus());
+                  << causedBy(serverStatusStatus.getStatus());
         }
 
         std::set<std::string> shardTags;
@@ -158,9 +189,33 @@ StatusWith<std::vector<ShardStatistics>> ClusterStatisticsImpl::getStats(Operati
                            shard.getDraining(),
                            std::move(shardTags),
                            std::move(mongoDVersion));
+        stats.back().opsPerSecond = opsPerSecond;
     }
 
     return stats;
 }
 
+double ClusterStatisticsImpl::_updateOpsPerSecond(const ShardId& shardId,
+                                                  long long numOps,
+                                                  Date_t now) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    auto it = _lastOpCounters.find(shardId);
+    if (it == _lastOpCounters.end()) {
+        _lastOpCounters.emplace(shardId, OpCountersSample{numOps, now});
+        return 0;
+    }
+
+    const auto previous = it->second;
+    it->second = OpCountersSample{numOps, now};
+
+    // The counters start over when the shard's primary changes or restarts
+    const long long elapsedMillis = durationCount<Milliseconds>(now - previous.sampledAt);
+    if (numOps < previous.numOps || elapsedMillis <= 0) {
+        return 0;
+    }
+
+    return (numOps - previous.numOps) * 1000.0 / elapsedMillis;
+}
+
 }  // namespace mongo
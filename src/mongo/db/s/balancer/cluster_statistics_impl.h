@@ -30,15 +30,20 @@
 
 #pragma once
 
+#include <map>
+
 #include "mongo/db/s/balancer/balancer_random.h"
 #include "mongo/db/s/balancer/cluster_statistics.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
 /**
  * Default implementation for the cluster statistics gathering utility. Uses a blocking method to
- * fetch the statistics and does not perform any caching. If any of the shards fails to report
- * statistics fails the entire refresh.
+ * fetch the statistics and does not perform any caching, except for the operation counters of each
+ * shard, which are kept until the next call in order to compute the shard's operation rate. If any
+ * of the shards fails to report statistics fails the entire refresh.
  */
 class ClusterStatisticsImpl final : public ClusterStatistics {
 public:
@@ -48,8 +53,25 @@ public:
     StatusWith<std::vector<ShardStatistics>> getStats(OperationContext* opCtx) override;
 
 private:
+    struct OpCountersSample {
+        long long numOps;
+        Date_t sampledAt;
+    };
+
+    /**
+     * Records the total number of operations reported by a shard and returns the rate of
+     * operations per second since the previous sample for that shard, or zero if there was none.
+     */
+    double _updateOpsPerSecond(const ShardId& shardId, long long numOps, Date_t now);
+
     // Source of randomness when metadata needs to be randomized.
     BalancerRandomSource& _random;
+
+    // Protects the state below
+    stdx::mutex _mutex;
+
+    // The operation counters of each shard at the time its statistics were last retrieved
+    std::map<ShardId, OpCountersSample> _lastOpCounters;
 };
 
 }  // namespace mongo
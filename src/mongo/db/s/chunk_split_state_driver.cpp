@@ -59,12 +59,15 @@ ChunkSplitStateDriver::ChunkSplitStateDriver(ChunkSplitStateDriver&& source) noe
 }
 
 ChunkSplitStateDriver::~ChunkSplitStateDriver() {
+    auto wt = _writesTracker.lock();
+    if (!wt) {
+        return;
+    }
+
+    wt->resetSampledKeys();
     if (_splitState != SplitState::kSplitCommitted) {
-        auto wt = _writesTracker.lock();
-        if (wt) {
-            wt->releaseSplitLock();
-            wt->addBytesWritten(_stashedBytesWritten);
-        }
+        wt->releaseSplitLock();
+        wt->addBytesWritten(_stashedBytesWritten);
     }
 }
 
@@ -87,4 +90,20 @@ void ChunkSplitStateDriver::commitSplit() {
     _splitState = SplitState::kSplitCommitted;
 }
 
+std::vector<BSONObj> ChunkSplitStateDriver::getSplitPointsFromSampledKeys(
+    const BSONObj& min, const BSONObj& max, size_t maxSplitPoints) const {
+    auto wt = _writesTracker.lock();
+    if (!wt) {
+        return {};
+    }
+    return wt->getSplitPointsFromSampledKeys(min, max, maxSplitPoints);
+}
+
+void ChunkSplitStateDriver::noteFailedHotSplit(Milliseconds hotPeriod, Date_t now) {
+    auto wt = _writesTracker.lock();
+    if (wt) {
+        wt->noteFailedHotSplit(hotPeriod, now);
+    }
+}
+
 }  // namespace mongo
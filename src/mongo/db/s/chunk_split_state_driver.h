@@ -72,7 +72,8 @@ public:
     ChunkSplitStateDriver& operator=(ChunkSplitStateDriver&&) = delete;
 
     /**
-     * If there's an ongoing split, cancels it. Otherwise does nothing.
+     * If there's an ongoing split, cancels it. In either case discards the shard keys sampled from
+     * the writes to the chunk, so that a later split is based only on the writes after this one.
      */
     ~ChunkSplitStateDriver();
 
@@ -97,6 +98,21 @@ public:
      */
     void commitSplit();
 
+    /**
+     * Returns split points chosen from the shard keys sampled from the writes to the chunk (see
+     * ChunkWritesTracker::getSplitPointsFromSampledKeys), or none if the chunk's metadata has
+     * changed since the split was initiated.
+     */
+    std::vector<BSONObj> getSplitPointsFromSampledKeys(const BSONObj& min,
+                                                       const BSONObj& max,
+                                                       size_t maxSplitPoints) const;
+
+    /**
+     * Notes that the split was triggered because the chunk was hot and failed, so that the chunk
+     * is not considered hot again for a while (see ChunkWritesTracker::noteFailedHotSplit).
+     */
+    void noteFailedHotSplit(Milliseconds hotPeriod, Date_t now);
+
 private:
     /**
      * Should only be used by tryInitiateSplit
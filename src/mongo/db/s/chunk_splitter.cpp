@@ -44,6 +44,7 @@
 #include "mongo/db/s/sharding_state.h"
 #include "mongo/db/s/split_chunk.h"
 #include "mongo/db/s/split_vector.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/s/balancer_configuration.h"
 #include "mongo/s/catalog/type_chunk.h"
@@ -53,9 +54,21 @@
 #include "mongo/s/grid.h"
 #include "mongo/s/shard_key_pattern.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/clock_source.h"
 #include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
+
+MONGO_EXPORT_SERVER_PARAMETER(autoSplitHotChunkPeriodSecs, int, 60)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "autoSplitHotChunkPeriodSecs must be greater than or equal to 0");
+        }
+        return Status::OK();
+    });
+
 namespace {
 
 /**
@@ -269,21 +282,22 @@ void ChunkSplitter::trySplitting(std::shared_ptr<ChunkSplitStateDriver> chunkSpl
                                  const NamespaceString& nss,
                                  const BSONObj& min,
                                  const BSONObj& max,
-                                 long dataWritten) {
+                                 long dataWritten,
+                                 bool isHot) {
     if (!_isPrimary) {
         return;
     }
     uassertStatusOK(_threadPool.schedule(
-        [ this, csd = std::move(chunkSplitStateDriver), nss, min, max, dataWritten ]() noexcept {
-            _runAutosplit(csd, nss, min, max, dataWritten);
-        }));
+        [ this, csd = std::move(chunkSplitStateDriver), nss, min, max, dataWritten, isHot ](
+            ) noexcept { _runAutosplit(csd, nss, min, max, dataWritten, isHot); }));
 }
 
 void ChunkSplitter::_runAutosplit(std::shared_ptr<ChunkSplitStateDriver> chunkSplitStateDriver,
                                   const NamespaceString& nss,
                                   const BSONObj& min,
                                   const BSONObj& max,
-                                  long dataWritten) {
+                                  long dataWritten,
+                                  bool isHot) {
     if (!_isPrimary) {
         return;
     }
@@ -313,21 +327,41 @@ void ChunkSplitter::_runAutosplit(std::shared_ptr<ChunkSplitStateDriver> chunkSp
 
         LOG(1) << "about to initiate autosplit: " << redact(chunk.toString())
                << " dataWritten since last check: " << dataWritten
-               << " maxChunkSizeBytes: " << maxChunkSizeBytes;
+               << " maxChunkSizeBytes: " << maxChunkSizeBytes << (isHot ? " (hot chunk)" : "");
 
         chunkSplitStateDriver->prepareSplit();
-        auto splitPoints = uassertStatusOK(splitVector(opCtx.get(),
-                                                       nss,
-                                                       shardKeyPattern.toBSON(),
-                                                       chunk.getMin(),
-                                                       chunk.getMax(),
-                                                       false,
-                                                       boost::none,
-                                                       boost::none,
-                                                       boost::none,
-                                                       maxChunkSizeBytes));
-
-        if (splitPoints.size() <= 1) {
+
+        // A hot chunk which could not be split is still written to quickly, so it would otherwise
+        // be retried, and possibly scanned, every time it receives a few more writes
+        auto failedHotSplitGuard = MakeGuard([&] {
+            if (isHot) {
+                chunkSplitStateDriver->noteFailedHotSplit(
+                    Seconds(autoSplitHotChunkPeriodSecs.load()),
+                    opCtx->getServiceContext()->getFastClockSource()->now());
+            }
+        });
+
+        // A hot chunk is split in two at the median of its sampled writes. If too few distinct
+        // keys were sampled, it is split based on its size like any other chunk.
+        auto splitPoints = isHot ? chunkSplitStateDriver->getSplitPointsFromSampledKeys(
+                                       chunk.getMin(), chunk.getMax(), 1)
+                                 : std::vector<BSONObj>();
+        const bool splitAtSampledKeys = !splitPoints.empty();
+
+        if (!splitAtSampledKeys) {
+            splitPoints = uassertStatusOK(splitVector(opCtx.get(),
+                                                      nss,
+                                                      shardKeyPattern.toBSON(),
+                                                      chunk.getMin(),
+                                                      chunk.getMax(),
+                                                      false,
+                                                      boost::none,
+                                                      boost::none,
+                                                      boost::none,
+                                                      maxChunkSizeBytes));
+        }
+
+        if (!splitAtSampledKeys && splitPoints.size() <= 1) {
             LOG(1)
                 << "ChunkSplitter attempted split but not enough split points were found for chunk "
                 << redact(chunk.toString());
@@ -376,12 +410,13 @@ void ChunkSplitter::_runAutosplit(std::shared_ptr<ChunkSplitStateDriver> chunkSp
                                                    ChunkRange(min, max),
                                                    splitPoints));
         chunkSplitStateDriver->commitSplit();
+        failedHotSplitGuard.Dismiss();
 
         const bool shouldBalance = isAutoBalanceEnabled(opCtx.get(), nss, balancerConfig);
 
         log() << "autosplitted " << nss << " chunk: " << redact(chunk.toString()) << " into "
               << (splitPoints.size() + 1) << " parts (maxChunkSizeBytes " << maxChunkSizeBytes
-              << ")"
+              << ")" << (splitAtSampledKeys ? " at sampled keys of hot chunk" : "")
               << (topChunkMinKey.isEmpty() ? "" : " (top chunk migration suggested" +
                           (std::string)(shouldBalance ? ")" : ", but no migrations allowed)"));
 
@@ -30,11 +30,19 @@
 
 #pragma once
 
+#include "mongo/platform/atomic_word.h"
 #include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/periodic_runner.h"
 
 namespace mongo {
 
+/**
+ * A chunk is considered hot when the rate at which it is written to would fill a chunk of the
+ * maximum size within this many seconds. Hot chunks are split early, at the shard keys sampled
+ * from their writes. Zero disables splitting of hot chunks.
+ */
+extern AtomicInt32 autoSplitHotChunkPeriodSecs;
+
 class NamespaceString;
 class OperationContext;
 class ServiceContext;
@@ -84,12 +92,16 @@ public:
 
     /**
      * Schedules an autosplit task. This function throws on scheduling failure.
+     *
+     * If 'isHot' is true, the split was triggered by the rate at which the chunk is written to
+     * rather than by its size.
      */
     void trySplitting(std::shared_ptr<ChunkSplitStateDriver> chunkSplitStateDriver,
                       const NamespaceString& nss,
                       const BSONObj& min,
                       const BSONObj& max,
-                      long dataWritten);
+                      long dataWritten,
+                      bool isHot = false);
 
 private:
     /**
@@ -99,12 +111,16 @@ private:
      * MaxKey or MinKey as a range extreme will be moved off to another shard to relieve load on the
      * original owner. This optimization presumes that the user is doing writes with increasing or
      * decreasing shard key values.
+     *
+     * A hot chunk is split at the median of the shard keys sampled from its writes, which halves
+     * its write load without scanning it. Other chunks are split based on their size on disk.
      */
     void _runAutosplit(std::shared_ptr<ChunkSplitStateDriver> chunkSplitStateDriver,
                        const NamespaceString& nss,
                        const BSONObj& min,
                        const BSONObj& max,
-                       long dataWritten);
+                       long dataWritten,
+                       bool isHot);
 
     // Protects the state below.
     stdx::mutex _mutex;
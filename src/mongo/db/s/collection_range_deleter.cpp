@@ -36,6 +36,7 @@
 
 #include <algorithm>
 #include <utility>
+#include <vector>
 
 #include "mongo/db/catalog/index_catalog.h"
 #include "mongo/db/catalog_raii.h"
@@ -79,6 +80,14 @@ MONGO_EXPORT_SERVER_PARAMETER(rangeDeleterBatchDelayMS, int, 20)
         return Status::OK();
     });
 
+MONGO_EXPORT_SERVER_PARAMETER(rangeDeleterDocsPerScanBatch, int, 16)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1) {
+            return Status(ErrorCodes::BadValue, "rangeDeleterDocsPerScanBatch must be positive");
+        }
+        return Status::OK();
+    });
+
 namespace {
 
 using Deletion = CollectionRangeDeleter::Deletion;
@@ -393,38 +402,77 @@ StatusWith<int> CollectionRangeDeleter::_doDeletion(OperationContext* opCtx,
     auto halfOpen = BoundInclusion::kIncludeStartKeyOnly;
     auto manual = PlanExecutor::YIELD_MANUAL;
     auto forward = InternalPlanner::FORWARD;
-    auto fetch = InternalPlanner::IXSCAN_FETCH;
+    // The documents themselves are only needed to save them before deletion, deleteDocument reads
+    // them anyway to remove their index keys.
+    auto fetch = saver ? InternalPlanner::IXSCAN_FETCH : InternalPlanner::IXSCAN_DEFAULT;
 
     auto exec = InternalPlanner::indexScan(
         opCtx, collection, descriptor, min, max, halfOpen, manual, forward, fetch);
 
+    const int docsPerScanBatch = rangeDeleterDocsPerScanBatch.load();
+
+    std::vector<RecordId> toDelete;
+    std::vector<BSONObj> toSave;
+
     int numDeleted = 0;
-    do {
-        RecordId rloc;
-        BSONObj obj;
-        PlanExecutor::ExecState state = exec->getNext(&obj, &rloc);
-        if (state == PlanExecutor::IS_EOF) {
-            break;
+    while (numDeleted < maxToDelete) {
+        toDelete.clear();
+        toSave.clear();
+
+        // Gather the next group of documents in shard key order before deleting any of them, so
+        // the index cursor is only saved and restored once per group.
+        const size_t groupSize = std::min(docsPerScanBatch, maxToDelete - numDeleted);
+        bool exhausted = false;
+        while (toDelete.size() < groupSize) {
+            RecordId rloc;
+            BSONObj obj;
+            PlanExecutor::ExecState state = exec->getNext(&obj, &rloc);
+            if (state == PlanExecutor::IS_EOF) {
+                exhausted = true;
+                break;
+            }
+            if (state == PlanExecutor::FAILURE || state == PlanExecutor::DEAD) {
+                warning() << PlanExecutor::statestr(state)
+                          << " - cursor error while trying to delete " << redact(min) << " to "
+                          << redact(max) << " in " << nss << ": "
+                          << redact(WorkingSetCommon::toStatusString(obj))
+                          << ", stats: " << Explain::getWinningPlanStats(exec.get());
+                exhausted = true;
+                break;
+            }
+            invariant(PlanExecutor::ADVANCED == state);
+
+            toDelete.push_back(rloc);
+            if (saver) {
+                toSave.push_back(obj.getOwned());
+            }
         }
-        if (state == PlanExecutor::FAILURE || state == PlanExecutor::DEAD) {
-            warning() << PlanExecutor::statestr(state) << " - cursor error while trying to delete "
-                      << redact(min) << " to " << redact(max) << " in " << nss << ": "
-                      << redact(WorkingSetCommon::toStatusString(obj))
-                      << ", stats: " << Explain::getWinningPlanStats(exec.get());
+
+        if (toDelete.empty()) {
             break;
         }
-        invariant(PlanExecutor::ADVANCED == state);
 
         exec->saveState();
 
-        writeConflictRetry(opCtx, "delete range", nss.ns(), [&] {
-            WriteUnitOfWork wuow(opCtx);
+        // Each deletion gets its own transaction, so that the removal of each document is
+        // timestamped with its own oplog entry.
+        for (size_t i = 0; i < toDelete.size(); ++i) {
             if (saver) {
-                uassertStatusOK(saver->goingToDelete(obj));
+                uassertStatusOK(saver->goingToDelete(toSave[i]));
             }
-            collection->deleteDocument(opCtx, kUninitializedStmtId, rloc, nullptr, true);
-            wuow.commit();
-        });
+            writeConflictRetry(opCtx, "delete range", nss.ns(), [&] {
+                WriteUnitOfWork wuow(opCtx);
+                collection->deleteDocument(opCtx, kUninitializedStmtId, toDelete[i], nullptr, true);
+                wuow.commit();
+            });
+        }
+
+        numDeleted += toDelete.size();
+        ShardingStatistics::get(opCtx).countDocsDeletedOnDonor.addAndFetch(toDelete.size());
+
+        if (exhausted) {
+            break;
+        }
 
         try {
             exec->restoreState();
@@ -435,9 +483,7 @@ StatusWith<int> CollectionRangeDeleter::_doDeletion(OperationContext* opCtx,
                       << redact(ex.toStatus());
             break;
         }
-        ShardingStatistics::get(opCtx).countDocsDeletedOnDonor.addAndFetch(1);
-
-    } while (++numDeleted < maxToDelete);
+    }
 
     return numDeleted;
 }
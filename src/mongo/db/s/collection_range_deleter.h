@@ -55,6 +55,12 @@ extern AtomicInt32 rangeDeleterBatchSize;
 // next batch of deletions.
 extern AtomicInt32 rangeDeleterBatchDelayMS;
 
+// The maximum number of documents the range deleter gathers from its scan of the shard key index
+// before deleting them, so that the index cursor is saved and restored once per group rather than
+// once per document. Each document is still deleted in its own storage transaction. Must be
+// positive, defaults to 16.
+extern AtomicInt32 rangeDeleterDocsPerScanBatch;
+
 class CollectionRangeDeleter {
     MONGO_DISALLOW_COPYING(CollectionRangeDeleter);
 
@@ -47,6 +47,7 @@
 #include "mongo/s/client/shard_registry.h"
 #include "mongo/s/shard_server_test_fixture.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -233,6 +234,39 @@ TEST_F(CollectionRangeDeleterTest, MultipleCleanupNextRangeCalls) {
     ASSERT_EQUALS(0ULL, dbclient.count(kAdminSysVer.ns(), BSON(kShardKey << "startRangeDeletion")));
 }
 
+// Tests that a run of the range deleter removes at most the requested number of documents when
+// they are gathered from the index scan in groups which do not evenly divide it.
+TEST_F(CollectionRangeDeleterTest, MultipleDocumentsDeletedPerScanBatch) {
+    const int originalDocsPerScanBatch = rangeDeleterDocsPerScanBatch.load();
+    rangeDeleterDocsPerScanBatch.store(2);
+    ON_BLOCK_EXIT([&] { rangeDeleterDocsPerScanBatch.store(originalDocsPerScanBatch); });
+
+    CollectionRangeDeleter rangeDeleter;
+    DBDirectClient dbclient(operationContext());
+    for (int i = 1; i <= 5; ++i) {
+        dbclient.insert(kNss.toString(), BSON(kShardKey << i));
+    }
+    dbclient.insert(kNss.toString(), BSON(kShardKey << 10));
+    ASSERT_EQUALS(6ULL, dbclient.count(kNss.toString(), BSON(kShardKey << LTE << 10)));
+
+    std::list<Deletion> ranges;
+    auto deletion = Deletion{ChunkRange(BSON(kShardKey << 0), BSON(kShardKey << 10)), Date_t{}};
+    ranges.emplace_back(std::move(deletion));
+    auto when = rangeDeleter.add(std::move(ranges));
+    ASSERT(when && *when == Date_t{});
+
+    ASSERT_TRUE(next(rangeDeleter, 3));
+    ASSERT_EQUALS(3ULL, dbclient.count(kNss.toString(), BSON(kShardKey << LTE << 10)));
+
+    ASSERT_TRUE(next(rangeDeleter, 100));
+    ASSERT_EQUALS(1ULL, dbclient.count(kNss.toString(), BSON(kShardKey << LTE << 10)));
+    ASSERT_TRUE(next(rangeDeleter, 100));
+    ASSERT_FALSE(next(rangeDeleter, 100));
+
+    // The document at the exclusive upper bound of the range is not deleted
+    ASSERT_EQUALS(1ULL, dbclient.count(kNss.toString(), BSON(kShardKey << 10)));
+}
+
 // Tests the case that there are two ranges to clean, each containing multiple documents.
 TEST_F(CollectionRangeDeleterTest, MultipleDocumentsInMultipleRangesToClean) {
     CollectionRangeDeleter rangeDeleter;
@@ -34,6 +34,9 @@
 
 #include "mongo/db/s/migration_chunk_cloner_source_legacy.h"
 
+#include <algorithm>
+#include <vector>
+
 #include "mongo/base/status.h"
 #include "mongo/client/read_preference.h"
 #include "mongo/db/catalog/index_catalog.h"
@@ -452,9 +455,9 @@ Status MigrationChunkClonerSourceLegacy::nextCloneBatch(OperationContext* opCtx,
 
     stdx::lock_guard<stdx::mutex> sl(_mutex);
 
-    std::set<RecordId>::iterator it;
+    auto it = _cloneLocs.begin();
 
-    for (it = _cloneLocs.begin(); it != _cloneLocs.end(); ++it) {
+    for (; it != _cloneLocs.end(); ++it) {
         // We must always make progress in this method by at least one document because empty return
         // indicates there is no more initial clone data.
         if (arrBuilder->arrSize() && tracker.intervalHasElapsed()) {
@@ -596,6 +599,10 @@ Status MigrationChunkClonerSourceLegacy::_storeCurrentLocs(OperationContext* opC
     bool isLargeChunk = false;
     unsigned long long recCount = 0;
 
+    // Collect the record ids outside of the mutex and publish them sorted once the scan completes,
+    // so that the clone batches read the documents in storage order.
+    std::vector<RecordId> cloneLocs;
+
     BSONObj obj;
     RecordId recordId;
     PlanExecutor::ExecState state;
@@ -606,8 +613,7 @@ Status MigrationChunkClonerSourceLegacy::_storeCurrentLocs(OperationContext* opC
         }
 
         if (!isLargeChunk) {
-            stdx::lock_guard<stdx::mutex> lk(_mutex);
-            _cloneLocs.insert(recordId);
+            cloneLocs.push_back(recordId);
         }
 
         if (++recCount > maxRecsWhenFull) {
@@ -644,7 +650,10 @@ Status MigrationChunkClonerSourceLegacy::_storeCurrentLocs(OperationContext* opC
                           << _args.getMaxKey()};
     }
 
+    std::sort(cloneLocs.begin(), cloneLocs.end());
+
     stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _cloneLocs.assign(cloneLocs.begin(), cloneLocs.end());
     _averageObjectSizeForCloneLocs = collectionAverageObjectSize + 12;
 
     return Status::OK();
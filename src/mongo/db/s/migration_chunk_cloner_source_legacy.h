@@ -30,8 +30,8 @@
 
 #pragma once
 
+#include <deque>
 #include <list>
-#include <set>
 
 #include "mongo/bson/bsonobj.h"
 #include "mongo/client/connection_string.h"
@@ -229,8 +229,9 @@ private:
     // The current state of the cloner
     State _state{kNew};
 
-    // List of record ids that needs to be transferred (initial clone)
-    std::set<RecordId> _cloneLocs;
+    // Record ids that need to be transferred (initial clone), sorted in storage order. Clone
+    // batches consume them from the front.
+    std::deque<RecordId> _cloneLocs;
 
     // The estimated average object size during the clone phase. Used for buffer size
     // pre-allocation (initial clone).
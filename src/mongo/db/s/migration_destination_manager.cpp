@@ -57,6 +57,7 @@
 #include "mongo/db/s/start_chunk_clone_request.h"
 #include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/s/catalog/type_chunk.h"
 #include "mongo/s/client/shard_registry.h"
 #include "mongo/s/grid.h"
@@ -379,51 +380,80 @@ Status MigrationDestinationManager::start(OperationContext* opCtx,
 void MigrationDestinationManager::cloneDocumentsFromDonor(
     OperationContext* opCtx,
     stdx::function<void(OperationContext*, BSONObj)> insertBatchFn,
-    stdx::function<BSONObj(OperationContext*)> fetchBatchFn) {
-
-    SingleProducerSingleConsumerQueue<BSONObj>::Options options;
-    options.maxQueueDepth = 1;
-
-    SingleProducerSingleConsumerQueue<BSONObj> batches(options);
-
-    stdx::thread inserterThread{[&] {
-        ThreadClient tc("chunkInserter", opCtx->getServiceContext());
+    stdx::function<BSONObj(OperationContext*)> fetchBatchFn,
+    int numInserterThreads) {
+    invariant(numInserterThreads > 0);
+
+    // Allow the fetcher to run one batch ahead of each inserter, so that fetching the next batch
+    // from the donor overlaps with the insertion of the previous ones.
+    SingleProducerMultiConsumerQueue<BSONObj>::Options options;
+    options.maxQueueDepth = numInserterThreads;
+
+    SingleProducerMultiConsumerQueue<BSONObj> batches(options);
+
+    // Set by the first inserter to fail. The others then stop at their next pop, either because
+    // that inserter closed the consumer end or because the interrupted fetcher closed the producer
+    // end, and their own errors are only a consequence of the first one.
+    AtomicWord<bool> insertFailed{false};
+
+    // Batches are inserted in no particular order, which is safe because the cloned documents
+    // have distinct _ids and modifications made on the donor are only applied after the clone
+    // phase completes.
+    auto inserterFn = [&](int inserterId) {
+        ThreadClient tc(std::string(str::stream() << "chunkInserter-" << inserterId),
+                        opCtx->getServiceContext());
         auto inserterOpCtx = Client::getCurrent()->makeOperationContext();
         auto consumerGuard = MakeGuard([&] { batches.closeConsumerEnd(); });
         try {
             while (true) {
                 auto nextBatch = batches.pop(inserterOpCtx.get());
-                auto arr = nextBatch["objects"].Obj();
-                if (arr.isEmpty()) {
-                    return;
-                }
-                insertBatchFn(inserterOpCtx.get(), arr);
+                insertBatchFn(inserterOpCtx.get(), nextBatch["objects"].Obj());
             }
+        } catch (const ExceptionFor<ErrorCodes::ProducerConsumerQueueConsumed>&) {
+            // The fetcher received the last batch and all batches have been handed out
+        } catch (const ExceptionFor<ErrorCodes::ProducerConsumerQueueEndClosed>&) {
+            // Another inserter stopped, because it failed or because the batches ran out
         } catch (...) {
+            if (insertFailed.swap(true)) {
+                return;
+            }
+
             stdx::lock_guard<Client> lk(*opCtx->getClient());
             opCtx->getServiceContext()->killOperation(opCtx, ErrorCodes::Error(51008));
             log() << "Batch insertion failed " << causedBy(redact(exceptionToStatus()));
         }
-    }};
-    auto inserterThreadJoinGuard = MakeGuard([&] {
+    };
+
+    std::vector<stdx::thread> inserterThreads;
+    auto inserterThreadsJoinGuard = MakeGuard([&] {
         batches.closeProducerEnd();
-        inserterThread.join();
+        for (auto& inserterThread : inserterThreads) {
+            inserterThread.join();
+        }
     });
 
+    for (int i = 0; i < numInserterThreads; ++i) {
+        inserterThreads.emplace_back(inserterFn, i);
+    }
+
     while (true) {
         opCtx->checkForInterrupt();
 
         auto res = fetchBatchFn(opCtx);
 
         opCtx->checkForInterrupt();
-        batches.push(res.getOwned(), opCtx);
         auto arr = res["objects"].Obj();
         if (arr.isEmpty()) {
-            inserterThreadJoinGuard.Dismiss();
-            inserterThread.join();
+            inserterThreadsJoinGuard.Dismiss();
+            batches.closeProducerEnd();
+            for (auto& inserterThread : inserterThreads) {
+                inserterThread.join();
+            }
             opCtx->checkForInterrupt();
             break;
         }
+
+        batches.push(res.getOwned(), opCtx);
     }
 }
 
@@ -726,6 +756,18 @@ MONGO_EXPORT_SERVER_PARAMETER(migrateCloneInsertionBatchDelayMS, int, 0)
         return Status::OK();
     });
 
+// The number of threads which concurrently insert the batches fetched from the donor during
+// migration clone. Fetching of further batches proceeds while these threads are inserting.
+// Defaults to 1, which inserts the batches serially in the order they were received.
+MONGO_EXPORT_SERVER_PARAMETER(migrateCloneInserterThreads, int, 1)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1 || newVal > 16) {
+            return Status(ErrorCodes::BadValue,
+                          "migrateCloneInserterThreads must be between 1 and 16");
+        }
+        return Status::OK();
+    });
+
 void MigrationDestinationManager::_migrateDriver(OperationContext* opCtx) {
     invariant(isActive());
     invariant(_sessionId);
@@ -870,7 +912,8 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* opCtx) {
             return res.response;
         };
 
-        cloneDocumentsFromDonor(opCtx, insertBatchFn, fetchBatchFn);
+        cloneDocumentsFromDonor(
+            opCtx, insertBatchFn, fetchBatchFn, migrateCloneInserterThreads.load());
 
         timing.done(3);
         MONGO_FAIL_POINT_PAUSE_WHILE_SET(migrateThreadHangAtStep3);
@@ -110,12 +110,15 @@ public:
                  const WriteConcernOptions& writeConcern);
 
     /**
-     * Clones documents from a donor shard.
+     * Clones documents from a donor shard. Batches are fetched on the calling thread by
+     * 'fetchBatchFn' until it returns an empty batch, while up to 'numInserterThreads' threads
+     * concurrently pass the previously fetched batches to 'insertBatchFn'.
      */
     static void cloneDocumentsFromDonor(
         OperationContext* opCtx,
         stdx::function<void(OperationContext*, BSONObj)> insertBatchFn,
-        stdx::function<BSONObj(OperationContext*)> fetchBatchFn);
+        stdx::function<BSONObj(OperationContext*)> fetchBatchFn,
+        int numInserterThreads = 1);
 
     /**
      * Idempotent method, which causes the current ongoing migration to abort only if it has the
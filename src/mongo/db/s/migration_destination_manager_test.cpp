@@ -31,7 +31,12 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/db/s/migration_destination_manager.h"
+
+#include <algorithm>
+
+#include "mongo/platform/atomic_word.h"
 #include "mongo/s/shard_server_test_fixture.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/unittest/unittest.h"
 
 namespace mongo {
@@ -106,6 +111,47 @@ TEST_F(MigrationDestinationManagerTest, CloneDocumentsFromDonorWorksCorrectly) {
     }
 }
 
+// Tests that every fetched batch is inserted exactly once when several inserter threads run
+// concurrently.
+TEST_F(MigrationDestinationManagerTest, CloneDocumentsFromDonorWithMultipleInserterThreads) {
+    const int kNumBatches = 20;
+    int numFetched = 0;
+
+    auto fetchBatchFn = [&](OperationContext* opCtx) {
+        BSONObjBuilder fetchBatchResultBuilder;
+
+        if (numFetched == kNumBatches) {
+            fetchBatchResultBuilder.append("objects", BSONObj());
+        } else {
+            BSONArrayBuilder arrayBuilder;
+            arrayBuilder.append(BSON("_id" << numFetched++));
+            fetchBatchResultBuilder.append("objects", arrayBuilder.arr());
+        }
+
+        return fetchBatchResultBuilder.obj();
+    };
+
+    stdx::mutex mutex;
+    std::vector<int> insertedIds;
+
+    auto insertBatchFn = [&](OperationContext* opCtx, BSONObj docs) {
+        stdx::lock_guard<stdx::mutex> lk(mutex);
+        for (auto&& docToClone : docs) {
+            insertedIds.push_back(docToClone.Obj()["_id"].numberInt());
+        }
+    };
+
+    MigrationDestinationManager::cloneDocumentsFromDonor(
+        operationContext(), insertBatchFn, fetchBatchFn, 4);
+
+    std::sort(insertedIds.begin(), insertedIds.end());
+
+    ASSERT_EQ(static_cast<size_t>(kNumBatches), insertedIds.size());
+    for (int i = 0; i < kNumBatches; ++i) {
+        ASSERT_EQ(i, insertedIds[i]);
+    }
+}
+
 // Tests that an exception in the fetch logic will successfully throw an exception on the main
 // thread.
 TEST_F(MigrationDestinationManagerTest, CloneDocumentsThrowsFetchErrors) {
@@ -158,5 +204,29 @@ TEST_F(MigrationDestinationManagerTest, CloneDocumentsCatchesInsertErrors) {
     ASSERT_EQ(operationContext()->getKillStatus(), 51008);
 }
 
+// Tests that when several inserter threads fail, the migration is interrupted with the error of
+// the first failure, and the other inserters stop cleanly.
+TEST_F(MigrationDestinationManagerTest, CloneDocumentsCatchesInsertErrorsFromMultipleInserters) {
+    auto fetchBatchFn = [&](OperationContext* opCtx) {
+        BSONObjBuilder fetchBatchResultBuilder;
+        fetchBatchResultBuilder.append("objects", createDocumentsToCloneArray());
+        return fetchBatchResultBuilder.obj();
+    };
+
+    AtomicWord<int> numInsertAttempts{0};
+    auto insertBatchFn = [&](OperationContext* opCtx, BSONObj docs) {
+        numInsertAttempts.fetchAndAdd(1);
+        uasserted(ErrorCodes::FailedToParse, "insertion error");
+    };
+
+    ASSERT_THROWS_CODE(MigrationDestinationManager::cloneDocumentsFromDonor(
+                           operationContext(), insertBatchFn, fetchBatchFn, 4),
+                       DBException,
+                       51008);
+
+    ASSERT_EQ(operationContext()->getKillStatus(), 51008);
+    ASSERT_GTE(numInsertAttempts.load(), 1);
+}
+
 }  // namespace
 }  // namespace mongo
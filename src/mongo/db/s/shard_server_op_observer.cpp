@@ -49,6 +49,7 @@
 #include "mongo/s/catalog/type_shard_database.h"
 #include "mongo/s/catalog_cache_loader.h"
 #include "mongo/s/grid.h"
+#include "mongo/util/clock_source.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
@@ -173,14 +174,21 @@ void incrementChunkOnInsertOrUpdate(OperationContext* opCtx,
     // collations.
     auto chunk = chunkManager.findIntersectingChunkWithSimpleCollation(shardKey);
     auto chunkWritesTracker = chunk.getWritesTracker();
-    chunkWritesTracker->addBytesWritten(dataWritten);
+    const auto now = opCtx->getServiceContext()->getFastClockSource()->now();
+    chunkWritesTracker->addWrite(shardKey, dataWritten, now);
     // Don't trigger chunk splits from inserts happening due to migration since
     // we don't necessarily own that chunk yet
     if (!fromMigrate) {
         const auto balancerConfig = Grid::get(opCtx)->getBalancerConfiguration();
+        const auto maxChunkSizeBytes = balancerConfig->getMaxChunkSizeBytes();
+
+        // A chunk which is written to quickly is split before it reaches the size which would
+        // otherwise trigger a split, so that it is not a bottleneck for long
+        const bool isHot = chunkWritesTracker->isHot(
+            maxChunkSizeBytes, Seconds(autoSplitHotChunkPeriodSecs.load()), now);
 
         if (balancerConfig->getShouldAutoSplit() &&
-            chunkWritesTracker->shouldSplit(balancerConfig->getMaxChunkSizeBytes())) {
+            (isHot || chunkWritesTracker->shouldSplit(maxChunkSizeBytes))) {
             auto chunkSplitStateDriver =
                 ChunkSplitStateDriver::tryInitiateSplit(chunkWritesTracker);
             if (chunkSplitStateDriver) {
@@ -188,7 +196,8 @@ void incrementChunkOnInsertOrUpdate(OperationContext* opCtx,
                                                        nss,
                                                        chunk.getMin(),
                                                        chunk.getMax(),
-                                                       dataWritten);
+                                                       dataWritten,
+                                                       isHot);
             }
         }
     }
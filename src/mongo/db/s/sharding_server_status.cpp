@@ -115,7 +115,9 @@ public:
 
         BSONObjBuilder result;
         ShardingStatistics::get(opCtx).report(&result);
-        catalogCache->report(&result);
+        // Per-collection refresh statistics are only reported on request, since the number of
+        // collections is unbounded
+        catalogCache->report(&result, configElement.numberInt() > 1);
         return result.obj();
     }
 
@@ -72,6 +72,7 @@
 #include "mongo/db/session_catalog_mongod.h"
 #include "mongo/db/snapshot_window_util.h"
 #include "mongo/db/stats/counters.h"
+#include "mongo/db/stats/operation_phase_latencies.h"
 #include "mongo/db/stats/top.h"
 #include "mongo/db/transaction_coordinator_factory.h"
 #include "mongo/db/transaction_participant.h"
@@ -913,6 +914,14 @@ DbResponse receivedCommands(OperationContext* opCtx,
                 CurOp::get(opCtx)->setLogicalOp_inlock(c->getLogicalOp());
             }
 
+            // The ServiceStateMachine continues 'find' and 'getMore' commands which allow exhaust
+            // as a stream of synthetic 'getMore' requests. Make that visible in the slow query log
+            // and the profiler.
+            if (OpMsg::isFlagSet(message, OpMsg::kExhaustSupported) &&
+                (c->getName() == "find" || c->getName() == "getMore")) {
+                CurOp::get(opCtx)->debug().exhaust = true;
+            }
+
             execCommandDatabase(opCtx, c, request, replyBuilder.get(), behaviors);
         } catch (const DBException& ex) {
             BSONObjBuilder metadataBob;
@@ -942,7 +951,6 @@ DbResponse receivedCommands(OperationContext* opCtx,
     auto response = replyBuilder->done();
     CurOp::get(opCtx)->debug().responseLength = response.header().dataLen();
 
-    // TODO exhaust
     return DbResponse{std::move(response)};
 }
 
@@ -1133,6 +1141,40 @@ DbResponse receivedGetMore(OperationContext* opCtx,
     return dbresponse;
 }
 
+/**
+ * Records the latency of a completed operation in the histogram of the command it ran, and splits
+ * it into the lock acquisition, query planning and execution phase histograms, both process-wide
+ * and for the command. Operations run through DBDirectClient are part of their parent's phases, so
+ * they only update their command's end-to-end histogram.
+ */
+void recordLatencyHistograms(OperationContext* opCtx, CurOp& currentOp) {
+    const auto elapsed = duration_cast<Microseconds>(currentOp.elapsedTimeExcludingPauses());
+    const auto command = currentOp.getCommand();
+    if (command) {
+        command->recordLatency(elapsed);
+    }
+
+    if (opCtx->getClient()->isInDirectClient()) {
+        return;
+    }
+
+    const Microseconds lockWait = currentOp.getLockWaitTime(opCtx);
+    const Microseconds planning(currentOp.debug().planningTimeMicros);
+    const Microseconds execution = elapsed - lockWait - planning;
+
+    auto recordPhase = [&](OperationPhase phase, Microseconds latency) {
+        globalOperationPhaseLatencies.record(phase, latency);
+        if (command) {
+            command->recordPhaseLatency(phase, latency);
+        }
+    };
+    recordPhase(OperationPhase::kLockAcquisition, lockWait);
+    if (planning > Microseconds(0)) {
+        recordPhase(OperationPhase::kQueryPlanning, planning);
+    }
+    recordPhase(OperationPhase::kExecution, execution);
+}
+
 }  // namespace
 
 BSONObj ServiceEntryPointCommon::getRedactedCopyForLogging(const Command* command,
@@ -1254,6 +1296,7 @@ DbResponse ServiceEntryPointCommon::handleRequest(OperationContext* opCtx,
             opCtx,
             durationCount<Microseconds>(currentOp.elapsedTimeExcludingPauses()),
             currentOp.getReadWriteType());
+    recordLatencyHistograms(opCtx, currentOp);
 
     if (currentOp.shouldDBProfile(shouldSample)) {
         // Performance profiling is on
@@ -30,9 +30,12 @@
 
 #include "mongo/platform/basic.h"
 
+#include "mongo/db/commands.h"
 #include "mongo/db/commands/server_status.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/stats/operation_phase_latencies.h"
+#include "mongo/db/stats/sharded_latency_histogram.h"
 #include "mongo/db/stats/top.h"
 
 namespace mongo {
@@ -59,5 +62,48 @@ public:
         return latencyBuilder.obj();
     }
 } globalHistogramServerStatusSection;
+
+/**
+ * Appends the per-command and per-phase latency histograms to the server status. Only commands
+ * which have run at least once are reported, each with its own phase histograms.
+ */
+class LatencyHistogramsServerStatusSection final : public ServerStatusSection {
+public:
+    LatencyHistogramsServerStatusSection() : ServerStatusSection("latencyHistograms") {}
+
+    bool includeByDefault() const {
+        return true;
+    }
+
+    BSONObj generateSection(OperationContext* opCtx, const BSONElement& configElem) const {
+        bool includeHistograms = false;
+        if (configElem.type() == BSONType::Object) {
+            includeHistograms = configElem.Obj()["histograms"].trueValue();
+        }
+
+        BSONObjBuilder builder;
+        {
+            BSONObjBuilder commandsBuilder(builder.subobjStart("commands"));
+            for (const auto& entry : globalCommandRegistry()->allCommands()) {
+                const Command* command = entry.second;
+                // Skip the aliases, which map to the same Command as its primary name.
+                if (entry.first != command->getName()) {
+                    continue;
+                }
+                if (auto histogram = command->getLatencyHistogram()) {
+                    BSONObjBuilder commandBuilder(commandsBuilder.subobjStart(entry.first));
+                    histogram->append(includeHistograms, &commandBuilder);
+                    BSONObjBuilder phasesBuilder(commandBuilder.subobjStart("phases"));
+                    command->getPhaseLatencies()->append(includeHistograms, &phasesBuilder);
+                }
+            }
+        }
+        {
+            BSONObjBuilder phasesBuilder(builder.subobjStart("phases"));
+            globalOperationPhaseLatencies.append(includeHistograms, &phasesBuilder);
+        }
+        return builder.obj();
+    }
+} latencyHistogramsServerStatusSection;
 }  // namespace
 }  // namespace mongo
@@ -0,0 +1,73 @@
+
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/stats/operation_phase_latencies.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+constexpr size_t OperationPhaseLatencies::kNumPhases;
+constexpr size_t OperationPhaseLatencies::kNumCommandPhases;
+
+OperationPhaseLatencies globalOperationPhaseLatencies;
+
+OperationPhaseLatencies::OperationPhaseLatencies(size_t numPhases)
+    : _numPhases(numPhases), _histograms(new ShardedLatencyHistogram[numPhases]) {
+    invariant(_numPhases <= kNumPhases);
+}
+
+StringData OperationPhaseLatencies::phaseName(OperationPhase phase) {
+    switch (phase) {
+        case OperationPhase::kLockAcquisition:
+            return "lockAcquisition"_sd;
+        case OperationPhase::kQueryPlanning:
+            return "queryPlanning"_sd;
+        case OperationPhase::kExecution:
+            return "execution"_sd;
+        case OperationPhase::kNetworkWrite:
+            return "networkWrite"_sd;
+    }
+    MONGO_UNREACHABLE;
+}
+
+void OperationPhaseLatencies::append(bool includeHistograms, BSONObjBuilder* builder) const {
+    for (size_t i = 0; i < _numPhases; ++i) {
+        BSONObjBuilder phaseBuilder(
+            builder->subobjStart(phaseName(static_cast<OperationPhase>(i))));
+        _histograms[i].append(includeHistograms, &phaseBuilder);
+        phaseBuilder.doneFast();
+    }
+}
+
+}  // namespace mongo
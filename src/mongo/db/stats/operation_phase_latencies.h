@@ -0,0 +1,88 @@
+
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/db/stats/sharded_latency_histogram.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+/**
+ * The phases of handling a request whose latency distributions are tracked separately from the
+ * end-to-end latency of each command.
+ */
+enum class OperationPhase {
+    kLockAcquisition,  // Time spent waiting to acquire locks.
+    kQueryPlanning,    // Time spent running plan selection trials.
+    kExecution,        // End-to-end time minus the lock acquisition and query planning time.
+    kNetworkWrite,     // Time spent writing the response back to the client.
+};
+
+/**
+ * Latency histograms for the first 'numPhases' OperationPhases. One is kept process-wide, and one
+ * per command for the phases timed while the command runs. Thread-safe.
+ */
+class OperationPhaseLatencies {
+    MONGO_DISALLOW_COPYING(OperationPhaseLatencies);
+
+public:
+    static constexpr size_t kNumPhases = static_cast<size_t>(OperationPhase::kNetworkWrite) + 1;
+
+    // The network write phase is timed by the transport layer, which does not know the command a
+    // response belongs to, so it is only tracked process-wide.
+    static constexpr size_t kNumCommandPhases = static_cast<size_t>(OperationPhase::kExecution) + 1;
+
+    explicit OperationPhaseLatencies(size_t numPhases = kNumPhases);
+
+    static StringData phaseName(OperationPhase phase);
+
+    void record(OperationPhase phase, Microseconds latency) {
+        dassert(static_cast<size_t>(phase) < _numPhases);
+        _histograms[static_cast<size_t>(phase)].record(latency);
+    }
+
+    /**
+     * Appends one sub-document per phase, see ShardedLatencyHistogram::append.
+     */
+    void append(bool includeHistograms, BSONObjBuilder* builder) const;
+
+private:
+    const size_t _numPhases;
+    std::unique_ptr<ShardedLatencyHistogram[]> _histograms;
+};
+
+extern OperationPhaseLatencies globalOperationPhaseLatencies;
+
+}  // namespace mongo
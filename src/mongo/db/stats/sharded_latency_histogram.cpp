@@ -0,0 +1,180 @@
+
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/stats/sharded_latency_histogram.h"
+
+#include <cmath>
+#include <functional>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/platform/bits.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+constexpr int ShardedLatencyHistogram::kSubBucketBits;
+constexpr int ShardedLatencyHistogram::kSubBucketCount;
+constexpr int ShardedLatencyHistogram::kMaxExponent;
+constexpr int ShardedLatencyHistogram::kNumBuckets;
+constexpr size_t ShardedLatencyHistogram::kMaxShards;
+
+namespace {
+
+size_t roundUpToPowerOfTwo(size_t value) {
+    size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+size_t defaultNumShards() {
+    return std::min<size_t>(std::max(1U, stdx::thread::hardware_concurrency()),
+                            ShardedLatencyHistogram::kMaxShards);
+}
+
+}  // namespace
+
+ShardedLatencyHistogram::ShardedLatencyHistogram()
+    : ShardedLatencyHistogram(defaultNumShards()) {}
+
+ShardedLatencyHistogram::ShardedLatencyHistogram(size_t numShards)
+    : _shardMask(roundUpToPowerOfTwo(std::max<size_t>(numShards, 1)) - 1),
+      _shards(new CacheAligned<Shard>[_shardMask + 1]) {}
+
+int ShardedLatencyHistogram::getBucket(uint64_t micros) {
+    if (micros < static_cast<uint64_t>(kSubBucketCount)) {
+        return static_cast<int>(micros);
+    }
+
+    const int exponent = 63 - countLeadingZeros64(micros);
+    if (exponent >= kMaxExponent) {
+        return kNumBuckets - 1;
+    }
+
+    // The bits immediately below the leading one select the linear sub-bucket.
+    const int subBucket = (micros >> (exponent - kSubBucketBits)) & (kSubBucketCount - 1);
+    return kSubBucketCount + (exponent - kSubBucketBits) * kSubBucketCount + subBucket;
+}
+
+uint64_t ShardedLatencyHistogram::getBucketLowerBound(int bucket) {
+    invariant(bucket >= 0 && bucket < kNumBuckets);
+    if (bucket < kSubBucketCount) {
+        return bucket;
+    }
+
+    const int exponent = (bucket - kSubBucketCount) / kSubBucketCount + kSubBucketBits;
+    const uint64_t subBucket = (bucket - kSubBucketCount) % kSubBucketCount;
+    return (1ULL << exponent) + (subBucket << (exponent - kSubBucketBits));
+}
+
+size_t ShardedLatencyHistogram::_currentShard() const {
+    if (_shardMask == 0) {
+        return 0;
+    }
+#if defined(__linux__)
+    const int cpu = sched_getcpu();
+    if (cpu >= 0) {
+        return static_cast<size_t>(cpu) & _shardMask;
+    }
+#endif
+    return std::hash<stdx::thread::id>()(stdx::this_thread::get_id()) & _shardMask;
+}
+
+void ShardedLatencyHistogram::record(Microseconds latency) {
+    const long long micros = std::max<long long>(durationCount<Microseconds>(latency), 0);
+    auto& shard = _shards[_currentShard()];
+    shard.buckets[getBucket(micros)].fetchAndAddRelaxed(1);
+    shard.sum.fetchAndAddRelaxed(micros);
+}
+
+ShardedLatencyHistogram::Snapshot ShardedLatencyHistogram::snapshot() const {
+    Snapshot snapshot;
+    for (size_t i = 0; i <= _shardMask; ++i) {
+        const auto& shard = _shards[i];
+        for (int bucket = 0; bucket < kNumBuckets; ++bucket) {
+            const long long count = shard.buckets[bucket].loadRelaxed();
+            snapshot.buckets[bucket] += count;
+            snapshot.count += count;
+        }
+        snapshot.sum += shard.sum.loadRelaxed();
+    }
+    return snapshot;
+}
+
+long long ShardedLatencyHistogram::Snapshot::percentile(double fraction) const {
+    if (count == 0) {
+        return 0;
+    }
+
+    const long long rank =
+        std::max(1LL, static_cast<long long>(std::ceil(fraction * static_cast<double>(count))));
+    long long seen = 0;
+    for (int bucket = 0; bucket < kNumBuckets - 1; ++bucket) {
+        seen += buckets[bucket];
+        if (seen >= rank) {
+            // Report the highest value that is equivalent to this bucket.
+            return static_cast<long long>(getBucketLowerBound(bucket + 1)) - 1;
+        }
+    }
+    return static_cast<long long>(getBucketLowerBound(kNumBuckets - 1));
+}
+
+void ShardedLatencyHistogram::append(bool includeHistograms, BSONObjBuilder* builder) const {
+    const auto data = snapshot();
+
+    if (includeHistograms) {
+        BSONArrayBuilder arrayBuilder(builder->subarrayStart("histogram"));
+        for (int bucket = 0; bucket < kNumBuckets; ++bucket) {
+            if (data.buckets[bucket] == 0)
+                continue;
+            BSONObjBuilder entryBuilder(arrayBuilder.subobjStart());
+            entryBuilder.append("micros", static_cast<long long>(getBucketLowerBound(bucket)));
+            entryBuilder.append("count", data.buckets[bucket]);
+            entryBuilder.doneFast();
+        }
+        arrayBuilder.doneFast();
+    }
+    builder->append("latency", data.sum);
+    builder->append("ops", data.count);
+    builder->append("p50", data.percentile(0.5));
+    builder->append("p90", data.percentile(0.9));
+    builder->append("p99", data.percentile(0.99));
+    builder->append("p999", data.percentile(0.999));
+}
+
+}  // namespace mongo
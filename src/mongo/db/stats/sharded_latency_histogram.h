@@ -0,0 +1,133 @@
+
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <array>
+#include <memory>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/util/duration.h"
+#include "mongo/util/with_alignment.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+
+/**
+ * A thread-safe latency histogram with log-linear buckets, in the style of an HDR histogram: every
+ * power-of-two range of microseconds is split into kSubBucketCount equal-width buckets, so any
+ * recorded value is reported with a relative error below 1 / kSubBucketCount.
+ *
+ * Counts are kept in a set of cache-aligned shards chosen by the CPU that records the value, so
+ * that threads running on different cores never write to the same cache line. Reads merge all of
+ * the shards, which makes them considerably more expensive than writes.
+ */
+class ShardedLatencyHistogram {
+    MONGO_DISALLOW_COPYING(ShardedLatencyHistogram);
+
+public:
+    static constexpr int kSubBucketBits = 2;
+    static constexpr int kSubBucketCount = 1 << kSubBucketBits;
+
+    // Latencies at or above 2^kMaxExponent microseconds (about six days) share the last bucket.
+    static constexpr int kMaxExponent = 39;
+    static constexpr int kNumBuckets =
+        kSubBucketCount + (kMaxExponent - kSubBucketBits) * kSubBucketCount;
+
+    static constexpr size_t kMaxShards = 16;
+
+    /**
+     * Point-in-time merge of all the shards of a histogram.
+     */
+    struct Snapshot {
+        /**
+         * Returns an upper bound on the latency, in microseconds, below which the given fraction
+         * of the recorded values fall, or 0 if nothing has been recorded.
+         */
+        long long percentile(double fraction) const;
+
+        std::array<long long, kNumBuckets> buckets{};
+        long long count = 0;
+        long long sum = 0;
+    };
+
+    /**
+     * Creates a histogram with one shard per core, up to kMaxShards. The number of shards is
+     * always rounded up to a power of two.
+     */
+    ShardedLatencyHistogram();
+    explicit ShardedLatencyHistogram(size_t numShards);
+
+    /**
+     * Records a single latency. Negative latencies are recorded as zero.
+     */
+    void record(Microseconds latency);
+
+    /**
+     * Merges all the shards. Concurrent calls to record() may or may not be reflected.
+     */
+    Snapshot snapshot() const;
+
+    /**
+     * Appends the number of recorded values, their sum and the p50, p90, p99 and p999 latencies
+     * to 'builder'. If 'includeHistograms' is true, also appends the non-empty buckets keyed by
+     * their inclusive lower bound, in the same format as the opLatencies serverStatus section.
+     */
+    void append(bool includeHistograms, BSONObjBuilder* builder) const;
+
+    size_t numShards() const {
+        return _shardMask + 1;
+    }
+
+    /**
+     * Returns the index of the bucket that 'micros' falls into.
+     */
+    static int getBucket(uint64_t micros);
+
+    /**
+     * Returns the inclusive lower bound, in microseconds, of 'bucket'.
+     */
+    static uint64_t getBucketLowerBound(int bucket);
+
+private:
+    struct Shard {
+        std::array<AtomicInt64, kNumBuckets> buckets;
+        AtomicInt64 sum;
+    };
+
+    size_t _currentShard() const;
+
+    const size_t _shardMask;
+    std::unique_ptr<CacheAligned<Shard>[]> _shards;
+};
+
+}  // namespace mongo
@@ -0,0 +1,163 @@
+
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/stats/sharded_latency_histogram.h"
+
+#include <vector>
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/stats/operation_phase_latencies.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using Histogram = ShardedLatencyHistogram;
+
+TEST(ShardedLatencyHistogram, BucketsAreContiguousAndMonotonic) {
+    ASSERT_EQ(0U, Histogram::getBucketLowerBound(0));
+    for (int bucket = 1; bucket < Histogram::kNumBuckets; ++bucket) {
+        const auto lowerBound = Histogram::getBucketLowerBound(bucket);
+        ASSERT_GT(lowerBound, Histogram::getBucketLowerBound(bucket - 1));
+        ASSERT_EQ(bucket, Histogram::getBucket(lowerBound));
+        ASSERT_EQ(bucket - 1, Histogram::getBucket(lowerBound - 1));
+    }
+}
+
+TEST(ShardedLatencyHistogram, RelativeErrorIsBounded) {
+    for (uint64_t micros = Histogram::kSubBucketCount; micros < (1ULL << 30);
+         micros = micros * 3 + 1) {
+        const auto lowerBound = Histogram::getBucketLowerBound(Histogram::getBucket(micros));
+        ASSERT_LTE(lowerBound, micros);
+        ASSERT_LT(micros - lowerBound, micros / Histogram::kSubBucketCount + 1);
+    }
+}
+
+TEST(ShardedLatencyHistogram, LargeValuesShareTheLastBucket) {
+    ASSERT_EQ(Histogram::kNumBuckets - 1, Histogram::getBucket(1ULL << Histogram::kMaxExponent));
+    ASSERT_EQ(Histogram::kNumBuckets - 1, Histogram::getBucket(~0ULL));
+}
+
+TEST(ShardedLatencyHistogram, ShardCountIsRoundedUpToPowerOfTwo) {
+    ASSERT_EQ(1U, Histogram(0).numShards());
+    ASSERT_EQ(1U, Histogram(1).numShards());
+    ASSERT_EQ(4U, Histogram(3).numShards());
+    ASSERT_LTE(Histogram().numShards(), Histogram::kMaxShards);
+}
+
+TEST(ShardedLatencyHistogram, SnapshotReportsCountSumAndPercentiles) {
+    Histogram hist(4);
+    for (int i = 1; i <= 1000; ++i) {
+        hist.record(Microseconds(i));
+    }
+    hist.record(Microseconds(-5));
+
+    auto snapshot = hist.snapshot();
+    ASSERT_EQ(1001, snapshot.count);
+    ASSERT_EQ(500500, snapshot.sum);
+
+    // Each percentile must be an upper bound within one sub-bucket of the exact value.
+    for (auto fraction : {0.5, 0.9, 0.99, 0.999}) {
+        const long long exact = static_cast<long long>(fraction * 1001);
+        const long long reported = snapshot.percentile(fraction);
+        ASSERT_GTE(reported, exact);
+        ASSERT_LTE(reported, exact + exact / Histogram::kSubBucketCount + 1);
+    }
+    ASSERT_EQ(0, Histogram(1).snapshot().percentile(0.99));
+}
+
+TEST(ShardedLatencyHistogram, ConcurrentRecordsAreNotLost) {
+    Histogram hist;
+    const int kThreads = 8;
+    const int kRecordsPerThread = 10000;
+
+    std::vector<stdx::thread> threads;
+    for (int i = 0; i < kThreads; ++i) {
+        threads.emplace_back([&hist, i] {
+            for (int j = 0; j < kRecordsPerThread; ++j) {
+                hist.record(Microseconds(i));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    auto snapshot = hist.snapshot();
+    ASSERT_EQ(kThreads * kRecordsPerThread, snapshot.count);
+    ASSERT_EQ(kRecordsPerThread * (kThreads * (kThreads - 1) / 2), snapshot.sum);
+}
+
+TEST(ShardedLatencyHistogram, AppendMatchesOpLatenciesFormat) {
+    Histogram hist(2);
+    hist.record(Microseconds(3));
+    hist.record(Microseconds(3));
+    hist.record(Microseconds(1000));
+
+    BSONObjBuilder builder;
+    hist.append(true, &builder);
+    auto obj = builder.obj();
+
+    ASSERT_EQ(1006, obj["latency"].numberLong());
+    ASSERT_EQ(3, obj["ops"].numberLong());
+    ASSERT_EQ(3, obj["p50"].numberLong());
+    ASSERT_GTE(obj["p99"].numberLong(), 1000);
+
+    auto histogram = obj["histogram"].Array();
+    ASSERT_EQ(2U, histogram.size());
+    ASSERT_BSONOBJ_EQ(BSON("micros" << 3LL << "count" << 2LL), histogram[0].Obj());
+    ASSERT_EQ(1LL, histogram[1].Obj()["count"].numberLong());
+
+    BSONObjBuilder withoutHistograms;
+    hist.append(false, &withoutHistograms);
+    ASSERT_FALSE(withoutHistograms.obj().hasField("histogram"));
+}
+
+TEST(OperationPhaseLatencies, CommandPhasesExcludeNetworkWrite) {
+    OperationPhaseLatencies phases(OperationPhaseLatencies::kNumCommandPhases);
+    phases.record(OperationPhase::kLockAcquisition, Microseconds(2));
+    phases.record(OperationPhase::kExecution, Microseconds(10));
+
+    BSONObjBuilder builder;
+    phases.append(false, &builder);
+    auto obj = builder.obj();
+
+    ASSERT_EQ(3, obj.nFields());
+    ASSERT_EQ(2, obj["lockAcquisition"]["latency"].numberLong());
+    ASSERT_EQ(0, obj["queryPlanning"]["ops"].numberLong());
+    ASSERT_EQ(10, obj["execution"]["latency"].numberLong());
+    ASSERT_FALSE(obj.hasField("networkWrite"));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -45,6 +45,7 @@
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/json.h"
 #include "mongo/db/repl/repl_settings.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/key_string.h"
 #include "mongo/db/storage/storage_options.h"
@@ -59,6 +60,7 @@
 #include "mongo/util/hex.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
 
 #define TRACING_ENABLED 0
 
@@ -79,6 +81,13 @@ namespace {
 
 MONGO_FAIL_POINT_DEFINE(WTEmulateOutOfOrderNextIndexKey);
 
+// Keep a filter of the keys in each timestamp safe unique index, which lets inserts of keys the
+// index does not hold skip searching it for a duplicate.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(wiredTigerUniqueIndexKeyFilter, bool, false);
+
+// The fewest keys a unique index key filter is sized for.
+const std::size_t kMinKeyFilterCapacity = 16 * 1024;
+
 using std::string;
 using std::vector;
 
@@ -656,11 +665,13 @@ public:
     UniqueBulkBuilder(WiredTigerIndex* idx,
                       OperationContext* opCtx,
                       bool dupsAllowed,
-                      KVPrefix prefix)
+                      KVPrefix prefix,
+                      WiredTigerUniqueKeyFilter* keyFilter)
         : BulkBuilder(idx, opCtx, prefix),
           _idx(idx),
           _dupsAllowed(dupsAllowed),
-          _keyString(idx->keyStringVersion()) {}
+          _keyString(idx->keyStringVersion()),
+          _keyFilter(keyFilter) {}
 
     StatusWith<SpecialFormatInserted> addKey(const BSONObj& newKey, const RecordId& id) override {
         if (_idx->isTimestampSafeUniqueIdx()) {
@@ -713,6 +724,13 @@ private:
 
         invariantWTOK(_cursor->insert(_cursor));
 
+        if (_keyFilter) {
+            _keyFilter->add(WiredTigerUniqueKeyFilter::hash(
+                _keyString.getBuffer(),
+                KeyString::sizeWithoutRecordIdAtEnd(_keyString.getBuffer(),
+                                                    _keyString.getSize())));
+        }
+
         // Don't copy the key again if dups are allowed.
         if (!_dupsAllowed)
             _previousKey = newKey.getOwned();
@@ -787,6 +805,7 @@ private:
     WiredTigerIndex* _idx;
     const bool _dupsAllowed;
     KeyString _keyString;
+    WiredTigerUniqueKeyFilter* const _keyFilter;
     std::vector<std::pair<RecordId, KeyString::TypeBits>> _records;
     BSONObj _previousKey;
 };
@@ -1246,7 +1265,51 @@ WiredTigerIndexUnique::WiredTigerIndexUnique(OperationContext* ctx,
                                              const IndexDescriptor* desc,
                                              KVPrefix prefix,
                                              bool isReadOnly)
-    : WiredTigerIndex(ctx, uri, desc, prefix, isReadOnly), _partial(desc->isPartial()) {}
+    : WiredTigerIndex(ctx, uri, desc, prefix, isReadOnly), _partial(desc->isPartial()) {
+    if (wiredTigerUniqueIndexKeyFilter && !isReadOnly && isTimestampSafeUniqueIdx() &&
+        _prefix == KVPrefix::kNotPrefixed) {
+        _buildKeyFilter(ctx);
+    }
+}
+
+void WiredTigerIndexUnique::_buildKeyFilter(OperationContext* opCtx) {
+    // Indexes are only constructed while no other operation can write to them, so the keys read
+    // here cannot change before the filter is installed.
+    std::vector<WiredTigerUniqueKeyFilter::Hash> hashes;
+    {
+        // Use a different session to ensure we don't hijack an existing transaction.
+        UniqueWiredTigerSession session =
+            WiredTigerRecoveryUnit::get(opCtx)->getSessionCache()->getSession();
+        WT_SESSION* s = session->getSession();
+        WT_CURSOR* c;
+        invariantWTOK(s->open_cursor(s, _uri.c_str(), NULL, NULL, &c));
+        ON_BLOCK_EXIT([c] { invariantWTOK(c->close(c)); });
+
+        // Only the version of the type bits is used to find the size of the key.
+        const KeyString::TypeBits typeBits(keyStringVersion());
+        int ret;
+        while ((ret = c->next(c)) == 0) {
+            WT_ITEM item;
+            getKey(c, &item);
+            // Keys in the timestamp safe format end with a RecordId, which is not part of the
+            // unique key. Keys in the old format do not.
+            const char* data = static_cast<const char*>(item.data);
+            hashes.push_back(WiredTigerUniqueKeyFilter::hash(
+                data, KeyString::getKeySize(data, item.size, _ordering, typeBits)));
+        }
+        if (ret != WT_NOTFOUND)
+            invariantWTOK(ret);
+    }
+
+    _keyFilter = std::make_shared<WiredTigerUniqueKeyFilter>(
+        std::max(kMinKeyFilterCapacity, 2 * hashes.size()));
+    for (const auto& hash : hashes) {
+        _keyFilter->add(hash);
+    }
+    LOG(1) << "Built key filter for unique index " << _indexName << " on "
+           << _collectionNamespace << " with " << hashes.size() << " keys using "
+           << _keyFilter->getMemoryUsageBytes() << " bytes";
+}
 
 std::unique_ptr<SortedDataInterface::Cursor> WiredTigerIndexUnique::newCursor(
     OperationContext* opCtx, bool forward) const {
@@ -1255,7 +1318,7 @@ std::unique_ptr<SortedDataInterface::Cursor> WiredTigerIndexUnique::newCursor(
 
 SortedDataBuilderInterface* WiredTigerIndexUnique::getBulkBuilder(OperationContext* opCtx,
                                                                   bool dupsAllowed) {
-    return new UniqueBulkBuilder(this, opCtx, dupsAllowed, _prefix);
+    return new UniqueBulkBuilder(this, opCtx, dupsAllowed, _prefix, _keyFilter.get());
 }
 
 bool WiredTigerIndexUnique::isTimestampSafeUniqueIdx() const {
@@ -1476,8 +1539,13 @@ StatusWith<SpecialFormatInserted> WiredTigerIndexUnique::_insertTimestampSafe(
         ret = WT_OP_CHECK(c->remove(c));
         invariantWTOK(ret);
 
-        // Second phase looks up for existence of key to avoid insertion of duplicate key
-        if (_keyExists(opCtx, c, prefixKey))
+        // Second phase looks up for existence of key to avoid insertion of duplicate key. The key
+        // filter rules out most keys the index does not hold without searching for them.
+        const bool mayExist = !_keyFilter ||
+            _keyFilter->mayContain(
+                WiredTigerUniqueKeyFilter::hash(prefixKey.getBuffer(), prefixKey.getSize()),
+                WiredTigerRecoveryUnit::get(opCtx)->getKeyFilterSnapshotTick());
+        if (mayExist && _keyExists(opCtx, c, prefixKey))
             return buildDupKeyErrorStatus(key, _collectionNamespace, _indexName, _keyPattern);
     }
 
@@ -1496,6 +1564,15 @@ StatusWith<SpecialFormatInserted> WiredTigerIndexUnique::_insertTimestampSafe(
     if (ret != WT_DUPLICATE_KEY)
         invariantWTOK(ret);
 
+    if (_keyFilter && ret == 0) {
+        const auto hash = WiredTigerUniqueKeyFilter::hash(
+            tableKey.getBuffer(),
+            KeyString::sizeWithoutRecordIdAtEnd(tableKey.getBuffer(), tableKey.getSize()));
+        _keyFilter->add(hash);
+        opCtx->recoveryUnit()->onRollback(
+            [ keyFilter = _keyFilter, hash ] { keyFilter->undoAdd(hash); });
+    }
+
     if (tableKey.getTypeBits().isLongEncoding())
         return StatusWith<SpecialFormatInserted>(SpecialFormatInserted::LongTypeBitsInserted);
 
@@ -1619,6 +1696,18 @@ void WiredTigerIndexUnique::_unindexTimestampUnsafe(OperationContext* opCtx,
     invariantWTOK(c->update(c));
 }
 
+void WiredTigerIndexUnique::_removeFromKeyFilterOnCommit(OperationContext* opCtx,
+                                                         const char* key,
+                                                         size_t size) {
+    if (!_keyFilter) {
+        return;
+    }
+    // Until the removal commits, other transactions may still see the key.
+    opCtx->recoveryUnit()->onCommit(
+        [ keyFilter = _keyFilter, hash = WiredTigerUniqueKeyFilter::hash(key, size) ](
+            boost::optional<Timestamp>) { keyFilter->remove(hash); });
+}
+
 void WiredTigerIndexUnique::_unindexTimestampSafe(OperationContext* opCtx,
                                                   WT_CURSOR* c,
                                                   const BSONObj& key,
@@ -1630,6 +1719,10 @@ void WiredTigerIndexUnique::_unindexTimestampSafe(OperationContext* opCtx,
     int ret = WT_OP_CHECK(c->remove(c));
     if (ret != WT_NOTFOUND) {
         invariantWTOK(ret);
+        _removeFromKeyFilterOnCommit(
+            opCtx,
+            data.getBuffer(),
+            KeyString::sizeWithoutRecordIdAtEnd(data.getBuffer(), data.getSize()));
         return;
     }
 
@@ -1644,6 +1737,7 @@ void WiredTigerIndexUnique::_unindexTimestampSafe(OperationContext* opCtx,
     ret = WT_OP_CHECK(c->remove(c));
     if (ret != WT_NOTFOUND) {
         invariantWTOK(ret);
+        _removeFromKeyFilterOnCommit(opCtx, oldFormatKey.getBuffer(), oldFormatKey.getSize());
         return;
     }
     // Otherwise WT_NOTFOUND is only expected during a background index build. Insert a dummy value
@@ -39,6 +39,7 @@
 #include "mongo/db/storage/sorted_data_interface.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_prepare_conflict.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_unique_key_filter.h"
 
 namespace mongo {
 
@@ -213,6 +214,13 @@ public:
 
     bool isDup(OperationContext* opCtx, WT_CURSOR* c, const BSONObj& key) override;
 
+    /**
+     * Returns the key filter of this index, or nullptr if it does not keep one.
+     */
+    const WiredTigerUniqueKeyFilter* getKeyFilter_forTest() const {
+        return _keyFilter.get();
+    }
+
     StatusWith<SpecialFormatInserted> _insert(OperationContext* opCtx,
                                               WT_CURSOR* c,
                                               const BSONObj& key,
@@ -255,7 +263,23 @@ private:
      */
     bool _keyExists(OperationContext* opCtx, WT_CURSOR* c, const KeyString& key);
 
+    /**
+     * Fills '_keyFilter' with the key of every entry in the index.
+     */
+    void _buildKeyFilter(OperationContext* opCtx);
+
+    /**
+     * Takes the index key encoded by the 'size' bytes at 'key' out of '_keyFilter' once the
+     * removal of its entry commits.
+     */
+    void _removeFromKeyFilterOnCommit(OperationContext* opCtx, const char* key, size_t size);
+
     bool _partial;
+
+    // Lets inserts skip the search for a duplicate key. Only kept for timestamp safe unique
+    // indexes, and only if the 'wiredTigerUniqueIndexKeyFilter' startup parameter is set. Shared
+    // with the commit and rollback handlers which maintain it.
+    std::shared_ptr<WiredTigerUniqueKeyFilter> _keyFilter;
 };
 
 class WiredTigerIndexStandard : public WiredTigerIndex {
@@ -34,6 +34,7 @@
 #include "mongo/db/operation_context.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
+#include "mongo/db/wait_event_stats.h"
 #include "mongo/util/fail_point_service.h"
 
 namespace mongo {
@@ -71,6 +72,7 @@ int wiredTigerPrepareConflictRetry(OperationContext* opCtx, F&& f) {
         CurOp::get(opCtx)->debug().additiveMetrics.incrementPrepareReadConflicts(1);
         wiredTigerPrepareConflictLog(attempts);
         // Wait on the session cache to signal that a unit of work has been committed or aborted.
+        ScopedWaitEvent prepareWait(opCtx, WaitEventClass::kPrepareConflict);
         recoveryUnit->getSessionCache()->waitUntilPreparedUnitOfWorkCommitsOrAborts(opCtx);
     }
 }
@@ -372,6 +372,14 @@ void WiredTigerRecoveryUnit::_txnOpen() {
     }
     WT_SESSION* session = _session->getSession();
 
+    // Take the tick before the snapshot is opened, so that any removal from a unique index key
+    // filter this txn does not see has a later tick.
+    const bool readsLatest = (_timestampReadSource == ReadSource::kUnset ||
+                              _timestampReadSource == ReadSource::kNoTimestamp) &&
+        !_isOplogReader;
+    _keyFilterSnapshotTick = readsLatest ? WiredTigerUniqueKeyFilter::currentTick()
+                                         : WiredTigerUniqueKeyFilter::kUntrustedSnapshotTick;
+
     switch (_timestampReadSource) {
         case ReadSource::kUnset:
         case ReadSource::kNoTimestamp: {
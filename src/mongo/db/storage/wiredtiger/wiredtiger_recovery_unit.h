@@ -45,6 +45,7 @@
 #include "mongo/db/storage/recovery_unit.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_begin_transaction_block.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_unique_key_filter.h"
 #include "mongo/util/timer.h"
 
 namespace mongo {
@@ -143,6 +144,15 @@ public:
     WiredTigerSessionCache* getSessionCache() {
         return _sessionCache;
     }
+
+    /**
+     * Returns the unique index key filter tick taken when the current WT txn was started, or
+     * WiredTigerUniqueKeyFilter::kUntrustedSnapshotTick if the txn reads at a timestamp.
+     */
+    std::uint64_t getKeyFilterSnapshotTick() const {
+        return _keyFilterSnapshotTick;
+    }
+
     bool inActiveTxn() const {
         return _isActive();
     }
@@ -263,6 +273,7 @@ private:
     Timestamp _readAtTimestamp;
     std::unique_ptr<Timer> _timer;
     bool _isOplogReader = false;
+    std::uint64_t _keyFilterSnapshotTick = WiredTigerUniqueKeyFilter::kUntrustedSnapshotTick;
     typedef std::vector<std::unique_ptr<Change>> Changes;
     Changes _changes;
 };
@@ -0,0 +1,252 @@
+
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <memory>
+
+#include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/storage/kv/kv_prefix.h"
+#include "mongo/db/storage/test_harness_helper.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_index.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_unique_key_filter.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/unittest/ensure_fcv.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using unittest::EnsureFCV;
+
+const BSONObj key1 = BSON("" << 1);
+const BSONObj key2 = BSON("" << 2);
+const BSONObj key3 = BSON("" << 3);
+
+const RecordId loc1(0, 42);
+const RecordId loc2(0, 44);
+const RecordId loc3(0, 46);
+
+void setKeyFilterEnabled(bool enabled) {
+    auto param = ServerParameterSet::getGlobal()->getMap().find("wiredTigerUniqueIndexKeyFilter");
+    invariant(param != ServerParameterSet::getGlobal()->getMap().end());
+    ASSERT_OK(param->second->setFromString(enabled ? "true" : "false"));
+}
+
+/**
+ * Creates a timestamp safe unique index with the 'wiredTigerUniqueIndexKeyFilter' startup
+ * parameter set, and opens index objects on it. Each index object builds its key filter from the
+ * entries the index holds when it is opened, as happens at startup.
+ */
+class KeyFilterHarnessHelper final : public HarnessHelper {
+public:
+    KeyFilterHarnessHelper()
+        : _fcv(EnsureFCV::Version::kFullyUpgradedTo42), _dbpath("wt_test"), _conn(NULL) {
+        setKeyFilterEnabled(true);
+
+        const char* config = "create,cache_size=1G,";
+        int ret = wiredtiger_open(_dbpath.path().c_str(), NULL, config, &_conn);
+        invariantWTOK(ret);
+
+        _sessionCache = new WiredTigerSessionCache(_conn);
+
+        IndexDescriptor desc(NULL, "", _spec);
+        StatusWith<std::string> result = WiredTigerIndex::generateCreateString(
+            kWiredTigerEngineName, "", "", desc, KVPrefix::kNotPrefixed.isPrefixed());
+        ASSERT_OK(result.getStatus());
+
+        auto opCtx = newOperationContext();
+        invariantWTOK(WiredTigerIndex::Create(opCtx.get(), _uri, result.getValue()));
+    }
+
+    ~KeyFilterHarnessHelper() {
+        delete _sessionCache;
+        _conn->close(_conn, NULL);
+        setKeyFilterEnabled(false);
+    }
+
+    std::unique_ptr<WiredTigerIndexUnique> openIndex() {
+        auto opCtx = newOperationContext();
+        IndexDescriptor desc(NULL, "", _spec);
+        auto index = stdx::make_unique<WiredTigerIndexUnique>(
+            opCtx.get(), _uri, &desc, KVPrefix::kNotPrefixed);
+        ASSERT(index->isTimestampSafeUniqueIdx());
+        ASSERT(index->getKeyFilter_forTest());
+        return index;
+    }
+
+    std::unique_ptr<RecoveryUnit> newRecoveryUnit() final {
+        return stdx::make_unique<WiredTigerRecoveryUnit>(_sessionCache, &_oplogManager);
+    }
+
+private:
+    const BSONObj _spec = BSON("key" << BSON("a" << 1) << "name"
+                                     << "testIndex"
+                                     << "v"
+                                     << static_cast<int>(IndexDescriptor::kLatestIndexVersion)
+                                     << "ns"
+                                     << "test.wt"
+                                     << "unique"
+                                     << true);
+    const std::string _uri = "table:test.wt";
+
+    EnsureFCV _fcv;
+    unittest::TempDir _dbpath;
+    WT_CONNECTION* _conn;
+    WiredTigerSessionCache* _sessionCache;
+    WiredTigerOplogManager _oplogManager;
+};
+
+void insertAndCommit(KeyFilterHarnessHelper* harnessHelper,
+                     WiredTigerIndexUnique* index,
+                     const BSONObj& key,
+                     const RecordId& loc) {
+    auto opCtx = harnessHelper->newOperationContext();
+    WriteUnitOfWork uow(opCtx.get());
+    ASSERT_OK(index->insert(opCtx.get(), key, loc, false));
+    uow.commit();
+}
+
+void unindexAndCommit(KeyFilterHarnessHelper* harnessHelper,
+                      WiredTigerIndexUnique* index,
+                      const BSONObj& key,
+                      const RecordId& loc) {
+    auto opCtx = harnessHelper->newOperationContext();
+    WriteUnitOfWork uow(opCtx.get());
+    index->unindex(opCtx.get(), key, loc, false);
+    uow.commit();
+}
+
+void assertDuplicate(KeyFilterHarnessHelper* harnessHelper,
+                     WiredTigerIndexUnique* index,
+                     const BSONObj& key,
+                     const RecordId& loc) {
+    auto opCtx = harnessHelper->newOperationContext();
+    WriteUnitOfWork uow(opCtx.get());
+    ASSERT_EQUALS(ErrorCodes::DuplicateKey, index->insert(opCtx.get(), key, loc, false));
+}
+
+TEST(WiredTigerUniqueIndexKeyFilterTest, DuplicateRejectedWhenFilterBuiltFromExistingIndex) {
+    KeyFilterHarnessHelper harnessHelper;
+    {
+        auto index = harnessHelper.openIndex();
+        insertAndCommit(&harnessHelper, index.get(), key1, loc1);
+        insertAndCommit(&harnessHelper, index.get(), key2, loc2);
+    }
+
+    auto index = harnessHelper.openIndex();
+    ASSERT_EQUALS(2, index->getKeyFilter_forTest()->getNumKeys());
+    assertDuplicate(&harnessHelper, index.get(), key1, loc3);
+    assertDuplicate(&harnessHelper, index.get(), key2, loc3);
+    insertAndCommit(&harnessHelper, index.get(), key3, loc3);
+}
+
+TEST(WiredTigerUniqueIndexKeyFilterTest, DuplicateRejectedAfterDeleteAndReinsert) {
+    KeyFilterHarnessHelper harnessHelper;
+    auto index = harnessHelper.openIndex();
+    insertAndCommit(&harnessHelper, index.get(), key1, loc1);
+
+    unindexAndCommit(&harnessHelper, index.get(), key1, loc1);
+    ASSERT_EQUALS(0, index->getKeyFilter_forTest()->getNumKeys());
+
+    insertAndCommit(&harnessHelper, index.get(), key1, loc2);
+    ASSERT_EQUALS(1, index->getKeyFilter_forTest()->getNumKeys());
+    assertDuplicate(&harnessHelper, index.get(), key1, loc3);
+}
+
+TEST(WiredTigerUniqueIndexKeyFilterTest, SnapshotOpenedBeforeDeleteStillSeesDuplicate) {
+    KeyFilterHarnessHelper harnessHelper;
+    auto index = harnessHelper.openIndex();
+    insertAndCommit(&harnessHelper, index.get(), key1, loc1);
+
+    // Open a snapshot which sees the entry for 'key1'.
+    auto opCtx = harnessHelper.newOperationContext();
+    WriteUnitOfWork uow(opCtx.get());
+    {
+        auto cursor = index->newCursor(opCtx.get(), true);
+        ASSERT_EQ(cursor->seekExact(key1), IndexKeyEntry(key1, loc1));
+    }
+
+    // Delete the entry from another transaction, which clears the key from the filter.
+    {
+        auto client = harnessHelper.serviceContext()->makeClient("unindex");
+        auto otherOpCtx = harnessHelper.newOperationContext(client.get());
+        WriteUnitOfWork otherUow(otherOpCtx.get());
+        index->unindex(otherOpCtx.get(), key1, loc1, false);
+        otherUow.commit();
+    }
+    ASSERT_EQUALS(0, index->getKeyFilter_forTest()->getNumKeys());
+
+    // The older snapshot must still search for, and find, the deleted entry.
+    ASSERT_EQUALS(ErrorCodes::DuplicateKey, index->insert(opCtx.get(), key1, loc2, false));
+}
+
+TEST(WiredTigerUniqueIndexKeyFilterTest, RolledBackInsertIsTakenOutOfFilter) {
+    KeyFilterHarnessHelper harnessHelper;
+    auto index = harnessHelper.openIndex();
+    {
+        auto opCtx = harnessHelper.newOperationContext();
+        WriteUnitOfWork uow(opCtx.get());
+        ASSERT_OK(index->insert(opCtx.get(), key1, loc1, false));
+        ASSERT_EQUALS(1, index->getKeyFilter_forTest()->getNumKeys());
+        // Not committed.
+    }
+    ASSERT_EQUALS(0, index->getKeyFilter_forTest()->getNumKeys());
+
+    insertAndCommit(&harnessHelper, index.get(), key1, loc2);
+    assertDuplicate(&harnessHelper, index.get(), key1, loc3);
+}
+
+TEST(WiredTigerUniqueIndexKeyFilterTest, DuplicateRejectedAfterBulkBuild) {
+    KeyFilterHarnessHelper harnessHelper;
+    auto index = harnessHelper.openIndex();
+    {
+        auto opCtx = harnessHelper.newOperationContext();
+        const std::unique_ptr<SortedDataBuilderInterface> builder(
+            index->getBulkBuilder(opCtx.get(), false));
+        ASSERT_OK(builder->addKey(key1, loc1));
+        ASSERT_OK(builder->addKey(key2, loc2));
+        builder->commit(false);
+    }
+    ASSERT_EQUALS(2, index->getKeyFilter_forTest()->getNumKeys());
+
+    assertDuplicate(&harnessHelper, index.get(), key1, loc3);
+    assertDuplicate(&harnessHelper, index.get(), key2, loc3);
+    insertAndCommit(&harnessHelper, index.get(), key3, loc3);
+}
+
+}  // namespace
+}  // namespace mongo
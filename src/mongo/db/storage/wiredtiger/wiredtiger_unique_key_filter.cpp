@@ -0,0 +1,158 @@
+
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_unique_key_filter.h"
+
+#include <algorithm>
+#include <third_party/murmurhash3/MurmurHash3.h>
+
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+namespace {
+
+const std::uint32_t kHashSeed = 0x2d9bc7e5;
+
+}  // namespace
+
+AtomicWord<std::uint64_t> WiredTigerUniqueKeyFilter::_tick(1);
+
+WiredTigerUniqueKeyFilter::Hash WiredTigerUniqueKeyFilter::hash(const char* data,
+                                                                std::size_t size) {
+    std::uint64_t out[2];
+    MurmurHash3_x64_128(data, static_cast<int>(size), kHashSeed, out);
+    // An odd step visits distinct counters for each of the hashes, as the number of counters is
+    // a power of two.
+    return {out[0], out[1] | 1};
+}
+
+std::uint64_t WiredTigerUniqueKeyFilter::currentTick() {
+    return _tick.load();
+}
+
+WiredTigerUniqueKeyFilter::WiredTigerUniqueKeyFilter(std::size_t capacity)
+    : _capacity(std::max<std::size_t>(capacity, 1)) {
+    _numCounters = kCountersPerWord;
+    while (_numCounters < _capacity * kCountersPerKey) {
+        _numCounters *= 2;
+    }
+    _numWords = _numCounters / kCountersPerWord;
+    _words.reset(new Word[_numWords]);
+}
+
+void WiredTigerUniqueKeyFilter::add(const Hash& hash) {
+    for (int i = 0; i < kNumHashes; ++i) {
+        _increment(_counterIndex(hash, i));
+    }
+    _numKeys.fetchAndAdd(1);
+}
+
+void WiredTigerUniqueKeyFilter::undoAdd(const Hash& hash) {
+    _numKeys.fetchAndSubtract(1);
+    for (int i = 0; i < kNumHashes; ++i) {
+        _decrement(_counterIndex(hash, i));
+    }
+}
+
+void WiredTigerUniqueKeyFilter::remove(const Hash& hash) {
+    // Publish the removal before the key's counters can drop, so that a transaction which finds
+    // them clear also finds that its snapshot may predate the removal.
+    const std::uint64_t tick = _tick.fetchAndAdd(1) + 1;
+    std::uint64_t last = _lastRemovalTick.load();
+    while (last < tick) {
+        const std::uint64_t seen = _lastRemovalTick.compareAndSwap(last, tick);
+        if (seen == last) {
+            break;
+        }
+        last = seen;
+    }
+
+    undoAdd(hash);
+}
+
+bool WiredTigerUniqueKeyFilter::mayContain(const Hash& hash, std::uint64_t snapshotTick) const {
+    bool absent = false;
+    for (int i = 0; i < kNumHashes; ++i) {
+        if (!_isSet(_counterIndex(hash, i))) {
+            absent = true;
+            break;
+        }
+    }
+    if (!absent) {
+        return true;
+    }
+
+    // The counters are read before the removal tick, which pairs with remove() to ensure a clear
+    // counter left by a removal the snapshot may not reflect is never trusted.
+    return snapshotTick == kUntrustedSnapshotTick || _lastRemovalTick.load() > snapshotTick ||
+        _numKeys.load() > static_cast<long long>(_capacity);
+}
+
+void WiredTigerUniqueKeyFilter::_increment(std::size_t counter) {
+    Word& word = _words[counter / kCountersPerWord];
+    const int shift = (counter % kCountersPerWord) * 4;
+    std::uint32_t current = word.load();
+    while (((current >> shift) & kMaxCount) != kMaxCount) {
+        const std::uint32_t seen = word.compareAndSwap(current, current + (1u << shift));
+        if (seen == current) {
+            return;
+        }
+        current = seen;
+    }
+}
+
+void WiredTigerUniqueKeyFilter::_decrement(std::size_t counter) {
+    Word& word = _words[counter / kCountersPerWord];
+    const int shift = (counter % kCountersPerWord) * 4;
+    std::uint32_t current = word.load();
+    while (true) {
+        const std::uint32_t count = (current >> shift) & kMaxCount;
+        // A saturated counter no longer knows how many keys use it, so it is left set.
+        if (count == kMaxCount) {
+            return;
+        }
+        invariant(count != 0);
+        const std::uint32_t seen = word.compareAndSwap(current, current - (1u << shift));
+        if (seen == current) {
+            return;
+        }
+        current = seen;
+    }
+}
+
+bool WiredTigerUniqueKeyFilter::_isSet(std::size_t counter) const {
+    const std::uint32_t word = _words[counter / kCountersPerWord].load();
+    return (word >> ((counter % kCountersPerWord) * 4)) & kMaxCount;
+}
+
+}  // namespace mongo
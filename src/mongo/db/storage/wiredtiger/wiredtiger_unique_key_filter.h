@@ -0,0 +1,151 @@
+
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/platform/atomic_word.h"
+
+namespace mongo {
+
+/**
+ * A counting Bloom filter over the keys of a unique index, which lets an insert skip the search
+ * for a duplicate of a key the index certainly does not hold. Each key sets several 4-bit
+ * counters chosen by hashing its KeyString without the RecordId. A key is possibly present if
+ * all of its counters are non-zero. A counter which reaches its maximum stays there, so it can
+ * never drop to zero while a key still uses it.
+ *
+ * A key is added when its index entry is inserted, and taken away again if that insert rolls
+ * back or once the entry's removal commits. A transaction reading from a snapshot opened before
+ * a removal committed may still see the removed key. Removals therefore advance a tick, and only
+ * a transaction whose snapshot was opened at or after the filter's most recent removal may trust
+ * the filter's answer that a key is absent.
+ *
+ * The filter is sized when it is built. If it comes to hold more keys than that size allows, it
+ * reports every key as possibly present until enough are removed.
+ *
+ * All methods are thread-safe.
+ */
+class WiredTigerUniqueKeyFilter {
+    MONGO_DISALLOW_COPYING(WiredTigerUniqueKeyFilter);
+
+public:
+    struct Hash {
+        std::uint64_t h1;
+        std::uint64_t h2;
+    };
+
+    /**
+     * Returns the hash of the index key encoded by the 'size' bytes at 'data'.
+     */
+    static Hash hash(const char* data, std::size_t size);
+
+    /**
+     * Returns the current removal tick. Taken before a transaction opens its snapshot, and
+     * passed to mayContain() by inserts made in that transaction.
+     */
+    static std::uint64_t currentTick();
+
+    /**
+     * Stands for a snapshot which may be older than any removal, for which the filter never
+     * reports a key absent.
+     */
+    static constexpr std::uint64_t kUntrustedSnapshotTick = 0;
+
+    /**
+     * Builds a filter sized to hold 'capacity' keys with a false positive rate of about 1%.
+     */
+    explicit WiredTigerUniqueKeyFilter(std::size_t capacity);
+
+    void add(const Hash& hash);
+
+    /**
+     * Takes away a key whose insert rolled back. No other transaction can have seen its entry.
+     */
+    void undoAdd(const Hash& hash);
+
+    /**
+     * Takes away a key whose removal has committed.
+     */
+    void remove(const Hash& hash);
+
+    /**
+     * Returns false only if no index entry with the key can be visible to a transaction whose
+     * snapshot was opened at 'snapshotTick'.
+     */
+    bool mayContain(const Hash& hash, std::uint64_t snapshotTick) const;
+
+    std::size_t getCapacity() const {
+        return _capacity;
+    }
+
+    long long getNumKeys() const {
+        return _numKeys.load();
+    }
+
+    std::size_t getMemoryUsageBytes() const {
+        return _numWords * sizeof(Word);
+    }
+
+private:
+    using Word = AtomicWord<std::uint32_t>;
+
+    static constexpr int kNumHashes = 7;
+    static constexpr std::size_t kCountersPerKey = 10;
+    static constexpr std::size_t kCountersPerWord = 8;
+    static constexpr std::uint32_t kMaxCount = 0xF;
+
+    std::size_t _counterIndex(const Hash& hash, int i) const {
+        return (hash.h1 + i * hash.h2) & (_numCounters - 1);
+    }
+
+    void _increment(std::size_t counter);
+    void _decrement(std::size_t counter);
+    bool _isSet(std::size_t counter) const;
+
+    // Advanced by every committed removal, across all filters.
+    static AtomicWord<std::uint64_t> _tick;
+
+    const std::size_t _capacity;
+    std::size_t _numCounters;
+    std::size_t _numWords;
+    std::unique_ptr<Word[]> _words;
+
+    AtomicWord<long long> _numKeys;
+
+    // The tick of the most recent removal from this filter.
+    AtomicWord<std::uint64_t> _lastRemovalTick;
+};
+
+}  // namespace mongo
@@ -0,0 +1,144 @@
+
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <string>
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_unique_key_filter.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+WiredTigerUniqueKeyFilter::Hash hashOf(const std::string& key) {
+    return WiredTigerUniqueKeyFilter::hash(key.data(), key.size());
+}
+
+TEST(WiredTigerUniqueKeyFilterTest, EmptyFilterContainsNothing) {
+    WiredTigerUniqueKeyFilter filter(100);
+    const auto tick = WiredTigerUniqueKeyFilter::currentTick();
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_FALSE(filter.mayContain(hashOf(std::to_string(i)), tick));
+    }
+    ASSERT_EQ(0, filter.getNumKeys());
+}
+
+TEST(WiredTigerUniqueKeyFilterTest, AddedKeysAreAlwaysPresent) {
+    WiredTigerUniqueKeyFilter filter(1000);
+    for (int i = 0; i < 1000; ++i) {
+        filter.add(hashOf(std::to_string(i)));
+    }
+    const auto tick = WiredTigerUniqueKeyFilter::currentTick();
+    for (int i = 0; i < 1000; ++i) {
+        ASSERT_TRUE(filter.mayContain(hashOf(std::to_string(i)), tick));
+    }
+    ASSERT_EQ(1000, filter.getNumKeys());
+}
+
+TEST(WiredTigerUniqueKeyFilterTest, FalsePositiveRateIsLowAtCapacity) {
+    WiredTigerUniqueKeyFilter filter(10000);
+    for (int i = 0; i < 10000; ++i) {
+        filter.add(hashOf("present" + std::to_string(i)));
+    }
+    const auto tick = WiredTigerUniqueKeyFilter::currentTick();
+    int falsePositives = 0;
+    for (int i = 0; i < 10000; ++i) {
+        if (filter.mayContain(hashOf("absent" + std::to_string(i)), tick)) {
+            ++falsePositives;
+        }
+    }
+    ASSERT_LT(falsePositives, 300);
+}
+
+TEST(WiredTigerUniqueKeyFilterTest, UndoneAddIsAbsent) {
+    WiredTigerUniqueKeyFilter filter(100);
+    filter.add(hashOf("a"));
+    filter.add(hashOf("b"));
+    filter.undoAdd(hashOf("a"));
+    const auto tick = WiredTigerUniqueKeyFilter::currentTick();
+    ASSERT_FALSE(filter.mayContain(hashOf("a"), tick));
+    ASSERT_TRUE(filter.mayContain(hashOf("b"), tick));
+    ASSERT_EQ(1, filter.getNumKeys());
+}
+
+TEST(WiredTigerUniqueKeyFilterTest, RemovalIsOnlyTrustedBySnapshotsOpenedAfterIt) {
+    WiredTigerUniqueKeyFilter filter(100);
+    filter.add(hashOf("a"));
+    const auto before = WiredTigerUniqueKeyFilter::currentTick();
+    filter.remove(hashOf("a"));
+    const auto after = WiredTigerUniqueKeyFilter::currentTick();
+    ASSERT_GT(after, before);
+
+    ASSERT_TRUE(filter.mayContain(hashOf("a"), before));
+    ASSERT_FALSE(filter.mayContain(hashOf("a"), after));
+    ASSERT_EQ(0, filter.getNumKeys());
+}
+
+TEST(WiredTigerUniqueKeyFilterTest, UntrustedSnapshotSeesEveryKey) {
+    WiredTigerUniqueKeyFilter filter(100);
+    ASSERT_TRUE(
+        filter.mayContain(hashOf("a"), WiredTigerUniqueKeyFilter::kUntrustedSnapshotTick));
+}
+
+TEST(WiredTigerUniqueKeyFilterTest, OverloadedFilterReportsEveryKeyPresent) {
+    WiredTigerUniqueKeyFilter filter(1000);
+    for (int i = 0; i <= 1000; ++i) {
+        filter.add(hashOf("present" + std::to_string(i)));
+    }
+    const auto countPositives = [&] {
+        const auto tick = WiredTigerUniqueKeyFilter::currentTick();
+        int positives = 0;
+        for (int i = 0; i < 1000; ++i) {
+            if (filter.mayContain(hashOf("absent" + std::to_string(i)), tick)) {
+                ++positives;
+            }
+        }
+        return positives;
+    };
+    ASSERT_EQ(1000, countPositives());
+
+    filter.undoAdd(hashOf("present0"));
+    ASSERT_LT(countPositives(), 100);
+}
+
+TEST(WiredTigerUniqueKeyFilterTest, SaturatedCountersStaySet) {
+    WiredTigerUniqueKeyFilter filter(1);
+    for (int i = 0; i < 20; ++i) {
+        filter.add(hashOf("a"));
+    }
+    for (int i = 0; i < 20; ++i) {
+        filter.undoAdd(hashOf("a"));
+    }
+    ASSERT_TRUE(filter.mayContain(hashOf("a"), WiredTigerUniqueKeyFilter::currentTick()));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -44,6 +44,7 @@
 #include "mongo/db/concurrency/lock_state.h"
 #include "mongo/db/concurrency/locker.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/curop.h"
 #include "mongo/db/curop_failpoint_helpers.h"
 #include "mongo/db/dbdirectclient.h"
 #include "mongo/db/index/index_access_method.h"
@@ -501,7 +502,7 @@ TransactionParticipant::OplogSlotReserver::OplogSlotReserver(OperationContext* o
 
     // The new transaction should have an empty locker, and thus we do not need to save it.
     invariant(opCtx->lockState()->getClientState() == Locker::ClientState::kInactive);
-    _locker = opCtx->swapLockState(stdx::make_unique<LockerImpl>());
+    _locker = CurOp::get(opCtx)->swapLockState(opCtx, stdx::make_unique<LockerImpl>());
     // Inherit the locking setting from the original one.
     opCtx->lockState()->setShouldConflictWithSecondaryBatchApplication(
         _locker->shouldConflictWithSecondaryBatchApplication());
@@ -541,7 +542,7 @@ TransactionParticipant::TxnResources::TxnResources(OperationContext* opCtx, bool
     _ruState = opCtx->getWriteUnitOfWork()->release();
     opCtx->setWriteUnitOfWork(nullptr);
 
-    _locker = opCtx->swapLockState(stdx::make_unique<LockerImpl>());
+    _locker = CurOp::get(opCtx)->swapLockState(opCtx, stdx::make_unique<LockerImpl>());
     // Inherit the locking setting from the original one.
     opCtx->lockState()->setShouldConflictWithSecondaryBatchApplication(
         _locker->shouldConflictWithSecondaryBatchApplication());
@@ -609,7 +610,7 @@ void TransactionParticipant::TxnResources::release(OperationContext* opCtx) {
     // We intentionally do not capture the return value of swapLockState(), which is just an empty
     // locker. At the end of the operation, if the transaction is not complete, we will stash the
     // operation context's locker and replace it with a new empty locker.
-    opCtx->swapLockState(std::move(_locker));
+    CurOp::get(opCtx)->swapLockState(opCtx, std::move(_locker));
     opCtx->lockState()->updateThreadIdToCurrentThread();
 
     auto oldState = opCtx->setRecoveryUnit(std::move(_recoveryUnit),
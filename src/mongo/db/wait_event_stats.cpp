@@ -0,0 +1,143 @@
+
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/wait_event_stats.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace {
+
+const auto getWaitEventStats = OperationContext::declareDecoration<WaitEventStats>();
+
+AtomicBool waitEventTrackingEnabled(true);
+
+ExportedServerParameter<bool, ServerParameterType::kStartupAndRuntime>
+    waitEventTrackingEnabledParameter(ServerParameterSet::getGlobal(),
+                                      "waitEventTrackingEnabled",
+                                      &waitEventTrackingEnabled);
+
+}  // namespace
+
+constexpr size_t WaitEventStats::kNumClasses;
+
+WaitEventStats& WaitEventStats::get(OperationContext* opCtx) {
+    return getWaitEventStats(opCtx);
+}
+
+bool WaitEventStats::isEnabled() {
+    return waitEventTrackingEnabled.loadRelaxed();
+}
+
+StringData WaitEventStats::className(WaitEventClass waitClass) {
+    switch (waitClass) {
+        case WaitEventClass::kLockManager:
+            return "lockManager"_sd;
+        case WaitEventClass::kTicket:
+            return "ticket"_sd;
+        case WaitEventClass::kPrepareConflict:
+            return "prepareConflict"_sd;
+        case WaitEventClass::kJournal:
+            return "journal"_sd;
+        case WaitEventClass::kReplication:
+            return "replication"_sd;
+        case WaitEventClass::kNetwork:
+            return "network"_sd;
+    }
+    MONGO_UNREACHABLE;
+}
+
+void WaitEventStats::record(OperationContext* opCtx,
+                            WaitEventClass waitClass,
+                            Microseconds duration) {
+    if (opCtx && isEnabled()) {
+        get(opCtx).record(waitClass, duration);
+    }
+}
+
+void WaitEventStats::record(WaitEventClass waitClass, Microseconds duration) {
+    auto& counters = _counters[static_cast<size_t>(waitClass)];
+    // Only the thread running the operation writes, so plain stores suffice.
+    counters.count.store(counters.count.loadRelaxed() + 1);
+    counters.micros.store(counters.micros.loadRelaxed() + durationCount<Microseconds>(duration));
+}
+
+bool WaitEventStats::empty() const {
+    for (const auto& counters : _counters) {
+        if (counters.count.loadRelaxed() != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+long long WaitEventStats::getCount(WaitEventClass waitClass) const {
+    return _counters[static_cast<size_t>(waitClass)].count.load();
+}
+
+Microseconds WaitEventStats::getDuration(WaitEventClass waitClass) const {
+    return Microseconds(_counters[static_cast<size_t>(waitClass)].micros.load());
+}
+
+void WaitEventStats::append(BSONObjBuilder* builder) const {
+    for (size_t i = 0; i < kNumClasses; ++i) {
+        const auto waitClass = static_cast<WaitEventClass>(i);
+        const long long count = getCount(waitClass);
+        if (count == 0) {
+            continue;
+        }
+        BSONObjBuilder classBuilder(builder->subobjStart(className(waitClass)));
+        classBuilder.append("count", count);
+        classBuilder.append("micros", durationCount<Microseconds>(getDuration(waitClass)));
+    }
+}
+
+ScopedWaitEvent::ScopedWaitEvent(OperationContext* opCtx, WaitEventClass waitClass)
+    : _stats(opCtx && WaitEventStats::isEnabled() ? &WaitEventStats::get(opCtx) : nullptr),
+      _waitClass(waitClass) {
+    if (_stats) {
+        _startMicros = curTimeMicros64();
+    }
+}
+
+ScopedWaitEvent::~ScopedWaitEvent() {
+    if (_stats) {
+        _stats->record(_waitClass,
+                       Microseconds(static_cast<long long>(curTimeMicros64() - _startMicros)));
+    }
+}
+
+}  // namespace mongo
@@ -0,0 +1,125 @@
+
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <array>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/util/duration.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+class OperationContext;
+
+/**
+ * The classes of off-CPU waits an operation's time is attributed to.
+ */
+enum class WaitEventClass {
+    kLockManager,      // Waiting for a lock to be granted by the lock manager.
+    kTicket,           // Waiting for a storage engine read or write ticket.
+    kPrepareConflict,  // Waiting for a prepared transaction to commit or abort.
+    kJournal,          // Waiting for writes to become durable in the journal.
+    kReplication,      // Waiting for a write concern to be satisfied by other members.
+    kNetwork,          // Waiting for responses to requests sent to other nodes.
+};
+
+/**
+ * Per-operation count and total duration of each class of wait. Updated only by the thread
+ * running the operation, but may be read concurrently by threads reporting $currentOp.
+ */
+class WaitEventStats {
+    MONGO_DISALLOW_COPYING(WaitEventStats);
+
+public:
+    static constexpr size_t kNumClasses = static_cast<size_t>(WaitEventClass::kNetwork) + 1;
+
+    WaitEventStats() = default;
+
+    static WaitEventStats& get(OperationContext* opCtx);
+
+    /**
+     * Whether wait events are tracked, controlled by the waitEventTrackingEnabled server parameter.
+     */
+    static bool isEnabled();
+
+    static StringData className(WaitEventClass waitClass);
+
+    /**
+     * Records a wait of the given class against 'opCtx', if tracking is enabled and 'opCtx' is not
+     * null.
+     */
+    static void record(OperationContext* opCtx, WaitEventClass waitClass, Microseconds duration);
+
+    void record(WaitEventClass waitClass, Microseconds duration);
+
+    /**
+     * Returns true if no wait has been recorded.
+     */
+    bool empty() const;
+
+    long long getCount(WaitEventClass waitClass) const;
+    Microseconds getDuration(WaitEventClass waitClass) const;
+
+    /**
+     * Appends {<class>: {count: <n>, micros: <t>}, ...} for each class that had a wait.
+     */
+    void append(BSONObjBuilder* builder) const;
+
+private:
+    struct Counters {
+        AtomicInt64 count;
+        AtomicInt64 micros;
+    };
+
+    std::array<Counters, kNumClasses> _counters;
+};
+
+/**
+ * Records the time from construction to destruction as a wait of the given class against an
+ * operation. Reads no clock when tracking is disabled or no operation is given.
+ */
+class ScopedWaitEvent {
+    MONGO_DISALLOW_COPYING(ScopedWaitEvent);
+
+public:
+    ScopedWaitEvent(OperationContext* opCtx, WaitEventClass waitClass);
+    ~ScopedWaitEvent();
+
+private:
+    WaitEventStats* const _stats;
+    const WaitEventClass _waitClass;
+    unsigned long long _startMicros = 0;
+};
+
+}  // namespace mongo
@@ -0,0 +1,109 @@
+
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/wait_event_stats.h"
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/service_context_test_fixture.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+class WaitEventStatsTest : public ServiceContextTest {};
+
+TEST_F(WaitEventStatsTest, StartsEmpty) {
+    auto opCtx = makeOperationContext();
+    auto& stats = WaitEventStats::get(opCtx.get());
+    ASSERT_TRUE(stats.empty());
+
+    BSONObjBuilder builder;
+    stats.append(&builder);
+    ASSERT_BSONOBJ_EQ(BSONObj(), builder.obj());
+}
+
+TEST_F(WaitEventStatsTest, RecordsCountAndDurationPerClass) {
+    auto opCtx = makeOperationContext();
+    WaitEventStats::record(opCtx.get(), WaitEventClass::kLockManager, Microseconds(10));
+    WaitEventStats::record(opCtx.get(), WaitEventClass::kLockManager, Microseconds(5));
+    WaitEventStats::record(opCtx.get(), WaitEventClass::kReplication, Microseconds(100));
+
+    auto& stats = WaitEventStats::get(opCtx.get());
+    ASSERT_FALSE(stats.empty());
+    ASSERT_EQ(2, stats.getCount(WaitEventClass::kLockManager));
+    ASSERT_EQ(Microseconds(15), stats.getDuration(WaitEventClass::kLockManager));
+    ASSERT_EQ(0, stats.getCount(WaitEventClass::kNetwork));
+
+    BSONObjBuilder builder;
+    stats.append(&builder);
+    ASSERT_BSONOBJ_EQ(BSON("lockManager" << BSON("count" << 2LL << "micros" << 15LL)
+                                         << "replication"
+                                         << BSON("count" << 1LL << "micros" << 100LL)),
+                      builder.obj());
+}
+
+TEST_F(WaitEventStatsTest, RecordWithoutOperationContextIsANoop) {
+    WaitEventStats::record(nullptr, WaitEventClass::kTicket, Microseconds(1));
+    ScopedWaitEvent wait(nullptr, WaitEventClass::kTicket);
+}
+
+TEST_F(WaitEventStatsTest, ScopedWaitEventRecordsElapsedTime) {
+    auto opCtx = makeOperationContext();
+    {
+        ScopedWaitEvent wait(opCtx.get(), WaitEventClass::kNetwork);
+        stdx::this_thread::sleep_for(Milliseconds(2).toSystemDuration());
+    }
+
+    auto& stats = WaitEventStats::get(opCtx.get());
+    ASSERT_EQ(1, stats.getCount(WaitEventClass::kNetwork));
+    ASSERT_GTE(stats.getDuration(WaitEventClass::kNetwork), Milliseconds(2));
+}
+
+TEST_F(WaitEventStatsTest, DisablingTrackingStopsRecording) {
+    auto parameter = ServerParameterSet::getGlobal()->getMap().find("waitEventTrackingEnabled");
+    ASSERT(parameter != ServerParameterSet::getGlobal()->getMap().end());
+    ASSERT_OK(parameter->second->setFromString("false"));
+    ON_BLOCK_EXIT([&] { parameter->second->setFromString("true").ignore(); });
+
+    auto opCtx = makeOperationContext();
+    WaitEventStats::record(opCtx.get(), WaitEventClass::kJournal, Microseconds(10));
+    { ScopedWaitEvent wait(opCtx.get(), WaitEventClass::kJournal); }
+
+    ASSERT_TRUE(WaitEventStats::get(opCtx.get()).empty());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -45,6 +45,7 @@
 #include "mongo/db/service_context.h"
 #include "mongo/db/stats/timer_stats.h"
 #include "mongo/db/storage/storage_engine.h"
+#include "mongo/db/wait_event_stats.h"
 #include "mongo/db/write_concern_options.h"
 #include "mongo/rpc/protocol.h"
 #include "mongo/util/fail_point_service.h"
@@ -208,6 +209,9 @@ Status waitForWriteConcern(OperationContext* opCtx,
     }
 
     result->syncMillis = syncTimer.millis();
+    if (writeConcernWithPopulatedSyncMode.syncMode != WriteConcernOptions::SyncMode::NONE) {
+        WaitEventStats::record(opCtx, WaitEventClass::kJournal, Microseconds(syncTimer.micros()));
+    }
 
     // Now wait for replication
 
@@ -226,6 +230,7 @@ Status waitForWriteConcern(OperationContext* opCtx,
     // Replica set stepdowns and gle mode changes are thrown as errors
     repl::ReplicationCoordinator::StatusAndDuration replStatus =
         replCoord->awaitReplication(opCtx, replOpTime, writeConcernWithPopulatedSyncMode);
+    WaitEventStats::record(opCtx, WaitEventClass::kReplication, replStatus.duration);
     if (replStatus.status == ErrorCodes::WriteConcernFailed) {
         gleWtimeouts.increment();
         result->err = "timeout";
@@ -43,6 +43,7 @@
 #include "mongo/db/client.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/dbdirectclient.h"
+#include "mongo/db/exec/and_bitmap.h"
 #include "mongo/db/exec/and_hash.h"
 #include "mongo/db/exec/and_sorted.h"
 #include "mongo/db/exec/fetch.h"
@@ -921,6 +922,205 @@ public:
     }
 };
 
+//
+// Bitmap AND tests
+//
+
+/**
+ * An AND_BITMAP of two index scans returns the intersection of their record ids, in record id
+ * order, regardless of the order in which the children produce them.
+ */
+class QueryStageAndBitmapTwoLeaf : public QueryStageAndBase {
+public:
+    void run() {
+        dbtests::WriteContextForTests ctx(&_opCtx, ns());
+        Database* db = ctx.db();
+        Collection* coll = ctx.getCollection();
+        if (!coll) {
+            WriteUnitOfWork wuow(&_opCtx);
+            coll = db->createCollection(&_opCtx, ns());
+            wuow.commit();
+        }
+
+        for (int i = 0; i < 50; ++i) {
+            insert(BSON("foo" << i << "bar" << i));
+        }
+
+        addIndex(BSON("foo" << 1));
+        addIndex(BSON("bar" << 1));
+
+        WorkingSet ws;
+        auto ab = make_unique<AndBitmapStage>(&_opCtx, &ws);
+
+        // Foo <= 20
+        auto params = makeIndexScanParams(&_opCtx, getIndex(BSON("foo" << 1), coll));
+        params.bounds.startKey = BSON("" << 20);
+        params.direction = -1;
+        ab->addChild(new IndexScan(&_opCtx, params, &ws, NULL));
+
+        // Bar >= 10
+        params = makeIndexScanParams(&_opCtx, getIndex(BSON("bar" << 1), coll));
+        params.bounds.startKey = BSON("" << 10);
+        ab->addChild(new IndexScan(&_opCtx, params, &ws, NULL));
+
+        // foo == bar, and foo<=20, bar>=10, so our values are:
+        // foo == 10, 11, 12, 13, 14, 15. 16, 17, 18, 19, 20
+        set<RecordId> expected;
+        getRecordIds(&expected, coll);
+
+        RecordId previous;
+        int count = 0;
+        while (!ab->isEOF()) {
+            WorkingSetID id = WorkingSet::INVALID_ID;
+            PlanStage::StageState status = ab->work(&id);
+            if (PlanStage::ADVANCED != status) {
+                continue;
+            }
+
+            WorkingSetMember* member = ws.get(id);
+            ASSERT(member->hasRecordId());
+            ASSERT_FALSE(member->hasObj());
+            ASSERT_EQUALS(1U, expected.count(member->recordId));
+            ASSERT_LT(previous, member->recordId);
+            previous = member->recordId;
+            ++count;
+        }
+
+        ASSERT_EQUALS(11, count);
+
+        const AndBitmapStats* stats = static_cast<const AndBitmapStats*>(ab->getSpecificStats());
+        ASSERT_EQUALS(2U, stats->intersectionAfterChild.size());
+        ASSERT_EQUALS(21U, stats->intersectionAfterChild[0]);
+        ASSERT_EQUALS(11U, stats->intersectionAfterChild[1]);
+    }
+};
+
+// An AND_BITMAP under a FETCH returns the matching documents.
+class QueryStageAndBitmapFetch : public QueryStageAndBase {
+public:
+    void run() {
+        dbtests::WriteContextForTests ctx(&_opCtx, ns());
+        Database* db = ctx.db();
+        Collection* coll = ctx.getCollection();
+        if (!coll) {
+            WriteUnitOfWork wuow(&_opCtx);
+            coll = db->createCollection(&_opCtx, ns());
+            wuow.commit();
+        }
+
+        for (int i = 0; i < 50; ++i) {
+            insert(BSON("foo" << i << "bar" << (i % 5)));
+        }
+
+        addIndex(BSON("foo" << 1));
+        addIndex(BSON("bar" << 1));
+
+        WorkingSet ws;
+        auto ab = make_unique<AndBitmapStage>(&_opCtx, &ws);
+
+        // Foo >= 30
+        auto params = makeIndexScanParams(&_opCtx, getIndex(BSON("foo" << 1), coll));
+        params.bounds.startKey = BSON("" << 30);
+        ab->addChild(new IndexScan(&_opCtx, params, &ws, NULL));
+
+        // Bar == 2
+        params = makeIndexScanParams(&_opCtx, getIndex(BSON("bar" << 1), coll));
+        params.bounds.startKey = BSON("" << 2);
+        params.bounds.endKey = BSON("" << 2);
+        ab->addChild(new IndexScan(&_opCtx, params, &ws, NULL));
+
+        auto fetch = make_unique<FetchStage>(&_opCtx, &ws, ab.release(), nullptr, coll);
+
+        // foo == 32, 37, 42, 47
+        set<int> foos;
+        for (int i = 0; i < 4; ++i) {
+            BSONObj obj = getNext(fetch.get(), &ws);
+            ASSERT_EQUALS(2, obj["bar"].numberInt());
+            foos.insert(obj["foo"].numberInt());
+        }
+        ASSERT(foos == set<int>({32, 37, 42, 47}));
+        ASSERT_EQUALS(0, countResults(fetch.get()));
+    }
+};
+
+// An AND_BITMAP whose first child returns nothing hits EOF without reading its other children.
+class QueryStageAndBitmapWithNothing : public QueryStageAndBase {
+public:
+    void run() {
+        dbtests::WriteContextForTests ctx(&_opCtx, ns());
+        Database* db = ctx.db();
+        Collection* coll = ctx.getCollection();
+        if (!coll) {
+            WriteUnitOfWork wuow(&_opCtx);
+            coll = db->createCollection(&_opCtx, ns());
+            wuow.commit();
+        }
+
+        for (int i = 0; i < 50; ++i) {
+            insert(BSON("foo" << i << "bar" << 20));
+        }
+
+        addIndex(BSON("foo" << 1));
+        addIndex(BSON("bar" << 1));
+
+        WorkingSet ws;
+        auto ab = make_unique<AndBitmapStage>(&_opCtx, &ws);
+
+        // Bar == 5.  Index scan should be eof.
+        auto params = makeIndexScanParams(&_opCtx, getIndex(BSON("bar" << 1), coll));
+        params.bounds.startKey = BSON("" << 5);
+        params.bounds.endKey = BSON("" << 5);
+        ab->addChild(new IndexScan(&_opCtx, params, &ws, NULL));
+
+        // Foo <= 20
+        params = makeIndexScanParams(&_opCtx, getIndex(BSON("foo" << 1), coll));
+        params.bounds.startKey = BSON("" << 20);
+        params.direction = -1;
+        ab->addChild(new IndexScan(&_opCtx, params, &ws, NULL));
+
+        ASSERT_EQUALS(0, countResults(ab.get()));
+
+        const AndBitmapStats* stats = static_cast<const AndBitmapStats*>(ab->getSpecificStats());
+        ASSERT_EQUALS(1U, stats->intersectionAfterChild.size());
+        ASSERT_EQUALS(0U, stats->intersectionAfterChild[0]);
+    }
+};
+
+// An AND_BITMAP fails once its bitmaps use more memory than it is allowed.
+class QueryStageAndBitmapExceedsMemoryLimit : public QueryStageAndBase {
+public:
+    void run() {
+        dbtests::WriteContextForTests ctx(&_opCtx, ns());
+        Database* db = ctx.db();
+        Collection* coll = ctx.getCollection();
+        if (!coll) {
+            WriteUnitOfWork wuow(&_opCtx);
+            coll = db->createCollection(&_opCtx, ns());
+            wuow.commit();
+        }
+
+        for (int i = 0; i < 5000; ++i) {
+            insert(BSON("foo" << i << "bar" << i));
+        }
+
+        addIndex(BSON("foo" << 1));
+        addIndex(BSON("bar" << 1));
+
+        WorkingSet ws;
+        auto ab = make_unique<AndBitmapStage>(&_opCtx, &ws, 1024);
+
+        auto params = makeIndexScanParams(&_opCtx, getIndex(BSON("foo" << 1), coll));
+        params.bounds.startKey = BSON("" << 0);
+        ab->addChild(new IndexScan(&_opCtx, params, &ws, NULL));
+
+        params = makeIndexScanParams(&_opCtx, getIndex(BSON("bar" << 1), coll));
+        params.bounds.startKey = BSON("" << 0);
+        ab->addChild(new IndexScan(&_opCtx, params, &ws, NULL));
+
+        ASSERT_EQUALS(-1, countResults(ab.get()));
+    }
+};
+
 //
 // Sorted AND tests
 //
@@ -1351,6 +1551,10 @@ public:
         add<QueryStageAndHashFirstChildFetched>();
         add<QueryStageAndHashSecondChildFetched>();
         add<QueryStageAndHashDeadChild>();
+        add<QueryStageAndBitmapTwoLeaf>();
+        add<QueryStageAndBitmapFetch>();
+        add<QueryStageAndBitmapWithNothing>();
+        add<QueryStageAndBitmapExceedsMemoryLimit>();
         add<QueryStageAndSortedDeleteDuringYield>();
         add<QueryStageAndSortedThreeLeaf>();
         add<QueryStageAndSortedWithNothing>();
@@ -578,6 +578,86 @@ public:
     }
 };
 
+//
+// Check that only keys passing the filter are counted
+//
+class QueryStageCountScanFilter : public CountBase {
+public:
+    void run() {
+        dbtests::WriteContextForTests ctx(&_opCtx, ns());
+
+        // Insert documents, add index
+        for (int i = 0; i < 10; ++i) {
+            insert(BSON("a" << 1 << "b" << i));
+            insert(BSON("a" << 2 << "b" << i));
+        }
+        addIndex(BSON("a" << 1 << "b" << 1));
+
+        // Set up count stage over a == 1, counting only keys with b divisible by 3
+        auto params =
+            makeCountScanParams(&_opCtx, getIndex(ctx.db(), BSON("a" << 1 << "b" << 1)));
+        params.startKey = BSON("" << 1 << "" << MINKEY);
+        params.startKeyInclusive = true;
+        params.endKey = BSON("" << 1 << "" << MAXKEY);
+        params.endKeyInclusive = true;
+
+        const boost::intrusive_ptr<ExpressionContext> expCtx(
+            new ExpressionContext(&_opCtx, nullptr));
+        auto statusWithMatcher =
+            MatchExpressionParser::parse(fromjson("{b: {$mod: [3, 0]}}"), expCtx);
+        ASSERT_OK(statusWithMatcher.getStatus());
+        std::unique_ptr<MatchExpression> filter = std::move(statusWithMatcher.getValue());
+
+        WorkingSet ws;
+        CountScan count(&_opCtx, params, &ws, filter.get());
+
+        // b == 0, 3, 6, 9
+        int numCounted = runCount(&count);
+        ASSERT_EQUALS(4, numCounted);
+
+        const CountScanStats* stats = static_cast<const CountScanStats*>(count.getSpecificStats());
+        ASSERT_EQUALS(11U, stats->keysExamined);
+    }
+};
+
+//
+// Check that a multikey document is counted once when any of its keys passes the filter
+//
+class QueryStageCountScanFilterDups : public CountBase {
+public:
+    void run() {
+        dbtests::WriteContextForTests ctx(&_opCtx, ns());
+
+        // Insert some docs
+        insert(BSON("a" << 1 << "b" << BSON_ARRAY(1 << 4 << 7)));
+        insert(BSON("a" << 1 << "b" << BSON_ARRAY(2 << 3)));
+        insert(BSON("a" << 1 << "b" << BSON_ARRAY(5 << 8)));
+
+        // Add an index on {a: 1, b: 1}
+        addIndex(BSON("a" << 1 << "b" << 1));
+
+        // Set up the count stage, counting only keys with b greater than 3
+        auto params =
+            makeCountScanParams(&_opCtx, getIndex(ctx.db(), BSON("a" << 1 << "b" << 1)));
+        params.startKey = BSON("" << 1 << "" << MINKEY);
+        params.startKeyInclusive = true;
+        params.endKey = BSON("" << 1 << "" << MAXKEY);
+        params.endKeyInclusive = true;
+
+        const boost::intrusive_ptr<ExpressionContext> expCtx(
+            new ExpressionContext(&_opCtx, nullptr));
+        auto statusWithMatcher = MatchExpressionParser::parse(fromjson("{b: {$gt: 3}}"), expCtx);
+        ASSERT_OK(statusWithMatcher.getStatus());
+        std::unique_ptr<MatchExpression> filter = std::move(statusWithMatcher.getValue());
+
+        WorkingSet ws;
+        CountScan count(&_opCtx, params, &ws, filter.get());
+
+        int numCounted = runCount(&count);
+        ASSERT_EQUALS(2, numCounted);
+    }
+};
+
 class All : public Suite {
 public:
     All() : Suite("query_stage_count_scan") {}
@@ -593,6 +673,8 @@ public:
         add<QueryStageCountScanDeleteDuringYield>();
         add<QueryStageCountScanInsertNewDocsDuringYield>();
         add<QueryStageCountScanUnusedKeys>();
+        add<QueryStageCountScanFilter>();
+        add<QueryStageCountScanFilterDups>();
     }
 };
 
@@ -40,6 +40,7 @@
 #include "mongo/db/exec/distinct_scan.h"
 #include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/json.h"
+#include "mongo/db/matcher/expression_parser.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/query/index_bounds_builder.h"
 #include "mongo/db/query/plan_executor.h"
@@ -303,6 +304,71 @@ public:
     }
 };
 
+// Tests distinct over the leading field of a compound index with a filter on the other field.
+class QueryStageDistinctFilterOnNonLeadingField : public DistinctBase {
+public:
+    void run() {
+        // Only a: 2 and a: 3 have a document with b greater than 2. The matching key for a: 2 is
+        // not the first key with that value.
+        insert(BSON("a" << 1 << "b" << 1));
+        insert(BSON("a" << 1 << "b" << 2));
+        insert(BSON("a" << 2 << "b" << 1));
+        insert(BSON("a" << 2 << "b" << 3));
+        insert(BSON("a" << 3 << "b" << 5));
+        insert(BSON("a" << 4 << "b" << 1));
+
+        addIndex(BSON("a" << 1 << "b" << 1));
+
+        AutoGetCollectionForReadCommand ctx(&_opCtx, nss);
+        Collection* coll = ctx.getCollection();
+
+        std::vector<IndexDescriptor*> indices;
+        coll->getIndexCatalog()->findIndexesByKeyPattern(
+            &_opCtx, BSON("a" << 1 << "b" << 1), false, &indices);
+        ASSERT_EQ(1U, indices.size());
+
+        DistinctParams params{&_opCtx, indices[0]};
+
+        params.scanDirection = 1;
+        params.fieldNo = 0;
+        params.bounds.isSimpleRange = false;
+
+        OrderedIntervalList aOil{"a"};
+        aOil.intervals.push_back(IndexBoundsBuilder::allValues());
+        params.bounds.fields.push_back(aOil);
+
+        OrderedIntervalList bOil{"b"};
+        bOil.intervals.push_back(IndexBoundsBuilder::allValues());
+        params.bounds.fields.push_back(bOil);
+
+        const boost::intrusive_ptr<ExpressionContext> expCtx(
+            new ExpressionContext(&_opCtx, nullptr));
+        auto statusWithMatcher = MatchExpressionParser::parse(fromjson("{b: {$gt: 2}}"), expCtx);
+        ASSERT_OK(statusWithMatcher.getStatus());
+        std::unique_ptr<MatchExpression> filter = std::move(statusWithMatcher.getValue());
+
+        WorkingSet ws;
+        DistinctScan distinct(&_opCtx, std::move(params), &ws, filter.get());
+
+        WorkingSetID wsid;
+        PlanStage::StageState state;
+
+        std::vector<int> seen;
+
+        while (PlanStage::IS_EOF != (state = distinct.work(&wsid))) {
+            ASSERT_NE(PlanStage::FAILURE, state);
+            ASSERT_NE(PlanStage::DEAD, state);
+            if (PlanStage::ADVANCED == state) {
+                seen.push_back(getIntFieldDotted(ws, wsid, "a"));
+            }
+        }
+
+        ASSERT_EQUALS(2U, seen.size());
+        ASSERT_EQUALS(2, seen[0]);
+        ASSERT_EQUALS(3, seen[1]);
+    }
+};
+
 // XXX: add a test case with bounds where skipping to the next key gets us a result that's not
 // valid w.r.t. our query.
 
@@ -314,6 +380,7 @@ public:
         add<QueryStageDistinctBasic>();
         add<QueryStageDistinctMultiKey>();
         add<QueryStageDistinctCompoundIndex>();
+        add<QueryStageDistinctFilterOnNonLeadingField>();
     }
 };
 
@@ -45,6 +45,7 @@
 #include "mongo/db/exec/queued_data_stage.h"
 #include "mongo/db/json.h"
 #include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/stdx/memory.h"
 
@@ -221,6 +222,80 @@ public:
     }
 };
 
+//
+// Test that a FETCH reading ahead returns its child's results in the child's order, dropping
+// the ones that were deleted and the ones that fail the filter.
+//
+class FetchStagePrefetch : public QueryStageFetchBase {
+public:
+    void run() {
+        dbtests::WriteContextForTests ctx(&_opCtx, ns());
+        Database* db = ctx.db();
+        Collection* coll = db->getCollection(&_opCtx, ns());
+        if (!coll) {
+            WriteUnitOfWork wuow(&_opCtx);
+            coll = db->createCollection(&_opCtx, ns());
+            wuow.commit();
+        }
+
+        for (int i = 0; i < 20; ++i) {
+            insert(BSON("foo" << i));
+        }
+        set<RecordId> recordIds;
+        getRecordIds(&recordIds, coll);
+        ASSERT_EQUALS(size_t(20), recordIds.size());
+
+        // Queue the record ids in reverse order, so that each batch is fetched in the opposite
+        // order to the one it is returned in.
+        WorkingSet ws;
+        auto mockStage = make_unique<QueuedDataStage>(&_opCtx, &ws);
+        for (auto it = recordIds.rbegin(); it != recordIds.rend(); ++it) {
+            WorkingSetID id = ws.allocate();
+            WorkingSetMember* mockMember = ws.get(id);
+            mockMember->recordId = *it;
+            ws.transitionToRecordIdAndIdx(id);
+            mockStage->pushBack(id);
+        }
+
+        // The document with foo == 12 is deleted before it can be fetched.
+        remove(BSON("foo" << 12));
+
+        const boost::intrusive_ptr<ExpressionContext> expCtx(
+            new ExpressionContext(&_opCtx, nullptr));
+        StatusWithMatchExpression statusWithMatcher =
+            MatchExpressionParser::parse(BSON("foo" << BSON("$ne" << 7)), expCtx);
+        verify(statusWithMatcher.isOK());
+        unique_ptr<MatchExpression> filterExpr = std::move(statusWithMatcher.getValue());
+
+        const int oldBatchSize = internalQueryExecFetchPrefetchBatchSize.load();
+        internalQueryExecFetchPrefetchBatchSize.store(4);
+        unique_ptr<FetchStage> fetchStage(
+            new FetchStage(&_opCtx, &ws, mockStage.release(), filterExpr.get(), coll));
+        internalQueryExecFetchPrefetchBatchSize.store(oldBatchSize);
+
+        std::vector<int> seen;
+        PlanStage::StageState state = PlanStage::NEED_TIME;
+        while (PlanStage::IS_EOF != state) {
+            WorkingSetID id = WorkingSet::INVALID_ID;
+            state = fetchStage->work(&id);
+            ASSERT_NOT_EQUALS(PlanStage::FAILURE, state);
+            if (PlanStage::ADVANCED == state) {
+                WorkingSetMember* member = ws.get(id);
+                ASSERT_TRUE(member->hasObj());
+                seen.push_back(member->obj.value()["foo"].numberInt());
+            }
+        }
+
+        std::vector<int> expected;
+        for (int i = 19; i >= 0; --i) {
+            if (i != 12 && i != 7) {
+                expected.push_back(i);
+            }
+        }
+        ASSERT(expected == seen);
+    }
+};
+
 class All : public Suite {
 public:
     All() : Suite("query_stage_fetch") {}
@@ -228,6 +303,7 @@ public:
     void setupTests() {
         add<FetchStageAlreadyFetched>();
         add<FetchStageFilter>();
+        add<FetchStagePrefetch>();
     }
 };
 
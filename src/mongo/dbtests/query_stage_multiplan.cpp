@@ -276,6 +276,35 @@ TEST_F(QueryStageMultiPlanTest, MPSCollectionScanVsHighlySelectiveIXScan) {
     ASSERT_EQUALS(results, N / 10);
 }
 
+// With early elimination enabled, a plan which falls far behind stops being worked before the
+// trial period ends, and the most productive plan still wins.
+TEST_F(QueryStageMultiPlanTest, MPSEliminatesUnproductivePlanEarly) {
+    const double oldEliminationRatio = internalQueryPlanEvaluationEliminationRatio.load();
+    internalQueryPlanEvaluationEliminationRatio.store(5.0);
+    ON_BLOCK_EXIT([oldEliminationRatio] {
+        internalQueryPlanEvaluationEliminationRatio.store(oldEliminationRatio);
+    });
+
+    const int N = 5000;
+    for (int i = 0; i < N; ++i) {
+        insert(BSON("foo" << (i % 10)));
+    }
+
+    addIndex(BSON("foo" << 1));
+
+    AutoGetCollectionForReadCommand ctx(_opCtx.get(), nss);
+    const Collection* coll = ctx.getCollection();
+
+    auto mps = runMultiPlanner(_opCtx.get(), nss, coll, 7);
+
+    // The index scan produces a result on every round and the collection scan on one round in
+    // ten, so the collection scan is set aside at the first check after the index scan has
+    // produced a quarter of the results which end the trial period.
+    const size_t collScanWorks = mps->getChildren()[1]->getStats()->common.works;
+    ASSERT_EQ(collScanWorks, 32U);
+    ASSERT_LT(collScanWorks, getBestPlanWorks(mps.get()));
+}
+
 TEST_F(QueryStageMultiPlanTest, MPSDoesNotCreateActiveCacheEntryImmediately) {
     const int N = 100;
     for (int i = 0; i < N; ++i) {
@@ -38,6 +38,7 @@
 #include "mongo/base/status_with.h"
 #include "mongo/client/connection_string.h"
 #include "mongo/db/commands/test_commands_enabled.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/wire_version.h"
 #include "mongo/executor/network_connection_hook.h"
 #include "mongo/executor/network_interface_integration_fixture.h"
@@ -318,6 +319,56 @@ TEST_F(NetworkInterfaceTest, StartCommand) {
     assertNumOps(0u, 0u, 0u, 1u);
 }
 
+class CoalescingNetworkInterfaceTest : public NetworkInterfaceTest {
+public:
+    void setUp() override {
+        _parameter =
+            ServerParameterSet::getGlobal()->getMap().find("networkInterfaceMaxCoalescedCommands");
+        ASSERT(_parameter != ServerParameterSet::getGlobal()->getMap().end());
+        ASSERT_OK(_parameter->second->setFromString("8"));
+        NetworkInterfaceTest::setUp();
+    }
+
+    void tearDown() override {
+        NetworkInterfaceTest::tearDown();
+        ASSERT_OK(_parameter->second->setFromString("1"));
+    }
+
+private:
+    ServerParameter::Map::const_iterator _parameter;
+};
+
+TEST_F(CoalescingNetworkInterfaceTest, CoalescedCommandsGetTheirOwnResponses) {
+    const int numCommands = 20;
+    std::vector<Future<RemoteCommandResponse>> deferred;
+    for (int i = 0; i < numCommands; ++i) {
+        deferred.push_back(
+            runCommand(makeCallbackHandle(), makeTestCommand(boost::none, BSON("echo" << i))));
+    }
+
+    for (int i = 0; i < numCommands; ++i) {
+        auto res = deferred[i].get();
+        uassertStatusOK(res.status);
+        ASSERT_EQ(res.data.getObjectField("echo").getIntField("echo"), i);
+        ASSERT_EQ(res.data.getIntField("ok"), 1);
+    }
+    assertNumOps(0u, 0u, 0u, numCommands);
+}
+
+TEST_F(CoalescingNetworkInterfaceTest, CancelOneCoalescedCommand) {
+    auto first = runCommand(makeCallbackHandle(), makeTestCommand());
+    auto cbh = makeCallbackHandle();
+    auto canceled = runCommand(cbh, makeTestCommand());
+    auto last = runCommand(makeCallbackHandle(), makeTestCommand());
+
+    net().cancelCommand(cbh);
+
+    ASSERT_EQ(ErrorCodes::CallbackCanceled, canceled.get().status);
+    ASSERT_OK(first.get().status);
+    ASSERT_OK(last.get().status);
+    assertNumOps(1u, 0u, 0u, 2u);
+}
+
 TEST_F(NetworkInterfaceTest, SetAlarm) {
     // set a first alarm, to execute after "expiration"
     Date_t expiration = net().now() + Milliseconds(100);
@@ -36,6 +36,7 @@
 
 #include "mongo/db/commands/test_commands_enabled.h"
 #include "mongo/db/server_options.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/executor/connection_pool_tl.h"
 #include "mongo/transport/transport_layer_manager.h"
 #include "mongo/util/concurrency/idle_thread_block.h"
@@ -45,6 +46,21 @@
 namespace mongo {
 namespace executor {
 
+namespace {
+
+// Commands started for the same host at about the same time are sent together over one
+// connection, in batches of at most this many commands. 1 sends every command on its own.
+MONGO_EXPORT_SERVER_PARAMETER(networkInterfaceMaxCoalescedCommands, int, 1)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1) {
+            return Status(ErrorCodes::BadValue,
+                          "networkInterfaceMaxCoalescedCommands must be at least 1");
+        }
+        return Status::OK();
+    });
+
+}  // namespace
+
 NetworkInterfaceTL::NetworkInterfaceTL(std::string instanceName,
                                        ConnectionPool::Options connPoolOpts,
                                        ServiceContext* svcCtx,
@@ -212,6 +228,17 @@ Status NetworkInterfaceTL::startCommand(const TaskExecutor::CallbackHandle& cbHa
         return Status::OK();
     }
 
+    // Commands run on a baton are sent from the client thread, so they can not wait for the
+    // reactor to coalesce them.
+    if (!baton && networkInterfaceMaxCoalescedCommands.load() > 1) {
+        std::move(pf.future).getAsync([ this, state, onFinish = std::move(onFinish) ](
+            StatusWith<RemoteCommandResponse> response) {
+            _finishCommand(state, std::move(response), onFinish);
+        });
+        _coalesceCommand(std::move(state));
+        return Status::OK();
+    }
+
     // Interacting with the connection pool can involve more work than just getting a connection
     // out.  In particular, we can end up having to spin up new connections, and fulfilling promises
     // for other requesters.  Returning connections has the same issue.
@@ -254,25 +281,9 @@ Status NetworkInterfaceTL::startCommand(const TaskExecutor::CallbackHandle& cbHa
             return _onAcquireConn(
                 state, std::move(future), std::move(*uassertStatusOK(swConn)), baton);
         })
-            .onError([](Status error) -> StatusWith<RemoteCommandResponse> {
-                // The TransportLayer has, for historical reasons returned SocketException for
-                // network errors, but sharding assumes HostUnreachable on network errors.
-                if (error == ErrorCodes::SocketException) {
-                    error = Status(ErrorCodes::HostUnreachable, error.reason());
-                }
-                return error;
-            })
             .getAsync([ this, state, onFinish = std::move(onFinish) ](
                 StatusWith<RemoteCommandResponse> response) {
-                auto duration = now() - state->start;
-                if (!response.isOK()) {
-                    onFinish(RemoteCommandResponse(response.getStatus(), duration));
-                } else {
-                    const auto& rs = response.getValue();
-                    LOG(2) << "Request " << state->request.id << " finished with response: "
-                           << redact(rs.isOK() ? rs.data.toString() : rs.status.toString());
-                    onFinish(rs);
-                }
+                _finishCommand(state, std::move(response), onFinish);
             });
     };
 
@@ -406,6 +417,253 @@ Future<RemoteCommandResponse> NetworkInterfaceTL::_onAcquireConn(
     return future;
 }
 
+void NetworkInterfaceTL::_finishCommand(const std::shared_ptr<CommandState>& state,
+                                        StatusWith<RemoteCommandResponse> response,
+                                        const RemoteCommandCompletionFn& onFinish) {
+    auto duration = now() - state->start;
+    if (!response.isOK()) {
+        auto error = response.getStatus();
+        // The TransportLayer has, for historical reasons returned SocketException for network
+        // errors, but sharding assumes HostUnreachable on network errors.
+        if (error == ErrorCodes::SocketException) {
+            error = Status(ErrorCodes::HostUnreachable, error.reason());
+        }
+        onFinish(RemoteCommandResponse(error, duration));
+    } else {
+        const auto& rs = response.getValue();
+        LOG(2) << "Request " << state->request.id << " finished with response: "
+               << redact(rs.isOK() ? rs.data.toString() : rs.status.toString());
+        onFinish(rs);
+    }
+}
+
+void NetworkInterfaceTL::_coalesceCommand(std::shared_ptr<CommandState> state) {
+    // The deadline of a coalesced command also covers the time it waits for the rest of its batch
+    // and for a connection.
+    if (state->deadline != RemoteCommandRequest::kNoExpirationDate) {
+        state->timer = _reactor->makeTimer();
+        state->timer->waitUntil(state->deadline, nullptr).getAsync([this, state](Status status) {
+            if (status == ErrorCodes::CallbackCanceled) {
+                invariant(state->done.load());
+                return;
+            }
+
+            if (state->done.swap(true)) {
+                return;
+            }
+
+            if (getTestCommandsEnabled()) {
+                stdx::lock_guard<stdx::mutex> lk(_mutex);
+                _counters.timedOut++;
+            }
+
+            LOG(2) << "Request " << state->request.id << " timed out"
+                   << ", deadline was " << state->deadline << ", op was "
+                   << redact(state->request.toString());
+            state->promise.setError(
+                Status(ErrorCodes::NetworkInterfaceExceededTimeLimit, "timed out"));
+
+            _cancelCoalescedBatchIfDone(state);
+        });
+    }
+
+    auto target = state->request.target;
+    bool isFirst;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_coalescingMutex);
+        auto& queue = _coalescing[target];
+        isFirst = queue.empty();
+        queue.push_back(std::move(state));
+    }
+
+    // Every command started for the host before the reactor runs this joins the batch.
+    if (isFirst) {
+        _reactor->schedule(transport::Reactor::kPost,
+                           [this, target] { _sendCoalesced(target); });
+    }
+}
+
+void NetworkInterfaceTL::_sendCoalesced(const HostAndPort& target) {
+    std::vector<std::shared_ptr<CommandState>> states;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_coalescingMutex);
+        auto it = _coalescing.find(target);
+        if (it == _coalescing.end()) {
+            return;
+        }
+
+        auto& queue = it->second;
+        const auto numToSend = std::min(
+            queue.size(), static_cast<size_t>(networkInterfaceMaxCoalescedCommands.load()));
+        states.assign(std::make_move_iterator(queue.begin()),
+                      std::make_move_iterator(queue.begin() + numToSend));
+        queue.erase(queue.begin(), queue.begin() + numToSend);
+
+        if (queue.empty()) {
+            _coalescing.erase(it);
+        } else {
+            _reactor->schedule(transport::Reactor::kPost,
+                               [this, target] { _sendCoalesced(target); });
+        }
+    }
+
+    // Wait for a connection for as long as the command with the latest deadline can.
+    auto timeout = RemoteCommandRequest::kNoTimeout;
+    bool anyWithoutDeadline = false;
+    const auto nowVal = now();
+    for (const auto& state : states) {
+        if (state->deadline == RemoteCommandRequest::kNoExpirationDate) {
+            anyWithoutDeadline = true;
+        } else if (timeout == RemoteCommandRequest::kNoTimeout ||
+                   state->deadline - nowVal > timeout) {
+            timeout = std::max(Milliseconds(1), state->deadline - nowVal);
+        }
+    }
+    if (anyWithoutDeadline) {
+        timeout = RemoteCommandRequest::kNoTimeout;
+    }
+
+    _pool->get(target, timeout)
+        .getAsync([ this, states = std::move(states) ](
+            StatusWith<ConnectionPool::ConnectionHandle> swConn) mutable {
+            _onAcquireCoalescedConn(std::move(states), std::move(swConn));
+        });
+}
+
+void NetworkInterfaceTL::_onAcquireCoalescedConn(
+    std::vector<std::shared_ptr<CommandState>> states,
+    StatusWith<ConnectionPool::ConnectionHandle> swConn) {
+    if (!swConn.isOK()) {
+        for (const auto& state : states) {
+            _eraseInUseConn(state->cbHandle);
+            if (state->done.swap(true)) {
+                continue;
+            }
+
+            LOG(2) << "Failed to get connection from pool for request " << state->request.id
+                   << ": " << swConn.getStatus();
+            if (state->timer) {
+                state->timer->cancel();
+            }
+            state->promise.setError(swConn.getStatus());
+        }
+        return;
+    }
+
+    auto conn = std::move(swConn.getValue());
+    auto deleter = conn.get_deleter();
+    auto batch = std::make_shared<CoalescedBatch>();
+    batch->conn =
+        CommandState::ConnHandle(conn.release(), CommandState::Deleter{deleter, _reactor});
+
+    // Commands canceled or timed out while they waited are not sent.
+    std::vector<RemoteCommandRequest> requests;
+    for (auto& state : states) {
+        if (state->done.load()) {
+            _eraseInUseConn(state->cbHandle);
+            continue;
+        }
+        requests.push_back(state->request);
+        batch->states.push_back(std::move(state));
+    }
+
+    if (batch->states.empty()) {
+        batch->conn->indicateSuccess();
+        return;
+    }
+
+    batch->numOutstanding = batch->states.size();
+    {
+        stdx::lock_guard<stdx::mutex> lk(_inProgressMutex);
+        for (const auto& state : batch->states) {
+            state->batch = batch;
+        }
+    }
+
+    auto client = checked_cast<connection_pool_tl::TLConnection*>(batch->conn.get())->client();
+    auto responses = client->runCommandRequests(std::move(requests));
+    for (size_t i = 0; i < responses.size(); ++i) {
+        std::move(responses[i])
+            .then([this, batch](RemoteCommandResponse response) {
+                if (_metadataHook && response.status.isOK()) {
+                    auto target = batch->conn->getHostAndPort().toString();
+                    response.status =
+                        _metadataHook->readReplyMetadata(nullptr, std::move(target), response.data);
+                }
+
+                return RemoteCommandResponse(std::move(response));
+            })
+            .getAsync([ this, state = batch->states[i], batch ](
+                StatusWith<RemoteCommandResponse> swr) {
+                _onCoalescedResponse(state, batch, std::move(swr));
+            });
+    }
+}
+
+void NetworkInterfaceTL::_onCoalescedResponse(const std::shared_ptr<CommandState>& state,
+                                              const std::shared_ptr<CoalescedBatch>& batch,
+                                              StatusWith<RemoteCommandResponse> swr) {
+    _eraseInUseConn(state->cbHandle);
+
+    // The connection goes back to the pool once all of the responses have been read from it.
+    {
+        stdx::lock_guard<stdx::mutex> lk(batch->mutex);
+        if (batch->connStatus.isOK()) {
+            if (!swr.isOK()) {
+                batch->connStatus = swr.getStatus();
+            } else if (!swr.getValue().isOK()) {
+                batch->connStatus = swr.getValue().status;
+            }
+        }
+
+        if (--batch->numOutstanding == 0) {
+            if (!batch->connStatus.isOK()) {
+                batch->conn->indicateFailure(batch->connStatus);
+            } else {
+                batch->conn->indicateUsed();
+                batch->conn->indicateSuccess();
+            }
+        }
+    }
+
+    if (state->done.swap(true))
+        return;
+
+    if (getTestCommandsEnabled()) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (swr.isOK() && swr.getValue().status.isOK()) {
+            _counters.succeeded++;
+        } else {
+            _counters.failed++;
+        }
+    }
+
+    if (state->timer) {
+        state->timer->cancel();
+    }
+
+    state->promise.setFromStatusWith(std::move(swr));
+}
+
+void NetworkInterfaceTL::_cancelCoalescedBatchIfDone(const std::shared_ptr<CommandState>& state) {
+    auto batch = [&] {
+        stdx::lock_guard<stdx::mutex> lk(_inProgressMutex);
+        return state->batch.lock();
+    }();
+    if (!batch) {
+        return;
+    }
+
+    for (const auto& other : batch->states) {
+        if (!other->done.load()) {
+            return;
+        }
+    }
+
+    // No command is waiting for the rest of the responses anymore.
+    checked_cast<connection_pool_tl::TLConnection*>(batch->conn.get())->client()->cancel();
+}
+
 void NetworkInterfaceTL::_eraseInUseConn(const TaskExecutor::CallbackHandle& cbHandle) {
     stdx::lock_guard<stdx::mutex> lk(_inProgressMutex);
     _inProgress.erase(cbHandle);
@@ -438,6 +696,8 @@ void NetworkInterfaceTL::cancelCommand(const TaskExecutor::CallbackHandle& cbHan
     if (state->conn) {
         auto client = checked_cast<connection_pool_tl::TLConnection*>(state->conn.get());
         client->client()->cancel(baton);
+    } else {
+        _cancelCoalescedBatchIfDone(state);
     }
 }
 
@@ -31,6 +31,7 @@
 #pragma once
 
 #include <deque>
+#include <vector>
 
 #include "mongo/client/async_client.h"
 #include "mongo/db/service_context.h"
@@ -81,6 +82,8 @@ public:
     void dropConnections(const HostAndPort& hostAndPort) override;
 
 private:
+    struct CoalescedBatch;
+
     struct CommandState {
         CommandState(RemoteCommandRequest request_,
                      TaskExecutor::CallbackHandle cbHandle_,
@@ -108,12 +111,49 @@ private:
         ConnHandle conn;
         std::unique_ptr<transport::ReactorTimer> timer;
 
+        // Set instead of 'conn' once a coalesced command is sent. Guarded by _inProgressMutex.
+        std::weak_ptr<CoalescedBatch> batch;
+
         AtomicBool done;
         Promise<RemoteCommandResponse> promise;
     };
 
+    /**
+     * Commands to the same host sent together over one connection with a single write. The
+     * connection is returned to the pool once every command in the batch has its response.
+     */
+    struct CoalescedBatch {
+        CommandState::ConnHandle conn;
+        std::vector<std::shared_ptr<CommandState>> states;
+
+        stdx::mutex mutex;
+        size_t numOutstanding = 0;
+        Status connStatus = Status::OK();
+    };
+
     void _run();
     void _eraseInUseConn(const TaskExecutor::CallbackHandle& handle);
+    void _finishCommand(const std::shared_ptr<CommandState>& state,
+                        StatusWith<RemoteCommandResponse> response,
+                        const RemoteCommandCompletionFn& onFinish);
+
+    /**
+     * Queues 'state' to be sent together with the other commands started for the same host
+     * before the reactor gets to them. See _sendCoalesced().
+     */
+    void _coalesceCommand(std::shared_ptr<CommandState> state);
+    void _sendCoalesced(const HostAndPort& target);
+    void _onAcquireCoalescedConn(std::vector<std::shared_ptr<CommandState>> states,
+                                 StatusWith<ConnectionPool::ConnectionHandle> swConn);
+    void _onCoalescedResponse(const std::shared_ptr<CommandState>& state,
+                              const std::shared_ptr<CoalescedBatch>& batch,
+                              StatusWith<RemoteCommandResponse> swr);
+
+    /**
+     * Cancels the sending of the batch 'state' was coalesced into once none of its commands are
+     * waiting for their responses anymore.
+     */
+    void _cancelCoalescedBatchIfDone(const std::shared_ptr<CommandState>& state);
     Future<RemoteCommandResponse> _onAcquireConn(std::shared_ptr<CommandState> state,
                                                  Future<RemoteCommandResponse> future,
                                                  CommandState::ConnHandle conn,
@@ -140,6 +180,10 @@ private:
     stdx::unordered_map<TaskExecutor::CallbackHandle, std::shared_ptr<CommandState>> _inProgress;
     stdx::unordered_set<std::shared_ptr<transport::ReactorTimer>> _inProgressAlarms;
 
+    // Commands waiting to be coalesced, by host.
+    stdx::mutex _coalescingMutex;
+    stdx::unordered_map<HostAndPort, std::vector<std::shared_ptr<CommandState>>> _coalescing;
+
     stdx::condition_variable _workReadyCond;
     bool _isExecutorRunnable = false;
 };
@@ -36,6 +36,7 @@
 
 #include "mongo/client/remote_command_targeter.h"
 #include "mongo/db/server_parameters.h"
+#include "mongo/db/wait_event_stats.h"
 #include "mongo/executor/remote_command_request.h"
 #include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/s/client/shard_registry.h"
@@ -120,6 +121,33 @@ void AsyncRequestsSender::stopRetrying() {
     _stopRetrying = true;
 }
 
+void AsyncRequestsSender::addRequest(const AsyncRequestsSender::Request& request) {
+    invariant(!_stopRetrying);
+
+    // Reuse the entry of a remote whose response has already been returned, so that a caller which
+    // keeps adding requests holds on to as many entries as it has requests outstanding, rather
+    // than to every command it ever sent. Jobs only refer to remotes awaiting a response, so no
+    // job can refer to a returned remote.
+    auto it = std::find_if(_remotes.begin(), _remotes.end(), [](const RemoteData& remote) {
+        return remote.done;
+    });
+    if (it != _remotes.end()) {
+        *it = RemoteData(request.shardId, request.cmdObj);
+    } else {
+        it = _remotes.emplace(_remotes.end(), request.shardId, request.cmdObj);
+    }
+
+    const size_t remoteIndex = it - _remotes.begin();
+    auto scheduleStatus = _scheduleRequest(remoteIndex);
+    if (!scheduleStatus.isOK()) {
+        _remotes[remoteIndex].swResponse = std::move(scheduleStatus);
+
+        // Push a noop response to the queue to indicate that a remote is ready for
+        // re-processing due to failure.
+        _responseQueue.producer.push(boost::none);
+    }
+}
+
 bool AsyncRequestsSender::done() {
     return std::all_of(
         _remotes.begin(), _remotes.end(), [](const RemoteData& remote) { return remote.done; });
@@ -251,7 +279,11 @@ Status AsyncRequestsSender::_scheduleRequest(size_t remoteIndex) {
 
 // Passing opCtx means you'd like to opt into opCtx interruption.  During cleanup we actually don't.
 void AsyncRequestsSender::_makeProgress() {
-    auto job = _responseQueue.consumer.pop(_opCtx);
+    boost::optional<Job> job;
+    {
+        ScopedWaitEvent networkWait(_opCtx, WaitEventClass::kNetwork);
+        job = _responseQueue.consumer.pop(_opCtx);
+    }
 
     if (!job) {
         return;
@@ -161,6 +161,16 @@ public:
      */
     void stopRetrying();
 
+    /**
+     * Schedules an additional request while responses to the earlier ones may still be
+     * outstanding. Its response is returned by a later call to next() like any other. The state
+     * kept for a request whose response has already been returned is reused.
+     *
+     * Note: Must be called from the thread which calls next(), and invalid to call once
+     * stopRetrying() has been called.
+     */
+    void addRequest(const AsyncRequestsSender::Request& request);
+
 private:
     /**
      * We instantiate one of these per remote host.
@@ -54,6 +54,7 @@ const char kStopped[] = "stopped";
 const char kMode[] = "mode";
 const char kActiveWindow[] = "activeWindow";
 const char kWaitForDelete[] = "_waitForDelete";
+const char kPolicy[] = "policy";
 
 const NamespaceString kSettingsNamespace("config", "settings");
 
@@ -61,6 +62,7 @@ const NamespaceString kSettingsNamespace("config", "settings");
 
 const char BalancerSettingsType::kKey[] = "balancer";
 const char* BalancerSettingsType::kBalancerModes[] = {"full", "autoSplitOnly", "off"};
+const char* BalancerSettingsType::kBalancingPolicies[] = {"chunkCount", "dataSize"};
 
 const char ChunkSizeSettingsType::kKey[] = "chunksize";
 const uint64_t ChunkSizeSettingsType::kDefaultMaxChunkSizeBytes{64 * 1024 * 1024};
@@ -131,6 +133,11 @@ bool BalancerConfiguration::waitForDelete() const {
     return _balancerSettings.waitForDelete();
 }
 
+BalancerSettingsType::BalancingPolicy BalancerConfiguration::getBalancingPolicy() const {
+    stdx::lock_guard<stdx::mutex> lk(_balancerSettingsMutex);
+    return _balancerSettings.getBalancingPolicy();
+}
+
 Status BalancerConfiguration::refreshAndCheck(OperationContext* opCtx) {
     // Balancer configuration
     Status balancerSettingsStatus = _refreshBalancerSettings(opCtx);
@@ -321,6 +328,21 @@ StatusWith<BalancerSettingsType> BalancerSettingsType::fromBSON(const BSONObj& o
         settings._waitForDelete = waitForDelete;
     }
 
+    {
+        std::string policyStr;
+        Status status = bsonExtractStringFieldWithDefault(
+            obj, kPolicy, kBalancingPolicies[kChunkCount], &policyStr);
+        if (!status.isOK())
+            return status;
+        auto it = std::find(std::begin(kBalancingPolicies), std::end(kBalancingPolicies), policyStr);
+        if (it == std::end(kBalancingPolicies)) {
+            return Status(ErrorCodes::BadValue, "Invalid balancing policy");
+        }
+
+        settings._balancingPolicy =
+            static_cast<BalancingPolicy>(it - std::begin(kBalancingPolicies));
+    }
+
     return settings;
 }
 
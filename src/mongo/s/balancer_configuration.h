@@ -54,7 +54,8 @@ class StatusWith;
  * balancer: {
  *  stopped: <true|false>,
  *  mode: <full|autoSplitOnly|off>,         // Only consulted if "stopped" is missing or false
- *  activeWindow: { start: "<HH:MM>", stop: "<HH:MM>" }
+ *  activeWindow: { start: "<HH:MM>", stop: "<HH:MM>" },
+ *  policy: <chunkCount|dataSize>            // What the balancer evens out across the shards
  * }
  */
 class BalancerSettingsType {
@@ -66,12 +67,21 @@ public:
         kOff,            // Balancer is completely off
     };
 
+    // Supported balancing policies
+    enum BalancingPolicy {
+        kChunkCount,  // Even out the number of chunks of each collection on every shard
+        kDataSize,    // Even out the amount of data of each collection on every shard
+    };
+
     // The key under which this setting is stored on the config server
     static const char kKey[];
 
     // String representation of the balancer modes
     static const char* kBalancerModes[];
 
+    // String representation of the balancing policies
+    static const char* kBalancingPolicies[];
+
     /**
      * Constructs a settings object with the default values. To be used when no balancer settings
      * have been specified.
@@ -109,6 +119,13 @@ public:
         return _waitForDelete;
     }
 
+    /**
+     * Returns what the balancer should even out across the shards.
+     */
+    BalancingPolicy getBalancingPolicy() const {
+        return _balancingPolicy;
+    }
+
 private:
     BalancerSettingsType();
 
@@ -120,6 +137,8 @@ private:
     MigrationSecondaryThrottleOptions _secondaryThrottle;
 
     bool _waitForDelete{false};
+
+    BalancingPolicy _balancingPolicy{kChunkCount};
 };
 
 /**
@@ -236,6 +255,11 @@ public:
      */
     bool waitForDelete() const;
 
+    /**
+     * Returns what the balancer should even out across the shards.
+     */
+    BalancerSettingsType::BalancingPolicy getBalancingPolicy() const;
+
     /**
      * Returns the max chunk size after which a chunk would be considered jumbo.
      */
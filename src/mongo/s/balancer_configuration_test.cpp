@@ -240,6 +240,27 @@ TEST(BalancerSettingsType, InvalidBalancerModeOption) {
                   .code());
 }
 
+TEST(BalancerSettingsType, AllValidBalancingPolicyOptions) {
+    ASSERT_EQ(BalancerSettingsType::kChunkCount,
+              assertGet(BalancerSettingsType::fromBSON(BSONObj())).getBalancingPolicy());
+    ASSERT_EQ(BalancerSettingsType::kChunkCount,
+              assertGet(BalancerSettingsType::fromBSON(BSON("policy"
+                                                            << "chunkCount")))
+                  .getBalancingPolicy());
+    ASSERT_EQ(BalancerSettingsType::kDataSize,
+              assertGet(BalancerSettingsType::fromBSON(BSON("policy"
+                                                            << "dataSize")))
+                  .getBalancingPolicy());
+}
+
+TEST(BalancerSettingsType, InvalidBalancingPolicyOption) {
+    ASSERT_EQ(ErrorCodes::BadValue,
+              BalancerSettingsType::fromBSON(BSON("policy"
+                                                  << "BAD"))
+                  .getStatus()
+                  .code());
+}
+
 TEST(BalancerSettingsType, BalancingWindowStartLessThanStop) {
     BalancerSettingsType settings =
         assertGet(BalancerSettingsType::fromBSON(BSON("activeWindow" << BSON("start"
@@ -435,16 +435,25 @@ void CatalogCache::purgeAllDatabases() {
     _collectionsByDb.clear();
 }
 
-void CatalogCache::report(BSONObjBuilder* builder) const {
+void CatalogCache::report(BSONObjBuilder* builder, bool includeCollectionStats) const {
     BSONObjBuilder cacheStatsBuilder(builder->subobjStart("catalogCache"));
 
     size_t numDatabaseEntries;
     size_t numCollectionEntries{0};
+    BSONObjBuilder collectionStatsBuilder;
     {
         stdx::lock_guard<stdx::mutex> ul(_mutex);
         numDatabaseEntries = _databases.size();
         for (const auto& entry : _collectionsByDb) {
             numCollectionEntries += entry.second.size();
+
+            if (includeCollectionStats) {
+                for (const auto& collEntry : entry.second) {
+                    BSONObjBuilder refreshStatsBuilder(
+                        collectionStatsBuilder.subobjStart(collEntry.first));
+                    collEntry.second->refreshStats.report(&refreshStatsBuilder);
+                }
+            }
         }
     }
 
@@ -452,6 +461,10 @@ void CatalogCache::report(BSONObjBuilder* builder) const {
     cacheStatsBuilder.append("numCollectionEntries", static_cast<long long>(numCollectionEntries));
 
     _stats.report(&cacheStatsBuilder);
+
+    if (includeCollectionStats) {
+        cacheStatsBuilder.append("collections", collectionStatsBuilder.obj());
+    }
 }
 
 void CatalogCache::_scheduleDatabaseRefresh(WithLock,
@@ -551,8 +564,10 @@ void CatalogCache::_scheduleCollectionRefresh(WithLock lk,
         const Status& status, RoutingTableHistory* routingInfoAfterRefresh) {
         if (isIncremental) {
             _stats.numActiveIncrementalRefreshes.subtractAndFetch(1);
+            _stats.totalIncrementalRefreshTimeMicros.addAndFetch(t.micros());
         } else {
             _stats.numActiveFullRefreshes.subtractAndFetch(1);
+            _stats.totalFullRefreshTimeMicros.addAndFetch(t.micros());
         }
 
         if (!status.isOK()) {
@@ -597,10 +612,19 @@ void CatalogCache::_scheduleCollectionRefresh(WithLock lk,
         }
     };
 
-    const auto refreshCallback =
-        [ this, collEntry, nss, existingRoutingInfo, onRefreshFailed, onRefreshCompleted ](
-            OperationContext * opCtx,
-            StatusWith<CatalogCacheLoader::CollectionAndChangedChunks> swCollAndChunks) noexcept {
+    const auto refreshCallback = [
+        this,
+        t = Timer(),
+        collEntry,
+        nss,
+        existingRoutingInfo,
+        onRefreshFailed,
+        onRefreshCompleted
+    ](OperationContext * opCtx,
+      StatusWith<CatalogCacheLoader::CollectionAndChangedChunks> swCollAndChunks) noexcept {
+        const size_t numChangedChunks =
+            swCollAndChunks.isOK() ? swCollAndChunks.getValue().changedChunks.size() : 0;
+
         std::shared_ptr<RoutingTableHistory> newRoutingInfo;
         try {
             newRoutingInfo = refreshCollectionRoutingInfo(
@@ -609,12 +633,17 @@ void CatalogCache::_scheduleCollectionRefresh(WithLock lk,
             onRefreshCompleted(Status::OK(), newRoutingInfo.get());
         } catch (const DBException& ex) {
             stdx::lock_guard<stdx::mutex> lg(_mutex);
+            collEntry->refreshStats.recordRefresh(
+                Microseconds(t.micros()), numChangedChunks, false /* succeeded */);
             onRefreshFailed(lg, ex.toStatus());
             return;
         }
 
         stdx::lock_guard<stdx::mutex> lg(_mutex);
 
+        collEntry->refreshStats.recordRefresh(
+            Microseconds(t.micros()), numChangedChunks, true /* succeeded */);
+
         collEntry->needsRefresh = false;
         collEntry->refreshCompletionNotification->set(Status::OK());
         collEntry->refreshCompletionNotification = nullptr;
@@ -665,6 +694,33 @@ void CatalogCache::Stats::report(BSONObjBuilder* builder) const {
     builder->append("countFullRefreshesStarted", countFullRefreshesStarted.load());
 
     builder->append("countFailedRefreshes", countFailedRefreshes.load());
+
+    builder->append("totalIncrementalRefreshTimeMicros", totalIncrementalRefreshTimeMicros.load());
+    builder->append("totalFullRefreshTimeMicros", totalFullRefreshTimeMicros.load());
+}
+
+void CatalogCache::CollectionRefreshStats::recordRefresh(Microseconds duration,
+                                                         size_t numChangedChunks,
+                                                         bool succeeded) {
+    const auto micros = durationCount<Microseconds>(duration);
+
+    countRefreshes++;
+    if (!succeeded) {
+        countFailedRefreshes++;
+    }
+    totalRefreshTimeMicros += micros;
+    maxRefreshTimeMicros = std::max(maxRefreshTimeMicros, micros);
+    lastRefreshTimeMicros = micros;
+    lastRefreshNumChangedChunks = static_cast<long long>(numChangedChunks);
+}
+
+void CatalogCache::CollectionRefreshStats::report(BSONObjBuilder* builder) const {
+    builder->append("countRefreshes", countRefreshes);
+    builder->append("countFailedRefreshes", countFailedRefreshes);
+    builder->append("totalRefreshTimeMicros", totalRefreshTimeMicros);
+    builder->append("maxRefreshTimeMicros", maxRefreshTimeMicros);
+    builder->append("lastRefreshTimeMicros", lastRefreshTimeMicros);
+    builder->append("lastRefreshNumChangedChunks", lastRefreshNumChangedChunks);
 }
 
 CachedDatabaseInfo::CachedDatabaseInfo(DatabaseType dbt, std::shared_ptr<Shard> primaryShard)
@@ -240,15 +240,35 @@ public:
     void purgeAllDatabases();
 
     /**
-     * Reports statistics about the catalog cache to be used by serverStatus
+     * Reports statistics about the catalog cache to be used by serverStatus. If
+     * 'includeCollectionStats' is true, also reports the refresh statistics of each cached
+     * collection.
      */
-    void report(BSONObjBuilder* builder) const;
+    void report(BSONObjBuilder* builder, bool includeCollectionStats = false) const;
 
 private:
     // Make the cache entries friends so they can access the private classes below
     friend class CachedDatabaseInfo;
     friend class CachedCollectionRoutingInfo;
 
+    /**
+     * Statistics about the refreshes of a single collection's routing info.
+     */
+    struct CollectionRefreshStats {
+        void recordRefresh(Microseconds duration, size_t numChangedChunks, bool succeeded);
+
+        void report(BSONObjBuilder* builder) const;
+
+        long long countRefreshes{0};
+        long long countFailedRefreshes{0};
+        long long totalRefreshTimeMicros{0};
+        long long maxRefreshTimeMicros{0};
+        long long lastRefreshTimeMicros{0};
+
+        // Number of chunks returned by the loader in the last refresh
+        long long lastRefreshNumChangedChunks{0};
+    };
+
     /**
      * Cache entry describing a collection.
      */
@@ -263,6 +283,9 @@ private:
 
         // Contains the cached routing information (only available if needsRefresh is false)
         std::shared_ptr<RoutingTableHistory> routingInfo;
+
+        // Statistics about the refreshes of this entry
+        CollectionRefreshStats refreshStats;
     };
 
     /**
@@ -370,6 +393,11 @@ private:
         // for whatever reason
         AtomicInt64 countFailedRefreshes{0};
 
+        // Cumulative, always-increasing counters of how much time incremental and full refreshes
+        // took to complete, including loading the changed chunks and updating the routing table
+        AtomicInt64 totalIncrementalRefreshTimeMicros{0};
+        AtomicInt64 totalFullRefreshTimeMicros{0};
+
         /**
          * Reports the accumulated statistics for serverStatus.
          */
@@ -120,6 +120,13 @@ TEST_F(CatalogCacheRefreshTest, FullLoad) {
     auto cm = routingInfo->cm();
 
     ASSERT_EQ(4, cm->numChunks());
+
+    BSONObjBuilder statsBuilder;
+    Grid::get(getServiceContext())->catalogCache()->report(&statsBuilder, true);
+    const auto collStats = statsBuilder.obj()["catalogCache"]["collections"][kNss.ns()].Obj();
+    ASSERT_EQ(1, collStats["countRefreshes"].numberLong());
+    ASSERT_EQ(0, collStats["countFailedRefreshes"].numberLong());
+    ASSERT_EQ(4, collStats["lastRefreshNumChangedChunks"].numberLong());
 }
 
 class MockLockerAlwaysReportsToBeLocked : public LockerNoop {
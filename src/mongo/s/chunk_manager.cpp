@@ -34,6 +34,8 @@
 
 #include "mongo/s/chunk_manager.h"
 
+#include <limits>
+
 #include "mongo/base/owned_pointer_vector.h"
 #include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/db/matcher/extensions_callback_noop.h"
@@ -51,6 +53,12 @@ namespace {
 // Used to generate sequence numbers to assign to each newly created RoutingTableHistory
 AtomicUInt32 nextCMSequenceNumber(0);
 
+// Refreshes are applied by patching a copy of the routing table, which shares all the blocks it
+// does not modify, as long as they change at most this many chunks or one chunk per block. Larger
+// ones (including the initial load) are applied to an ordered tree, which is flattened afterwards,
+// so that their cost does not grow with the product of the number of changes and chunks.
+const size_t kMinChangesToPatchInPlace = 16;
+
 void checkAllElementsAreOfType(BSONType type, const BSONObj& o) {
     for (auto&& element : o) {
         uassert(ErrorCodes::ConflictingOperationInProgress,
@@ -69,6 +77,598 @@ std::string extractKeyStringInternal(const BSONObj& shardKeyValue, Ordering orde
     return {ks.getBuffer(), ks.getSize()};
 }
 
+/**
+ * Adapts the flat ChunkMap for applyChunkChanges, patching it in place.
+ */
+class FlatChunkTable {
+public:
+    using Position = size_t;
+
+    explicit FlatChunkTable(ChunkMap* chunkMap) : _chunkMap(chunkMap) {}
+
+    Position upperBound(const std::string& keyString) const {
+        return _chunkMap->upperBound(keyString);
+    }
+
+    size_t distance(Position low, Position high) const {
+        return high - low;
+    }
+
+    bool isEnd(Position pos) const {
+        return pos == _chunkMap->size();
+    }
+
+    const std::shared_ptr<ChunkInfo>& chunkAt(Position pos) const {
+        return _chunkMap->chunkAt(pos);
+    }
+
+    void replace(Position low,
+                 Position high,
+                 const std::string& maxKeyString,
+                 std::shared_ptr<ChunkInfo> chunk) {
+        _chunkMap->replace(low, high, maxKeyString, std::move(chunk));
+    }
+
+private:
+    ChunkMap* const _chunkMap;
+};
+
+/**
+ * Adapts an ordered map from the max KeyString of each chunk to the chunk for applyChunkChanges.
+ */
+class TreeChunkTable {
+public:
+    using Map = std::map<std::string, std::shared_ptr<ChunkInfo>>;
+    using Position = Map::iterator;
+
+    explicit TreeChunkTable(Map* map) : _map(map) {}
+
+    Position upperBound(const std::string& keyString) const {
+        return _map->upper_bound(keyString);
+    }
+
+    size_t distance(Position low, Position high) const {
+        return std::distance(low, high);
+    }
+
+    bool isEnd(Position pos) const {
+        return pos == _map->end();
+    }
+
+    const std::shared_ptr<ChunkInfo>& chunkAt(Position pos) const {
+        return pos->second;
+    }
+
+    void replace(Position low,
+                 Position high,
+                 const std::string& maxKeyString,
+                 std::shared_ptr<ChunkInfo> chunk) {
+        _map->erase(low, high);
+        _map->emplace_hint(high, maxKeyString, std::move(chunk));
+    }
+
+private:
+    Map* const _map;
+};
+
+/**
+ * Applies 'changedChunks', which must be sorted in ascending order by version, to 'table' such that
+ * each of them replaces all the chunks it overlaps. Returns the resulting collection version.
+ */
+template <typename ChunkTable>
+ChunkVersion applyChunkChanges(ChunkTable& table,
+                               const NamespaceString& nss,
+                               Ordering ordering,
+                               ChunkVersion collectionVersion,
+                               const std::vector<ChunkType>& changedChunks) {
+    for (const auto& chunk : changedChunks) {
+        const auto& chunkVersion = chunk.getVersion();
+
+        uassert(ErrorCodes::ConflictingOperationInProgress,
+                str::stream() << "Chunk " << chunk.genID(nss, chunk.getMin())
+                              << " has epoch different from that of the collection "
+                              << chunkVersion.epoch(),
+                collectionVersion.epoch() == chunkVersion.epoch());
+
+        // Chunks must always come in incrementally sorted order
+        invariant(chunkVersion >= collectionVersion);
+        collectionVersion = chunkVersion;
+
+        const auto chunkMinKeyString = extractKeyStringInternal(chunk.getMin(), ordering);
+        const auto chunkMaxKeyString = extractKeyStringInternal(chunk.getMax(), ordering);
+
+        // Returns the first chunk with a max key that is > min - implies that the chunk overlaps
+        // min
+        const auto low = table.upperBound(chunkMinKeyString);
+
+        // Returns the first chunk with a max key that is > max - implies that the next chunk cannot
+        // not overlap max
+        const auto high = table.upperBound(chunkMaxKeyString);
+
+        // If we are in the middle of splitting a chunk, for the first few
+        // chunks inserted, low == high, because both lookups will point to the
+        // same chunk (the one being split). If we're inserting the last chunk
+        // for the current chunk being split, low will point to the chunk that
+        // we're splitting, and high will point to the next chunk past the one
+        // we're splitting (which could be chunkMap.end()). In this case,
+        // std::distance(low, high) == 1. Lastly, this does not apply during
+        // the creation of the original routing table, in which case the map is
+        // empty and the first chunk that is inserted will find that low ==
+        // high, but low == chunkMap.end(), and we aren't doing a split in that
+        // case.
+        auto foundSingleChunk = (table.distance(low, high) <= 1 && !table.isEnd(low));
+
+        auto newChunk = std::make_shared<ChunkInfo>(chunk);
+        if (foundSingleChunk) {
+            auto chunkBeingReplacedBySplit = table.chunkAt(low);
+            auto bytesInReplacedChunk =
+                chunkBeingReplacedBySplit->getWritesTracker()->getBytesWritten();
+            newChunk->getWritesTracker()->addBytesWritten(bytesInReplacedChunk);
+        }
+
+        // Replace all chunks in the table, which overlap the chunk we got from the persistent
+        // store, with the chunk itself
+        table.replace(low, high, chunkMaxKeyString, std::move(newChunk));
+    }
+
+    return collectionVersion;
+}
+
+}  // namespace
+
+size_t ChunkMap::Block::upperBound(StringData keyString) const {
+    size_t first = 0;
+    size_t count = size();
+    while (count > 0) {
+        const size_t step = count / 2;
+        if (maxKeyStringAt(first + step).compare(keyString) <= 0) {
+            first += step + 1;
+            count -= step + 1;
+        } else {
+            count = step;
+        }
+    }
+    return first;
+}
+
+size_t ChunkMap::Block::lowerBound(StringData keyString) const {
+    size_t first = 0;
+    size_t count = size();
+    while (count > 0) {
+        const size_t step = count / 2;
+        if (maxKeyStringAt(first + step).compare(keyString) < 0) {
+            first += step + 1;
+            count -= step + 1;
+        } else {
+            count = step;
+        }
+    }
+    return first;
+}
+
+void ChunkMap::Block::replace(size_t first,
+                              size_t last,
+                              StringData maxKeyString,
+                              uint32_t shardIndex,
+                              uint64_t version,
+                              std::shared_ptr<ChunkInfo> chunk) {
+    invariant(first <= last);
+    invariant(last <= size());
+
+    const size_t keysBegin = first == 0 ? 0 : maxKeyStringEnds[first - 1];
+    const size_t keysEnd = last == 0 ? 0 : maxKeyStringEnds[last - 1];
+    maxKeyStrings.replace(
+        keysBegin, keysEnd - keysBegin, maxKeyString.rawData(), maxKeyString.size());
+    invariant(maxKeyStrings.size() <= std::numeric_limits<uint32_t>::max());
+
+    if (first == last) {
+        maxKeyStringEnds.insert(maxKeyStringEnds.begin() + first, 0);
+        shardIndexes.insert(shardIndexes.begin() + first, shardIndex);
+        versions.insert(versions.begin() + first, version);
+        chunks.insert(chunks.begin() + first, std::move(chunk));
+    } else {
+        maxKeyStringEnds.erase(maxKeyStringEnds.begin() + first + 1,
+                               maxKeyStringEnds.begin() + last);
+        shardIndexes.erase(shardIndexes.begin() + first + 1, shardIndexes.begin() + last);
+        versions.erase(versions.begin() + first + 1, versions.begin() + last);
+        chunks.erase(chunks.begin() + first + 1, chunks.begin() + last);
+
+        shardIndexes[first] = shardIndex;
+        versions[first] = version;
+        chunks[first] = std::move(chunk);
+    }
+
+    maxKeyStringEnds[first] = keysBegin + maxKeyString.size();
+
+    // Shift the end offsets of all the following keys by the change in size of the replaced keys
+    const int64_t delta =
+        static_cast<int64_t>(maxKeyString.size()) - static_cast<int64_t>(keysEnd - keysBegin);
+    if (delta != 0) {
+        for (size_t i = first + 1; i < maxKeyStringEnds.size(); ++i) {
+            maxKeyStringEnds[i] = static_cast<uint32_t>(maxKeyStringEnds[i] + delta);
+        }
+    }
+}
+
+void ChunkMap::Block::erase(size_t first, size_t last) {
+    invariant(first <= last);
+    invariant(last <= size());
+    if (first == last) {
+        return;
+    }
+
+    const size_t keysBegin = first == 0 ? 0 : maxKeyStringEnds[first - 1];
+    const size_t keysEnd = maxKeyStringEnds[last - 1];
+    maxKeyStrings.erase(keysBegin, keysEnd - keysBegin);
+
+    maxKeyStringEnds.erase(maxKeyStringEnds.begin() + first, maxKeyStringEnds.begin() + last);
+    shardIndexes.erase(shardIndexes.begin() + first, shardIndexes.begin() + last);
+    versions.erase(versions.begin() + first, versions.begin() + last);
+    chunks.erase(chunks.begin() + first, chunks.begin() + last);
+
+    const uint32_t delta = keysEnd - keysBegin;
+    for (size_t i = first; i < maxKeyStringEnds.size(); ++i) {
+        maxKeyStringEnds[i] -= delta;
+    }
+}
+
+std::shared_ptr<ChunkMap::Block> ChunkMap::Block::splitAt(size_t offset) {
+    invariant(offset <= size());
+
+    auto tail = std::make_shared<Block>();
+    const size_t keysBegin = offset == 0 ? 0 : maxKeyStringEnds[offset - 1];
+    tail->maxKeyStrings.assign(maxKeyStrings, keysBegin, std::string::npos);
+    for (size_t i = offset; i < size(); ++i) {
+        tail->maxKeyStringEnds.push_back(maxKeyStringEnds[i] - keysBegin);
+    }
+    tail->shardIndexes.assign(shardIndexes.begin() + offset, shardIndexes.end());
+    tail->versions.assign(versions.begin() + offset, versions.end());
+    tail->chunks.assign(std::make_move_iterator(chunks.begin() + offset),
+                        std::make_move_iterator(chunks.end()));
+
+    maxKeyStrings.resize(keysBegin);
+    maxKeyStringEnds.resize(offset);
+    shardIndexes.resize(offset);
+    versions.resize(offset);
+    chunks.resize(offset);
+
+    return tail;
+}
+
+ChunkMap::const_iterator ChunkMap::iteratorAt(size_t index) const {
+    if (index == size()) {
+        return end();
+    }
+
+    const auto pos = _locate(index);
+    return {this, pos.first, pos.second};
+}
+
+const std::shared_ptr<ChunkInfo>& ChunkMap::chunkAt(size_t index) const {
+    const auto pos = _locate(index);
+    return _blocks[pos.first]->chunks[pos.second];
+}
+
+StringData ChunkMap::maxKeyStringAt(size_t index) const {
+    const auto pos = _locate(index);
+    return _blocks[pos.first]->maxKeyStringAt(pos.second);
+}
+
+uint32_t ChunkMap::shardIndexAt(size_t index) const {
+    const auto pos = _locate(index);
+    return _blocks[pos.first]->shardIndexes[pos.second];
+}
+
+const ShardId& ChunkMap::shardIdAt(size_t index, const boost::optional<Timestamp>& ts) const {
+    const auto pos = _locate(index);
+    const auto& block = *_blocks[pos.first];
+    return ts ? block.chunks[pos.second]->getShardIdAt(ts)
+              : _shardIds[block.shardIndexes[pos.second]];
+}
+
+ChunkVersion ChunkMap::versionAt(size_t index) const {
+    const auto pos = _locate(index);
+    const uint64_t combined = _blocks[pos.first]->versions[pos.second];
+    return ChunkVersion(static_cast<uint32_t>(combined >> 32),
+                        static_cast<uint32_t>(combined & 0xFFFFFFFF),
+                        _epoch);
+}
+
+size_t ChunkMap::upperBound(StringData keyString) const {
+    // Find the first block whose last chunk's max bound sorts after the key
+    const auto it = std::partition_point(
+        _blocks.begin(), _blocks.end(), [&keyString](const std::shared_ptr<Block>& block) {
+            return block->maxKeyStringAt(block->size() - 1).compare(keyString) <= 0;
+        });
+    if (it == _blocks.end()) {
+        return size();
+    }
+
+    const size_t blockIndex = it - _blocks.begin();
+    const size_t blockBegin = blockIndex == 0 ? 0 : _blockEnds[blockIndex - 1];
+    return blockBegin + (*it)->upperBound(keyString);
+}
+
+size_t ChunkMap::lowerBound(StringData keyString) const {
+    const auto it = std::partition_point(
+        _blocks.begin(), _blocks.end(), [&keyString](const std::shared_ptr<Block>& block) {
+            return block->maxKeyStringAt(block->size() - 1).compare(keyString) < 0;
+        });
+    if (it == _blocks.end()) {
+        return size();
+    }
+
+    const size_t blockIndex = it - _blocks.begin();
+    const size_t blockBegin = blockIndex == 0 ? 0 : _blockEnds[blockIndex - 1];
+    return blockBegin + (*it)->lowerBound(keyString);
+}
+
+void ChunkMap::append(StringData maxKeyString, std::shared_ptr<ChunkInfo> chunk) {
+    dassert(empty() || maxKeyStringAt(size() - 1).compare(maxKeyString) < 0);
+
+    if (_blocks.empty() || _blocks.back()->size() >= kMaxBlockSize) {
+        _blocks.push_back(std::make_shared<Block>());
+        _blockEnds.push_back(size());
+    }
+
+    const auto shardIndex = _getShardIndex(chunk->getShardIdAt(boost::none));
+    const auto version = chunk->getLastmod().toLong();
+    _addToShardStats(shardIndex, version);
+
+    auto& block = _mutableBlock(_blocks.size() - 1);
+    block.replace(
+        block.size(), block.size(), maxKeyString, shardIndex, version, std::move(chunk));
+    ++_blockEnds.back();
+}
+
+void ChunkMap::replace(size_t first,
+                       size_t last,
+                       StringData maxKeyString,
+                       std::shared_ptr<ChunkInfo> chunk) {
+    invariant(first <= last);
+    invariant(last <= size());
+
+    if (first == size()) {
+        append(maxKeyString, std::move(chunk));
+        return;
+    }
+
+    // Account for the chunks being replaced
+    for (auto it = iteratorAt(first), itEnd = iteratorAt(last); it != itEnd; ++it) {
+        const auto& block = *_blocks[it._block];
+        _removeFromShardStats(block.shardIndexes[it._offset], block.versions[it._offset]);
+    }
+
+    const auto shardIndex = _getShardIndex(chunk->getShardIdAt(boost::none));
+    const auto version = chunk->getLastmod().toLong();
+    _addToShardStats(shardIndex, version);
+
+    const auto pos = _locate(first);
+    const size_t blockIndex = pos.first;
+    auto& block = _mutableBlock(blockIndex);
+
+    size_t numToReplace = last - first;
+    const size_t numInBlock = std::min(numToReplace, block.size() - pos.second);
+    block.replace(pos.second,
+                  pos.second + numInBlock,
+                  maxKeyString,
+                  shardIndex,
+                  version,
+                  std::move(chunk));
+    numToReplace -= numInBlock;
+
+    // The replaced range may extend into the following blocks, in which case drop the blocks it
+    // covers entirely and trim the beginning of the last one
+    size_t nextBlockIndex = blockIndex + 1;
+    while (numToReplace > 0) {
+        const size_t nextBlockSize = _blocks[nextBlockIndex]->size();
+        if (numToReplace >= nextBlockSize) {
+            _blocks.erase(_blocks.begin() + nextBlockIndex);
+            _blockEnds.erase(_blockEnds.begin() + nextBlockIndex);
+            numToReplace -= nextBlockSize;
+        } else {
+            _mutableBlock(nextBlockIndex).erase(0, numToReplace);
+            numToReplace = 0;
+        }
+    }
+
+    if (block.size() > kMaxBlockSize) {
+        auto tail = block.splitAt(block.size() / 2);
+        _blocks.insert(_blocks.begin() + blockIndex + 1, std::move(tail));
+        _blockEnds.insert(_blockEnds.begin() + blockIndex + 1, 0);
+    }
+
+    _updateBlockEnds(blockIndex);
+}
+
+ShardVersionMap ChunkMap::getShardVersions() {
+    // Rescan the chunks of the shards whose max version is no longer known exactly
+    const bool anyStale = std::any_of(_shardStats.begin(),
+                                      _shardStats.end(),
+                                      [](const ShardChunkStats& stats) {
+                                          return stats.numChunks > 0 && stats.maxVersionStale;
+                                      });
+    if (anyStale) {
+        std::vector<uint64_t> maxVersions(_shardStats.size(), 0);
+        for (const auto& block : _blocks) {
+            for (size_t i = 0; i < block->size(); ++i) {
+                auto& maxVersion = maxVersions[block->shardIndexes[i]];
+                maxVersion = std::max(maxVersion, block->versions[i]);
+            }
+        }
+
+        for (size_t i = 0; i < _shardStats.size(); ++i) {
+            if (_shardStats[i].maxVersionStale) {
+                _shardStats[i].maxVersion = maxVersions[i];
+                _shardStats[i].maxVersionStale = false;
+            }
+        }
+    }
+
+    ShardVersionMap shardVersions;
+    for (size_t i = 0; i < _shardStats.size(); ++i) {
+        const auto& stats = _shardStats[i];
+        if (stats.numChunks == 0) {
+            continue;
+        }
+
+        ChunkVersion maxShardVersion(static_cast<uint32_t>(stats.maxVersion >> 32),
+                                     static_cast<uint32_t>(stats.maxVersion & 0xFFFFFFFF),
+                                     _epoch);
+
+        // If a shard has chunks it must have a shard version, otherwise we have an invalid chunk
+        // somewhere, which should have been caught at chunk load time
+        invariant(maxShardVersion.isSet());
+
+        shardVersions.emplace(_shardIds[i], std::move(maxShardVersion));
+    }
+
+    return shardVersions;
+}
+
+std::pair<size_t, size_t> ChunkMap::_locate(size_t index) const {
+    invariant(index < size());
+    const auto it = std::upper_bound(_blockEnds.begin(), _blockEnds.end(), index);
+    const size_t blockIndex = it - _blockEnds.begin();
+    const size_t blockBegin = blockIndex == 0 ? 0 : _blockEnds[blockIndex - 1];
+    return {blockIndex, index - blockBegin};
+}
+
+ChunkMap::Block& ChunkMap::_mutableBlock(size_t blockIndex) {
+    auto& block = _blocks[blockIndex];
+
+    // A block referenced only by this map cannot be reached by any other thread, since maps are
+    // not modified while they are shared
+    if (block.use_count() > 1) {
+        block = std::make_shared<Block>(*block);
+    }
+
+    return *block;
+}
+
+void ChunkMap::_updateBlockEnds(size_t fromBlock) {
+    size_t end = fromBlock == 0 ? 0 : _blockEnds[fromBlock - 1];
+    for (size_t i = fromBlock; i < _blocks.size(); ++i) {
+        end += _blocks[i]->size();
+        _blockEnds[i] = end;
+    }
+}
+
+uint32_t ChunkMap::_getShardIndex(const ShardId& shardId) {
+    // The number of shards is small, so a linear search is cheaper than maintaining an index
+    const auto it = std::find(_shardIds.begin(), _shardIds.end(), shardId);
+    if (it != _shardIds.end()) {
+        return it - _shardIds.begin();
+    }
+
+    _shardIds.push_back(shardId);
+    _shardStats.emplace_back();
+    return _shardIds.size() - 1;
+}
+
+void ChunkMap::_addToShardStats(uint32_t shardIndex, uint64_t version) {
+    auto& stats = _shardStats[shardIndex];
+    ++stats.numChunks;
+
+    // The max version remains an upper bound of the versions of the shard's chunks even when it is
+    // stale, so a version at least as high is the new exact max
+    if (version >= stats.maxVersion) {
+        stats.maxVersion = version;
+        stats.maxVersionStale = false;
+    }
+}
+
+void ChunkMap::_removeFromShardStats(uint32_t shardIndex, uint64_t version) {
+    auto& stats = _shardStats[shardIndex];
+    invariant(stats.numChunks > 0);
+
+    if (--stats.numChunks == 0) {
+        stats.maxVersion = 0;
+        stats.maxVersionStale = false;
+    } else if (version == stats.maxVersion) {
+        stats.maxVersionStale = true;
+    }
+}
+
+namespace {
+
+/**
+ * Throws ConflictingOperationInProgress if there is a gap or an overlap between 'chunk' and the
+ * chunk following it in the routing table, 'nextChunk'.
+ */
+void checkChunksAreContiguous(const ChunkInfo& chunk, const ChunkInfo& nextChunk) {
+    const auto& max = chunk.getMax();
+    const auto& nextMin = nextChunk.getMin();
+    if (SimpleBSONObjComparator::kInstance.evaluate(max == nextMin)) {
+        return;
+    }
+
+    if (SimpleBSONObjComparator::kInstance.evaluate(max < nextMin))
+        uasserted(ErrorCodes::ConflictingOperationInProgress,
+                  str::stream() << "Gap exists in the routing table between chunks "
+                                << chunk.getRange().toString()
+                                << " and "
+                                << nextChunk.getRange().toString());
+    else
+        uasserted(ErrorCodes::ConflictingOperationInProgress,
+                  str::stream() << "Overlap exists in the routing table between chunks "
+                                << chunk.getRange().toString()
+                                << " and "
+                                << nextChunk.getRange().toString());
+}
+
+/**
+ * Checks that the chunks in 'chunkMap' cover the complete space from [MinKey, MaxKey). Continuity
+ * is only checked between consecutive chunks on different shards.
+ */
+void validateChunkMap(const ChunkMap& chunkMap) {
+    if (chunkMap.empty()) {
+        return;
+    }
+
+    auto it = chunkMap.begin();
+    checkAllElementsAreOfType(MinKey, (*it)->getMin());
+
+    for (auto prev = it++; it != chunkMap.end(); prev = it++) {
+        if ((*prev)->getShardIdAt(boost::none) != (*it)->getShardIdAt(boost::none)) {
+            checkChunksAreContiguous(**prev, **it);
+        }
+    }
+
+    checkAllElementsAreOfType(MaxKey, chunkMap.chunkAt(chunkMap.size() - 1)->getMax());
+}
+
+/**
+ * Checks the continuity of 'chunkMap' around each of 'changedChunks' which is still present in it
+ * after they were applied. Any gap or overlap introduced by applying the changes must border one
+ * of them, so this is equivalent to validateChunkMap on a map which was previously valid.
+ */
+void validateChangedChunks(const ChunkMap& chunkMap,
+                           const std::vector<ChunkType>& changedChunks,
+                           Ordering ordering) {
+    for (const auto& changedChunk : changedChunks) {
+        const auto maxKeyString = extractKeyStringInternal(changedChunk.getMax(), ordering);
+        const auto index = chunkMap.lowerBound(maxKeyString);
+        if (index == chunkMap.size() || chunkMap.maxKeyStringAt(index) != maxKeyString) {
+            // The chunk was replaced by a later change
+            continue;
+        }
+
+        const auto& chunk = chunkMap.chunkAt(index);
+        if (index == 0) {
+            checkAllElementsAreOfType(MinKey, chunk->getMin());
+        } else {
+            checkChunksAreContiguous(*chunkMap.chunkAt(index - 1), *chunk);
+        }
+
+        if (index + 1 == chunkMap.size()) {
+            checkAllElementsAreOfType(MaxKey, chunk->getMax());
+        } else {
+            checkChunksAreContiguous(*chunk, *chunkMap.chunkAt(index + 1));
+        }
+    }
+}
+
 }  // namespace
 
 RoutingTableHistory::RoutingTableHistory(NamespaceString nss,
@@ -76,8 +676,9 @@ RoutingTableHistory::RoutingTableHistory(NamespaceString nss,
                                          KeyPattern shardKeyPattern,
                                          std::unique_ptr<CollatorInterface> defaultCollator,
                                          bool unique,
-                                         ChunkInfoMap chunkMap,
-                                         ChunkVersion collectionVersion)
+                                         ChunkMap chunkMap,
+                                         ChunkVersion collectionVersion,
+                                         ShardVersionMap shardVersions)
     : _sequenceNumber(nextCMSequenceNumber.addAndFetch(1)),
       _nss(std::move(nss)),
       _uuid(uuid),
@@ -87,7 +688,7 @@ RoutingTableHistory::RoutingTableHistory(NamespaceString nss,
       _unique(unique),
       _chunkMap(std::move(chunkMap)),
       _collectionVersion(collectionVersion),
-      _shardVersions(_constructShardVersionMap()) {}
+      _shardVersions(std::move(shardVersions)) {}
 
 Chunk ChunkManager::findIntersectingChunk(const BSONObj& shardKey, const BSONObj& collation) const {
     const bool hasSimpleCollation = (collation.isEmpty() && !_rt->getDefaultCollator()) ||
@@ -101,25 +702,27 @@ Chunk ChunkManager::findIntersectingChunk(const BSONObj& shardKey, const BSONObj
         }
     }
 
-    const auto it = _rt->getChunkMap().upper_bound(_rt->_extractKeyString(shardKey));
+    const auto& chunkMap = _rt->getChunkMap();
+    const auto index = chunkMap.upperBound(_rt->_extractKeyString(shardKey));
     uassert(ErrorCodes::ShardKeyNotFound,
             str::stream() << "Cannot target single shard using key " << shardKey,
-            it != _rt->getChunkMap().end() && it->second->containsKey(shardKey));
+            index != chunkMap.size() && chunkMap.chunkAt(index)->containsKey(shardKey));
 
-    return Chunk(*(it->second), _clusterTime);
+    return Chunk(*chunkMap.chunkAt(index), _clusterTime);
 }
 
 bool ChunkManager::keyBelongsToShard(const BSONObj& shardKey, const ShardId& shardId) const {
     if (shardKey.isEmpty())
         return false;
 
-    const auto it = _rt->getChunkMap().upper_bound(_rt->_extractKeyString(shardKey));
-    if (it == _rt->getChunkMap().end())
+    const auto& chunkMap = _rt->getChunkMap();
+    const auto index = chunkMap.upperBound(_rt->_extractKeyString(shardKey));
+    if (index == chunkMap.size())
         return false;
 
-    invariant(it->second->containsKey(shardKey));
+    invariant(chunkMap.chunkAt(index)->containsKey(shardKey));
 
-    return it->second->getShardIdAt(_clusterTime) == shardId;
+    return chunkMap.shardIdAt(index, _clusterTime) == shardId;
 }
 
 void ChunkManager::getShardIdsForQuery(OperationContext* opCtx,
@@ -183,16 +786,17 @@ void ChunkManager::getShardIdsForQuery(OperationContext* opCtx,
     // For now, we satisfy that assumption by adding a shard with no matches rather than returning
     // an empty set of shards.
     if (shardIds->empty()) {
-        shardIds->insert(_rt->getChunkMap().begin()->second->getShardIdAt(_clusterTime));
+        shardIds->insert(_rt->getChunkMap().shardIdAt(0, _clusterTime));
     }
 }
 
 void ChunkManager::getShardIdsForRange(const BSONObj& min,
                                        const BSONObj& max,
                                        std::set<ShardId>* shardIds) const {
-    const auto bounds = _rt->overlappingRanges(min, max, true);
-    for (auto it = bounds.first; it != bounds.second; ++it) {
-        shardIds->insert(it->second->getShardIdAt(_clusterTime));
+    const auto& chunkMap = _rt->getChunkMap();
+    const auto bounds = _rt->_overlappingRangeIndexes(min, max, true);
+    for (auto index = bounds.first; index != bounds.second; ++index) {
+        shardIds->insert(chunkMap.shardIdAt(index, _clusterTime));
 
         // No need to iterate through the rest of the ranges, because we already know we need to use
         // all shards.
@@ -203,24 +807,26 @@ void ChunkManager::getShardIdsForRange(const BSONObj& min,
 }
 
 bool ChunkManager::rangeOverlapsShard(const ChunkRange& range, const ShardId& shardId) const {
-    const auto bounds = _rt->overlappingRanges(range.getMin(), range.getMax(), false);
-    const auto it = std::find_if(bounds.first, bounds.second, [this, &shardId](const auto& scr) {
-        return scr.second->getShardIdAt(_clusterTime) == shardId;
-    });
+    const auto& chunkMap = _rt->getChunkMap();
+    const auto bounds = _rt->_overlappingRangeIndexes(range.getMin(), range.getMax(), false);
+    for (auto index = bounds.first; index != bounds.second; ++index) {
+        if (chunkMap.shardIdAt(index, _clusterTime) == shardId) {
+            return true;
+        }
+    }
 
-    return it != bounds.second;
+    return false;
 }
 
 ChunkManager::ConstRangeOfChunks ChunkManager::getNextChunkOnShard(const BSONObj& shardKey,
                                                                    const ShardId& shardId) const {
-    for (auto it = _rt->getChunkMap().upper_bound(_rt->_extractKeyString(shardKey));
-         it != _rt->getChunkMap().end();
-         ++it) {
-        const auto& chunk = it->second;
-        if (chunk->getShardIdAt(_clusterTime) == shardId) {
-            const auto begin = it;
-            const auto end = ++it;
-            return {ConstChunkIterator(begin, _clusterTime), ConstChunkIterator(end, _clusterTime)};
+    const auto& chunkMap = _rt->getChunkMap();
+    for (auto index = chunkMap.upperBound(_rt->_extractKeyString(shardKey));
+         index != chunkMap.size();
+         ++index) {
+        if (chunkMap.shardIdAt(index, _clusterTime) == shardId) {
+            return {ConstChunkIterator(chunkMap.iteratorAt(index), _clusterTime),
+                    ConstChunkIterator(chunkMap.iteratorAt(index + 1), _clusterTime)};
         }
     }
 
@@ -234,19 +840,24 @@ void RoutingTableHistory::getAllShardIds(std::set<ShardId>* all) const {
                    [](const ShardVersionMap::value_type& pair) { return pair.first; });
 }
 
-std::pair<ChunkInfoMap::const_iterator, ChunkInfoMap::const_iterator>
+std::pair<ChunkMap::const_iterator, ChunkMap::const_iterator>
 RoutingTableHistory::overlappingRanges(const BSONObj& min,
                                        const BSONObj& max,
                                        bool isMaxInclusive) const {
+    const auto bounds = _overlappingRangeIndexes(min, max, isMaxInclusive);
+    return {_chunkMap.iteratorAt(bounds.first), _chunkMap.iteratorAt(bounds.second)};
+}
 
-    const auto itMin = _chunkMap.upper_bound(_extractKeyString(min));
-    const auto itMax = [this, &max, isMaxInclusive]() {
-        auto it = isMaxInclusive ? _chunkMap.upper_bound(_extractKeyString(max))
-                                 : _chunkMap.lower_bound(_extractKeyString(max));
-        return it == _chunkMap.end() ? it : ++it;
+std::pair<size_t, size_t> RoutingTableHistory::_overlappingRangeIndexes(
+    const BSONObj& min, const BSONObj& max, bool isMaxInclusive) const {
+    const auto indexMin = _chunkMap.upperBound(_extractKeyString(min));
+    const auto indexMax = [this, &max, isMaxInclusive]() {
+        auto index = isMaxInclusive ? _chunkMap.upperBound(_extractKeyString(max))
+                                    : _chunkMap.lowerBound(_extractKeyString(max));
+        return index == _chunkMap.size() ? index : index + 1;
     }();
 
-    return {itMin, itMax};
+    return {indexMin, indexMax};
 }
 
 IndexBounds ChunkManager::getIndexBoundsForQuery(const BSONObj& key,
@@ -394,7 +1005,7 @@ std::string RoutingTableHistory::toString() const {
 
     sb << "Chunks:\n";
     for (const auto& chunk : _chunkMap) {
-        sb << "\t" << chunk.second->toString() << '\n';
+        sb << "\t" << chunk->toString() << '\n';
     }
 
     sb << "Shard versions:\n";
@@ -405,89 +1016,6 @@ std::string RoutingTableHistory::toString() const {
     return sb.str();
 }
 
-ShardVersionMap RoutingTableHistory::_constructShardVersionMap() const {
-    const OID& epoch = _collectionVersion.epoch();
-
-    ShardVersionMap shardVersions;
-    ChunkInfoMap::const_iterator current = _chunkMap.cbegin();
-
-    boost::optional<BSONObj> firstMin = boost::none;
-    boost::optional<BSONObj> lastMax = boost::none;
-
-    while (current != _chunkMap.cend()) {
-        const auto& firstChunkInRange = current->second;
-        const auto& currentRangeShardId = firstChunkInRange->getShardIdAt(boost::none);
-
-        // Tracks the max shard version for the shard on which the current range will reside
-        auto shardVersionIt = shardVersions.find(currentRangeShardId);
-        if (shardVersionIt == shardVersions.end()) {
-            shardVersionIt =
-                shardVersions.emplace(currentRangeShardId, ChunkVersion(0, 0, epoch)).first;
-        }
-
-        auto& maxShardVersion = shardVersionIt->second;
-
-        current =
-            std::find_if(current,
-                         _chunkMap.cend(),
-                         [&currentRangeShardId,
-                          &maxShardVersion](const ChunkInfoMap::value_type& chunkMapEntry) {
-                             const auto& currentChunk = chunkMapEntry.second;
-
-                             if (currentChunk->getShardIdAt(boost::none) != currentRangeShardId)
-                                 return true;
-
-                             if (currentChunk->getLastmod() > maxShardVersion)
-                                 maxShardVersion = currentChunk->getLastmod();
-
-                             return false;
-                         });
-
-        const auto rangeLast = std::prev(current);
-
-        const auto& rangeMin = firstChunkInRange->getMin();
-        const auto& rangeMax = rangeLast->second->getMax();
-
-        // Check the continuity of the chunks map
-        if (lastMax && !SimpleBSONObjComparator::kInstance.evaluate(*lastMax == rangeMin)) {
-            if (SimpleBSONObjComparator::kInstance.evaluate(*lastMax < rangeMin))
-                uasserted(ErrorCodes::ConflictingOperationInProgress,
-                          str::stream()
-                              << "Gap exists in the routing table between chunks "
-                              << _chunkMap.at(_extractKeyString(*lastMax))->getRange().toString()
-                              << " and "
-                              << rangeLast->second->getRange().toString());
-            else
-                uasserted(ErrorCodes::ConflictingOperationInProgress,
-                          str::stream()
-                              << "Overlap exists in the routing table between chunks "
-                              << _chunkMap.at(_extractKeyString(*lastMax))->getRange().toString()
-                              << " and "
-                              << rangeLast->second->getRange().toString());
-        }
-
-        if (!firstMin)
-            firstMin = rangeMin;
-
-        lastMax = rangeMax;
-
-        // If a shard has chunks it must have a shard version, otherwise we have an invalid chunk
-        // somewhere, which should have been caught at chunk load time
-        invariant(maxShardVersion.isSet());
-    }
-
-    if (!_chunkMap.empty()) {
-        invariant(!shardVersions.empty());
-        invariant(firstMin.is_initialized());
-        invariant(lastMax.is_initialized());
-
-        checkAllElementsAreOfType(MinKey, firstMin.get());
-        checkAllElementsAreOfType(MaxKey, lastMax.get());
-    }
-
-    return shardVersions;
-}
-
 std::string RoutingTableHistory::_extractKeyString(const BSONObj& shardKeyValue) const {
     return extractKeyStringInternal(shardKeyValue, _shardKeyOrdering);
 }
@@ -505,8 +1033,9 @@ std::shared_ptr<RoutingTableHistory> RoutingTableHistory::makeNew(
                                std::move(shardKeyPattern),
                                std::move(defaultCollator),
                                std::move(unique),
-                               {},
-                               {0, 0, epoch})
+                               ChunkMap(epoch),
+                               {0, 0, epoch},
+                               {})
         .makeUpdated(chunks);
 }
 
@@ -514,60 +1043,30 @@ std::shared_ptr<RoutingTableHistory> RoutingTableHistory::makeUpdated(
     const std::vector<ChunkType>& changedChunks) {
 
     const auto startingCollectionVersion = getVersion();
-    auto chunkMap = _chunkMap;
-
-    ChunkVersion collectionVersion = startingCollectionVersion;
-    for (const auto& chunk : changedChunks) {
-        const auto& chunkVersion = chunk.getVersion();
-
-        uassert(ErrorCodes::ConflictingOperationInProgress,
-                str::stream() << "Chunk " << chunk.genID(getns(), chunk.getMin())
-                              << " has epoch different from that of the collection "
-                              << chunkVersion.epoch(),
-                collectionVersion.epoch() == chunkVersion.epoch());
-
-        // Chunks must always come in incrementally sorted order
-        invariant(chunkVersion >= collectionVersion);
-        collectionVersion = chunkVersion;
-
-        const auto chunkMinKeyString = _extractKeyString(chunk.getMin());
-        const auto chunkMaxKeyString = _extractKeyString(chunk.getMax());
-
-        // Returns the first chunk with a max key that is > min - implies that the chunk overlaps
-        // min
-        const auto low = chunkMap.upper_bound(chunkMinKeyString);
-
-        // Returns the first chunk with a max key that is > max - implies that the next chunk cannot
-        // not overlap max
-        const auto high = chunkMap.upper_bound(chunkMaxKeyString);
-
-        // If we are in the middle of splitting a chunk, for the first few
-        // chunks inserted, low == high, because both lookups will point to the
-        // same chunk (the one being split). If we're inserting the last chunk
-        // for the current chunk being split, low will point to the chunk that
-        // we're splitting, and high will point to the next chunk past the one
-        // we're splitting (which could be chunkMap.end()). In this case,
-        // std::distance(low, high) == 1. Lastly, this does not apply during
-        // the creation of the original routing table, in which case the map is
-        // empty and the first chunk that is inserted will find that low ==
-        // high, but low == chunkMap.end(), and we aren't doing a split in that
-        // case.
-        auto foundSingleChunk =
-            ((low == high || std::distance(low, high) == 1) && low != chunkMap.end());
-
-        auto newChunk = std::make_shared<ChunkInfo>(chunk);
-        if (foundSingleChunk) {
-            auto chunkBeingReplacedBySplit = low->second;
-            auto bytesInReplacedChunk =
-                chunkBeingReplacedBySplit->getWritesTracker()->getBytesWritten();
-            newChunk->getWritesTracker()->addBytesWritten(bytesInReplacedChunk);
+    ChunkMap chunkMap(startingCollectionVersion.epoch());
+    ChunkVersion collectionVersion;
+
+    const bool patchInPlace = changedChunks.size() <=
+        std::max(kMinChangesToPatchInPlace, _chunkMap.size() / ChunkMap::kMaxBlockSize);
+    if (patchInPlace) {
+        chunkMap = _chunkMap;
+        FlatChunkTable table(&chunkMap);
+        collectionVersion = applyChunkChanges(
+            table, getns(), _shardKeyOrdering, startingCollectionVersion, changedChunks);
+    } else {
+        TreeChunkTable::Map treeMap;
+        for (size_t i = 0; i < _chunkMap.size(); ++i) {
+            treeMap.emplace_hint(
+                treeMap.end(), _chunkMap.maxKeyStringAt(i).toString(), _chunkMap.chunkAt(i));
         }
 
-        // Erase all chunks from the map, which overlap the chunk we got from the persistent store
-        chunkMap.erase(low, high);
+        TreeChunkTable table(&treeMap);
+        collectionVersion = applyChunkChanges(
+            table, getns(), _shardKeyOrdering, startingCollectionVersion, changedChunks);
 
-        // Insert only the chunk itself
-        chunkMap.insert(std::make_pair(chunkMaxKeyString, newChunk));
+        for (auto& entry : treeMap) {
+            chunkMap.append(entry.first, std::move(entry.second));
+        }
     }
 
     // If at least one diff was applied, the metadata is correct, but it might not have changed so
@@ -581,6 +1080,14 @@ std::shared_ptr<RoutingTableHistory> RoutingTableHistory::makeUpdated(
         return shared_from_this();
     }
 
+    if (patchInPlace) {
+        validateChangedChunks(chunkMap, changedChunks, _shardKeyOrdering);
+    } else {
+        validateChunkMap(chunkMap);
+    }
+
+    auto shardVersions = chunkMap.getShardVersions();
+
     return std::shared_ptr<RoutingTableHistory>(
         new RoutingTableHistory(_nss,
                                 _uuid,
@@ -588,7 +1095,8 @@ std::shared_ptr<RoutingTableHistory> RoutingTableHistory::makeUpdated(
                                 CollatorInterface::cloneCollator(getDefaultCollator()),
                                 isUnique(),
                                 std::move(chunkMap),
-                                collectionVersion));
+                                collectionVersion,
+                                std::move(shardVersions)));
 }
 
 }  // namespace mongo
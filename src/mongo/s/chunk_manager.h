@@ -30,6 +30,7 @@
 
 #pragma once
 
+#include <iterator>
 #include <map>
 #include <set>
 #include <string>
@@ -51,12 +52,244 @@ struct QuerySolutionNode;
 class OperationContext;
 class ChunkManager;
 
-// Ordered map from the max for each chunk to an entry describing the chunk
-using ChunkInfoMap = std::map<std::string, std::shared_ptr<ChunkInfo>>;
-
 // Map from a shard is to the max chunk version on that shard
 using ShardVersionMap = std::map<ShardId, ChunkVersion>;
 
+/**
+ * Flat routing table mapping the max bound of each chunk to an entry describing the chunk. Chunks
+ * are kept sorted by the KeyString of their max bound and stored as parallel arrays: the KeyStrings
+ * are packed into a single buffer, and each chunk's current shard and version are kept next to it,
+ * so that routing lookups are binary searches over contiguous memory rather than walks over a
+ * pointer-linked tree.
+ *
+ * The arrays are split into blocks of bounded size, which are immutable once shared between copies
+ * of the map. Copying a map only copies the block pointers, and patching a copy only clones the
+ * blocks it touches, so successive versions of a routing table share most of their memory and a
+ * refresh of a few chunks does not cost time proportional to the number of chunks.
+ */
+class ChunkMap {
+    struct Block;
+
+public:
+    // Blocks are split once they grow past this many chunks
+    static constexpr size_t kMaxBlockSize = 512;
+
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::shared_ptr<ChunkInfo>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type*;
+        using reference = const value_type&;
+
+        const_iterator() = default;
+
+        reference operator*() const {
+            return _map->_blocks[_block]->chunks[_offset];
+        }
+        pointer operator->() const {
+            return &**this;
+        }
+
+        const_iterator& operator++() {
+            if (++_offset == _map->_blocks[_block]->chunks.size()) {
+                ++_block;
+                _offset = 0;
+            }
+            return *this;
+        }
+        const_iterator operator++(int) {
+            auto result = *this;
+            ++*this;
+            return result;
+        }
+
+        bool operator==(const const_iterator& other) const {
+            return _block == other._block && _offset == other._offset;
+        }
+        bool operator!=(const const_iterator& other) const {
+            return !(*this == other);
+        }
+
+    private:
+        friend class ChunkMap;
+
+        const_iterator(const ChunkMap* map, size_t block, size_t offset)
+            : _map(map), _block(block), _offset(offset) {}
+
+        const ChunkMap* _map{nullptr};
+        size_t _block{0};
+        size_t _offset{0};
+    };
+
+    explicit ChunkMap(OID epoch) : _epoch(std::move(epoch)) {}
+
+    size_t size() const {
+        return _blockEnds.empty() ? 0 : _blockEnds.back();
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+
+    const_iterator begin() const {
+        return {this, 0, 0};
+    }
+
+    const_iterator end() const {
+        return {this, _blocks.size(), 0};
+    }
+
+    const_iterator cbegin() const {
+        return begin();
+    }
+
+    const_iterator cend() const {
+        return end();
+    }
+
+    const_iterator iteratorAt(size_t index) const;
+
+    const std::shared_ptr<ChunkInfo>& chunkAt(size_t index) const;
+
+    /**
+     * Returns the KeyString of the max bound of the chunk at 'index'.
+     */
+    StringData maxKeyStringAt(size_t index) const;
+
+    /**
+     * Returns a dense index identifying the shard currently owning the chunk at 'index'. Chunks
+     * owned by the same shard have the same shard index.
+     */
+    uint32_t shardIndexAt(size_t index) const;
+
+    /**
+     * Returns the shard which owned the chunk at 'index' as of 'ts', or the current owner if 'ts'
+     * is not set.
+     */
+    const ShardId& shardIdAt(size_t index, const boost::optional<Timestamp>& ts) const;
+
+    ChunkVersion versionAt(size_t index) const;
+
+    /**
+     * Returns the index of the first chunk whose max bound sorts after 'keyString', or size() if
+     * there is none. This is the chunk containing the key, if any.
+     */
+    size_t upperBound(StringData keyString) const;
+
+    /**
+     * Returns the index of the first chunk whose max bound does not sort before 'keyString', or
+     * size() if there is none.
+     */
+    size_t lowerBound(StringData keyString) const;
+
+    /**
+     * Appends a chunk, whose max bound must sort after that of all chunks already in the map.
+     */
+    void append(StringData maxKeyString, std::shared_ptr<ChunkInfo> chunk);
+
+    /**
+     * Replaces the chunks in positions [first, last) with 'chunk', shifting the chunks after them.
+     * If 'first' == 'last', inserts 'chunk' at that position.
+     */
+    void replace(size_t first,
+                 size_t last,
+                 StringData maxKeyString,
+                 std::shared_ptr<ChunkInfo> chunk);
+
+    /**
+     * Returns the max version of the chunks owned by each shard. This is maintained as chunks are
+     * replaced, and only requires a scan of the map if a shard lost its highest-versioned chunk
+     * without receiving a newer one.
+     */
+    ShardVersionMap getShardVersions();
+
+private:
+    /**
+     * A contiguous run of chunks and the parallel arrays describing them.
+     */
+    struct Block {
+        size_t size() const {
+            return chunks.size();
+        }
+
+        StringData maxKeyStringAt(size_t offset) const {
+            const size_t begin = offset == 0 ? 0 : maxKeyStringEnds[offset - 1];
+            return StringData(maxKeyStrings.data() + begin, maxKeyStringEnds[offset] - begin);
+        }
+
+        size_t upperBound(StringData keyString) const;
+        size_t lowerBound(StringData keyString) const;
+
+        void replace(size_t first,
+                     size_t last,
+                     StringData maxKeyString,
+                     uint32_t shardIndex,
+                     uint64_t version,
+                     std::shared_ptr<ChunkInfo> chunk);
+
+        void erase(size_t first, size_t last);
+
+        /**
+         * Moves the chunks from 'offset' onwards into a new block.
+         */
+        std::shared_ptr<Block> splitAt(size_t offset);
+
+        // KeyStrings of the max bound of the chunks, concatenated in sorted order
+        std::string maxKeyStrings;
+
+        // End offset in 'maxKeyStrings' of the max bound of each chunk
+        std::vector<uint32_t> maxKeyStringEnds;
+
+        // Index into the map's shard ids of the shard currently owning each chunk
+        std::vector<uint32_t> shardIndexes;
+
+        // Combined major and minor version of each chunk
+        std::vector<uint64_t> versions;
+
+        std::vector<std::shared_ptr<ChunkInfo>> chunks;
+    };
+
+    /**
+     * Count and max version of the chunks owned by a shard. If the chunk with the max version was
+     * replaced, 'maxVersion' is only an upper bound until the shard's chunks are scanned again.
+     */
+    struct ShardChunkStats {
+        size_t numChunks{0};
+        uint64_t maxVersion{0};
+        bool maxVersionStale{false};
+    };
+
+    /**
+     * Returns the block containing the chunk at 'index' and the chunk's offset within it.
+     */
+    std::pair<size_t, size_t> _locate(size_t index) const;
+
+    /**
+     * Returns the block at 'blockIndex', first cloning it if it is shared with another map.
+     */
+    Block& _mutableBlock(size_t blockIndex);
+
+    void _updateBlockEnds(size_t fromBlock);
+
+    uint32_t _getShardIndex(const ShardId& shardId);
+
+    void _addToShardStats(uint32_t shardIndex, uint64_t version);
+    void _removeFromShardStats(uint32_t shardIndex, uint64_t version);
+
+    OID _epoch;
+
+    std::vector<std::shared_ptr<Block>> _blocks;
+
+    // Number of chunks in each block and all blocks before it
+    std::vector<size_t> _blockEnds;
+
+    // Every shard which has owned a chunk in this map, in the order they were first seen, and the
+    // statistics of the chunks each of them currently owns
+    std::vector<ShardId> _shardIds;
+    std::vector<ShardChunkStats> _shardStats;
+};
+
 /**
  * In-memory representation of the routing table for a single sharded collection at various points
  * in time.
@@ -123,7 +356,7 @@ public:
 
     ChunkVersion getVersion(const ShardId& shardId) const;
 
-    const ChunkInfoMap& getChunkMap() const {
+    const ChunkMap& getChunkMap() const {
         return _chunkMap;
     }
 
@@ -147,23 +380,26 @@ public:
         return _uuid;
     }
 
-    std::pair<ChunkInfoMap::const_iterator, ChunkInfoMap::const_iterator> overlappingRanges(
+    std::pair<ChunkMap::const_iterator, ChunkMap::const_iterator> overlappingRanges(
         const BSONObj& min, const BSONObj& max, bool isMaxInclusive) const;
 
-
 private:
     RoutingTableHistory(NamespaceString nss,
                         boost::optional<UUID> uuid,
                         KeyPattern shardKeyPattern,
                         std::unique_ptr<CollatorInterface> defaultCollator,
                         bool unique,
-                        ChunkInfoMap chunkMap,
-                        ChunkVersion collectionVersion);
+                        ChunkMap chunkMap,
+                        ChunkVersion collectionVersion,
+                        ShardVersionMap shardVersions);
 
     /**
-     * Does a single pass over the chunkMap and constructs the ShardVersionMap object.
+     * Returns the positions in the chunk map of the range of chunks overlapping [min, max) or
+     * [min, max], depending on 'isMaxInclusive'.
      */
-    ShardVersionMap _constructShardVersionMap() const;
+    std::pair<size_t, size_t> _overlappingRangeIndexes(const BSONObj& min,
+                                                       const BSONObj& max,
+                                                       bool isMaxInclusive) const;
 
     std::string _extractKeyString(const BSONObj& shardKeyValue) const;
 
@@ -190,7 +426,7 @@ private:
 
     // Map from the max for each chunk to an entry describing the chunk. The union of all chunks'
     // ranges must cover the complete space from [MinKey, MaxKey).
-    const ChunkInfoMap _chunkMap;
+    const ChunkMap _chunkMap;
 
     // Max version across all chunks
     const ChunkVersion _collectionVersion;
@@ -211,7 +447,7 @@ public:
     class ConstChunkIterator {
     public:
         ConstChunkIterator() = default;
-        explicit ConstChunkIterator(ChunkInfoMap::const_iterator iter,
+        explicit ConstChunkIterator(ChunkMap::const_iterator iter,
                                     boost::optional<Timestamp> clusterTime)
             : _iter{std::move(iter)}, _clusterTime{std::move(clusterTime)} {}
 
@@ -229,11 +465,11 @@ public:
             return !(*this == other);
         }
         const Chunk operator*() const {
-            return Chunk{*_iter->second, _clusterTime};
+            return Chunk{**_iter, _clusterTime};
         }
 
     private:
-        ChunkInfoMap::const_iterator _iter;
+        ChunkMap::const_iterator _iter;
         boost::optional<Timestamp> _clusterTime;
     };
 
@@ -32,17 +32,134 @@
 
 #include "mongo/platform/basic.h"
 
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
 
 #include "mongo/s/chunk_writes_tracker.h"
+
+#include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/util/assert_util.h"
 
 namespace mongo {
+namespace {
+
+/**
+ * Returns a random number in (0, 1], which can be passed to log().
+ */
+double nextPositiveDouble(PseudoRandom& random) {
+    return 1.0 - random.nextCanonicalDouble();
+}
+
+// Total size of the shard keys sampled by all the trackers, bounded by kMaxTotalSampledKeyBytes
+AtomicUInt64 totalSampledKeyBytes{0};
+
+/**
+ * Accounts for 'keyBytes' more bytes of sampled keys in place of 'replacedKeyBytes', returning
+ * false without changing the total if that would take it over kMaxTotalSampledKeyBytes.
+ */
+bool reserveSampledKeyBytes(uint64_t keyBytes, uint64_t replacedKeyBytes) {
+    if (keyBytes <= replacedKeyBytes) {
+        totalSampledKeyBytes.fetchAndSubtract(replacedKeyBytes - keyBytes);
+        return true;
+    }
+
+    const uint64_t extraBytes = keyBytes - replacedKeyBytes;
+    const uint64_t maxBytes = ChunkWritesTracker::kMaxTotalSampledKeyBytes;
+    if (totalSampledKeyBytes.addAndFetch(extraBytes) > maxBytes) {
+        totalSampledKeyBytes.fetchAndSubtract(extraBytes);
+        return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+ChunkWritesTracker::~ChunkWritesTracker() {
+    totalSampledKeyBytes.fetchAndSubtract(_sampledKeysBytes);
+}
+
+void ChunkWritesTracker::addWrite(const BSONObj& shardKey, uint64_t bytesWritten, Date_t now) {
+    addBytesWritten(bytesWritten);
+
+    _recentBytesWritten.fetchAndAdd(bytesWritten);
+    if (_recentWritesStartMillis.load() == 0) {
+        _recentWritesStartMillis.compareAndSwap(0, now.toMillisSinceEpoch());
+    }
+
+    const uint64_t keyIndex = _numKeysSeen.fetchAndAdd(1);
+    if (keyIndex >= kMaxSampledKeys && keyIndex < _nextKeyToSample.load()) {
+        return;
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_sampleMutex);
+
+    if (!_random) {
+        _random.emplace(static_cast<int32_t>(now.toMillisSinceEpoch() ^ keyIndex));
+    }
+
+    const uint64_t keyBytes = shardKey.objsize();
+
+    if (keyIndex < kMaxSampledKeys) {
+        // The sample may have been filled by writes counted after a concurrent reset, and a key
+        // over the memory limit leaves it short, so that the keys after it are never sampled
+        if (_sampledKeys.size() >= kMaxSampledKeys || !reserveSampledKeyBytes(keyBytes, 0)) {
+            return;
+        }
+        _sampledKeys.push_back(shardKey.getOwned());
+        _sampledKeysBytes += keyBytes;
+        if (_sampledKeys.size() < kMaxSampledKeys) {
+            return;
+        }
+        _sampleWeight = std::exp(std::log(nextPositiveDouble(*_random)) / kMaxSampledKeys);
+    } else {
+        // Another write may have taken the sample, or reset it, since this one checked the index
+        if (keyIndex < _nextKeyToSample.load()) {
+            return;
+        }
+        auto& sampledKey = _sampledKeys[_random->nextInt32(kMaxSampledKeys)];
+        const uint64_t replacedKeyBytes = sampledKey.objsize();
+        if (reserveSampledKeyBytes(keyBytes, replacedKeyBytes)) {
+            sampledKey = shardKey.getOwned();
+            _sampledKeysBytes = _sampledKeysBytes + keyBytes - replacedKeyBytes;
+        }
+        _sampleWeight *= std::exp(std::log(nextPositiveDouble(*_random)) / kMaxSampledKeys);
+    }
+
+    const double skip =
+        std::floor(std::log(nextPositiveDouble(*_random)) / std::log(1.0 - _sampleWeight));
+    _nextKeyToSample.store(std::max(keyIndex, uint64_t(kMaxSampledKeys) - 1) + 1 +
+                           (skip < 1e18 ? static_cast<uint64_t>(skip) : 0));
+}
 
 uint64_t ChunkWritesTracker::clearBytesWritten() {
+    _recentBytesWritten.store(0);
+    _recentWritesStartMillis.store(0);
     return _bytesWritten.swap(0);
 }
 
+void ChunkWritesTracker::resetSampledKeys() {
+    std::vector<BSONObj> sampledKeys;
+
+    stdx::lock_guard<stdx::mutex> lk(_sampleMutex);
+    _sampledKeys.swap(sampledKeys);
+    totalSampledKeyBytes.fetchAndSubtract(_sampledKeysBytes);
+    _sampledKeysBytes = 0;
+    _sampleWeight = 0;
+    _nextKeyToSample.store(std::numeric_limits<uint64_t>::max());
+    _numKeysSeen.store(0);
+}
+
+void ChunkWritesTracker::noteFailedHotSplit(Milliseconds hotPeriod, Date_t now) {
+    const int maxDoublings = kMaxHotSplitBackoffDoublings;
+    const int doublings = std::min(_numFailedHotSplits.fetchAndAdd(1), maxDoublings);
+    _hotSplitsBackedOffUntilMillis.store((now + hotPeriod * (1 << doublings)).toMillisSinceEpoch());
+}
+
+uint64_t ChunkWritesTracker::getTotalSampledKeyBytes() {
+    return totalSampledKeyBytes.load();
+}
+
 bool ChunkWritesTracker::shouldSplit(uint64_t maxChunkSize) {
     if (_isLockedForSplitting) {
         return false;
@@ -52,6 +169,66 @@ bool ChunkWritesTracker::shouldSplit(uint64_t maxChunkSize) {
     return getBytesWritten() > maxChunkSize / ChunkWritesTracker::kSplitTestFactor;
 }
 
+bool ChunkWritesTracker::isHot(uint64_t maxChunkSize, Milliseconds hotPeriod, Date_t now) {
+    if (_isLockedForSplitting || hotPeriod <= Milliseconds(0) ||
+        now.toMillisSinceEpoch() < _hotSplitsBackedOffUntilMillis.load()) {
+        return false;
+    }
+
+    const uint64_t recentBytesWritten = _recentBytesWritten.load();
+    if (recentBytesWritten <=
+        maxChunkSize / (ChunkWritesTracker::kSplitTestFactor * kHotSplitTestFactor)) {
+        return false;
+    }
+
+    const long long startMillis = _recentWritesStartMillis.load();
+    if (startMillis == 0) {
+        return false;
+    }
+
+    // Compare the measured rate with maxChunkSize / hotPeriod without dividing by the elapsed
+    // time, which may be zero
+    const long long elapsedMillis = std::max(now.toMillisSinceEpoch() - startMillis, 1LL);
+    return static_cast<double>(recentBytesWritten) * durationCount<Milliseconds>(hotPeriod) >=
+        static_cast<double>(maxChunkSize) * elapsedMillis;
+}
+
+std::vector<BSONObj> ChunkWritesTracker::getSplitPointsFromSampledKeys(const BSONObj& min,
+                                                                       const BSONObj& max,
+                                                                       size_t maxSplitPoints) {
+    std::vector<BSONObj> keysInRange;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_sampleMutex);
+        std::copy_if(_sampledKeys.begin(),
+                     _sampledKeys.end(),
+                     std::back_inserter(keysInRange),
+                     [&](const BSONObj& key) {
+                         return key.woCompare(min) >= 0 && key.woCompare(max) < 0;
+                     });
+    }
+
+    std::vector<BSONObj> splitPoints;
+    if (keysInRange.size() < kMinSampledKeysForSplit) {
+        return splitPoints;
+    }
+
+    std::sort(keysInRange.begin(),
+              keysInRange.end(),
+              SimpleBSONObjComparator::kInstance.makeLessThan());
+
+    // Split at the quantiles of the sample. A split point equal to the chunk's min or to the
+    // previous split point would produce an empty chunk, so such quantiles are skipped.
+    for (size_t i = 1; i <= maxSplitPoints; ++i) {
+        const auto& key = keysInRange[i * keysInRange.size() / (maxSplitPoints + 1)];
+        const auto& lowerBound = splitPoints.empty() ? min : splitPoints.back();
+        if (key.woCompare(lowerBound) > 0) {
+            splitPoints.push_back(key);
+        }
+    }
+
+    return splitPoints;
+}
+
 bool ChunkWritesTracker::acquireSplitLock() {
     stdx::lock_guard<stdx::mutex> lk(_mtx);
 
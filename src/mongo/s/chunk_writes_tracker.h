@@ -30,9 +30,16 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
+#include <limits>
+#include <vector>
+
 #include "mongo/base/disallow_copying.h"
+#include "mongo/bson/bsonobj.h"
 #include "mongo/platform/atomic_word.h"
+#include "mongo/platform/random.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
@@ -44,6 +51,34 @@ public:
      */
     static constexpr uint64_t kSplitTestFactor = 5;
 
+    /**
+     * A chunk which is hot is split once the bytes written to it reach the regular split threshold
+     * divided by this factor.
+     */
+    static constexpr uint64_t kHotSplitTestFactor = 4;
+
+    /**
+     * The number of shard keys of the writes to the chunk which are kept as a uniform random
+     * sample, and the minimum number of them needed to choose split points from the sample.
+     */
+    static constexpr size_t kMaxSampledKeys = 128;
+    static constexpr size_t kMinSampledKeysForSplit = 16;
+
+    /**
+     * The most bytes of sampled shard keys held by all the trackers in the process together. Keys
+     * which would take the total over this limit are not sampled.
+     */
+    static constexpr uint64_t kMaxTotalSampledKeyBytes = 64 * 1024 * 1024;
+
+    /**
+     * A chunk whose hot split failed is not considered hot again for the hot period multiplied by
+     * two to the power of the number of consecutive failures, up to this many doublings.
+     */
+    static constexpr int kMaxHotSplitBackoffDoublings = 4;
+
+    ChunkWritesTracker() = default;
+    ~ChunkWritesTracker();
+
     /**
      * Add more bytes written to the chunk.
      */
@@ -51,6 +86,13 @@ public:
         _bytesWritten.fetchAndAdd(bytesWritten);
     }
 
+    /**
+     * Notes a write of 'bytesWritten' bytes at time 'now' to the document with the given shard key.
+     * Besides adding the bytes written, this measures the rate at which the chunk is written to
+     * and adds the shard key to the sample of keys written.
+     */
+    void addWrite(const BSONObj& shardKey, uint64_t bytesWritten, Date_t now);
+
     /**
      * Returns the total number of bytes that have been written to the chunk.
      */
@@ -60,16 +102,55 @@ public:
 
     /**
      * Sets the number of bytes in the tracker to zero and returns the number
-     * of bytes in the tracker prior to clearing it.
+     * of bytes in the tracker prior to clearing it. Also restarts the measurement
+     * of the write rate.
      */
     uint64_t clearBytesWritten();
 
+    /**
+     * Discards the shard keys sampled so far, so that the sample only reflects writes made after a
+     * split attempt and the memory it holds is released.
+     */
+    void resetSampledKeys();
+
+    /**
+     * Notes that a split of this chunk triggered because it was hot failed at time 'now', so that
+     * isHot returns false for 'hotPeriod' times two to the power of the number of consecutive such
+     * failures (see kMaxHotSplitBackoffDoublings).
+     */
+    void noteFailedHotSplit(Milliseconds hotPeriod, Date_t now);
+
+    /**
+     * Returns the total size in bytes of the shard keys sampled by all the trackers in the process.
+     */
+    static uint64_t getTotalSampledKeyBytes();
+
     /**
      * Returns whether or not this chunk is ready to be split based on the
      * maximum allowable size of a chunk.
      */
     bool shouldSplit(uint64_t maxChunkSize);
 
+    /**
+     * Returns whether this chunk is written to fast enough that, at the rate measured since the
+     * bytes written were last cleared, it would receive 'maxChunkSize' bytes within 'hotPeriod'.
+     * Only writes noted through addWrite count, and a chunk is never hot before it has received
+     * maxChunkSize / (kSplitTestFactor * kHotSplitTestFactor) bytes that way, so that a short
+     * burst of writes is not mistaken for sustained load. Always returns false while backing off
+     * after a failed hot split.
+     */
+    bool isHot(uint64_t maxChunkSize, Milliseconds hotPeriod, Date_t now);
+
+    /**
+     * Returns up to 'maxSplitPoints' split points strictly between 'min' and 'max', chosen from the
+     * sampled shard keys so that the sampled writes are spread evenly over the resulting chunks.
+     * Returns no split points if fewer than kMinSampledKeysForSplit keys have been sampled in the
+     * range.
+     */
+    std::vector<BSONObj> getSplitPointsFromSampledKeys(const BSONObj& min,
+                                                       const BSONObj& max,
+                                                       size_t maxSplitPoints);
+
     /**
      * Locks the chunk for splitting, returning false if it is already locked.
      * While it is locked, shouldSplit will always return false.
@@ -88,6 +169,44 @@ private:
      */
     AtomicUInt64 _bytesWritten{0};
 
+    /**
+     * The bytes noted through addWrite since the write rate measurement started, and the time in
+     * milliseconds since the epoch of the first of those writes (zero if there was none yet).
+     */
+    AtomicUInt64 _recentBytesWritten{0};
+    AtomicInt64 _recentWritesStartMillis{0};
+
+    /**
+     * The time in milliseconds since the epoch until which the chunk is not considered hot, and
+     * the number of consecutive hot splits which failed.
+     */
+    AtomicInt64 _hotSplitsBackedOffUntilMillis{0};
+    AtomicInt32 _numFailedHotSplits{0};
+
+    /**
+     * The number of shard keys offered to the sample so far, and the index of the next one to be
+     * sampled once the sample is full. Writes with other indexes only do these atomic operations.
+     */
+    AtomicUInt64 _numKeysSeen{0};
+    AtomicUInt64 _nextKeyToSample{std::numeric_limits<uint64_t>::max()};
+
+    /**
+     * Protects the sample of shard keys and the state used to maintain it.
+     */
+    stdx::mutex _sampleMutex;
+
+    // Reservoir sample of the shard keys written to this chunk, maintained using Li's "Algorithm
+    // L", which picks the index of the next key to sample up front instead of drawing a random
+    // number for each key
+    std::vector<BSONObj> _sampledKeys;
+    double _sampleWeight{0};
+
+    // Total size of the keys in _sampledKeys, which counts towards kMaxTotalSampledKeyBytes
+    uint64_t _sampledKeysBytes{0};
+
+    // Created on the first sampled key, so that chunks which are not written to do not pay for it
+    boost::optional<PseudoRandom> _random;
+
     /**
      * Protects _splitState when starting a split.
      */
@@ -32,6 +32,7 @@
 
 #include "mongo/s/chunk_writes_tracker.h"
 
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/unittest/death_test.h"
 #include "mongo/unittest/unittest.h"
 
@@ -145,6 +146,215 @@ TEST(ChunkWritesTrackerTest, AcquireSplitLockThenReleaseThenReacquireReturnsTrue
     ASSERT_TRUE(wt.acquireSplitLock());
 }
 
+TEST(ChunkWritesTrackerTest, AddWriteAddsBytesWritten) {
+    ChunkWritesTracker wt;
+    wt.addWrite(BSON("x" << 1), 4ull, Date_t::now());
+    wt.addWrite(BSON("x" << 2), 6ull, Date_t::now());
+    ASSERT_EQ(wt.getBytesWritten(), 10ull);
+}
+
+TEST(ChunkWritesTrackerTest, IsHotReturnsFalseWithoutWrites) {
+    ChunkWritesTracker wt;
+    ASSERT_FALSE(wt.isHot(0ull, Seconds(60), Date_t::now()));
+}
+
+TEST(ChunkWritesTrackerTest, IsHotReturnsTrueWhenWriteRateFillsChunkWithinHotPeriod) {
+    ChunkWritesTracker wt;
+    const uint64_t maxChunkSize{1000};
+    const auto start = Date_t::now();
+
+    // 100 bytes per second fill the chunk in 10 seconds
+    wt.addWrite(BSON("x" << 1), 200ull, start);
+    wt.addWrite(BSON("x" << 2), 200ull, start + Seconds(4));
+    ASSERT_TRUE(wt.isHot(maxChunkSize, Seconds(10), start + Seconds(4)));
+    ASSERT_FALSE(wt.isHot(maxChunkSize, Seconds(9), start + Seconds(4)));
+}
+
+TEST(ChunkWritesTrackerTest, IsHotReturnsFalseBelowMinimumBytesWritten) {
+    ChunkWritesTracker wt;
+    const uint64_t maxChunkSize{1000};
+    const auto start = Date_t::now();
+    const auto minBytes = maxChunkSize /
+        (ChunkWritesTracker::kSplitTestFactor * ChunkWritesTracker::kHotSplitTestFactor);
+
+    wt.addWrite(BSON("x" << 1), minBytes, start);
+    ASSERT_FALSE(wt.isHot(maxChunkSize, Seconds(60), start));
+    wt.addWrite(BSON("x" << 2), 1ull, start);
+    ASSERT_TRUE(wt.isHot(maxChunkSize, Seconds(60), start));
+}
+
+TEST(ChunkWritesTrackerTest, IsHotIgnoresBytesAddedWithoutWrites) {
+    ChunkWritesTracker wt;
+    wt.addBytesWritten(1000ull);
+    ASSERT_FALSE(wt.isHot(1000ull, Seconds(60), Date_t::now()));
+}
+
+TEST(ChunkWritesTrackerTest, ClearBytesWrittenRestartsWriteRateMeasurement) {
+    ChunkWritesTracker wt;
+    const auto start = Date_t::now();
+    wt.addWrite(BSON("x" << 1), 1000ull, start);
+    ASSERT_TRUE(wt.isHot(1000ull, Seconds(60), start));
+    wt.clearBytesWritten();
+    ASSERT_FALSE(wt.isHot(1000ull, Seconds(60), start));
+}
+
+TEST(ChunkWritesTrackerTest, IsHotReturnsFalseWhenSplitLockAcquired) {
+    ChunkWritesTracker wt;
+    const auto start = Date_t::now();
+    wt.addWrite(BSON("x" << 1), 1000ull, start);
+    wt.acquireSplitLock();
+    ASSERT_FALSE(wt.isHot(1000ull, Seconds(60), start));
+}
+
+TEST(ChunkWritesTrackerTest, IsHotReturnsFalseWithZeroHotPeriod) {
+    ChunkWritesTracker wt;
+    const auto start = Date_t::now();
+    wt.addWrite(BSON("x" << 1), 1000ull, start);
+    ASSERT_FALSE(wt.isHot(1000ull, Seconds(0), start));
+}
+
+TEST(ChunkWritesTrackerTest, NoSampledSplitPointsWithTooFewKeys) {
+    ChunkWritesTracker wt;
+    for (size_t i = 0; i < ChunkWritesTracker::kMinSampledKeysForSplit - 1; ++i) {
+        wt.addWrite(BSON("x" << static_cast<int>(i)), 1ull, Date_t::now());
+    }
+    ASSERT(wt.getSplitPointsFromSampledKeys(BSON("x" << MINKEY), BSON("x" << MAXKEY), 1).empty());
+}
+
+TEST(ChunkWritesTrackerTest, SampledSplitPointIsMedianOfWrittenKeys) {
+    ChunkWritesTracker wt;
+    for (int i = 0; i < 100; ++i) {
+        wt.addWrite(BSON("x" << i), 1ull, Date_t::now());
+    }
+
+    const auto splitPoints =
+        wt.getSplitPointsFromSampledKeys(BSON("x" << MINKEY), BSON("x" << MAXKEY), 1);
+    ASSERT_EQ(splitPoints.size(), 1u);
+    ASSERT_BSONOBJ_EQ(splitPoints.front(), BSON("x" << 50));
+}
+
+TEST(ChunkWritesTrackerTest, SampledSplitPointsIgnoreKeysOutsideRangeAndDuplicates) {
+    ChunkWritesTracker wt;
+    for (int i = 0; i < 100; ++i) {
+        wt.addWrite(BSON("x" << (i < 30 ? 0 : i)), 1ull, Date_t::now());
+    }
+
+    // The first quantile is the chunk's min and cannot be a split point
+    const auto splitPoints = wt.getSplitPointsFromSampledKeys(BSON("x" << 0), BSON("x" << 90), 3);
+    ASSERT_EQ(splitPoints.size(), 2u);
+    for (const auto& splitPoint : splitPoints) {
+        ASSERT_GT(splitPoint.woCompare(BSON("x" << 0)), 0);
+        ASSERT_LT(splitPoint.woCompare(BSON("x" << 90)), 0);
+    }
+    ASSERT_LT(splitPoints[0].woCompare(splitPoints[1]), 0);
+}
+
+TEST(ChunkWritesTrackerTest, SampleOfManyWritesIsBoundedAndSpread) {
+    ChunkWritesTracker wt;
+    const int kNumWrites = 100000;
+    for (int i = 0; i < kNumWrites; ++i) {
+        wt.addWrite(BSON("x" << i), 1ull, Date_t::now());
+    }
+
+    // Keys sampled uniformly from an increasing sequence have a median near its middle, whereas
+    // keeping only the first or the last keys written would not
+    const auto splitPoints =
+        wt.getSplitPointsFromSampledKeys(BSON("x" << MINKEY), BSON("x" << MAXKEY), 1);
+    ASSERT_EQ(splitPoints.size(), 1u);
+    const int median = splitPoints.front()["x"].numberInt();
+    ASSERT_GT(median, kNumWrites / 4);
+    ASSERT_LT(median, 3 * kNumWrites / 4);
+}
+
+TEST(ChunkWritesTrackerTest, IsHotReturnsFalseWhileBackingOffAfterFailedHotSplits) {
+    ChunkWritesTracker wt;
+    const auto start = Date_t::now();
+    wt.addWrite(BSON("x" << 1), 1000ull, start);
+    ASSERT_TRUE(wt.isHot(1000ull, Seconds(3600), start));
+
+    wt.noteFailedHotSplit(Seconds(10), start);
+    ASSERT_FALSE(wt.isHot(1000ull, Seconds(3600), start + Seconds(9)));
+    ASSERT_TRUE(wt.isHot(1000ull, Seconds(3600), start + Seconds(10)));
+
+    // Each consecutive failure doubles the back off
+    wt.noteFailedHotSplit(Seconds(10), start + Seconds(10));
+    ASSERT_FALSE(wt.isHot(1000ull, Seconds(3600), start + Seconds(29)));
+    ASSERT_TRUE(wt.isHot(1000ull, Seconds(3600), start + Seconds(30)));
+}
+
+TEST(ChunkWritesTrackerTest, HotSplitBackoffIsCapped) {
+    ChunkWritesTracker wt;
+    const auto start = Date_t::now();
+    wt.addWrite(BSON("x" << 1), 1000ull, start);
+
+    for (int i = 0; i < 2 * ChunkWritesTracker::kMaxHotSplitBackoffDoublings; ++i) {
+        wt.noteFailedHotSplit(Seconds(10), start);
+    }
+
+    const auto maxBackoff = Seconds(10) * (1 << ChunkWritesTracker::kMaxHotSplitBackoffDoublings);
+    ASSERT_FALSE(wt.isHot(1000ull, Seconds(3600), start + maxBackoff - Seconds(1)));
+    ASSERT_TRUE(wt.isHot(1000ull, Seconds(3600), start + maxBackoff));
+}
+
+TEST(ChunkWritesTrackerTest, ResetSampledKeysRestartsSample) {
+    ChunkWritesTracker wt;
+    for (int i = 0; i < 100; ++i) {
+        wt.addWrite(BSON("x" << i), 1ull, Date_t::now());
+    }
+    ASSERT_GT(ChunkWritesTracker::getTotalSampledKeyBytes(), 0ull);
+
+    wt.resetSampledKeys();
+    ASSERT_EQ(ChunkWritesTracker::getTotalSampledKeyBytes(), 0ull);
+    ASSERT(wt.getSplitPointsFromSampledKeys(BSON("x" << MINKEY), BSON("x" << MAXKEY), 1).empty());
+
+    // Only the writes after the reset are sampled
+    for (int i = 1000; i < 1100; ++i) {
+        wt.addWrite(BSON("x" << i), 1ull, Date_t::now());
+    }
+    const auto splitPoints =
+        wt.getSplitPointsFromSampledKeys(BSON("x" << MINKEY), BSON("x" << MAXKEY), 1);
+    ASSERT_EQ(splitPoints.size(), 1u);
+    ASSERT_BSONOBJ_EQ(splitPoints.front(), BSON("x" << 1050));
+}
+
+TEST(ChunkWritesTrackerTest, DestroyingTrackerReleasesSampledKeyBytes) {
+    {
+        ChunkWritesTracker wt;
+        for (int i = 0; i < 1000; ++i) {
+            wt.addWrite(BSON("x" << i), 1ull, Date_t::now());
+        }
+        ASSERT_GT(ChunkWritesTracker::getTotalSampledKeyBytes(), 0ull);
+    }
+    ASSERT_EQ(ChunkWritesTracker::getTotalSampledKeyBytes(), 0ull);
+}
+
+TEST(ChunkWritesTrackerTest, SampledKeysOfAllTrackersAreBoundedInSize) {
+    const BSONObj key = BSON("x" << std::string(256 * 1024, 'a'));
+    const uint64_t keyBytes = key.objsize();
+    ASSERT_GT(2 * ChunkWritesTracker::kMaxSampledKeys * keyBytes,
+              ChunkWritesTracker::kMaxTotalSampledKeyBytes);
+
+    ChunkWritesTracker first;
+    ChunkWritesTracker second;
+    for (size_t i = 0; i < 2 * ChunkWritesTracker::kMaxSampledKeys; ++i) {
+        first.addWrite(key, 1ull, Date_t::now());
+        second.addWrite(key, 1ull, Date_t::now());
+    }
+    ASSERT_LTE(ChunkWritesTracker::getTotalSampledKeyBytes(),
+               ChunkWritesTracker::kMaxTotalSampledKeyBytes);
+    ASSERT_GT(ChunkWritesTracker::getTotalSampledKeyBytes() + keyBytes,
+              ChunkWritesTracker::kMaxTotalSampledKeyBytes);
+
+    // Resetting the samples releases their memory, so that a sample can be filled again
+    first.resetSampledKeys();
+    second.resetSampledKeys();
+    for (size_t i = 0; i < ChunkWritesTracker::kMaxSampledKeys; ++i) {
+        second.addWrite(key, 1ull, Date_t::now());
+    }
+    ASSERT_EQ(ChunkWritesTracker::getTotalSampledKeyBytes(),
+              ChunkWritesTracker::kMaxSampledKeys * keyBytes);
+}
+
 DEATH_TEST(ChunkWritesTrackerTest, ReleaseSplitLockWithoutAcquiringErrors, "Invariant failure") {
     ChunkWritesTracker wt;
     wt.releaseSplitLock();
@@ -48,6 +48,7 @@
 #include "mongo/db/query/query_request.h"
 #include "mongo/db/repl/read_concern_args.h"
 #include "mongo/db/server_parameters.h"
+#include "mongo/db/wait_event_stats.h"
 #include "mongo/executor/task_executor_pool.h"
 #include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/rpc/metadata/repl_set_metadata.h"
@@ -213,6 +214,7 @@ StatusWith<Shard::CommandResponse> ShardRemote::_runCommand(OperationContext* op
     // Block until the command is carried out
     auto executor = Grid::get(opCtx)->getExecutorPool()->getFixedExecutor();
     try {
+        ScopedWaitEvent networkWait(opCtx, WaitEventClass::kNetwork);
         executor->wait(asyncHandle.handle, opCtx);
     } catch (const DBException& e) {
         // If waiting for the response is interrupted, then we still have a callback out and
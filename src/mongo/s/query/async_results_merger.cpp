@@ -40,6 +40,8 @@
 #include "mongo/db/query/cursor_response.h"
 #include "mongo/db/query/getmore_request.h"
 #include "mongo/db/query/killcursors_request.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/storage/key_string.h"
 #include "mongo/executor/remote_command_request.h"
 #include "mongo/executor/remote_command_response.h"
 #include "mongo/util/assert_util.h"
@@ -47,6 +49,15 @@
 
 namespace mongo {
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryMongosReadAheadBufferedBytes, int, 0)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "internalQueryMongosReadAheadBufferedBytes must not be negative");
+        }
+        return Status::OK();
+    });
+
 constexpr StringData AsyncResultsMerger::kSortKeyField;
 const BSONObj AsyncResultsMerger::kWholeSortKeySortPattern = BSON(kSortKeyField << 1);
 
@@ -80,6 +91,14 @@ int compareSortKeys(BSONObj leftSortKey, BSONObj rightSortKey, BSONObj sortKeyPa
     return leftSortKey.woCompare(rightSortKey, sortKeyPattern, considerFieldName);
 }
 
+/**
+ * Returns true if sort keys for the specified sort pattern can be compared by their KeyString
+ * encoding, which orders them the same way as compareSortKeys().
+ */
+bool canEncodeSortKeys(const boost::optional<BSONObj>& sort) {
+    return sort && static_cast<size_t>(sort->nFields()) <= Ordering::kMaxCompoundIndexKeys;
+}
+
 }  // namespace
 
 AsyncResultsMerger::AsyncResultsMerger(OperationContext* opCtx,
@@ -94,11 +113,18 @@ AsyncResultsMerger::AsyncResultsMerger(OperationContext* opCtx,
       _params(std::move(params)),
       _mergeQueue(MergingComparator(_remotes,
                                     _params.getSort() ? *_params.getSort() : BSONObj(),
-                                    _params.getCompareWholeSortKey())) {
+                                    _params.getCompareWholeSortKey(),
+                                    canEncodeSortKeys(_params.getSort()))) {
     if (params.getTxnNumber()) {
         invariant(params.getSessionId());
     }
 
+    if (canEncodeSortKeys(_params.getSort())) {
+        _sortKeyOrdering = Ordering::make(*_params.getSort());
+    }
+
+    _mergeQueue.resize(_params.getRemotes().size());
+
     size_t remoteIndex = 0;
     for (const auto& remote : _params.getRemotes()) {
         _remotes.emplace_back(remote.getHostAndPort(),
@@ -180,6 +206,7 @@ void AsyncResultsMerger::addNewShardCursors(std::vector<RemoteCursor>&& newCurso
                               remote.getCursorResponse().getNSS(),
                               remote.getCursorResponse().getCursorId());
     }
+    _mergeQueue.resize(_remotes.size());
 }
 
 bool AsyncResultsMerger::_ready(WithLock lk) {
@@ -278,7 +305,7 @@ StatusWith<ClusterQueryResult> AsyncResultsMerger::nextReady() {
     return _params.getSort() ? _nextReadySorted(lk) : _nextReadyUnsorted(lk);
 }
 
-ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock) {
+ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock lk) {
     // Tailable non-awaitData cursors cannot have a sort.
     invariant(_tailableMode != TailableModeEnum::kTailable);
 
@@ -287,24 +314,31 @@ ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock) {
     }
 
     size_t smallestRemote = _mergeQueue.top();
-    _mergeQueue.pop();
 
     invariant(!_remotes[smallestRemote].docBuffer.empty());
     invariant(_remotes[smallestRemote].status.isOK());
 
     ClusterQueryResult front = _remotes[smallestRemote].docBuffer.front();
     _remotes[smallestRemote].docBuffer.pop();
+    _remotes[smallestRemote].bufferedBytes -= front.getResult()->objsize();
 
-    // Re-populate the merging queue with the next result from 'smallestRemote', if it has a
-    // next result.
+    // Keep 'smallestRemote' in the merging queue with its next result, if it has a next result.
     if (!_remotes[smallestRemote].docBuffer.empty()) {
-        _mergeQueue.push(smallestRemote);
+        _encodeFrontSortKey(lk, smallestRemote);
+        _mergeQueue.update(smallestRemote);
+    } else {
+        _mergeQueue.pop();
+    }
+
+    if (_shouldReadAhead(lk, smallestRemote)) {
+        // A failure to schedule is reported by the next call to ready().
+        _remotes[smallestRemote].status = _askForNextBatch(lk, smallestRemote);
     }
 
     return front;
 }
 
-ClusterQueryResult AsyncResultsMerger::_nextReadyUnsorted(WithLock) {
+ClusterQueryResult AsyncResultsMerger::_nextReadyUnsorted(WithLock lk) {
     size_t remotesAttempted = 0;
     while (remotesAttempted < _remotes.size()) {
         // It is illegal to call this method if there is an error received from any shard.
@@ -313,6 +347,7 @@ ClusterQueryResult AsyncResultsMerger::_nextReadyUnsorted(WithLock) {
         if (_remotes[_gettingFromRemote].hasNext()) {
             ClusterQueryResult front = _remotes[_gettingFromRemote].docBuffer.front();
             _remotes[_gettingFromRemote].docBuffer.pop();
+            _remotes[_gettingFromRemote].bufferedBytes -= front.getResult()->objsize();
 
             if (_tailableMode == TailableModeEnum::kTailable &&
                 !_remotes[_gettingFromRemote].hasNext()) {
@@ -322,6 +357,11 @@ ClusterQueryResult AsyncResultsMerger::_nextReadyUnsorted(WithLock) {
                 _eofNext = true;
             }
 
+            if (_shouldReadAhead(lk, _gettingFromRemote)) {
+                // A failure to schedule is reported by the next call to ready().
+                _remotes[_gettingFromRemote].status = _askForNextBatch(lk, _gettingFromRemote);
+            }
+
             return front;
         }
 
@@ -394,6 +434,17 @@ Status AsyncResultsMerger::_askForNextBatch(WithLock, size_t remoteIndex) {
     return Status::OK();
 }
 
+bool AsyncResultsMerger::_shouldReadAhead(WithLock, size_t remoteIndex) const {
+    const auto& remote = _remotes[remoteIndex];
+    const int maxBufferedBytes = internalQueryMongosReadAheadBufferedBytes.load();
+
+    // Tailable cursors pass the batches of their remote through to the client as-is, so they never
+    // read ahead.
+    return maxBufferedBytes > 0 && _tailableMode == TailableModeEnum::kNormal &&
+        _lifecycleState == kAlive && _opCtx && remote.status.isOK() && !remote.exhausted() &&
+        !remote.cbHandle.isValid() && remote.bufferedBytes < static_cast<size_t>(maxBufferedBytes);
+}
+
 Status AsyncResultsMerger::scheduleGetMores() {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
     return _scheduleGetMores(lk);
@@ -408,9 +459,11 @@ Status AsyncResultsMerger::_scheduleGetMores(WithLock lk) {
             return remote.status;
         }
 
-        if (!remote.hasNext() && !remote.exhausted() && !remote.cbHandle.isValid()) {
+        if ((!remote.hasNext() && !remote.exhausted() && !remote.cbHandle.isValid()) ||
+            _shouldReadAhead(lk, i)) {
             // If this remote is not exhausted and there is no outstanding request for it, schedule
-            // work to retrieve the next batch.
+            // work to retrieve the next batch. This is done before its buffered results are
+            // exhausted if reading ahead.
             auto nextBatchStatus = _askForNextBatch(lk, i);
             if (!nextBatchStatus.isOK()) {
                 return nextBatchStatus;
@@ -580,6 +633,7 @@ void AsyncResultsMerger::_cleanUpFailedBatch(WithLock lk, Status status, size_t
         // Clear the results buffer and cursor id.
         std::queue<ClusterQueryResult> emptyBuffer;
         std::swap(remote.docBuffer, emptyBuffer);
+        remote.bufferedBytes = 0;
         remote.cursorId = 0;
     }
 }
@@ -626,6 +680,9 @@ void AsyncResultsMerger::_processBatchResults(WithLock lk,
         // Be careful only to do this when '_opCtx' is non-null, since it is illegal to schedule a
         // remote command on a user's behalf without a non-null OperationContext.
         remote.status = _askForNextBatch(lk, remoteIndex);
+    } else if (_shouldReadAhead(lk, remoteIndex)) {
+        // Keep reading ahead until the results buffered from this remote reach the threshold.
+        remote.status = _askForNextBatch(lk, remoteIndex);
     }
 }
 
@@ -657,17 +714,32 @@ bool AsyncResultsMerger::_addBatchToBuffer(WithLock lk,
 
         ClusterQueryResult result(obj);
         remote.docBuffer.push(result);
+        remote.bufferedBytes += obj.objsize();
         ++remote.fetchedCount;
     }
 
     // If we're doing a sorted merge, then we have to make sure to put this remote onto the merge
     // queue.
-    if (_params.getSort() && !response.getBatch().empty()) {
+    if (_params.getSort() && !response.getBatch().empty() && !_mergeQueue.isActive(remoteIndex)) {
+        _encodeFrontSortKey(lk, remoteIndex);
         _mergeQueue.push(remoteIndex);
     }
     return true;
 }
 
+void AsyncResultsMerger::_encodeFrontSortKey(WithLock, size_t remoteIndex) {
+    if (!_sortKeyOrdering) {
+        return;
+    }
+
+    auto& remote = _remotes[remoteIndex];
+    const KeyString sortKey(
+        KeyString::kLatestVersion,
+        extractSortKey(*remote.docBuffer.front().getResult(), _params.getCompareWholeSortKey()),
+        *_sortKeyOrdering);
+    remote.frontSortKey.assign(sortKey.getBuffer(), sortKey.getSize());
+}
+
 void AsyncResultsMerger::_signalCurrentEventIfReady(WithLock lk) {
     if (_ready(lk) && _currentEvent.isValid()) {
         // To prevent ourselves from signalling the event twice, we set '_currentEvent' as
@@ -774,13 +846,17 @@ bool AsyncResultsMerger::RemoteCursorData::exhausted() const {
 // AsyncResultsMerger::MergingComparator
 //
 
-bool AsyncResultsMerger::MergingComparator::operator()(const size_t& lhs, const size_t& rhs) {
+bool AsyncResultsMerger::MergingComparator::operator()(size_t lhs, size_t rhs) const {
+    if (_compareEncodedSortKeys) {
+        return _remotes[lhs].frontSortKey < _remotes[rhs].frontSortKey;
+    }
+
     const ClusterQueryResult& leftDoc = _remotes[lhs].docBuffer.front();
     const ClusterQueryResult& rightDoc = _remotes[rhs].docBuffer.front();
 
     return compareSortKeys(extractSortKey(*leftDoc.getResult(), _compareWholeSortKey),
                            extractSortKey(*rightDoc.getResult(), _compareWholeSortKey),
-                           _sort) > 0;
+                           _sort) < 0;
 }
 
 }  // namespace mongo
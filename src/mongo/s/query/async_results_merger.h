@@ -32,15 +32,19 @@
 
 #include <boost/optional.hpp>
 #include <queue>
+#include <string>
 #include <vector>
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/base/status_with.h"
 #include "mongo/bson/bsonobj.h"
+#include "mongo/bson/ordering.h"
 #include "mongo/db/cursor_id.h"
 #include "mongo/executor/task_executor.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/s/query/async_results_merger_params_gen.h"
 #include "mongo/s/query/cluster_query_result.h"
+#include "mongo/s/query/tournament_tree.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/concurrency/with_lock.h"
 #include "mongo/util/net/hostandport.h"
@@ -50,6 +54,11 @@ namespace mongo {
 
 class CursorResponse;
 
+// If positive, the AsyncResultsMerger of a non-tailable cursor reads ahead by asking a remote for
+// its next batch while the results buffered from that remote total fewer than this many bytes,
+// rather than waiting for them to be exhausted. Zero by default, which disables read-ahead.
+extern AtomicInt32 internalQueryMongosReadAheadBufferedBytes;
+
 /**
  * Given a set of cursorIds across one or more shards, the AsyncResultsMerger calls getMore on the
  * cursors to present a single sorted or unsorted stream of documents.
@@ -295,16 +304,31 @@ private:
         // Count of fetched docs during ARM processing of the current batch. Used to reduce the
         // batchSize in getMore when mongod returned less docs than the requested batchSize.
         long long fetchedCount = 0;
+
+        // Total size in bytes of the results in 'docBuffer'.
+        size_t bufferedBytes = 0;
+
+        // If there is a sort, the KeyString encoding of the sort key of the document at the front
+        // of 'docBuffer', so that it can be compared with those of the other remotes by memcmp.
+        std::string frontSortKey;
     };
 
     class MergingComparator {
     public:
         MergingComparator(const std::vector<RemoteCursorData>& remotes,
                           const BSONObj& sort,
-                          bool compareWholeSortKey)
-            : _remotes(remotes), _sort(sort), _compareWholeSortKey(compareWholeSortKey) {}
+                          bool compareWholeSortKey,
+                          bool compareEncodedSortKeys)
+            : _remotes(remotes),
+              _sort(sort),
+              _compareWholeSortKey(compareWholeSortKey),
+              _compareEncodedSortKeys(compareEncodedSortKeys) {}
 
-        bool operator()(const size_t& lhs, const size_t& rhs);
+        /**
+         * Returns true if the document at the front of the 'lhs' remote sorts before the one at
+         * the front of the 'rhs' remote.
+         */
+        bool operator()(size_t lhs, size_t rhs) const;
 
     private:
         const std::vector<RemoteCursorData>& _remotes;
@@ -315,6 +339,10 @@ private:
         // We extract the sort key {$sortKey: <value>}. The sort key pattern '_sort' is verified to
         // be {$sortKey: 1}.
         const bool _compareWholeSortKey;
+
+        // When true, the remotes are compared by their 'frontSortKey' rather than by their BSON
+        // sort keys.
+        const bool _compareEncodedSortKeys;
     };
 
     enum LifecycleState { kAlive, kKillStarted, kKillComplete };
@@ -337,6 +365,13 @@ private:
      */
     Status _askForNextBatch(WithLock, size_t remoteIndex);
 
+    /**
+     * Returns true if a getMore should be scheduled on the remote at 'remoteIndex' ahead of its
+     * buffered results being exhausted. A remote cursor can only serve one getMore at a time, so
+     * this is never the case while a request to the remote is outstanding.
+     */
+    bool _shouldReadAhead(WithLock, size_t remoteIndex) const;
+
     /**
      * Checks whether or not the remote cursors are all exhausted.
      */
@@ -391,6 +426,12 @@ private:
      */
     bool _addBatchToBuffer(WithLock, size_t remoteIndex, const CursorResponse& response);
 
+    /**
+     * Encodes the sort key of the document at the front of the specified remote's buffer into its
+     * 'frontSortKey', if the sort keys are compared in their KeyString encoding.
+     */
+    void _encodeFrontSortKey(WithLock, size_t remoteIndex);
+
     /**
      * If there is a valid unsignaled event that has been requested via nextEvent() and there are
      * buffered results that are ready to return, signals that event.
@@ -432,9 +473,14 @@ private:
     // Data tracking the state of our communication with each of the remote nodes.
     std::vector<RemoteCursorData> _remotes;
 
-    // The top of this priority queue is the index into '_remotes' for the remote host that has the
-    // next document to return, according to the sort order. Used only if there is a sort.
-    std::priority_queue<size_t, std::vector<size_t>, MergingComparator> _mergeQueue;
+    // If there is a sort which fits in an Ordering, the ordering used to encode the sort keys of
+    // the documents at the front of each remote's buffer into their 'frontSortKey'.
+    boost::optional<Ordering> _sortKeyOrdering;
+
+    // The remotes which have buffered results, keyed by the document at the front of their buffer.
+    // Its top is the index into '_remotes' for the remote host that has the next document to
+    // return, according to the sort order. Used only if there is a sort.
+    TournamentTree<MergingComparator> _mergeQueue;
 
     // The index into '_remotes' for the remote from which we are currently retrieving results.
     // Used only if there is *not* a sort.
@@ -42,6 +42,7 @@
 #include "mongo/stdx/memory.h"
 #include "mongo/unittest/death_test.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -370,6 +371,94 @@ TEST_F(AsyncResultsMergerTest, MultiShardMultipleGets) {
     ASSERT_TRUE(unittest::assertGet(arm->nextReady()).isEOF());
 }
 
+TEST_F(AsyncResultsMergerTest, ReadAheadSchedulesGetMoreBeforeBufferIsExhausted) {
+    const auto docSize = fromjson("{_id: 1}").objsize();
+
+    // Read ahead only once less than two documents are buffered.
+    const int originalReadAheadBytes = internalQueryMongosReadAheadBufferedBytes.load();
+    internalQueryMongosReadAheadBufferedBytes.store(2 * docSize);
+    ON_BLOCK_EXIT([&] { internalQueryMongosReadAheadBufferedBytes.store(originalReadAheadBytes); });
+
+    std::vector<RemoteCursor> cursors;
+    std::vector<BSONObj> batch1 = {
+        fromjson("{_id: 1}"), fromjson("{_id: 2}"), fromjson("{_id: 3}")};
+    cursors.push_back(makeRemoteCursor(
+        kTestShardIds[0], kTestShardHosts[0], CursorResponse(kTestNss, 5, batch1)));
+    auto arm = makeARMFromExistingCursors(std::move(cursors));
+
+    // The first batch is buffered, and two documents remain buffered after returning the first
+    // one, so no getMore is scheduled.
+    ASSERT_TRUE(arm->ready());
+    ASSERT_BSONOBJ_EQ(fromjson("{_id: 1}"), *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_FALSE(networkHasReadyRequests());
+
+    // Once a single document remains buffered, the ARM asks for the next batch while it is still
+    // ready to return that document.
+    ASSERT_BSONOBJ_EQ(fromjson("{_id: 2}"), *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_TRUE(networkHasReadyRequests());
+    ASSERT_TRUE(arm->ready());
+
+    std::vector<CursorResponse> responses;
+    std::vector<BSONObj> batch2 = {fromjson("{_id: 4}")};
+    responses.emplace_back(kTestNss, CursorId(0), batch2);
+    scheduleNetworkResponses(std::move(responses));
+
+    // The second batch is appended behind the document which was still buffered.
+    ASSERT_TRUE(arm->remotesExhausted());
+    ASSERT_BSONOBJ_EQ(fromjson("{_id: 3}"), *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_TRUE(arm->ready());
+    ASSERT_BSONOBJ_EQ(fromjson("{_id: 4}"), *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_TRUE(arm->ready());
+    ASSERT_TRUE(unittest::assertGet(arm->nextReady()).isEOF());
+}
+
+TEST_F(AsyncResultsMergerTest, ReadAheadKeepsSortedMergeOrder) {
+    const int originalReadAheadBytes = internalQueryMongosReadAheadBufferedBytes.load();
+    internalQueryMongosReadAheadBufferedBytes.store(1024 * 1024);
+    ON_BLOCK_EXIT([&] { internalQueryMongosReadAheadBufferedBytes.store(originalReadAheadBytes); });
+
+    BSONObj findCmd = fromjson("{find: 'testcoll', sort: {_id: 1}}");
+    std::vector<RemoteCursor> cursors;
+    cursors.push_back(
+        makeRemoteCursor(kTestShardIds[0], kTestShardHosts[0], CursorResponse(kTestNss, 5, {})));
+    cursors.push_back(
+        makeRemoteCursor(kTestShardIds[1], kTestShardHosts[1], CursorResponse(kTestNss, 6, {})));
+    auto arm = makeARMFromExistingCursors(std::move(cursors), findCmd);
+
+    auto readyEvent = unittest::assertGet(arm->nextEvent());
+
+    // Each shard returns a batch but keeps its cursor open, so the ARM immediately asks both for
+    // their next batch even though it is ready to return results.
+    std::vector<CursorResponse> responses;
+    std::vector<BSONObj> batch1 = {fromjson("{$sortKey: {'': 1}}"),
+                                   fromjson("{$sortKey: {'': 4}}")};
+    responses.emplace_back(kTestNss, CursorId(5), batch1);
+    std::vector<BSONObj> batch2 = {fromjson("{$sortKey: {'': 2}}"),
+                                   fromjson("{$sortKey: {'': 3}}")};
+    responses.emplace_back(kTestNss, CursorId(6), batch2);
+    scheduleNetworkResponses(std::move(responses));
+
+    executor()->waitForEvent(readyEvent);
+    ASSERT_TRUE(arm->ready());
+    ASSERT_TRUE(networkHasReadyRequests());
+
+    responses.clear();
+    std::vector<BSONObj> batch3 = {fromjson("{$sortKey: {'': 5}}")};
+    responses.emplace_back(kTestNss, CursorId(0), batch3);
+    std::vector<BSONObj> batch4 = {fromjson("{$sortKey: {'': 6}}")};
+    responses.emplace_back(kTestNss, CursorId(0), batch4);
+    scheduleNetworkResponses(std::move(responses));
+
+    ASSERT_TRUE(arm->remotesExhausted());
+    for (int expected = 1; expected <= 6; ++expected) {
+        ASSERT_TRUE(arm->ready());
+        ASSERT_BSONOBJ_EQ(BSON("$sortKey" << BSON("" << expected)),
+                          *unittest::assertGet(arm->nextReady()).getResult());
+    }
+    ASSERT_TRUE(arm->ready());
+    ASSERT_TRUE(unittest::assertGet(arm->nextReady()).isEOF());
+}
+
 TEST_F(AsyncResultsMergerTest, CompoundSortKey) {
     BSONObj findCmd = fromjson("{find: 'testcoll', sort: {a: -1, b: 1}}");
     std::vector<RemoteCursor> cursors;
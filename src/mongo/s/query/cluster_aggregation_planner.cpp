@@ -60,17 +60,45 @@ namespace mongo {
 namespace cluster_aggregation_planner {
 
 namespace {
+/**
+ * Returns true if 'stage' leaves all of the fields in 'paths' unmodified and under the same names.
+ */
+bool stagePreservesPaths(const DocumentSource& stage, const std::set<std::string>& paths) {
+    auto renames = stage.renamedPaths(paths);
+    return renames && std::all_of(renames->begin(), renames->end(), [](const auto& rename) {
+               return rename.first == rename.second;
+           });
+}
+
+/**
+ * Returns true if 'stage' is a $group which can run in its entirety on each shard, given that
+ * 'shardKeyPaths' are the names of the shard key fields in the documents entering it. This is the
+ * case when the $group key includes every shard key field, since all the documents of a group then
+ * have the same shard key and so belong to the same shard. The shards then return final groups,
+ * which can be streamed to the client without a blocking merging $group.
+ */
+bool canPushGroupToShards(const boost::intrusive_ptr<DocumentSource>& stage,
+                          const std::set<std::string>& shardKeyPaths) {
+    auto group = dynamic_cast<DocumentSourceGroup*>(stage.get());
+    return group && !group->doingMerge() && group->canRunInParallelBeforeOut(shardKeyPaths);
+}
+
 /**
  * Moves everything before a splittable stage to the shards. If there are no splittable stages,
  * moves everything to the shards.
  *
+ * If 'shardKeyPaths' is set, the pipeline reads from a collection sharded on these fields, and
+ * $group stages which group on all of them are moved to the shards instead of being split.
+ *
  * It is not safe to call this optimization multiple times.
  *
  * NOTE: looks for NeedsMergerDocumentSources and uses that API
  *
  * Returns the sort specification if the input streams are sorted, and false otherwise.
  */
-boost::optional<BSONObj> findSplitPoint(Pipeline::SourceContainer* shardPipe, Pipeline* mergePipe) {
+boost::optional<BSONObj> findSplitPoint(Pipeline::SourceContainer* shardPipe,
+                                        Pipeline* mergePipe,
+                                        boost::optional<std::set<std::string>> shardKeyPaths) {
     while (!mergePipe->getSources().empty()) {
         boost::intrusive_ptr<DocumentSource> current = mergePipe->popFront();
 
@@ -79,8 +107,19 @@ boost::optional<BSONObj> findSplitPoint(Pipeline::SourceContainer* shardPipe, Pi
             dynamic_cast<NeedsMergerDocumentSource*>(current.get());
 
         if (!splittable) {
+            // Only track the shard key through stages which leave it as is.
+            if (shardKeyPaths && !stagePreservesPaths(*current, *shardKeyPaths)) {
+                shardKeyPaths = boost::none;
+            }
+
             // Move the source from the merger _sources to the shard _sources.
             shardPipe->push_back(current);
+        } else if (shardKeyPaths && canPushGroupToShards(current, *shardKeyPaths)) {
+            // Move the whole $group to the shards, where it will produce final results. The shard
+            // key fields are not preserved by a $group.
+            static_cast<DocumentSourceGroup*>(current.get())->setWillBeMerged(false);
+            shardPipe->push_back(current);
+            shardKeyPaths = boost::none;
         } else {
             // Split this source into 'merge' and 'shard' _sources.
             boost::intrusive_ptr<DocumentSource> shardSource = splittable->getShardSource();
@@ -449,14 +488,26 @@ boost::optional<ShardedExchangePolicy> walkPipelineBackwardsTrackingShardKey(
 
 }  // namespace
 
-SplitPipeline splitPipeline(std::unique_ptr<Pipeline, PipelineDeleter> pipeline) {
+SplitPipeline splitPipeline(std::unique_ptr<Pipeline, PipelineDeleter> pipeline,
+                            const ShardKeyPattern* shardKeyPattern) {
     auto& expCtx = pipeline->getContext();
     // Re-brand 'pipeline' as the merging pipeline. We will move stages one by one from the merging
     // half to the shards, as possible.
     auto mergePipeline = std::move(pipeline);
 
+    // A $group with a non-simple collation may put values which the shard key considers distinct
+    // into the same group, and so can't be assumed to group the documents of a single shard.
+    boost::optional<std::set<std::string>> shardKeyPaths;
+    if (shardKeyPattern && !expCtx->getCollator()) {
+        shardKeyPaths.emplace();
+        for (auto&& path : shardKeyPattern->getKeyPatternFields()) {
+            shardKeyPaths->emplace(path->dottedField().toString());
+        }
+    }
+
     Pipeline::SourceContainer shardStages;
-    boost::optional<BSONObj> inputsSort = findSplitPoint(&shardStages, mergePipeline.get());
+    boost::optional<BSONObj> inputsSort =
+        findSplitPoint(&shardStages, mergePipeline.get(), std::move(shardKeyPaths));
     auto shardsPipeline = uassertStatusOK(Pipeline::create(std::move(shardStages), expCtx));
 
     // The order in which optimizations are applied can have significant impact on the efficiency of
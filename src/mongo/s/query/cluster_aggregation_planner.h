@@ -39,6 +39,9 @@
 #include "mongo/s/shard_id.h"
 
 namespace mongo {
+
+class ShardKeyPattern;
+
 namespace cluster_aggregation_planner {
 
 /**
@@ -70,8 +73,13 @@ struct SplitPipeline {
  * The 'mergePipeline' returned as part of the SplitPipeline here is not ready to execute until the
  * 'shardsPipeline' has been sent to the shards and cursors have been established. Once cursors have
  * been established, the merge pipeline can be made executable by calling 'addMergeCursorsSource()'
+ *
+ * If the pipeline reads from a sharded collection, 'shardKeyPattern' should be its shard key. A
+ * $group on all of the shard key fields is then executed entirely on the shards, so that its
+ * results can be streamed through the merger.
  */
-SplitPipeline splitPipeline(std::unique_ptr<Pipeline, PipelineDeleter> pipeline);
+SplitPipeline splitPipeline(std::unique_ptr<Pipeline, PipelineDeleter> pipeline,
+                            const ShardKeyPattern* shardKeyPattern = nullptr);
 
 /**
  * Creates a new DocumentSourceMergeCursors from the provided 'remoteCursors' and adds it to the
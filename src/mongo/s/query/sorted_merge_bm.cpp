@@ -0,0 +1,150 @@
+
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <queue>
+#include <string>
+#include <vector>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/bson/ordering.h"
+#include "mongo/db/storage/key_string.h"
+#include "mongo/platform/random.h"
+#include "mongo/s/query/tournament_tree.h"
+
+namespace mongo {
+namespace {
+
+const int kDocsPerRemote = 1000;
+
+const BSONObj kSortPattern = BSON("a" << 1 << "b" << -1);
+
+/**
+ * Generates 'numRemotes' streams of sort keys, each sorted according to 'kSortPattern', in the
+ * shape of the $sortKey values returned to mongos by the shards.
+ */
+std::vector<std::vector<BSONObj>> makeRemoteSortKeys(int numRemotes) {
+    PseudoRandom random(numRemotes);
+
+    std::vector<std::vector<BSONObj>> remotes(numRemotes);
+    for (auto& remote : remotes) {
+        std::vector<std::pair<int, std::string>> values;
+        for (int i = 0; i < kDocsPerRemote; ++i) {
+            values.emplace_back(random.nextInt32(1000), std::string(8, 'a' + random.nextInt32(26)));
+        }
+        std::sort(values.begin(), values.end(), [](const auto& lhs, const auto& rhs) {
+            return lhs.first < rhs.first || (lhs.first == rhs.first && lhs.second > rhs.second);
+        });
+
+        for (const auto& value : values) {
+            remote.push_back(BSON("" << value.first << "" << value.second));
+        }
+    }
+    return remotes;
+}
+
+/**
+ * Merges by comparing BSON sort keys through a binary heap, which is how the AsyncResultsMerger
+ * used to merge sorted remotes.
+ */
+void BM_MergeWithBinaryHeapOverBSON(benchmark::State& state) {
+    const auto remotes = makeRemoteSortKeys(state.range(0));
+
+    for (auto keepRunning : state) {
+        std::vector<size_t> positions(remotes.size(), 0);
+        auto greater = [&](size_t lhs, size_t rhs) {
+            return remotes[lhs][positions[lhs]].woCompare(
+                       remotes[rhs][positions[rhs]], kSortPattern, false) > 0;
+        };
+        std::priority_queue<size_t, std::vector<size_t>, decltype(greater)> heap(greater);
+        for (size_t i = 0; i < remotes.size(); ++i) {
+            heap.push(i);
+        }
+
+        while (!heap.empty()) {
+            const size_t remote = heap.top();
+            heap.pop();
+            benchmark::DoNotOptimize(remotes[remote][positions[remote]]);
+            if (++positions[remote] < remotes[remote].size()) {
+                heap.push(remote);
+            }
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0) * kDocsPerRemote);
+}
+
+/**
+ * Merges by comparing the KeyString encodings of the sort keys through a tournament tree, as the
+ * AsyncResultsMerger does. Each key is encoded as it reaches the front of its remote, so encoding
+ * is part of the measured work.
+ */
+void BM_MergeWithTournamentTreeOverKeyString(benchmark::State& state) {
+    const auto remotes = makeRemoteSortKeys(state.range(0));
+    const auto ordering = Ordering::make(kSortPattern);
+
+    for (auto keepRunning : state) {
+        std::vector<size_t> positions(remotes.size(), 0);
+        std::vector<std::string> frontKeys(remotes.size());
+        auto encodeFront = [&](size_t remote) {
+            KeyString ks(KeyString::kLatestVersion, remotes[remote][positions[remote]], ordering);
+            frontKeys[remote].assign(ks.getBuffer(), ks.getSize());
+        };
+        auto less = [&](size_t lhs, size_t rhs) { return frontKeys[lhs] < frontKeys[rhs]; };
+
+        TournamentTree<decltype(less)> tree(less, remotes.size());
+        for (size_t i = 0; i < remotes.size(); ++i) {
+            encodeFront(i);
+            tree.push(i);
+        }
+
+        while (!tree.empty()) {
+            const size_t remote = tree.top();
+            benchmark::DoNotOptimize(remotes[remote][positions[remote]]);
+            if (++positions[remote] < remotes[remote].size()) {
+                encodeFront(remote);
+                tree.update(remote);
+            } else {
+                tree.pop();
+            }
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0) * kDocsPerRemote);
+}
+
+BENCHMARK(BM_MergeWithBinaryHeapOverBSON)->Arg(10)->Arg(50)->Arg(100)->Arg(200)->Arg(500);
+BENCHMARK(BM_MergeWithTournamentTreeOverKeyString)->Arg(10)->Arg(50)->Arg(100)->Arg(200)->Arg(500);
+
+}  // namespace
+}  // namespace mongo
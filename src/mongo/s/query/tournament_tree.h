@@ -0,0 +1,186 @@
+
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+/**
+ * A tournament tree used to repeatedly select the smallest among a fixed set of sorted sources, as
+ * is done when merging the sorted streams of results from multiple remotes.
+ *
+ * Each source is a leaf of a complete binary tree and is either active, when it has a current
+ * element which competes for the top, or inactive. Every internal node holds the winner of the
+ * match between the winners of its two subtrees. Activating, deactivating or changing the current
+ * element of any source only replays the matches on the path from its leaf to the root, so each of
+ * these operations costs log(k) comparisons for k sources.
+ *
+ * 'Less' is called with the indexes of two active sources and must return true if the current
+ * element of the first orders before the current element of the second. Ties are broken in favour
+ * of the source with the lower index.
+ */
+template <typename Less>
+class TournamentTree {
+public:
+    static constexpr size_t kNone = std::numeric_limits<size_t>::max();
+
+    explicit TournamentTree(Less less, size_t numSources = 0) : _less(std::move(less)) {
+        resize(numSources);
+    }
+
+    size_t numSources() const {
+        return _numSources;
+    }
+
+    /**
+     * Changes the number of sources. Sources which remain keep their state and added sources are
+     * inactive.
+     */
+    void resize(size_t numSources) {
+        size_t numLeaves = 1;
+        while (numLeaves < numSources) {
+            numLeaves *= 2;
+        }
+
+        if (numLeaves == _numLeaves) {
+            _numSources = numSources;
+            return;
+        }
+
+        std::vector<size_t> activeSources;
+        for (size_t source = 0; source < std::min(_numSources, numSources); ++source) {
+            if (isActive(source)) {
+                activeSources.push_back(source);
+            }
+        }
+
+        _numSources = numSources;
+        _numLeaves = numLeaves;
+        _nodes.assign(2 * _numLeaves, kNone);
+
+        for (auto source : activeSources) {
+            push(source);
+        }
+    }
+
+    bool isActive(size_t source) const {
+        dassert(source < _numSources);
+        return _nodes[_numLeaves + source] != kNone;
+    }
+
+    /**
+     * Returns true if no source is active.
+     */
+    bool empty() const {
+        return _nodes[1] == kNone;
+    }
+
+    /**
+     * Returns the index of the active source with the smallest current element. Must not be called
+     * if the tree is empty.
+     */
+    size_t top() const {
+        dassert(!empty());
+        return _nodes[1];
+    }
+
+    /**
+     * Activates an inactive source so that its current element competes for the top.
+     */
+    void push(size_t source) {
+        dassert(!isActive(source));
+        _nodes[_numLeaves + source] = source;
+        _replay(source);
+    }
+
+    /**
+     * Deactivates the top source.
+     */
+    void pop() {
+        const size_t source = top();
+        _nodes[_numLeaves + source] = kNone;
+        _replay(source);
+    }
+
+    /**
+     * Re-evaluates the position of an active source after its current element has changed.
+     */
+    void update(size_t source) {
+        dassert(isActive(source));
+        _replay(source);
+    }
+
+private:
+    /**
+     * Returns the winner of the match between the winners of two sibling subtrees.
+     */
+    size_t _winner(size_t left, size_t right) const {
+        if (left == kNone) {
+            return right;
+        }
+        if (right == kNone) {
+            return left;
+        }
+        // The source in the left subtree always has the lower index
+        return _less(right, left) ? right : left;
+    }
+
+    void _replay(size_t source) {
+        size_t node = _numLeaves + source;
+        size_t winner = _nodes[node];
+        while (node > 1) {
+            const size_t sibling = _nodes[node ^ 1];
+            winner = (node & 1) ? _winner(sibling, winner) : _winner(winner, sibling);
+            node /= 2;
+            _nodes[node] = winner;
+        }
+    }
+
+    Less _less;
+
+    size_t _numSources{0};
+
+    // Number of leaves of the tree, which is the number of sources rounded up to a power of two
+    size_t _numLeaves{0};
+
+    // Heap-ordered nodes of the tree, where the children of node i are nodes 2i and 2i+1 and the
+    // leaves start at index '_numLeaves'. Holds the index of the winning source of the subtree or
+    // kNone if none of its sources is active. Node 0 is unused.
+    std::vector<size_t> _nodes;
+};
+
+}  // namespace mongo
@@ -0,0 +1,214 @@
+
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/s/query/tournament_tree.h"
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+#include "mongo/platform/random.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Merges sorted sources through a TournamentTree, where each source is a vector of ints consumed
+ * from the front.
+ */
+class SortedSources {
+public:
+    explicit SortedSources(std::vector<std::vector<int>> sources)
+        : _sources(std::move(sources)),
+          _positions(_sources.size(), 0),
+          _tree(Less{this}, _sources.size()) {
+        for (size_t i = 0; i < _sources.size(); ++i) {
+            if (!_sources[i].empty()) {
+                _tree.push(i);
+            }
+        }
+    }
+
+    std::vector<int> mergeAll() {
+        std::vector<int> merged;
+        while (!_tree.empty()) {
+            merged.push_back(next());
+        }
+        return merged;
+    }
+
+    int next() {
+        const size_t source = _tree.top();
+        const int value = _current(source);
+        if (++_positions[source] < _sources[source].size()) {
+            _tree.update(source);
+        } else {
+            _tree.pop();
+        }
+        return value;
+    }
+
+    void append(size_t source, int value) {
+        const bool wasEmpty = _positions[source] == _sources[source].size();
+        _sources[source].push_back(value);
+        if (wasEmpty) {
+            _tree.push(source);
+        }
+    }
+
+private:
+    struct Less {
+        bool operator()(size_t lhs, size_t rhs) const {
+            return sources->_current(lhs) < sources->_current(rhs);
+        }
+
+        const SortedSources* sources;
+    };
+
+    int _current(size_t source) const {
+        return _sources[source][_positions[source]];
+    }
+
+    std::vector<std::vector<int>> _sources;
+    std::vector<size_t> _positions;
+    TournamentTree<Less> _tree;
+};
+
+TEST(TournamentTreeTest, EmptyTree) {
+    TournamentTree<std::less<size_t>> tree(std::less<size_t>{});
+    ASSERT(tree.empty());
+    ASSERT_EQ(0U, tree.numSources());
+
+    tree.resize(5);
+    ASSERT(tree.empty());
+    ASSERT_FALSE(tree.isActive(4));
+}
+
+TEST(TournamentTreeTest, SingleSource) {
+    SortedSources sources({{1, 2, 3}});
+    ASSERT(std::vector<int>({1, 2, 3}) == sources.mergeAll());
+}
+
+TEST(TournamentTreeTest, MergesSourcesWithEmptyOnes) {
+    SortedSources sources({{}, {1, 4, 7}, {}, {2, 5}, {0, 3, 6, 8}});
+    ASSERT(std::vector<int>({0, 1, 2, 3, 4, 5, 6, 7, 8}) == sources.mergeAll());
+}
+
+TEST(TournamentTreeTest, TiesAreBrokenByLowerSource) {
+    std::vector<size_t> order;
+    std::vector<int> values{5, 5, 3, 5};
+    auto less = [&](size_t lhs, size_t rhs) { return values[lhs] < values[rhs]; };
+
+    TournamentTree<decltype(less)> tree(less, values.size());
+    for (size_t i = 0; i < values.size(); ++i) {
+        tree.push(i);
+    }
+
+    while (!tree.empty()) {
+        order.push_back(tree.top());
+        tree.pop();
+    }
+
+    ASSERT(std::vector<size_t>({2, 0, 1, 3}) == order);
+}
+
+TEST(TournamentTreeTest, SourceRejoinsAfterBeingExhausted) {
+    SortedSources sources({{1, 10}, {2, 3, 4}});
+    ASSERT_EQ(1, sources.next());
+    ASSERT_EQ(2, sources.next());
+    ASSERT_EQ(3, sources.next());
+    ASSERT_EQ(4, sources.next());
+
+    // The second source is exhausted and rejoins with a value smaller than the current top
+    sources.append(1, 5);
+    ASSERT_EQ(5, sources.next());
+    ASSERT_EQ(10, sources.next());
+    ASSERT(sources.mergeAll().empty());
+}
+
+TEST(TournamentTreeTest, ResizeKeepsActiveSources) {
+    std::vector<int> values{7, 3, 9};
+    auto less = [&](size_t lhs, size_t rhs) { return values[lhs] < values[rhs]; };
+
+    TournamentTree<decltype(less)> tree(less, values.size());
+    tree.push(0);
+    tree.push(2);
+    ASSERT_EQ(0U, tree.top());
+
+    values.push_back(1);
+    values.push_back(4);
+    tree.resize(values.size());
+    ASSERT_EQ(5U, tree.numSources());
+    ASSERT(tree.isActive(0));
+    ASSERT_FALSE(tree.isActive(1));
+    ASSERT(tree.isActive(2));
+    ASSERT_EQ(0U, tree.top());
+
+    tree.push(4);
+    tree.push(3);
+    ASSERT_EQ(3U, tree.top());
+    tree.pop();
+    ASSERT_EQ(4U, tree.top());
+    tree.pop();
+    ASSERT_EQ(0U, tree.top());
+    tree.pop();
+    ASSERT_EQ(2U, tree.top());
+    tree.pop();
+    ASSERT(tree.empty());
+}
+
+TEST(TournamentTreeTest, RandomizedMergeMatchesSort) {
+    PseudoRandom random(12345);
+
+    for (int iteration = 0; iteration < 50; ++iteration) {
+        const size_t numSources = 1 + random.nextInt32(70);
+
+        std::vector<std::vector<int>> input(numSources);
+        std::vector<int> expected;
+        for (auto& source : input) {
+            const int numValues = random.nextInt32(20);
+            for (int i = 0; i < numValues; ++i) {
+                source.push_back(random.nextInt32(100));
+            }
+            std::sort(source.begin(), source.end());
+            expected.insert(expected.end(), source.begin(), source.end());
+        }
+        std::sort(expected.begin(), expected.end());
+
+        SortedSources sources(std::move(input));
+        ASSERT(expected == sources.mergeAll());
+    }
+}
+
+}  // namespace
+}  // namespace mongo
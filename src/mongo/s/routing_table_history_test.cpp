@@ -94,9 +94,7 @@ std::set<ChunkInfo*> getChunksInRange(std::shared_ptr<RoutingTableHistory> rt,
     std::transform(chunksFromSplitIter.first,
                    chunksFromSplitIter.second,
                    std::inserter(chunksFromSplit, chunksFromSplit.begin()),
-                   [](const std::pair<std::string, std::shared_ptr<ChunkInfo>>& pair) {
-                       return pair.second.get();
-                   });
+                   [](const std::shared_ptr<ChunkInfo>& chunkInfo) { return chunkInfo.get(); });
     return chunksFromSplit;
 }
 
@@ -109,7 +107,7 @@ std::shared_ptr<ChunkInfo> getChunkToSplit(std::shared_ptr<RoutingTableHistory>
     invariant(std::distance(chunkToSplitIter.first, chunkToSplitIter.second) <= 1);
     invariant(chunkToSplitIter.first != rt->getChunkMap().end());
 
-    return (*chunkToSplitIter.first).second;
+    return *chunkToSplitIter.first;
 }
 
 /**
@@ -137,8 +135,7 @@ void assertCorrectBytesWritten(std::shared_ptr<RoutingTableHistory> rt,
     auto chunksFromSplit = getChunksInRange(rt, minSplitBoundary, maxSplitBoundary);
     ASSERT_EQ(chunksFromSplit.size(), expectedNumChunksFromSplit);
 
-    for (auto kv : rt->getChunkMap()) {
-        auto chunkInfo = kv.second;
+    for (const auto& chunkInfo : rt->getChunkMap()) {
         auto writesTracker = chunkInfo->getWritesTracker();
         auto bytesWritten = writesTracker->getBytesWritten();
         if (chunksFromSplit.count(chunkInfo.get()) > 0) {
@@ -171,8 +168,7 @@ public:
 
         ASSERT_EQ(_rt->getChunkMap().size(), 1ull);
         // Should only be one
-        for (auto kv : _rt->getChunkMap()) {
-            auto chunkInfo = kv.second;
+        for (const auto& chunkInfo : _rt->getChunkMap()) {
             auto writesTracker = chunkInfo->getWritesTracker();
             writesTracker->addBytesWritten(_bytesInOriginalChunk);
         }
@@ -235,8 +231,7 @@ TEST_F(RoutingTableHistoryTest, SplittingOnlyChunkCopiesBytesWrittenToAllSubchun
     auto rt = splitChunk(getInitialRoutingTable(), newChunkBoundaryPoints);
 
     ASSERT_EQ(rt->getChunkMap().size(), 3ull);
-    for (auto kv : rt->getChunkMap()) {
-        auto chunkInfo = kv.second;
+    for (const auto& chunkInfo : rt->getChunkMap()) {
         auto writesTracker = chunkInfo->getWritesTracker();
         auto bytesWritten = writesTracker->getBytesWritten();
         ASSERT_EQ(bytesWritten, getBytesInOriginalChunk());
@@ -319,5 +314,307 @@ TEST_F(RoutingTableHistoryTestThreeInitialChunks,
                               expectedBytesInChunksNotSplit);
 }
 
+TEST_F(RoutingTableHistoryTestThreeInitialChunks,
+       SplittingMiddleChunkIntoManyCopiesBytesWrittenToAllSubchunks) {
+    auto minKey = getInitialChunkBoundaryPoints()[1];
+    auto maxKey = getInitialChunkBoundaryPoints()[2];
+
+    // Enough chunks that the refresh is not applied by patching the routing table in place
+    const int numChunksFromSplit = 40;
+    std::vector<BSONObj> newChunkBoundaryPoints;
+    for (int i = 0; i < numChunksFromSplit; ++i) {
+        newChunkBoundaryPoints.push_back(BSON("a" << 10 + i * 0.25));
+    }
+    newChunkBoundaryPoints.push_back(maxKey);
+
+    auto chunkToSplit = getChunkToSplit(getInitialRoutingTable(), minKey, maxKey);
+    auto bytesToWrite = 5ull;
+    chunkToSplit->getWritesTracker()->addBytesWritten(bytesToWrite);
+
+    auto rt = splitChunk(getInitialRoutingTable(), newChunkBoundaryPoints);
+
+    auto expectedBytesInChunksFromSplit = getBytesInOriginalChunk() + bytesToWrite;
+    auto expectedBytesInChunksNotSplit = getBytesInOriginalChunk();
+    ASSERT_EQ(rt->getChunkMap().size(), 2ull + numChunksFromSplit);
+    assertCorrectBytesWritten(rt,
+                              minKey,
+                              maxKey,
+                              numChunksFromSplit,
+                              expectedBytesInChunksFromSplit,
+                              expectedBytesInChunksNotSplit);
+
+    ChunkManager cm(rt, boost::none);
+    auto chunk = cm.findIntersectingChunkWithSimpleCollation(BSON("a" << 15.1));
+    ASSERT_BSONOBJ_EQ(chunk.getMin(), BSON("a" << 15.0));
+    ASSERT_BSONOBJ_EQ(chunk.getMax(), BSON("a" << 15.25));
+    ASSERT_EQ(chunk.getShardId(), kThisShard);
+    ASSERT_EQ(cm.getVersion(kThisShard), rt->getVersion());
+}
+
+TEST_F(RoutingTableHistoryTestThreeInitialChunks, MovingChunkUpdatesShardVersions) {
+    const ShardId otherShard("otherShard");
+    auto minKey = getInitialChunkBoundaryPoints()[1];
+    auto maxKey = getInitialChunkBoundaryPoints()[2];
+
+    auto version = getInitialRoutingTable()->getVersion();
+    version.incMajor();
+    std::vector<ChunkType> changedChunks{
+        ChunkType{kNss, ChunkRange{minKey, maxKey}, version, otherShard}};
+    version.incMinor();
+    changedChunks.emplace_back(kNss,
+                               ChunkRange{getInitialChunkBoundaryPoints()[0], minKey},
+                               version,
+                               kThisShard);
+
+    auto rt = getInitialRoutingTable()->makeUpdated(changedChunks);
+    ASSERT_EQ(rt->getChunkMap().size(), 3ull);
+    ASSERT_EQ(rt->getVersion(kThisShard), version);
+    ASSERT_EQ(rt->getVersion(otherShard).majorVersion(), version.majorVersion());
+    ASSERT_EQ(rt->getVersion(otherShard).minorVersion(), 0u);
+
+    ChunkManager cm(rt, boost::none);
+    ASSERT_TRUE(cm.keyBelongsToShard(BSON("a" << 15), otherShard));
+    ASSERT_FALSE(cm.keyBelongsToShard(BSON("a" << 15), kThisShard));
+    ASSERT_TRUE(cm.keyBelongsToShard(BSON("a" << 25), kThisShard));
+
+    std::set<ShardId> shardIds;
+    cm.getShardIdsForRange(BSON("a" << 0), BSON("a" << 12), &shardIds);
+    ASSERT_EQ(shardIds.size(), 2ull);
+}
+
+/**
+ * Test fixture for tests that need a routing table spanning several blocks of the chunk map. Chunk
+ * i covers [i * 100, (i + 1) * 100), except that the first and last chunks extend to MinKey and
+ * MaxKey. Chunks alternate between two shards and chunk i has version 1|i.
+ */
+class RoutingTableHistoryTestManyChunks : public unittest::Test {
+public:
+    static constexpr int kNumChunks = 4 * ChunkMap::kMaxBlockSize;
+
+    const ShardId kOtherShard{"otherShard"};
+
+    void setUp() override {
+        _epoch = OID::gen();
+
+        std::vector<ChunkType> chunks;
+        for (int i = 0; i < kNumChunks; ++i) {
+            chunks.emplace_back(kNss,
+                                ChunkRange{i == 0 ? _shardKeyPattern.globalMin() : key(i * 100),
+                                           i == kNumChunks - 1 ? _shardKeyPattern.globalMax()
+                                                               : key((i + 1) * 100)},
+                                ChunkVersion{1, static_cast<uint32_t>(i), _epoch},
+                                i % 2 == 0 ? kThisShard : kOtherShard);
+        }
+
+        _rt = RoutingTableHistory::makeNew(
+            kNss, UUID::gen(), _shardKeyPattern, nullptr, false, _epoch, chunks);
+        ASSERT_EQ(_rt->getChunkMap().size(), static_cast<size_t>(kNumChunks));
+    }
+
+    static BSONObj key(double value) {
+        return BSON("a" << value);
+    }
+
+    const std::shared_ptr<RoutingTableHistory>& getInitialRoutingTable() const {
+        return _rt;
+    }
+
+    /**
+     * Splits the chunk containing 'min' into 'numPieces' chunks of equal width, which stay on the
+     * chunk's shard.
+     */
+    std::shared_ptr<RoutingTableHistory> splitChunk(const std::shared_ptr<RoutingTableHistory>& rt,
+                                                    double min,
+                                                    double max,
+                                                    int numPieces) {
+        auto chunkToSplit = getChunkToSplit(rt, key(min), key(max));
+        const auto shardId = chunkToSplit->getShardIdAt(boost::none);
+
+        std::vector<ChunkType> newChunks;
+        auto curVersion = rt->getVersion();
+        const double width = (max - min) / numPieces;
+        for (int i = 0; i < numPieces; ++i) {
+            const auto pieceMin = i == 0 ? chunkToSplit->getMin() : key(min + i * width);
+            const auto pieceMax =
+                i == numPieces - 1 ? chunkToSplit->getMax() : key(min + (i + 1) * width);
+            curVersion.incMinor();
+            newChunks.emplace_back(kNss, ChunkRange{pieceMin, pieceMax}, curVersion, shardId);
+        }
+        return rt->makeUpdated(newChunks);
+    }
+
+    /**
+     * Checks that the key 'value' falls in the chunk [min, max) of 'rt' and returns its shard.
+     */
+    ShardId assertKeyIsInChunk(const std::shared_ptr<RoutingTableHistory>& rt,
+                               double value,
+                               double min,
+                               double max) {
+        ChunkManager cm(rt, boost::none);
+        const auto chunk = cm.findIntersectingChunkWithSimpleCollation(key(value));
+        ASSERT_BSONOBJ_EQ(chunk.getMin(), key(min));
+        ASSERT_BSONOBJ_EQ(chunk.getMax(), key(max));
+        return chunk.getShardId();
+    }
+
+    /**
+     * Checks that the chunks of 'rt' are contiguous, that each of them is found by a lookup of its
+     * min bound, and that the shard versions are the max versions of each shard's chunks.
+     */
+    void assertRoutingTableIsConsistent(const std::shared_ptr<RoutingTableHistory>& rt) {
+        ChunkManager cm(rt, boost::none);
+        std::map<ShardId, ChunkVersion> expectedShardVersions;
+
+        BSONObj prevMax = _shardKeyPattern.globalMin();
+        for (const auto& chunk : rt->getChunkMap()) {
+            ASSERT_BSONOBJ_EQ(chunk->getMin(), prevMax);
+            prevMax = chunk->getMax();
+
+            const auto found = cm.findIntersectingChunkWithSimpleCollation(chunk->getMin());
+            ASSERT_BSONOBJ_EQ(found.getMin(), chunk->getMin());
+            ASSERT_BSONOBJ_EQ(found.getMax(), chunk->getMax());
+
+            auto& expectedVersion = expectedShardVersions[chunk->getShardIdAt(boost::none)];
+            if (expectedVersion < chunk->getLastmod()) {
+                expectedVersion = chunk->getLastmod();
+            }
+        }
+        ASSERT_BSONOBJ_EQ(prevMax, _shardKeyPattern.globalMax());
+
+        for (const auto& entry : expectedShardVersions) {
+            ASSERT_EQ(rt->getVersion(entry.first), entry.second);
+        }
+    }
+
+private:
+    OID _epoch;
+    KeyPattern _shardKeyPattern{BSON("a" << 1)};
+    std::shared_ptr<RoutingTableHistory> _rt;
+};
+
+TEST_F(RoutingTableHistoryTestManyChunks, RepeatedSplitsWithinOneBlockSplitItSeveralTimes) {
+    // Each refresh adds 15 chunks to the first block, so it outgrows the maximum block size and is
+    // split several times over
+    const int kNumSplits = 100;
+    const int kNumPieces = 16;
+    auto rt = getInitialRoutingTable();
+    for (int i = 0; i < kNumSplits; ++i) {
+        const double min = (i * 5 + 1) * 100;
+        rt = splitChunk(rt, min, min + 100, kNumPieces);
+    }
+
+    ASSERT_EQ(rt->getChunkMap().size(),
+              static_cast<size_t>(kNumChunks + kNumSplits * (kNumPieces - 1)));
+    assertRoutingTableIsConsistent(rt);
+
+    assertKeyIsInChunk(rt, 160.5, 156.25, 162.5);
+    assertKeyIsInChunk(rt, 250, 200, 300);
+
+    // The initial routing table is unaffected
+    ASSERT_EQ(getInitialRoutingTable()->getChunkMap().size(), static_cast<size_t>(kNumChunks));
+    assertRoutingTableIsConsistent(getInitialRoutingTable());
+}
+
+TEST_F(RoutingTableHistoryTestManyChunks, MergingChunksAcrossBlocksReplacesThemAll) {
+    const int kBlockSize = ChunkMap::kMaxBlockSize;
+
+    // The first merged chunk straddles the boundary between the first two blocks and the second
+    // one covers the whole of the third block along with parts of its neighbours
+    auto version = getInitialRoutingTable()->getVersion();
+    version.incMinor();
+    std::vector<ChunkType> changedChunks{
+        ChunkType{kNss,
+                  ChunkRange{key((kBlockSize - 10) * 100), key((kBlockSize + 20) * 100)},
+                  version,
+                  kThisShard}};
+    version.incMinor();
+    changedChunks.emplace_back(
+        kNss,
+        ChunkRange{key((2 * kBlockSize - 5) * 100), key((3 * kBlockSize + 5) * 100)},
+        version,
+        kOtherShard);
+
+    auto rt = getInitialRoutingTable()->makeUpdated(changedChunks);
+    ASSERT_EQ(rt->getChunkMap().size(), static_cast<size_t>(kNumChunks - 29 - (kBlockSize + 9)));
+    assertRoutingTableIsConsistent(rt);
+
+    ASSERT_EQ(assertKeyIsInChunk(
+                  rt, kBlockSize * 100, (kBlockSize - 10) * 100, (kBlockSize + 20) * 100),
+              kThisShard);
+    ASSERT_EQ(assertKeyIsInChunk(rt,
+                                 2.5 * kBlockSize * 100,
+                                 (2 * kBlockSize - 5) * 100,
+                                 (3 * kBlockSize + 5) * 100),
+              kOtherShard);
+    assertKeyIsInChunk(
+        rt, (3 * kBlockSize + 5) * 100, (3 * kBlockSize + 5) * 100, (3 * kBlockSize + 6) * 100);
+
+    ASSERT_EQ(getInitialRoutingTable()->getChunkMap().size(), static_cast<size_t>(kNumChunks));
+    assertRoutingTableIsConsistent(getInitialRoutingTable());
+}
+
+TEST_F(RoutingTableHistoryTestManyChunks, UpdatedRoutingTableSharesUntouchedBlocks) {
+    const auto& initialChunkMap = getInitialRoutingTable()->getChunkMap();
+    auto rt = splitChunk(getInitialRoutingTable(), 1000, 1100, 2);
+    const auto& chunkMap = rt->getChunkMap();
+    ASSERT_EQ(chunkMap.size(), static_cast<size_t>(kNumChunks + 1));
+
+    // Blocks the refresh did not touch are shared with the previous routing table, so their
+    // entries are the very same objects
+    for (size_t i = ChunkMap::kMaxBlockSize; i < initialChunkMap.size(); ++i) {
+        ASSERT_EQ(&initialChunkMap.chunkAt(i), &chunkMap.chunkAt(i + 1));
+    }
+
+    // The block holding the split chunk was copied before being modified, so the previous routing
+    // table still sees the unsplit chunk, while the unchanged chunks themselves are shared
+    ASSERT_NE(&initialChunkMap.chunkAt(0), &chunkMap.chunkAt(0));
+    ASSERT_EQ(initialChunkMap.chunkAt(0), chunkMap.chunkAt(0));
+    ASSERT_BSONOBJ_EQ(initialChunkMap.chunkAt(10)->getMax(), key(1100));
+    ASSERT_BSONOBJ_EQ(chunkMap.chunkAt(10)->getMax(), key(1050));
+    ASSERT_BSONOBJ_EQ(chunkMap.chunkAt(11)->getMax(), key(1100));
+
+    assertRoutingTableIsConsistent(getInitialRoutingTable());
+    assertRoutingTableIsConsistent(rt);
+}
+
+TEST_F(RoutingTableHistoryTestManyChunks, MovingShardsHighestVersionedChunkRescansItsVersion) {
+    // The highest-versioned chunk of this shard is the second to last one, with version 1|2046
+    const auto lastThisShardChunk = kNumChunks - 2;
+    ASSERT_EQ(getInitialRoutingTable()->getVersion(kThisShard),
+              ChunkVersion(1, lastThisShardChunk, getInitialRoutingTable()->getVersion().epoch()));
+
+    // Move it to the other shard without giving this shard a newer chunk, so its version has to
+    // be found by scanning its remaining chunks
+    auto version = getInitialRoutingTable()->getVersion();
+    version.incMajor();
+    std::vector<ChunkType> changedChunks{
+        ChunkType{kNss,
+                  ChunkRange{key(lastThisShardChunk * 100), key((lastThisShardChunk + 1) * 100)},
+                  version,
+                  kOtherShard}};
+
+    auto rt = getInitialRoutingTable()->makeUpdated(changedChunks);
+    ASSERT_EQ(rt->getVersion(kOtherShard), version);
+    ASSERT_EQ(rt->getVersion(kThisShard),
+              ChunkVersion(1, lastThisShardChunk - 2, version.epoch()));
+    assertRoutingTableIsConsistent(rt);
+
+    // Moving it back gives this shard a newer chunk, which is its max version without a rescan,
+    // while the other shard now has to be rescanned
+    version.incMajor();
+    changedChunks = {
+        ChunkType{kNss,
+                  ChunkRange{key(lastThisShardChunk * 100), key((lastThisShardChunk + 1) * 100)},
+                  version,
+                  kThisShard}};
+    rt = rt->makeUpdated(changedChunks);
+    ASSERT_EQ(rt->getVersion(kThisShard), version);
+    ASSERT_EQ(rt->getVersion(kOtherShard), ChunkVersion(1, kNumChunks - 1, version.epoch()));
+    assertRoutingTableIsConsistent(rt);
+
+    ASSERT_EQ(getInitialRoutingTable()->getVersion(kThisShard),
+              ChunkVersion(1, lastThisShardChunk, version.epoch()));
+}
+
 }  // namespace
 }  // namespace mongo
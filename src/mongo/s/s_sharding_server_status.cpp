@@ -83,7 +83,9 @@ public:
         auto const catalogCache = grid->catalogCache();
 
         BSONObjBuilder result;
-        catalogCache->report(&result);
+        // Per-collection refresh statistics are only reported on request, since the number of
+        // collections is unbounded
+        catalogCache->report(&result, configElement.numberInt() > 1);
         return result.obj();
     }
 
@@ -84,6 +84,303 @@ void noteStaleResponses(const std::vector<ShardError>& staleErrors, NSTargeter*
 // applies when no writes are occurring and metadata is not changing on reload.
 const int kMaxRoundsWithoutProgress(5);
 
+/**
+ * Builds the command to send a child batch to its shard, including the session information of
+ * the client operation.
+ */
+BSONObj buildShardRequest(OperationContext* opCtx,
+                          const BatchWriteOp& batchOp,
+                          const TargetedWriteBatch& batch) {
+    const auto shardBatchRequest(batchOp.buildBatchRequest(batch));
+
+    BSONObjBuilder requestBuilder;
+    shardBatchRequest.serialize(&requestBuilder);
+
+    {
+        OperationSessionInfo sessionInfo;
+
+        if (opCtx->getLogicalSessionId()) {
+            sessionInfo.setSessionId(*opCtx->getLogicalSessionId());
+        }
+
+        sessionInfo.setTxnNumber(opCtx->getTxnNumber());
+        sessionInfo.serialize(&requestBuilder);
+    }
+
+    return requestBuilder.obj();
+}
+
+/**
+ * Notes the response (or the error in place of a response) of a shard to a child batch in the
+ * batch op, and notes any stale metadata it reported in the targeter.
+ */
+void noteShardResponse(OperationContext* opCtx,
+                       NSTargeter& targeter,
+                       BatchWriteOp& batchOp,
+                       const TargetedWriteBatch& batch,
+                       AsyncRequestsSender::Response response,
+                       BatchWriteExecStats* stats) {
+    // First check if we were able to target a shard host.
+    if (!response.shardHostAndPort) {
+        invariant(!response.swResponse.isOK());
+
+        // Record a resolve failure
+        batchOp.noteBatchError(batch, errorFromStatus(response.swResponse.getStatus()));
+
+        // TODO: It may be necessary to refresh the cache if stale, or maybe just cancel and
+        // retarget the batch
+        LOG(4) << "Unable to send write batch to " << batch.getEndpoint().shardName
+               << causedBy(response.swResponse.getStatus());
+        return;
+    }
+
+    const auto shardHost(std::move(*response.shardHostAndPort));
+
+    // Then check if we successfully got a response.
+    Status responseStatus = response.swResponse.getStatus();
+    BatchedCommandResponse batchedCommandResponse;
+    if (responseStatus.isOK()) {
+        std::string errMsg;
+        if (!batchedCommandResponse.parseBSON(response.swResponse.getValue().data, &errMsg) ||
+            !batchedCommandResponse.isValid(&errMsg)) {
+            responseStatus = {ErrorCodes::FailedToParse, errMsg};
+        }
+    }
+
+    if (responseStatus.isOK()) {
+        TrackedErrors trackedErrors;
+        trackedErrors.startTracking(ErrorCodes::StaleShardVersion);
+        trackedErrors.startTracking(ErrorCodes::CannotImplicitlyCreateCollection);
+
+        LOG(4) << "Write results received from " << shardHost.toString() << ": "
+               << redact(batchedCommandResponse.toString());
+
+        // If we are in a transaction, we must fail the whole batch on any error.
+        if (TransactionRouter::get(opCtx)) {
+            // Note: this returns a bad status if any part of the batch failed.
+            auto batchStatus = batchedCommandResponse.toStatus();
+            if (!batchStatus.isOK()) {
+                batchOp.forgetTargetedBatchesOnTransactionAbortingError();
+                uassertStatusOK(batchStatus.withContext(str::stream()
+                                                        << "Encountered error from "
+                                                        << shardHost.toString()
+                                                        << " during a transaction"));
+            }
+        }
+
+        // Dispatch was ok, note response
+        batchOp.noteBatchResponse(batch, batchedCommandResponse, &trackedErrors);
+
+        // Note if anything was stale
+        const auto& staleErrors = trackedErrors.getErrors(ErrorCodes::StaleShardVersion);
+        if (!staleErrors.empty()) {
+            noteStaleResponses(staleErrors, &targeter);
+            ++stats->numStaleBatches;
+        }
+
+        const auto& cannotImplicitlyCreateErrors =
+            trackedErrors.getErrors(ErrorCodes::CannotImplicitlyCreateCollection);
+        if (!cannotImplicitlyCreateErrors.empty()) {
+            // This forces the chunk manager to reload so we can attach the correct version on
+            // retry and make sure we route to the correct shard.
+            targeter.noteCouldNotTarget();
+        }
+
+        // Remember that we successfully wrote to this shard
+        // NOTE: This will record lastOps for shards where we actually didn't update or delete
+        // any documents, which preserves old behavior but is conservative
+        stats->noteWriteAt(shardHost,
+                           batchedCommandResponse.isLastOpSet() ? batchedCommandResponse.getLastOp()
+                                                                : repl::OpTime(),
+                           batchedCommandResponse.isElectionIdSet()
+                               ? batchedCommandResponse.getElectionId()
+                               : OID());
+    } else {
+        // Error occurred dispatching, note it
+        const Status status = responseStatus.withContext(
+            str::stream() << "Write results unavailable from " << shardHost);
+
+        batchOp.noteBatchError(batch, errorFromStatus(status));
+
+        LOG(4) << "Unable to receive write results from " << shardHost
+               << causedBy(redact(status));
+
+        // If we are in a transaction, we must fail the whole batch on any error.
+        if (TransactionRouter::get(opCtx)) {
+            batchOp.forgetTargetedBatchesOnTransactionAbortingError();
+            uassertStatusOK(status.withContext(str::stream() << "Encountered error from "
+                                                             << shardHost.toString()
+                                                             << " during a transaction"));
+        }
+    }
+}
+
+/**
+ * Refreshes the targeter if any stale metadata was noted in it (no-op otherwise) and returns
+ * whether the targeting metadata changed.
+ */
+bool refreshTargeterIfNeeded(OperationContext* opCtx, NSTargeter& targeter) {
+    bool targeterChanged = false;
+    Status refreshStatus = targeter.refreshIfNeeded(opCtx, &targeterChanged);
+
+    LOG(4) << "executeBatch targeter changed: " << targeterChanged;
+
+    if (!refreshStatus.isOK()) {
+        // It's okay if we can't refresh, we'll just record errors for the ops if needed.
+        warning() << "could not refresh targeter" << causedBy(refreshStatus.reason());
+    }
+
+    return targeterChanged;
+}
+
+WriteErrorDetail noProgressError(const NamespaceString& nss, int numCompletedOps, int rounds) {
+    return errorFromStatus({ErrorCodes::NoProgressMade,
+                            str::stream() << "no progress was made executing batch write op in "
+                                          << nss.ns()
+                                          << " after "
+                                          << kMaxRoundsWithoutProgress
+                                          << " rounds ("
+                                          << numCompletedOps
+                                          << " ops completed in "
+                                          << rounds
+                                          << " rounds total)"});
+}
+
+/**
+ * Executes an unordered batch outside of a transaction by streaming child batches to the
+ * shards: each shard has at most one child batch in flight, and as soon as a shard responds the
+ * remaining writes are retargeted and the shard is sent its next batch, without waiting for the
+ * other shards. Stale metadata reported by one shard only causes the writes to that shard to be
+ * retargeted after a refresh, while the other shards keep receiving batches.
+ */
+void executeUnorderedBatchStreaming(OperationContext* opCtx,
+                                    NSTargeter& targeter,
+                                    const BatchedCommandRequest& clientRequest,
+                                    BatchWriteOp& batchOp,
+                                    BatchWriteExecStats* stats) {
+    const bool isRetryableWrite = opCtx->getTxnNumber().is_initialized();
+
+    AsyncRequestsSender ars(opCtx,
+                            Grid::get(opCtx)->getExecutorPool()->getArbitraryExecutor(),
+                            clientRequest.getNS().db(),
+                            {},
+                            kPrimaryOnlyReadPreference,
+                            isRetryableWrite ? Shard::RetryPolicy::kIdempotent
+                                             : Shard::RetryPolicy::kNoRetry);
+
+    // Child batches out on the network, mapped by shard
+    OwnedShardBatchMap ownedPendingBatches;
+    OwnedShardBatchMap::MapType& pendingBatches = ownedPendingBatches.mutableMap();
+
+    // See executeBatch for why targeting errors are only recorded after a refresh
+    bool refreshedTargeter = false;
+    int rounds = 0;
+    int numCompletedOps = 0;
+    int numRoundsWithoutProgress = 0;
+    bool noProgress = false;
+
+    // Progress is judged per round, as in executeBatch, rather than per response, so that the
+    // responses of several shards to the same metadata are not counted as separate attempts. A
+    // round ends once every batch which was in flight when it started has been responded to.
+    std::set<ShardId> roundShards;
+    bool targeterChangedInRound = false;
+
+    const auto endRound = [&] {
+        ++rounds;
+        ++stats->numRounds;
+
+        int currCompletedOps = batchOp.numWriteOpsIn(WriteOpState_Completed);
+        if (currCompletedOps == numCompletedOps && !targeterChangedInRound) {
+            ++numRoundsWithoutProgress;
+        } else {
+            numRoundsWithoutProgress = 0;
+        }
+        numCompletedOps = currCompletedOps;
+        targeterChangedInRound = false;
+
+        noProgress = numRoundsWithoutProgress > kMaxRoundsWithoutProgress;
+    };
+
+    while (!batchOp.isFinished()) {
+        if (!noProgress) {
+            std::set<ShardId> busyShards;
+            for (const auto& pendingBatch : pendingBatches) {
+                busyShards.insert(pendingBatch.first);
+            }
+
+            OwnedPointerMap<ShardId, TargetedWriteBatch> childBatchesOwned;
+            std::map<ShardId, TargetedWriteBatch*>& childBatches = childBatchesOwned.mutableMap();
+
+            Status targetStatus = batchOp.targetBatchForIdleShards(
+                targeter, refreshedTargeter, busyShards, &childBatches);
+            if (!targetStatus.isOK()) {
+                // Don't target anything more until a targeter refresh
+                targeter.noteCouldNotTarget();
+                refreshedTargeter = true;
+                ++stats->numTargetErrors;
+                dassert(childBatches.size() == 0u);
+            }
+
+            for (const auto& childBatch : childBatches) {
+                const auto& targetShardId = childBatch.first;
+                stats->noteTargetedShard(targetShardId);
+
+                const auto request = buildShardRequest(opCtx, batchOp, *childBatch.second);
+
+                LOG(4) << "Sending write batch to " << targetShardId << ": " << redact(request);
+
+                ars.addRequest({targetShardId, request});
+                pendingBatches.emplace(targetShardId, childBatch.second);
+            }
+
+            // The pending batches now own the sent child batches
+            childBatches.clear();
+        }
+
+        if (pendingBatches.empty()) {
+            if (noProgress)
+                break;
+
+            // Nothing could be targeted, refresh before trying again
+            targeterChangedInRound |= refreshTargeterIfNeeded(opCtx, targeter);
+            endRound();
+            continue;
+        }
+
+        if (roundShards.empty()) {
+            for (const auto& pendingBatch : pendingBatches) {
+                roundShards.insert(pendingBatch.first);
+            }
+        }
+
+        // Block until a response is available.
+        auto response = ars.next();
+
+        auto it = pendingBatches.find(response.shardId);
+        invariant(it != pendingBatches.end());
+        std::unique_ptr<TargetedWriteBatch> batch(it->second);
+        pendingBatches.erase(it);
+        roundShards.erase(response.shardId);
+
+        noteShardResponse(opCtx, targeter, batchOp, *batch, std::move(response), stats);
+
+        // Refresh right away, so that the writes of a shard which reported stale metadata are
+        // retargeted before it is sent its next batch
+        if (!batchOp.isFinished())
+            targeterChangedInRound |= refreshTargeterIfNeeded(opCtx, targeter);
+
+        if (roundShards.empty())
+            endRound();
+    }
+
+    // Writes are only left unfinished once no progress is being made, and no batches remain in
+    // flight at that point
+    if (!batchOp.isFinished()) {
+        invariant(noProgress && pendingBatches.empty());
+        batchOp.abortBatch(noProgressError(clientRequest.getNS(), numCompletedOps, rounds));
+    }
+}
+
 }  // namespace
 
 void BatchWriteExec::executeBatch(OperationContext* opCtx,
@@ -98,6 +395,17 @@ void BatchWriteExec::executeBatch(OperationContext* opCtx,
 
     BatchWriteOp batchOp(opCtx, clientRequest);
 
+    // Unordered writes outside of a transaction don't need the shards to be written to in rounds
+    if (!clientRequest.getWriteCommandBase().getOrdered() && !TransactionRouter::get(opCtx)) {
+        executeUnorderedBatchStreaming(opCtx, targeter, clientRequest, batchOp, stats);
+        batchOp.buildClientResponse(clientResponse);
+
+        LOG(4) << "Finished streaming execution of write batch"
+               << (clientResponse->isErrDetailsSet() ? " with write errors" : "") << " for "
+               << clientRequest.getNS();
+        return;
+    }
+
     // Current batch status
     bool refreshedTargeter = false;
     int rounds = 0;
@@ -178,25 +486,7 @@ void BatchWriteExec::executeBatch(OperationContext* opCtx,
 
                 stats->noteTargetedShard(targetShardId);
 
-                const auto request = [&] {
-                    const auto shardBatchRequest(batchOp.buildBatchRequest(*nextBatch));
-
-                    BSONObjBuilder requestBuilder;
-                    shardBatchRequest.serialize(&requestBuilder);
-
-                    {
-                        OperationSessionInfo sessionInfo;
-
-                        if (opCtx->getLogicalSessionId()) {
-                            sessionInfo.setSessionId(*opCtx->getLogicalSessionId());
-                        }
-
-                        sessionInfo.setTxnNumber(opCtx->getTxnNumber());
-                        sessionInfo.serialize(&requestBuilder);
-                    }
-
-                    return requestBuilder.obj();
-                }();
+                const auto request = buildShardRequest(opCtx, batchOp, *nextBatch);
 
                 LOG(4) << "Sending write batch to " << targetShardId << ": " << redact(request);
 
@@ -234,108 +524,7 @@ void BatchWriteExec::executeBatch(OperationContext* opCtx,
                 dassert(pendingBatches.find(response.shardId) != pendingBatches.end());
                 TargetedWriteBatch* batch = pendingBatches.find(response.shardId)->second;
 
-                // First check if we were able to target a shard host.
-                if (!response.shardHostAndPort) {
-                    invariant(!response.swResponse.isOK());
-
-                    // Record a resolve failure
-                    batchOp.noteBatchError(*batch,
-                                           errorFromStatus(response.swResponse.getStatus()));
-
-                    // TODO: It may be necessary to refresh the cache if stale, or maybe just cancel
-                    // and retarget the batch
-                    LOG(4) << "Unable to send write batch to " << batch->getEndpoint().shardName
-                           << causedBy(response.swResponse.getStatus());
-
-                    // We're done with this batch. Clean up when we can't resolve a host.
-                    auto it = childBatches.find(batch->getEndpoint().shardName);
-                    invariant(it != childBatches.end());
-                    delete it->second;
-                    it->second = nullptr;
-                    continue;
-                }
-
-                const auto shardHost(std::move(*response.shardHostAndPort));
-
-                // Then check if we successfully got a response.
-                Status responseStatus = response.swResponse.getStatus();
-                BatchedCommandResponse batchedCommandResponse;
-                if (responseStatus.isOK()) {
-                    std::string errMsg;
-                    if (!batchedCommandResponse.parseBSON(response.swResponse.getValue().data,
-                                                          &errMsg) ||
-                        !batchedCommandResponse.isValid(&errMsg)) {
-                        responseStatus = {ErrorCodes::FailedToParse, errMsg};
-                    }
-                }
-
-                if (responseStatus.isOK()) {
-                    TrackedErrors trackedErrors;
-                    trackedErrors.startTracking(ErrorCodes::StaleShardVersion);
-                    trackedErrors.startTracking(ErrorCodes::CannotImplicitlyCreateCollection);
-
-                    LOG(4) << "Write results received from " << shardHost.toString() << ": "
-                           << redact(batchedCommandResponse.toString());
-
-                    // If we are in a transaction, we must fail the whole batch on any error.
-                    if (TransactionRouter::get(opCtx)) {
-                        // Note: this returns a bad status if any part of the batch failed.
-                        auto batchStatus = batchedCommandResponse.toStatus();
-                        if (!batchStatus.isOK()) {
-                            batchOp.forgetTargetedBatchesOnTransactionAbortingError();
-                            uassertStatusOK(batchStatus.withContext(
-                                str::stream() << "Encountered error from " << shardHost.toString()
-                                              << " during a transaction"));
-                        }
-                    }
-
-                    // Dispatch was ok, note response
-                    batchOp.noteBatchResponse(*batch, batchedCommandResponse, &trackedErrors);
-
-                    // Note if anything was stale
-                    const auto& staleErrors =
-                        trackedErrors.getErrors(ErrorCodes::StaleShardVersion);
-                    if (!staleErrors.empty()) {
-                        noteStaleResponses(staleErrors, &targeter);
-                        ++stats->numStaleBatches;
-                    }
-
-                    const auto& cannotImplicitlyCreateErrors =
-                        trackedErrors.getErrors(ErrorCodes::CannotImplicitlyCreateCollection);
-                    if (!cannotImplicitlyCreateErrors.empty()) {
-                        // This forces the chunk manager to reload so we can attach the correct
-                        // version on retry and make sure we route to the correct shard.
-                        targeter.noteCouldNotTarget();
-                    }
-
-                    // Remember that we successfully wrote to this shard
-                    // NOTE: This will record lastOps for shards where we actually didn't update
-                    // or delete any documents, which preserves old behavior but is conservative
-                    stats->noteWriteAt(shardHost,
-                                       batchedCommandResponse.isLastOpSet()
-                                           ? batchedCommandResponse.getLastOp()
-                                           : repl::OpTime(),
-                                       batchedCommandResponse.isElectionIdSet()
-                                           ? batchedCommandResponse.getElectionId()
-                                           : OID());
-                } else {
-                    // Error occurred dispatching, note it
-                    const Status status = responseStatus.withContext(
-                        str::stream() << "Write results unavailable from " << shardHost);
-
-                    batchOp.noteBatchError(*batch, errorFromStatus(status));
-
-                    LOG(4) << "Unable to receive write results from " << shardHost
-                           << causedBy(redact(status));
-
-                    // If we are in a transaction, we must fail the whole batch on any error.
-                    if (TransactionRouter::get(opCtx)) {
-                        batchOp.forgetTargetedBatchesOnTransactionAbortingError();
-                        uassertStatusOK(status.withContext(
-                            str::stream() << "Encountered error from " << shardHost.toString()
-                                          << " during a transaction"));
-                    }
-                }
+                noteShardResponse(opCtx, targeter, batchOp, *batch, std::move(response), stats);
             }
         }
 
@@ -352,16 +541,7 @@ void BatchWriteExec::executeBatch(OperationContext* opCtx,
         // Refresh the targeter if we need to (no-op if nothing stale)
         //
 
-        bool targeterChanged = false;
-        Status refreshStatus = targeter.refreshIfNeeded(opCtx, &targeterChanged);
-
-        LOG(4) << "executeBatch targeter changed: " << targeterChanged;
-
-        if (!refreshStatus.isOK()) {
-            // It's okay if we can't refresh, we'll just record errors for the ops if
-            // needed.
-            warning() << "could not refresh targeter" << causedBy(refreshStatus.reason());
-        }
+        const bool targeterChanged = refreshTargeterIfNeeded(opCtx, targeter);
 
         //
         // Ensure progress is being made toward completing the batch op
@@ -376,17 +556,7 @@ void BatchWriteExec::executeBatch(OperationContext* opCtx,
         numCompletedOps = currCompletedOps;
 
         if (numRoundsWithoutProgress > kMaxRoundsWithoutProgress) {
-            batchOp.abortBatch(errorFromStatus(
-                {ErrorCodes::NoProgressMade,
-                 str::stream() << "no progress was made executing batch write op in "
-                               << clientRequest.getNS().ns()
-                               << " after "
-                               << kMaxRoundsWithoutProgress
-                               << " rounds ("
-                               << numCompletedOps
-                               << " ops completed in "
-                               << rounds
-                               << " rounds total)"}));
+            batchOp.abortBatch(noProgressError(clientRequest.getNS(), numCompletedOps, rounds));
             break;
         }
     }
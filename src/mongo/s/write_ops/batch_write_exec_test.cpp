@@ -52,6 +52,8 @@ namespace {
 const HostAndPort kTestShardHost = HostAndPort("FakeHost", 12345);
 const HostAndPort kTestConfigShardHost = HostAndPort("FakeConfigHost", 12345);
 const std::string shardName = "FakeShard";
+const HostAndPort kTestShardHost2 = HostAndPort("FakeHost2", 12345);
+const std::string shardName2 = "FakeShard2";
 const int kMaxRoundsWithoutProgress = 5;
 
 /**
@@ -615,6 +617,175 @@ TEST_F(BatchWriteExecTest, StaleEpochIsNotRetryable) {
     future.timed_get(kFutureTimeout);
 }
 
+/**
+ * Splits the collection between two shards, with the documents having negative x values on the
+ * first shard.
+ */
+class BatchWriteExecTwoShardsTest : public BatchWriteExecTest {
+public:
+    void setUp() override {
+        BatchWriteExecTest::setUp();
+
+        std::unique_ptr<RemoteCommandTargeterMock> targeter(
+            stdx::make_unique<RemoteCommandTargeterMock>());
+        targeter->setConnectionStringReturnValue(ConnectionString(kTestShardHost2));
+        targeter->setFindHostReturnValue(kTestShardHost2);
+        targeterFactory()->addTargeterToReturn(ConnectionString(kTestShardHost2),
+                                               std::move(targeter));
+
+        ShardType shardType;
+        shardType.setName(shardName);
+        shardType.setHost(kTestShardHost.toString());
+        ShardType shardType2;
+        shardType2.setName(shardName2);
+        shardType2.setHost(kTestShardHost2.toString());
+        setupShards({shardType, shardType2});
+
+        nsTargeter.init(nss,
+                        {MockRange(ShardEndpoint(shardName, ChunkVersion::IGNORED()),
+                                   BSON("x" << MINKEY),
+                                   BSON("x" << 0)),
+                         MockRange(ShardEndpoint(shardName2, ChunkVersion::IGNORED()),
+                                   BSON("x" << 0),
+                                   BSON("x" << MAXKEY))});
+    }
+
+    /**
+     * Expects an insert sent to 'host' whose documents are a prefix of [expectedFrom, expectedTo)
+     * and returns the number of documents it contained.
+     */
+    size_t expectInsertsToHostReturnSuccess(const HostAndPort& host,
+                                            std::vector<BSONObj>::const_iterator expectedFrom,
+                                            std::vector<BSONObj>::const_iterator expectedTo) {
+        size_t numInserted = 0;
+
+        onCommandForPoolExecutor([&](const executor::RemoteCommandRequest& request) {
+            ASSERT_EQUALS(host, request.target);
+
+            const auto opMsgRequest(OpMsgRequest::fromDBAndBody(request.dbname, request.cmdObj));
+            const auto actualBatchedInsert(BatchedCommandRequest::parseInsert(opMsgRequest));
+            ASSERT_EQUALS(nss.toString(), actualBatchedInsert.getNS().ns());
+
+            const auto& inserted = actualBatchedInsert.getInsertRequest().getDocuments();
+            ASSERT_LTE(inserted.size(), size_t(std::distance(expectedFrom, expectedTo)));
+
+            auto itExpected = expectedFrom;
+            for (const auto& doc : inserted) {
+                ASSERT_BSONOBJ_EQ(*itExpected++, doc);
+            }
+
+            numInserted = inserted.size();
+
+            BatchedCommandResponse response;
+            response.setStatus(Status::OK());
+            response.setN(inserted.size());
+
+            return response.toBSON();
+        });
+
+        return numInserted;
+    }
+};
+
+TEST_F(BatchWriteExecTwoShardsTest, UnorderedBatchIsStreamedToIdleShards) {
+    // The documents for the first shard need two child batches, and the document for the second
+    // shard comes after all of them
+    const int kNumLargeDocs = 20;
+    const std::string kDocValue(1024 * 1024, 'x');
+
+    std::vector<BSONObj> largeDocs;
+    for (int i = 0; i < kNumLargeDocs; i++) {
+        largeDocs.push_back(BSON("x" << -(i + 1) << "someLargeKeyToWasteSpace" << kDocValue));
+    }
+    const std::vector<BSONObj> smallDocs{BSON("x" << 1)};
+
+    BatchedCommandRequest request([&] {
+        write_ops::Insert insertOp(nss);
+        insertOp.setWriteCommandBase([] {
+            write_ops::WriteCommandBase writeCommandBase;
+            writeCommandBase.setOrdered(false);
+            return writeCommandBase;
+        }());
+        std::vector<BSONObj> docsToInsert(largeDocs);
+        docsToInsert.insert(docsToInsert.end(), smallDocs.begin(), smallDocs.end());
+        insertOp.setDocuments(docsToInsert);
+        return insertOp;
+    }());
+    request.setWriteConcern(BSONObj());
+
+    auto future = launchAsync([&] {
+        BatchedCommandResponse response;
+        BatchWriteExecStats stats;
+        BatchWriteExec::executeBatch(operationContext(), nsTargeter, request, &response, &stats);
+        ASSERT(response.getOk());
+        ASSERT_EQUALS(kNumLargeDocs + 1, response.getN());
+
+        // The second batch for the first shard is sent during the first round, which ends once
+        // both shards have responded
+        ASSERT_EQUALS(2, stats.numRounds);
+    });
+
+    const size_t numInFirstBatch =
+        expectInsertsToHostReturnSuccess(kTestShardHost, largeDocs.begin(), largeDocs.end());
+    ASSERT_LT(numInFirstBatch, largeDocs.size());
+
+    // The second shard is sent its batch along with the first batch for the first shard, rather
+    // than after all the batches for the first shard
+    ASSERT_EQUALS(
+        1u, expectInsertsToHostReturnSuccess(kTestShardHost2, smallDocs.begin(), smallDocs.end()));
+
+    ASSERT_EQUALS(largeDocs.size() - numInFirstBatch,
+                  expectInsertsToHostReturnSuccess(
+                      kTestShardHost, largeDocs.begin() + numInFirstBatch, largeDocs.end()));
+
+    future.timed_get(kFutureTimeout);
+}
+
+TEST_F(BatchWriteExecTwoShardsTest, UnorderedBatchCountsNoProgressPerRound) {
+    // Both shards keep reporting stale versions. Their responses to the same round of batches only
+    // count once towards the no progress limit.
+    const std::vector<BSONObj> firstShardDocs{BSON("x" << -1)};
+    const std::vector<BSONObj> secondShardDocs{BSON("x" << 1)};
+
+    BatchedCommandRequest request([&] {
+        write_ops::Insert insertOp(nss);
+        insertOp.setWriteCommandBase([] {
+            write_ops::WriteCommandBase writeCommandBase;
+            writeCommandBase.setOrdered(false);
+            return writeCommandBase;
+        }());
+        insertOp.setDocuments({firstShardDocs[0], secondShardDocs[0]});
+        return insertOp;
+    }());
+    request.setWriteConcern(BSONObj());
+
+    // The first shard is sent its next batch as soon as it responds, so it has one more batch in
+    // flight when the last round without progress ends
+    const int kNumRounds = 1 + kMaxRoundsWithoutProgress;
+
+    auto future = launchAsync([&] {
+        BatchedCommandResponse response;
+        BatchWriteExecStats stats;
+        BatchWriteExec::executeBatch(operationContext(), nsTargeter, request, &response, &stats);
+        ASSERT(response.getOk());
+        ASSERT_EQ(0, response.getN());
+        ASSERT(response.isErrDetailsSet());
+        ASSERT_EQUALS(response.getErrDetailsAt(0)->toStatus().code(), ErrorCodes::NoProgressMade);
+        ASSERT_EQUALS(response.getErrDetailsAt(1)->toStatus().code(), ErrorCodes::NoProgressMade);
+
+        ASSERT_EQUALS(stats.numStaleBatches, 2 * kNumRounds + 1);
+        ASSERT_EQUALS(stats.numRounds, kNumRounds + 1);
+    });
+
+    for (int i = 0; i < kNumRounds; i++) {
+        expectInsertsReturnStaleVersionErrors(firstShardDocs);
+        expectInsertsReturnStaleVersionErrors(secondShardDocs);
+    }
+    expectInsertsReturnStaleVersionErrors(firstShardDocs);
+
+    future.timed_get(kFutureTimeout);
+}
+
 class BatchWriteExecTransactionTest : public BatchWriteExecTest {
 public:
     const TxnNumber kTxnNumber = 5;
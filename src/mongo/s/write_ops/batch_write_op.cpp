@@ -127,6 +127,38 @@ bool isNewBatchRequiredUnordered(const std::vector<TargetedWrite*>& writes,
     return false;
 }
 
+/**
+ * Helper to determine whether any of a number of targeted writes goes to a shard which already
+ * has a batch outstanding.
+ */
+bool isAnyShardBusy(const std::vector<TargetedWrite*>& writes,
+                    const std::set<ShardId>& busyShards) {
+    for (const auto write : writes) {
+        if (busyShards.count(write->endpoint.shardName)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Helper to determine whether a write of the given size can no longer be added to a batch.
+ */
+bool isBatchFull(const TargetedWriteBatch& batch, int writeSizeBytes) {
+    if (batch.getNumOps() >= write_ops::kMaxWriteBatchSize) {
+        // Too many items in batch
+        return true;
+    }
+
+    if (batch.getEstimatedSizeBytes() + writeSizeBytes > BSONObjMaxUserSize) {
+        // Batch would be too big
+        return true;
+    }
+
+    return false;
+}
+
 /**
  * Helper to determine whether a number of targeted writes require a new targeted batch.
  */
@@ -140,15 +172,7 @@ bool wouldMakeBatchesTooBig(const std::vector<TargetedWrite*>& writes,
             continue;
         }
 
-        const auto& batch = it->second;
-
-        if (batch->getNumOps() >= write_ops::kMaxWriteBatchSize) {
-            // Too many items in batch
-            return true;
-        }
-
-        if (batch->getEstimatedSizeBytes() + writeSizeBytes > BSONObjMaxUserSize) {
-            // Batch would be too big
+        if (isBatchFull(*it->second, writeSizeBytes)) {
             return true;
         }
     }
@@ -258,6 +282,22 @@ BatchWriteOp::~BatchWriteOp() {
 Status BatchWriteOp::targetBatch(const NSTargeter& targeter,
                                  bool recordTargetErrors,
                                  std::map<ShardId, TargetedWriteBatch*>* targetedBatches) {
+    return _targetBatch(targeter, recordTargetErrors, nullptr, targetedBatches);
+}
+
+Status BatchWriteOp::targetBatchForIdleShards(
+    const NSTargeter& targeter,
+    bool recordTargetErrors,
+    const std::set<ShardId>& busyShards,
+    std::map<ShardId, TargetedWriteBatch*>* targetedBatches) {
+    invariant(!_clientRequest.getWriteCommandBase().getOrdered());
+    return _targetBatch(targeter, recordTargetErrors, &busyShards, targetedBatches);
+}
+
+Status BatchWriteOp::_targetBatch(const NSTargeter& targeter,
+                                  bool recordTargetErrors,
+                                  const std::set<ShardId>* busyShards,
+                                  std::map<ShardId, TargetedWriteBatch*>* targetedBatches) {
     //
     // Targeting of unordered batches is fairly simple - each remaining write op is targeted,
     // and each of those targeted writes are grouped into a batch for a particular shard
@@ -298,6 +338,23 @@ Status BatchWriteOp::targetBatch(const NSTargeter& targeter,
 
     int numTargetErrors = 0;
 
+    // When streaming, the idle shards whose batches can still take writes. Once the batches of
+    // all of them are full, every remaining op would only be targeted to be skipped, so the pass
+    // stops there instead of retargeting all the remaining ops each time a shard responds. Not set
+    // if the shards could not be listed, in which case every op is visited.
+    boost::optional<std::set<ShardId>> openShards;
+    if (busyShards) {
+        auto swEndpoints = targeter.targetAllShards(_opCtx);
+        if (swEndpoints.isOK()) {
+            openShards.emplace();
+            for (const auto& endpoint : swEndpoints.getValue()) {
+                if (!busyShards->count(endpoint.shardName)) {
+                    openShards->insert(endpoint.shardName);
+                }
+            }
+        }
+    }
+
     const size_t numWriteOps = _clientRequest.sizeWriteOps();
 
     for (size_t i = 0; i < numWriteOps; ++i) {
@@ -358,6 +415,13 @@ Status BatchWriteOp::targetBatch(const NSTargeter& targeter,
             }
         }
 
+        // When streaming batches, ops which target a shard with a batch still in flight wait for
+        // that shard to respond.
+        if (busyShards && isAnyShardBusy(writes, *busyShards)) {
+            writeOp.cancelWrites(nullptr);
+            continue;
+        }
+
         // Account the array overhead once for the actual updates array and once for the statement
         // ids array, if retryable writes are used
         const int writeSizeBytes = getWriteSizeBytes(writeOp) + kBSONArrayPerElementOverheadBytes +
@@ -365,13 +429,28 @@ Status BatchWriteOp::targetBatch(const NSTargeter& targeter,
 
         if (wouldMakeBatchesTooBig(writes, writeSizeBytes, batchMap)) {
             invariant(!batchMap.empty());
+
+            if (openShards) {
+                // A shard whose batch cannot take this write is considered full, even though a
+                // smaller write might still fit
+                for (const auto write : writes) {
+                    auto batchIt = batchMap.find(&write->endpoint);
+                    if (batchIt != batchMap.end() && isBatchFull(*batchIt->second, writeSizeBytes))
+                        openShards->erase(write->endpoint.shardName);
+                }
+            }
+
             writeOp.cancelWrites(nullptr);
+            if (busyShards && !(openShards && openShards->empty()))
+                continue;
             break;
         }
 
         if (!ordered && !batchMap.empty() &&
             isNewBatchRequiredUnordered(writes, batchMap, targetedShards)) {
             writeOp.cancelWrites(nullptr);
+            if (busyShards)
+                continue;
             break;
         }
 
@@ -389,6 +468,10 @@ Status BatchWriteOp::targetBatch(const NSTargeter& targeter,
 
             TargetedWriteBatch* batch = batchIt->second;
             batch->addWrite(write, writeSizeBytes);
+
+            // Also covers shards added since the list of shards was last loaded
+            if (openShards)
+                openShards->insert(write->endpoint.shardName);
         }
 
         // Relinquish ownership of TargetedWrites, now the TargetedBatches own them
@@ -143,6 +143,21 @@ public:
                        bool recordTargetErrors,
                        std::map<ShardId, TargetedWriteBatch*>* targetedBatches);
 
+    /**
+     * Like targetBatch, but only valid for unordered batches and only builds batches for shards
+     * which are not in 'busyShards'. Write ops which target a busy shard, or which do not fit in
+     * the batch already built for their shard, are left ready for a later call instead of ending
+     * the targeting pass, so that every idle shard is given as full a batch as possible. The pass
+     * ends early once the batches of all idle shards are full.
+     *
+     * This allows the caller to send a shard its next batch as soon as that shard has responded,
+     * while the batches to other shards are still outstanding.
+     */
+    Status targetBatchForIdleShards(const NSTargeter& targeter,
+                                    bool recordTargetErrors,
+                                    const std::set<ShardId>& busyShards,
+                                    std::map<ShardId, TargetedWriteBatch*>* targetedBatches);
+
     /**
      * Fills a BatchCommandRequest from a TargetedWriteBatch for this BatchWriteOp.
      */
@@ -198,6 +213,15 @@ public:
     int numWriteOpsIn(WriteOpState state) const;
 
 private:
+    /**
+     * Implementation of targetBatch and targetBatchForIdleShards. If 'busyShards' is set, ops
+     * which cannot be added to the current batches are skipped rather than ending targeting.
+     */
+    Status _targetBatch(const NSTargeter& targeter,
+                        bool recordTargetErrors,
+                        const std::set<ShardId>* busyShards,
+                        std::map<ShardId, TargetedWriteBatch*>* targetedBatches);
+
     /**
      * Maintains the batch execution statistics when a response is received.
      */
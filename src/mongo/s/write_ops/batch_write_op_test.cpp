@@ -577,6 +577,58 @@ TEST_F(BatchWriteOpTest, MultiOpTwoShardsEachOrdered) {
     ASSERT_EQUALS(clientResponse.getN(), 4);
 }
 
+// Multi-op, multi-endpoint targeting test (unordered) while one shard still has a batch in flight.
+// Only the idle shard should be sent a batch, and the writes for the busy shard should be targeted
+// once it becomes idle.
+TEST_F(BatchWriteOpTest, MultiOpTwoShardsUnorderedBusyShard) {
+    NamespaceString nss("foo.bar");
+    ShardEndpoint endpointA(ShardId("shardA"), ChunkVersion::IGNORED());
+    ShardEndpoint endpointB(ShardId("shardB"), ChunkVersion::IGNORED());
+    MockNSTargeter targeter;
+    initTargeterSplitRange(nss, endpointA, endpointB, &targeter);
+
+    // Do multi-target, multi-doc batch write op while shardB still has a batch outstanding
+    BatchedCommandRequest request([&] {
+        write_ops::Insert insertOp(nss);
+        insertOp.setWriteCommandBase([] {
+            write_ops::WriteCommandBase wcb;
+            wcb.setOrdered(false);
+            return wcb;
+        }());
+        insertOp.setDocuments({BSON("x" << 1), BSON("x" << -1), BSON("x" << 2), BSON("x" << -2)});
+        return insertOp;
+    }());
+
+    BatchWriteOp batchOp(operationContext(), request);
+
+    OwnedPointerMap<ShardId, TargetedWriteBatch> targetedOwned;
+    std::map<ShardId, TargetedWriteBatch*>& targeted = targetedOwned.mutableMap();
+    ASSERT_OK(batchOp.targetBatchForIdleShards(targeter, false, {endpointB.shardName}, &targeted));
+    ASSERT(!batchOp.isFinished());
+    ASSERT_EQUALS(targeted.size(), 1u);
+    verifyTargetedBatches({{endpointA.shardName, 2u}}, targeted);
+    ASSERT_EQUALS(batchOp.numWriteOpsIn(WriteOpState_Ready), 2);
+
+    BatchedCommandResponse response;
+    buildResponse(2, &response);
+    batchOp.noteBatchResponse(*targeted.begin()->second, response, NULL);
+    ASSERT(!batchOp.isFinished());
+
+    // Once shardB is idle, the writes for it are targeted
+    targetedOwned.clear();
+    ASSERT_OK(batchOp.targetBatchForIdleShards(targeter, false, {}, &targeted));
+    ASSERT_EQUALS(targeted.size(), 1u);
+    verifyTargetedBatches({{endpointB.shardName, 2u}}, targeted);
+
+    batchOp.noteBatchResponse(*targeted.begin()->second, response, NULL);
+    ASSERT(batchOp.isFinished());
+
+    BatchedCommandResponse clientResponse;
+    batchOp.buildClientResponse(&clientResponse);
+    ASSERT(clientResponse.getOk());
+    ASSERT_EQUALS(clientResponse.getN(), 4);
+}
+
 // Multi-op (unaordered) targeting test where each op goes to both shards. There should be one set
 // of two batches to each shard (containing writes for both ops).
 TEST_F(BatchWriteOpTest, MultiOpTwoShardsEachUnordered) {
@@ -1545,5 +1597,57 @@ TEST_F(BatchWriteOpLimitTests, OneBigOneSmall) {
     ASSERT(batchOp.isFinished());
 }
 
+// Streaming targeting stops once the batches of all idle shards are full, and leaves the
+// remaining ops to a later pass
+TEST_F(BatchWriteOpLimitTests, IdleShardsTargetingStopsWhenBatchesAreFull) {
+    NamespaceString nss("foo.bar");
+    ShardEndpoint endpoint(ShardId("shard"), ChunkVersion::IGNORED());
+    MockNSTargeter targeter;
+    initTargeterHalfRange(nss, endpoint, &targeter);
+
+    // Two docs which do not fit in one batch, followed by an untargetable doc
+    const std::string bigString(BSONObjMaxUserSize / 2, 'x');
+
+    BatchedCommandRequest request([&] {
+        write_ops::Insert insertOp(nss);
+        insertOp.setWriteCommandBase([] {
+            write_ops::WriteCommandBase wcb;
+            wcb.setOrdered(false);
+            return wcb;
+        }());
+        insertOp.setDocuments({BSON("x" << -1 << "data" << bigString),
+                               BSON("x" << -2 << "data" << bigString),
+                               BSON("x" << 1)});
+        return insertOp;
+    }());
+
+    BatchWriteOp batchOp(operationContext(), request);
+
+    // The only shard's batch is full after the first doc, so the untargetable doc is not visited
+    // and its targeting error is not recorded yet
+    OwnedPointerMap<ShardId, TargetedWriteBatch> targetedOwned;
+    std::map<ShardId, TargetedWriteBatch*>& targeted = targetedOwned.mutableMap();
+    ASSERT_OK(batchOp.targetBatchForIdleShards(targeter, true, {}, &targeted));
+    ASSERT_EQUALS(targeted.size(), 1u);
+    ASSERT_EQUALS(targeted.begin()->second->getWrites().size(), 1u);
+    ASSERT_EQUALS(batchOp.numWriteOpsIn(WriteOpState_Ready), 2);
+    ASSERT_EQUALS(batchOp.numWriteOpsIn(WriteOpState_Error), 0);
+
+    BatchedCommandResponse response;
+    buildResponse(1, &response);
+
+    batchOp.noteBatchResponse(*targeted.begin()->second, response, NULL);
+    ASSERT(!batchOp.isFinished());
+
+    targetedOwned.clear();
+    ASSERT_OK(batchOp.targetBatchForIdleShards(targeter, true, {}, &targeted));
+    ASSERT_EQUALS(targeted.size(), 1u);
+    ASSERT_EQUALS(targeted.begin()->second->getWrites().size(), 1u);
+    ASSERT_EQUALS(batchOp.numWriteOpsIn(WriteOpState_Error), 1);
+
+    batchOp.noteBatchResponse(*targeted.begin()->second, response, NULL);
+    ASSERT(batchOp.isFinished());
+}
+
 }  // namespace
 }  // namespace mongo
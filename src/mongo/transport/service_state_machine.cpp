@@ -38,6 +38,7 @@
 #include "mongo/db/client.h"
 #include "mongo/db/dbmessage.h"
 #include "mongo/db/stats/counters.h"
+#include "mongo/db/stats/operation_phase_latencies.h"
 #include "mongo/rpc/message.h"
 #include "mongo/rpc/op_msg.h"
 #include "mongo/stdx/memory.h"
@@ -94,6 +95,31 @@ Message makeLegacyExhaustMessage(Message* m, const DbResponse& dbresponse) {
     return Message(b.release());
 }
 
+/**
+ * Builds the body of the 'getMore' command which continues an exhaust stream opened by the 'find'
+ * command 'findCmd' on the cursor 'cursorId' over 'cursorNs'. The arguments which bind the cursor
+ * to a session or a transaction are carried over from the 'find', as is a positive batch size.
+ */
+BSONObj makeExhaustGetMoreForFind(const OpMsgRequest& findCmd,
+                                  long long cursorId,
+                                  StringData cursorNs) {
+    BSONObjBuilder bob;
+    bob.append("getMore", cursorId);
+    bob.append("collection", cursorNs.substr(cursorNs.find('.') + 1));
+
+    auto batchSize = findCmd.body["batchSize"];
+    if (batchSize.isNumber() && batchSize.numberLong() > 0) {
+        bob.append("batchSize", batchSize.numberLong());
+    }
+
+    for (auto&& fieldName : {"lsid"_sd, "txnNumber"_sd, "autocommit"_sd, "$db"_sd}) {
+        if (auto elem = findCmd.body[fieldName]) {
+            bob.append(elem);
+        }
+    }
+    return bob.obj();
+}
+
 /**
  * Given a request and its already generated response, checks for exhaust flags. If exhaust is
  * allowed, modifies the given request message to produce the subsequent exhaust message, and
@@ -101,7 +127,8 @@ Message makeLegacyExhaustMessage(Message* m, const DbResponse& dbresponse) {
  * request message for it to be used as the subsequent, 'synthetic' exhaust request. Returns an
  * empty message if exhaust is not allowed.
  *
- * Currently only supports exhaust for 'getMore' commands.
+ * Supports exhaust for 'find' and 'getMore' commands. A 'find' is continued by synthetic 'getMore'
+ * requests on the cursor it opened, so the client never has to send a 'getMore' itself.
  */
 Message makeExhaustMessage(Message requestMsg, DbResponse* dbresponse) {
     if (requestMsg.operation() == dbQuery) {
@@ -112,9 +139,10 @@ Message makeExhaustMessage(Message requestMsg, DbResponse* dbresponse) {
         return Message();
     }
 
-    // Only support exhaust for 'getMore' commands.
+    // Only support exhaust for 'find' and 'getMore' commands.
     auto request = OpMsgRequest::parse(requestMsg);
-    if (request.getCommandName() != "getMore"_sd) {
+    const bool isFind = request.getCommandName() == "find"_sd;
+    if (!isFind && request.getCommandName() != "getMore"_sd) {
         return Message();
     }
 
@@ -143,6 +171,15 @@ Message makeExhaustMessage(Message requestMsg, DbResponse* dbresponse) {
     // Indicate that the response is part of an exhaust stream.
     OpMsg::setFlag(&dbresponse->response, OpMsg::kMoreToCome);
 
+    // A 'getMore' is reused as is for the next request. A 'find' is replaced by a 'getMore' on the
+    // cursor it opened, which then keeps being reused until the cursor is exhausted.
+    if (isFind) {
+        OpMsgBuilder builder;
+        builder.setBody(makeExhaustGetMoreForFind(request, cursorId, cursorNs));
+        requestMsg = builder.finish();
+        OpMsg::setFlag(&requestMsg, OpMsg::kExhaustSupported);
+    }
+
     // Return an augmented form of the initial request, which is to be used as the next request to
     // be processed by the database. The id of the response is used as the request id of this
     // 'synthetic' request.
@@ -329,6 +366,7 @@ void ServiceStateMachine::_sinkMessage(ThreadGuard guard, Message toSink) {
     // Sink our response to the client
     invariant(_state.load() == State::Process);
     _state.store(State::SinkWait);
+    _sinkTimer.reset();
     guard.release();
 
     auto sinkMsgImpl = [&] {
@@ -405,7 +443,11 @@ void ServiceStateMachine::_sinkCallback(Status status) {
               << _session()->remote() << " (connection id: " << _session()->id() << ")";
         _state.store(State::EndSession);
         return _runNextInGuard(std::move(guard));
-    } else if (_inExhaust) {
+    }
+
+    globalOperationPhaseLatencies.record(OperationPhase::kNetworkWrite,
+                                         Microseconds(_sinkTimer.micros()));
+    if (_inExhaust) {
         _state.store(State::Process);
         return _scheduleNextWithGuard(std::move(guard),
                                       ServiceExecutor::kDeferredTask |
@@ -456,12 +498,12 @@ void ServiceStateMachine::_processMessage(ThreadGuard guard) {
         toSink.header().setId(nextMessageId());
         toSink.header().setResponseToMsgId(_inMessage.header().getId());
 
-        // If the incoming message has the exhaust flag set and is a 'getMore' command, then we
-        // bypass the normal RPC behavior. We will sink the response to the network, but we also
-        // synthesize a new 'getMore' request, as if we sourced a new message from the network. This
-        // new request is sent to the database once again to be processed. This cycle repeats as
-        // long as the associated cursor is not exhausted. Once it is exhausted, we will send a
-        // final response, terminating the exhaust stream.
+        // If the incoming message has the exhaust flag set and is a 'find' or 'getMore' command,
+        // then we bypass the normal RPC behavior. We will sink the response to the network, but we
+        // also synthesize a new 'getMore' request, as if we sourced a new message from the
+        // network. This new request is sent to the database once again to be processed. This cycle
+        // repeats as long as the associated cursor is not exhausted. Once it is exhausted, we will
+        // send a final response, terminating the exhaust stream.
         _inMessage = makeExhaustMessage(_inMessage, &dbresponse);
         _inExhaust = !_inMessage.empty();
 
@@ -46,6 +46,7 @@
 #include "mongo/transport/service_executor_task_names.h"
 #include "mongo/transport/session.h"
 #include "mongo/transport/transport_mode.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -237,6 +238,7 @@ private:
 
     bool _inExhaust = false;
     boost::optional<MessageCompressorId> _compressorId;
+    Timer _sinkTimer;
     Message _inMessage;
 
     AtomicWord<Ownership> _owned{Ownership::kUnowned};
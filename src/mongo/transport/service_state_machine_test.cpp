@@ -75,6 +75,7 @@ public:
     DbResponse handleRequest(OperationContext* opCtx, const Message& request) override {
         log() << "In handleRequest";
         _ranHandler = true;
+        _lastRequest = request;
         ASSERT_TRUE(haveClient());
 
         // Build out a dummy OK response, if no custom response message was set. Otherwise, use the
@@ -122,12 +123,19 @@ public:
         return ret;
     }
 
+    Message getLastRequest() {
+        return _lastRequest;
+    }
+
 private:
     bool _uassertInHandler = false;
     bool _ranHandler = false;
 
     // A custom response message to return from 'handleRequest'.
     Message _responseMessage;
+
+    // The last request passed to 'handleRequest'.
+    Message _lastRequest;
 };
 
 using namespace transport;
@@ -579,20 +587,92 @@ TEST_F(ServiceStateMachineFixture, TestGetMoreWithExhaustAndNonOKResponse) {
 }
 
 
-TEST_F(ServiceStateMachineFixture, TestExhaustOnlySupportedForGetMoreCommand) {
-    // Construct a 'find' OP_MSG request with the exhaust flag set. We should ignore exhaust flags
-    // for non 'getMore' commands.
+TEST_F(ServiceStateMachineFixture, TestFindWithExhaust) {
+    // Construct a 'find' OP_MSG request with the exhaust flag set, bound to a session.
+    const int32_t initRequestId = 1;
+    const long long cursorId = 42;
     const std::string nss = "test.coll";
-    Message findWithExhaust = buildOpMsg(BSON("find" << nss));
+    const auto lsid = BSON("id" << 1);
+    Message findWithExhaust = buildOpMsg(BSON("find"
+                                              << "coll"
+                                              << "batchSize"
+                                              << 2
+                                              << "lsid"
+                                              << lsid
+                                              << "$db"
+                                              << "test"));
+    findWithExhaust.header().setId(initRequestId);
     OpMsg::setFlag(&findWithExhaust, OpMsg::kExhaustSupported);
 
+    // Construct a 'find' response, with a non-zero cursor id and an empty batch.
+    BSONObj findResBody =
+        BSON("ok" << 1 << "cursor"
+                  << BSON("id" << cursorId << "ns" << nss << "firstBatch" << BSONArray()));
+    Message findRes = buildOpMsg(findResBody);
+
+    // Let the 'find' request be sourced from the network, processed in the database, and sunk to
+    // the TransportLayer. Because the request message has the exhaust flag, we should end up back
+    // in the 'Process' state, rather than in 'Source' state.
+    runSourceAndSinkTest(_tl, _sep, findWithExhaust, findRes, State::Process, State::Process);
+
+    // Check the last sunk message.
+    auto msg = _tl->getLastSunk();
+    auto firstResponseId = msg.header().getId();
+    ASSERT(!msg.empty());
+    ASSERT_EQ(initRequestId, msg.header().getResponseToMsgId());
+    ASSERT(OpMsg::isFlagSet(msg, OpMsg::kMoreToCome));
+    ASSERT_BSONOBJ_EQ(findResBody, OpMsg::parse(msg).body);
+
+    // Construct a terminal 'getMore' response, indicated by a cursor id equal to zero.
+    BSONObj getMoreTerminalResBody =
+        BSON("ok" << 1 << "cursor" << BSON("id" << 0 << "ns" << nss << "nextBatch" << BSONArray()));
+    _sep->setResponseMessage(buildOpMsg(getMoreTerminalResBody));
+
+    // The stream continues with a synthetic 'getMore' on the cursor opened by the 'find'.
+    log() << "runNext to terminate the exhaust stream";
+    _ssm->runNext();
+    ASSERT_FALSE(haveClient());
+    ASSERT_EQ(_ssm->state(), State::Source);
+
+    auto getMore = _sep->getLastRequest();
+    ASSERT(OpMsg::isFlagSet(getMore, OpMsg::kExhaustSupported));
+    ASSERT_BSONOBJ_EQ(BSON("getMore" << cursorId << "collection"
+                                     << "coll"
+                                     << "batchSize"
+                                     << 2LL
+                                     << "lsid"
+                                     << lsid
+                                     << "$db"
+                                     << "test"),
+                      OpMsg::parse(getMore).body);
+
+    // Check the final sunk message.
+    msg = _tl->getLastSunk();
+    ASSERT(!msg.empty());
+    ASSERT_FALSE(OpMsg::isFlagSet(msg, OpMsg::kMoreToCome));
+    ASSERT_BSONOBJ_EQ(getMoreTerminalResBody, OpMsg::parse(msg).body);
+    ASSERT_EQ(firstResponseId, msg.header().getResponseToMsgId());
+}
+
+TEST_F(ServiceStateMachineFixture, TestExhaustOnlySupportedForFindAndGetMoreCommands) {
+    // Construct an 'aggregate' OP_MSG request with the exhaust flag set. We should ignore exhaust
+    // flags for commands other than 'find' and 'getMore'.
+    const std::string nss = "test.coll";
+    Message aggWithExhaust = buildOpMsg(BSON("aggregate"
+                                             << "coll"
+                                             << "pipeline"
+                                             << BSONArray()
+                                             << "cursor"
+                                             << BSONObj()));
+    OpMsg::setFlag(&aggWithExhaust, OpMsg::kExhaustSupported);
+
     // Construct an OK response.
-    Message findRes = buildOpMsg(BSON(
+    Message aggRes = buildOpMsg(BSON(
         "ok" << 1 << "cursor" << BSON("id" << 42 << "ns" << nss << "firstBatch" << BSONArray())));
 
-    // Let the 'find' request be sourced from the network, processed in the database, and
+    // Let the 'aggregate' request be sourced from the network, processed in the database, and
     // and the response sunk to the TransportLayer.
-    runSourceAndSinkTest(_tl, _sep, findWithExhaust, findRes, State::Process, State::Source);
+    runSourceAndSinkTest(_tl, _sep, aggWithExhaust, aggRes, State::Process, State::Source);
 
     // Check the last sunk message.
     auto msg = _tl->getLastSunk();
@@ -70,5 +70,16 @@ Session::TagMask Session::getTags() const {
     return _tags.load();
 }
 
+Future<void> Session::asyncSinkMessages(std::vector<Message> messages,
+                                        const transport::BatonHandle& handle) {
+    auto sunk = Future<void>::makeReady();
+    for (auto& message : messages) {
+        sunk = std::move(sunk).then([ this, message = std::move(message), handle ]() mutable {
+            return asyncSinkMessage(std::move(message), handle);
+        });
+    }
+    return sunk;
+}
+
 }  // namespace transport
 }  // namespace mongo
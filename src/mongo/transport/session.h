@@ -31,6 +31,7 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/platform/atomic_word.h"
@@ -118,6 +119,13 @@ public:
     virtual Future<void> asyncSinkMessage(Message message,
                                           const transport::BatonHandle& handle = nullptr) = 0;
 
+    /**
+     * Sink (send) several Messages to the remote host for this Session, in order. Implementations
+     * may send them all with a single write.
+     */
+    virtual Future<void> asyncSinkMessages(std::vector<Message> messages,
+                                           const transport::BatonHandle& handle = nullptr);
+
     /**
      * Cancel any outstanding async operations. There is no way to cancel synchronous calls.
      * Futures will finish with an ErrorCodes::CallbackCancelled error if they haven't already
@@ -161,6 +161,30 @@ public:
             });
     }
 
+    Future<void> asyncSinkMessages(std::vector<Message> messages,
+                                   const transport::BatonHandle& baton = nullptr) override {
+        ensureAsync();
+
+        // Copy the messages into one buffer, so that they are all sent with a single write.
+        size_t size = 0;
+        for (const auto& message : messages) {
+            size += message.size();
+        }
+        auto buffer = SharedBuffer::allocate(size);
+        auto ptr = buffer.get();
+        for (const auto& message : messages) {
+            memcpy(ptr, message.buf(), message.size());
+            ptr += message.size();
+        }
+
+        return write(asio::buffer(buffer.get(), size), baton)
+            .then([ this, buffer = std::move(buffer), size ]() {
+                if (_isIngressSession) {
+                    networkCounter.hitPhysicalOut(size);
+                }
+            });
+    }
+
     void cancelAsyncOperations(const transport::BatonHandle& baton = nullptr) override {
         LOG(3) << "Cancelling outstanding I/O operations on connection to " << _remote;
         if (baton) {
@@ -181,6 +205,11 @@ public:
         if (!getSocket().is_open())
             return false;
 
+        // Bytes already read ahead from the socket count as readable data, just as if they were
+        // still waiting in the socket.
+        if (_readAheadEnd > _readAheadBegin)
+            return true;
+
         auto swPollEvents = pollASIOSocket(getSocket(), POLLIN, Milliseconds{0});
         if (!swPollEvents.isOK()) {
             if (swPollEvents != ErrorCodes::NetworkTimeout) {
@@ -344,6 +373,113 @@ private:
     }
 
     Future<Message> sourceMessageImpl(const transport::BatonHandle& baton = nullptr) {
+#ifdef MONGO_CONFIG_SSL
+        // The first bytes of an ingress session may be the start of a TLS handshake, which is
+        // detected by reading exactly one message header. See read().
+        if (!_ranHandshake) {
+            return sourceMessageExactImpl(baton);
+        }
+#endif
+        return sourceMessageReadAheadImpl(baton);
+    }
+
+    /**
+     * Sources a message through the read-ahead buffer. Messages which fit in the buffer are read
+     * together with their header, usually in a single read from the socket, and any bytes of the
+     * messages following them are kept for the next call. This saves a read per message for small
+     * requests and replies, and lets back to back messages, such as the batches of an exhaust
+     * cursor, be sourced without touching the socket at all.
+     */
+    Future<Message> sourceMessageReadAheadImpl(const transport::BatonHandle& baton) {
+        static constexpr auto kHeaderSize = sizeof(MSGHEADER::Value);
+
+        return fillReadAhead(kHeaderSize, baton).then([this, baton]() {
+            const char* header = _readAhead.get() + _readAheadBegin;
+            if (checkForHTTPRequest(asio::buffer(header, kHeaderSize))) {
+                return sendHTTPResponse(baton);
+            }
+
+            const auto msgLen = size_t(MSGHEADER::ConstView(header).getMessageLength());
+            if (msgLen < kHeaderSize || msgLen > MaxMessageSizeBytes) {
+                StringBuilder sb;
+                sb << "recv(): message msgLen " << msgLen << " is invalid. "
+                   << "Min " << kHeaderSize << " Max: " << MaxMessageSizeBytes;
+                const auto str = sb.str();
+                LOG(0) << str;
+
+                return Future<Message>::makeReady(Status(ErrorCodes::ProtocolError, str));
+            }
+
+            if (msgLen <= kReadAheadSize) {
+                return fillReadAhead(msgLen, baton).then([this, msgLen]() {
+                    auto buffer = SharedBuffer::allocate(msgLen);
+                    memcpy(buffer.get(), _readAhead.get() + _readAheadBegin, msgLen);
+                    consumeReadAhead(msgLen);
+                    if (_isIngressSession) {
+                        networkCounter.hitPhysicalIn(msgLen);
+                    }
+                    return Message(std::move(buffer));
+                });
+            }
+
+            // The message is larger than the read-ahead buffer, so read the rest of it directly
+            // into its own buffer.
+            const auto buffered = _readAheadEnd - _readAheadBegin;
+            auto buffer = SharedBuffer::allocate(msgLen);
+            memcpy(buffer.get(), _readAhead.get() + _readAheadBegin, buffered);
+            consumeReadAhead(buffered);
+
+            auto ptr = buffer.get() + buffered;
+            return read(asio::buffer(ptr, msgLen - buffered), baton)
+                .then([ this, buffer = std::move(buffer), msgLen ]() mutable {
+                    if (_isIngressSession) {
+                        networkCounter.hitPhysicalIn(msgLen);
+                    }
+                    return Message(std::move(buffer));
+                });
+        });
+    }
+
+    /**
+     * Makes sure at least 'minBytes' bytes are available in the read-ahead buffer, reading as many
+     * more bytes as the socket has ready, up to the capacity of the buffer.
+     */
+    Future<void> fillReadAhead(size_t minBytes, const transport::BatonHandle& baton) {
+        invariant(minBytes <= kReadAheadSize);
+        const auto buffered = _readAheadEnd - _readAheadBegin;
+        if (buffered >= minBytes) {
+            return Future<void>::makeReady();
+        }
+
+        if (!_readAhead) {
+            _readAhead = SharedBuffer::allocate(kReadAheadSize);
+        } else if (_readAheadBegin > 0) {
+            memmove(_readAhead.get(), _readAhead.get() + _readAheadBegin, buffered);
+        }
+        _readAheadBegin = 0;
+        _readAheadEnd = buffered;
+
+        auto freeSpace =
+            asio::buffer(_readAhead.get() + _readAheadEnd, kReadAheadSize - _readAheadEnd);
+        return readAtLeast(freeSpace, minBytes - buffered, baton).then([this](size_t size) {
+            _readAheadEnd += size;
+        });
+    }
+
+    /**
+     * Marks 'size' bytes of the read-ahead buffer as sourced. The buffer is released once it is
+     * empty, so that idle sessions do not hold on to it.
+     */
+    void consumeReadAhead(size_t size) {
+        _readAheadBegin += size;
+        invariant(_readAheadBegin <= _readAheadEnd);
+        if (_readAheadBegin == _readAheadEnd) {
+            _readAhead = {};
+            _readAheadBegin = _readAheadEnd = 0;
+        }
+    }
+
+    Future<Message> sourceMessageExactImpl(const transport::BatonHandle& baton = nullptr) {
         static constexpr auto kHeaderSize = sizeof(MSGHEADER::Value);
 
         auto headerBuffer = SharedBuffer::allocate(kHeaderSize);
@@ -413,6 +549,21 @@ private:
         return opportunisticRead(_socket, buffers, baton);
     }
 
+    /**
+     * Reads at least 'minBytes' and at most the size of 'buffer' bytes from the socket. Returns
+     * the number of bytes read.
+     */
+    Future<size_t> readAtLeast(asio::mutable_buffer buffer,
+                               size_t minBytes,
+                               const transport::BatonHandle& baton = nullptr) {
+#ifdef MONGO_CONFIG_SSL
+        if (_sslSocket) {
+            return opportunisticReadAtLeast(*_sslSocket, buffer, minBytes, baton);
+        }
+#endif
+        return opportunisticReadAtLeast(_socket, buffer, minBytes, baton);
+    }
+
     template <typename ConstBufferSequence>
     Future<void> write(const ConstBufferSequence& buffers,
                        const transport::BatonHandle& baton = nullptr) {
@@ -483,6 +634,48 @@ private:
         }
     }
 
+    template <typename Stream>
+    Future<size_t> opportunisticReadAtLeast(Stream& stream,
+                                            asio::mutable_buffer buffer,
+                                            size_t minBytes,
+                                            const transport::BatonHandle& baton = nullptr) {
+        std::error_code ec;
+        size_t size;
+
+        if (MONGO_FAIL_POINT(transportLayerASIOshortOpportunisticReadWrite) &&
+            _blockingMode == Async) {
+            size = asio::read(stream, asio::buffer(buffer, 1), ec);
+            if (!ec && minBytes > 1) {
+                ec = asio::error::would_block;
+            }
+        } else {
+            size = asio::read(stream, buffer, asio::transfer_at_least(minBytes), ec);
+        }
+
+        if (((ec == asio::error::would_block) || (ec == asio::error::try_again)) &&
+            (_blockingMode == Async)) {
+            // asio::read is a loop internally, so some bytes may have been read already. Only wait
+            // for the ones that are still missing.
+            auto asyncBuffer = buffer + size;
+            auto asyncMinBytes = minBytes - std::min(size, minBytes);
+
+            if (baton) {
+                return baton->addSession(*this, Baton::Type::In)
+                    .then([&stream, asyncBuffer, asyncMinBytes, baton, this] {
+                        return opportunisticReadAtLeast(
+                            stream, asyncBuffer, asyncMinBytes, baton);
+                    })
+                    .then([size](size_t asyncSize) { return size + asyncSize; });
+            }
+
+            return asio::async_read(
+                       stream, asyncBuffer, asio::transfer_at_least(asyncMinBytes), UseFuture{})
+                .then([size](size_t asyncSize) { return size + asyncSize; });
+        } else {
+            return futurize(ec, size);
+        }
+    }
+
     /**
      * moreToSend checks the ssl socket after an opportunisticWrite.  If there are still bytes to
      * send, we manually send them off the underlying socket.  Then we hook that up with a future
@@ -705,6 +898,15 @@ private:
     boost::optional<Milliseconds> _configuredTimeout;
     boost::optional<Milliseconds> _socketTimeout;
 
+    // Messages no larger than this are read together with their header. See
+    // sourceMessageReadAheadImpl().
+    static constexpr size_t kReadAheadSize = 16 * 1024;
+
+    // Bytes read from the socket but not sourced yet are in [_readAheadBegin, _readAheadEnd).
+    SharedBuffer _readAhead;
+    size_t _readAheadBegin = 0;
+    size_t _readAheadEnd = 0;
+
     GenericSocket _socket;
 #ifdef MONGO_CONFIG_SSL
     boost::optional<asio::ssl::stream<decltype(_socket)>> _sslSocket;
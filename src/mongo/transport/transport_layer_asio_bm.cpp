@@ -0,0 +1,228 @@
+
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+#include <vector>
+
+#include "mongo/db/server_options.h"
+#include "mongo/rpc/op_msg.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/transport/service_entry_point.h"
+#include "mongo/transport/transport_layer_asio.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+namespace transport {
+namespace {
+
+Message makeOpMsg(BSONObj body) {
+    OpMsgBuilder builder;
+    builder.setBody(body);
+    return builder.finish();
+}
+
+/**
+ * Serves each session accepted by the transport layer on its own thread. Every request sourced
+ * from a session is answered with 'repliesPerRequest' small replies, sunk back to back like the
+ * batches of an exhaust cursor.
+ */
+class ReplyingServiceEntryPoint : public ServiceEntryPoint {
+public:
+    explicit ReplyingServiceEntryPoint(int repliesPerRequest)
+        : _repliesPerRequest(repliesPerRequest) {}
+
+    ~ReplyingServiceEntryPoint() {
+        for (auto& thread : _threads) {
+            thread.join();
+        }
+    }
+
+    void startSession(SessionHandle session) override {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _threads.emplace_back([this, session] {
+            const auto reply = makeOpMsg(BSON("ok" << 1));
+            while (true) {
+                auto swRequest = session->sourceMessage();
+                if (!swRequest.isOK()) {
+                    return;
+                }
+
+                for (int i = 0; i < _repliesPerRequest; ++i) {
+                    Message toSink = reply;
+                    toSink.header().setResponseToMsgId(swRequest.getValue().header().getId());
+                    if (!session->sinkMessage(toSink).isOK()) {
+                        return;
+                    }
+                }
+            }
+        });
+    }
+
+    void endAllSessions(Session::TagMask tags) override {}
+
+    Status start() override {
+        return Status::OK();
+    }
+
+    bool shutdown(Milliseconds timeout) override {
+        return true;
+    }
+
+    void appendStats(BSONObjBuilder*) const override {}
+
+    size_t numOpenSessions() const override {
+        return 0;
+    }
+
+    DbResponse handleRequest(OperationContext* opCtx, const Message& request) override {
+        MONGO_UNREACHABLE;
+    }
+
+private:
+    const int _repliesPerRequest;
+
+    stdx::mutex _mutex;
+    std::vector<stdx::thread> _threads;
+};
+
+/**
+ * A TransportLayerASIO listening on a loopback port, and a client session connected to it. The
+ * egress reactor runs on its own thread, so the client session may also be used asynchronously.
+ */
+class LoopbackFixture {
+public:
+    explicit LoopbackFixture(int repliesPerRequest)
+        : _sep(repliesPerRequest), _tl(makeOptions(), &_sep) {
+        uassertStatusOK(_tl.setup());
+        uassertStatusOK(_tl.start());
+        _egressReactor = _tl.getReactor(TransportLayer::kEgress);
+        _egressThread = stdx::thread([this] { _egressReactor->run(); });
+        _client = uassertStatusOK(_tl.connect(HostAndPort("127.0.0.1", _tl.listenerPort()),
+                                              kDisableSSL,
+                                              Milliseconds(10 * 1000)));
+    }
+
+    ~LoopbackFixture() {
+        _client->end();
+        _client.reset();
+        _egressReactor->stop();
+        _egressThread.join();
+        _tl.shutdown();
+    }
+
+    Session* client() {
+        return _client.get();
+    }
+
+private:
+    static TransportLayerASIO::Options makeOptions() {
+        ServerGlobalParams params;
+        params.noUnixSocket = true;
+        TransportLayerASIO::Options opts(&params);
+        opts.port = 0;
+        opts.ipList = {"127.0.0.1"};
+        return opts;
+    }
+
+    ReplyingServiceEntryPoint _sep;
+    TransportLayerASIO _tl;
+    ReactorHandle _egressReactor;
+    stdx::thread _egressThread;
+    SessionHandle _client;
+};
+
+void BM_smallCommandRoundTrip(benchmark::State& state) {
+    LoopbackFixture fixture(1);
+    const auto request = makeOpMsg(BSON("ping" << 1));
+
+    for (auto _ : state) {
+        Message toSink = request;
+        uassertStatusOK(fixture.client()->sinkMessage(toSink));
+        benchmark::DoNotOptimize(uassertStatusOK(fixture.client()->sourceMessage()));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_streamedReplies(benchmark::State& state) {
+    const auto repliesPerRequest = state.range(0);
+    LoopbackFixture fixture(repliesPerRequest);
+    const auto request = makeOpMsg(BSON("getMore" << 1LL << "collection"
+                                                  << "coll"));
+
+    for (auto _ : state) {
+        Message toSink = request;
+        uassertStatusOK(fixture.client()->sinkMessage(toSink));
+        for (int i = 0; i < repliesPerRequest; ++i) {
+            benchmark::DoNotOptimize(uassertStatusOK(fixture.client()->sourceMessage()));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * repliesPerRequest);
+}
+
+/**
+ * Sends a burst of small commands before reading any of their replies, the way
+ * NetworkInterfaceTL sends coalesced commands. The commands are sent with one write each, or all
+ * with a single write if the second argument is set.
+ */
+void BM_pipelinedSmallCommands(benchmark::State& state) {
+    const auto numCommands = state.range(0);
+    const bool coalesce = state.range(1);
+    LoopbackFixture fixture(1);
+    const std::vector<Message> requests(numCommands, makeOpMsg(BSON("ping" << 1)));
+
+    for (auto _ : state) {
+        if (coalesce) {
+            fixture.client()->asyncSinkMessages(requests).get();
+        } else {
+            for (const auto& request : requests) {
+                fixture.client()->asyncSinkMessage(request).get();
+            }
+        }
+        for (int i = 0; i < numCommands; ++i) {
+            benchmark::DoNotOptimize(fixture.client()->asyncSourceMessage().get());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * numCommands);
+}
+
+BENCHMARK(BM_smallCommandRoundTrip);
+BENCHMARK(BM_streamedReplies)->Arg(1)->Arg(16)->Arg(128);
+BENCHMARK(BM_pipelinedSmallCommands)
+    ->ArgPair(16, 0)
+    ->ArgPair(16, 1)
+    ->ArgPair(128, 0)
+    ->ArgPair(128, 1);
+
+}  // namespace
+}  // namespace transport
+}  // namespace mongo
@@ -0,0 +1,412 @@
+
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kDefault
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/sampling_cpu_profiler.h"
+
+#include "mongo/base/init.h"
+#include "mongo/config.h"
+#include "mongo/db/commands/server_status.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/util/errno_util.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/stacktrace.h"
+
+#include <third_party/murmurhash3/MurmurHash3.h>
+
+// for dlfcn.h, backtrace and setitimer
+#if defined(__linux__) && defined(MONGO_CONFIG_HAVE_EXECINFO_BACKTRACE)
+
+#include <csignal>
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+
+//
+// Sampling CPU profiler
+//
+// Samples the stack of whichever thread is running on a CPU at a low, fixed rate, and keeps a
+// running count of the samples taken in each distinct stack so that CPU usage can be attributed
+// to code paths after the fact, in production.
+//
+// Uses ITIMER_PROF, which delivers SIGPROF to the thread consuming CPU each time the process has
+// used another 1/sampleHz seconds of CPU time. The signal handler only captures the return
+// addresses with backtrace() into a pre-allocated ring of sample slots; it never allocates or
+// takes locks. Draining the ring into the table of stacks is done when the serverStatus section is
+// generated, which FTDC does once per collection period; stacks seen for the first time are then
+// symbolized and logged without holding the table's mutex. Samples taken while the ring is full
+// are dropped and counted.
+//
+// This is independent of the gperftools based _cpuProfilerStart command, which also uses
+// SIGPROF; the two must not be used at the same time.
+//
+// Enable at startup time (only) with
+//     mongod --setParameter cpuProfilingEnabled=true
+//
+// If enabled, adds a cpuProfile section to serverStatus as follows:
+//
+// cpuProfile: {
+//     stats: {
+//         // sampling rate, samples taken and dropped, number of distinct stacks
+//     }
+//     stacks: {
+//         stack_n_: {         // one for each "important" stack _n_
+//             samples: ...,   // number of samples taken in this stack since startup
+//         }
+//     }
+// }
+//
+// Each new stack encountered is logged to the mongod log once, in the folded format understood by
+// flame graph tools, with a message like
+//     .... cpuProfile stack_n_: outermostFrame;...;innermostFrame
+//
+// Via FTDC - strings are not captured by FTDC, so each sample records {stack_n_: samples}. As the
+// counts are cumulative, the difference between two FTDC samples is the CPU time spent in that
+// stack during the interval, in units of 1/sampleHz seconds.
+//
+// Via serverStatus - requesting the section with {cpuProfile: {folded: true}} also appends a
+// 'folded' array holding one "<folded stack> <samples>" string for every stack, which can be fed
+// directly to a flame graph tool.
+//
+
+namespace mongo {
+
+SamplingCpuProfiler* SamplingCpuProfiler::_started;
+
+size_t SamplingCpuProfiler::Stack::Hasher::operator()(const Stack& stack) const {
+    uint32_t hash = 0;
+    MurmurHash3_x86_32(stack.frames.data(), stack.frames.size() * sizeof(void*), 0, &hash);
+    return hash;
+}
+
+SamplingCpuProfiler::SamplingCpuProfiler(int sampleHz) : _sampleHz(sampleHz) {
+    // The first call to backtrace() may load the unwinder, which allocates, so it must not
+    // happen in the signal handler.
+    void* frames[kMaxFramesPerStack];
+    backtrace(frames, kMaxFramesPerStack);
+}
+
+timeval SamplingCpuProfiler::samplingInterval(int sampleHz) {
+    // tv_usec must stay below one second, so whole seconds go in tv_sec.
+    const long long periodMicros = 1000 * 1000 / sampleHz;
+    timeval interval;
+    interval.tv_sec = periodMicros / (1000 * 1000);
+    interval.tv_usec = periodMicros % (1000 * 1000);
+    return interval;
+}
+
+//
+// Record a sample. Runs in the signal handler of the interrupted thread.
+//
+void SamplingCpuProfiler::recordSample() {
+    const uint64_t slotNum = _nextSlot.fetch_add(1, std::memory_order_relaxed);
+    SampleSlot& slot = _slots[slotNum % kNumSampleSlots];
+
+    // The slot still holds a sample which has not been aggregated yet, so the ring is full.
+    int expected = kEmpty;
+    if (!slot.state.compare_exchange_strong(expected, kWriting)) {
+        _samplesDropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    slot.numFrames = backtrace(slot.frames.data(), kMaxFramesPerStack);
+    slot.state.store(kFull, std::memory_order_release);
+    _samplesTaken.fetch_add(1, std::memory_order_relaxed);
+}
+
+//
+// Move every captured sample from the ring into the stack table. Stacks seen for the first time
+// are added with an empty folded representation and returned, to be symbolized by the caller.
+//
+std::vector<SamplingCpuProfiler::NewStack> SamplingCpuProfiler::_drain(WithLock) {
+    std::vector<NewStack> newStacks;
+    for (int i = 0; i < kNumSampleSlots; i++) {
+        SampleSlot& slot = _slots[i];
+        if (slot.state.load(std::memory_order_acquire) != kFull)
+            continue;
+
+        Stack stack;
+        const int start = std::min(kSkipStartFrames, slot.numFrames);
+        stack.frames.assign(slot.frames.begin() + start, slot.frames.begin() + slot.numFrames);
+        slot.state.store(kEmpty, std::memory_order_release);
+
+        _samplesAggregated++;
+        auto it = _stacks.find(stack);
+        if (it == _stacks.end()) {
+            if (_stacks.size() >= static_cast<size_t>(kMaxStacks)) {
+                _samplesOverflowed++;
+                continue;
+            }
+            StackInfo stackInfo;
+            stackInfo.stackNum = _stacks.size();
+            it = _stacks.emplace(stack, std::move(stackInfo)).first;
+            newStacks.push_back({&it->second, std::move(stack)});
+        }
+        it->second.samples++;
+    }
+    return newStacks;
+}
+
+//
+// Generate the folded representation of a stack: frames are joined with ';', starting from
+// the outermost frame.
+//
+std::string SamplingCpuProfiler::_fold(const Stack& stack) {
+    std::string folded;
+    for (auto it = stack.frames.rbegin(); it != stack.frames.rend(); ++it) {
+        if (!folded.empty())
+            folded += ';';
+
+        Dl_info dli;
+        char* demangled = nullptr;
+        StringData frameString;
+        if (dladdr(*it, &dli) && dli.dli_sname) {
+            int status;
+            demangled = abi::__cxa_demangle(dli.dli_sname, 0, 0, &status);
+            if (demangled) {
+                // strip off function parameters as they are very verbose and not useful
+                char* p = strchr(demangled, '(');
+                frameString = p ? StringData(demangled, p - demangled) : StringData(demangled);
+            } else {
+                frameString = dli.dli_sname;
+            }
+        }
+
+        if (frameString.empty()) {
+            std::ostringstream s;
+            s << *it;
+            folded += s.str();
+        } else {
+            // ';' separates frames in the folded format, so it may not appear in a frame.
+            for (char c : frameString) {
+                folded += (c == ';') ? ':' : c;
+            }
+        }
+        if (demangled)
+            free(demangled);
+    }
+    return folded;
+}
+
+//
+// Generate serverStatus section.
+//
+void SamplingCpuProfiler::generateServerStatusSection(bool includeFolded,
+                                                      BSONObjBuilder& builder) {
+    std::vector<NewStack> newStacks;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        newStacks = _drain(lk);
+    }
+
+    // dladdr and demangling are slow, and so is logging, so new stacks are symbolized without
+    // holding _mutex. The stackNum of an entry never changes once it is in _stacks.
+    std::vector<std::string> foldedNewStacks;
+    foldedNewStacks.reserve(newStacks.size());
+    for (const NewStack& newStack : newStacks) {
+        foldedNewStacks.push_back(_fold(newStack.stack));
+        log() << "cpuProfile stack" << newStack.info->stackNum << ": " << foldedNewStacks.back();
+    }
+
+    bool clearedImportantStacks = false;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        for (size_t i = 0; i < newStacks.size(); i++) {
+            newStacks[i].info->folded = std::move(foldedNewStacks[i]);
+        }
+
+        // Stats subsection.
+        BSONObjBuilder statsBuilder(builder.subobjStart("stats"));
+        statsBuilder.appendNumber("sampleHz", _sampleHz);
+        statsBuilder.appendNumber("samples", static_cast<long long>(_samplesTaken.load()));
+        statsBuilder.appendNumber("droppedSamples",
+                                  static_cast<long long>(_samplesDropped.load()));
+        statsBuilder.appendNumber("overflowedSamples", static_cast<long long>(_samplesOverflowed));
+        statsBuilder.appendNumber("numStacks", static_cast<long long>(_stacks.size()));
+        statsBuilder.doneFast();
+
+        // Find enough of the most sampled stacks to account for at least 95% of the samples, and
+        // deem any stack that has ever met this criterion as "important".
+        std::vector<const StackInfo*> stackInfos;
+        stackInfos.reserve(_stacks.size());
+        for (const auto& entry : _stacks) {
+            stackInfos.push_back(&entry.second);
+        }
+        std::stable_sort(stackInfos.begin(),
+                         stackInfos.end(),
+                         [](const StackInfo* a, const StackInfo* b) -> bool {
+                             return a->samples > b->samples;
+                         });
+        const uint64_t threshold = (_samplesAggregated - _samplesOverflowed) * 0.95;
+        uint64_t cumulative = 0;
+        for (const StackInfo* stackInfo : stackInfos) {
+            if (cumulative >= threshold)
+                break;
+            _importantStacks.insert(stackInfo);
+            cumulative += stackInfo->samples;
+        }
+
+        // Build the stacks subsection by emitting the "important" stacks.
+        BSONObjBuilder stacksBuilder(builder.subobjStart("stacks"));
+        for (const StackInfo* stackInfo : _importantStacks) {
+            std::ostringstream shortName;
+            shortName << "stack" << stackInfo->stackNum;
+            BSONObjBuilder stackBuilder(stacksBuilder.subobjStart(shortName.str()));
+            stackBuilder.appendNumber("samples", static_cast<long long>(stackInfo->samples));
+        }
+        stacksBuilder.doneFast();
+
+        if (includeFolded) {
+            BSONArrayBuilder foldedBuilder(builder.subarrayStart("folded"));
+            for (const StackInfo* stackInfo : stackInfos) {
+                // Still being symbolized by a concurrent caller.
+                if (stackInfo->folded.empty())
+                    continue;
+                foldedBuilder.append(stackInfo->folded + ' ' +
+                                     std::to_string(stackInfo->samples));
+            }
+            foldedBuilder.doneFast();
+        }
+
+        // importantStacks grows monotonically, so it can accumulate unneeded stacks,
+        // so we clear it periodically.
+        if (++_numImportantSamples >= kMaxImportantSamples) {
+            _importantStacks.clear();
+            _numImportantSamples = 0;
+            clearedImportantStacks = true;
+        }
+    }
+
+    if (clearedImportantStacks)
+        log() << "clearing cpuProfile importantStacks";
+}
+
+//
+// Static hook to give to the kernel.
+//
+void SamplingCpuProfiler::_handleSigprof(int) {
+    // Preserve errno for the interrupted code.
+    const int savedErrno = errno;
+    _started->recordSample();
+    errno = savedErrno;
+}
+
+Status SamplingCpuProfiler::start() {
+    if (_sampleHz < 1 || _sampleHz > 1000) {
+        return {ErrorCodes::BadValue, "cpuProfilingSampleHz must be between 1 and 1000"};
+    }
+
+    // Publish the profiler before the timer starts, since the signal handler dereferences it.
+    _started = this;
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = &_handleSigprof;
+    sa.sa_flags = SA_RESTART;
+    sigemptyset(&sa.sa_mask);
+    if (sigaction(SIGPROF, &sa, nullptr) != 0) {
+        return {ErrorCodes::InternalError,
+                str::stream() << "failed to install SIGPROF handler: " << errnoWithDescription()};
+    }
+
+    struct itimerval timer;
+    timer.it_interval = samplingInterval(_sampleHz);
+    timer.it_value = timer.it_interval;
+    if (setitimer(ITIMER_PROF, &timer, nullptr) != 0) {
+        return {ErrorCodes::InternalError,
+                str::stream() << "failed to start ITIMER_PROF: " << errnoWithDescription()};
+    }
+
+    log() << "cpuProfile sampling at " << _sampleHz << " Hz";
+    // print a stack trace to log somap for post-facto symbolization
+    log() << "following stack trace is for cpu profiler informational purposes";
+    printStackTrace();
+    return Status::OK();
+}
+
+namespace {
+
+SamplingCpuProfiler* cpuProfiler;
+bool cpuProfilingEnabled = false;
+int cpuProfilingSampleHz = 19;
+
+//
+// serverStatus section
+//
+
+class CpuProfilerServerStatusSection final : public ServerStatusSection {
+public:
+    CpuProfilerServerStatusSection() : ServerStatusSection("cpuProfile") {}
+
+    bool includeByDefault() const override {
+        return cpuProfilingEnabled;
+    }
+
+    BSONObj generateSection(OperationContext* opCtx,
+                            const BSONElement& configElement) const override {
+        bool includeFolded = false;
+        if (configElement.type() == BSONType::Object) {
+            includeFolded = configElement.Obj()["folded"].trueValue();
+        }
+
+        BSONObjBuilder builder;
+        if (cpuProfiler)
+            cpuProfiler->generateServerStatusSection(includeFolded, builder);
+        return builder.obj();
+    }
+} cpuProfilerServerStatusSection;
+
+//
+// startup
+//
+
+ExportedServerParameter<bool, ServerParameterType::kStartupOnly> cpuProfilingEnabledParameter(
+    ServerParameterSet::getGlobal(), "cpuProfilingEnabled", &cpuProfilingEnabled);
+
+ExportedServerParameter<int, ServerParameterType::kStartupOnly> cpuProfilingSampleHzParameter(
+    ServerParameterSet::getGlobal(), "cpuProfilingSampleHz", &cpuProfilingSampleHz);
+
+MONGO_INITIALIZER_GENERAL(StartCpuProfiling, ("EndStartupOptionHandling"), ("default"))
+(InitializerContext* context) {
+    if (!cpuProfilingEnabled)
+        return Status::OK();
+
+    cpuProfiler = new SamplingCpuProfiler(cpuProfilingSampleHz);
+    return cpuProfiler->start();
+}
+
+}  // namespace
+}  // namespace mongo
+
+#endif  // defined(__linux__) && defined(MONGO_CONFIG_HAVE_EXECINFO_BACKTRACE)
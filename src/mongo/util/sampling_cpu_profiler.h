@@ -0,0 +1,167 @@
+
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/config.h"
+
+#if defined(__linux__) && defined(MONGO_CONFIG_HAVE_EXECINFO_BACKTRACE)
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <set>
+#include <string>
+#include <sys/time.h>
+#include <vector>
+
+#include "mongo/base/status.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/util/concurrency/with_lock.h"
+
+namespace mongo {
+
+/**
+ * Samples the stack of whichever thread is running on a CPU at a low, fixed rate, and keeps a
+ * running count of the samples taken in each distinct stack. See sampling_cpu_profiler.cpp for
+ * how the samples are reported.
+ */
+class SamplingCpuProfiler {
+public:
+    static const int kMaxFramesPerStack = 64;  // max depth of a sampled stack
+    static const int kNumSampleSlots = 4096;   // ring of samples waiting to be aggregated
+    static const int kMaxStacks = 20000;       // max number of distinct stacks we track
+
+    explicit SamplingCpuProfiler(int sampleHz);
+
+    /**
+     * Installs the SIGPROF handler and starts ITIMER_PROF. Only one profiler may be started per
+     * process.
+     */
+    Status start();
+
+    /**
+     * Records the stack of the calling thread. Async-signal-safe: this is what the SIGPROF handler
+     * runs.
+     */
+    void recordSample();
+
+    /**
+     * Aggregates the samples recorded so far and appends the 'stats' and 'stacks' subsections,
+     * plus a 'folded' array of every stack if 'includeFolded' is set.
+     */
+    void generateServerStatusSection(bool includeFolded, BSONObjBuilder& builder);
+
+    /**
+     * Returns the ITIMER_PROF period for taking 'sampleHz' samples per second of CPU time.
+     */
+    static timeval samplingInterval(int sampleHz);
+
+private:
+    // Frames to skip at the top of each sample: the signal handler and the signal trampoline.
+    static const int kSkipStartFrames = 2;
+
+    enum SlotState : int { kEmpty, kWriting, kFull };
+
+    struct SampleSlot {
+        std::atomic<int> state{kEmpty};  // NOLINT
+        int numFrames = 0;
+        std::array<void*, kMaxFramesPerStack> frames;
+    };
+
+    struct Stack {
+        std::vector<void*> frames;
+
+        bool operator==(const Stack& that) const {
+            return frames == that.frames;
+        }
+
+        struct Hasher {
+            size_t operator()(const Stack& stack) const;
+        };
+    };
+
+    struct StackInfo {
+        int stackNum = 0;      // used for stack short name
+        std::string folded;    // symbolized representation, outermost frame first
+        uint64_t samples = 0;  // number of samples taken in this stack
+    };
+
+    // A stack first seen by _drain, which the caller symbolizes after releasing _mutex.
+    struct NewStack {
+        StackInfo* info;
+        Stack stack;
+    };
+
+    std::vector<NewStack> _drain(WithLock);
+
+    static std::string _fold(const Stack& stack);
+
+    static void _handleSigprof(int);
+
+    static SamplingCpuProfiler* _started;
+
+    const int _sampleHz;
+
+    // Written from the signal handler, so these are only touched through lock-free atomics.
+    std::unique_ptr<SampleSlot[]> _slots{new SampleSlot[kNumSampleSlots]};
+    std::atomic<uint64_t> _nextSlot{0};        // NOLINT
+    std::atomic<uint64_t> _samplesTaken{0};    // NOLINT
+    std::atomic<uint64_t> _samplesDropped{0};  // NOLINT
+
+    //
+    // Table of aggregated stacks, guarded by _mutex. Stacks are never removed, so StackInfo
+    // pointers stay valid.
+    //
+
+    stdx::mutex _mutex;
+    stdx::unordered_map<Stack, StackInfo, Stack::Hasher> _stacks;
+    uint64_t _samplesAggregated = 0;
+    uint64_t _samplesOverflowed = 0;  // samples whose stack did not fit in _stacks
+
+    // As in the heap profiler, only the stacks which are "important" are emitted, in stackNum
+    // order, to keep the set of fields FTDC sees stable. Once a stack is important it remains so
+    // until the set is periodically cleared.
+    std::set<const StackInfo*, bool (*)(const StackInfo*, const StackInfo*)> _importantStacks{
+        [](const StackInfo* a, const StackInfo* b) -> bool { return a->stackNum < b->stackNum; }};
+
+    // Number of times the section has been generated since importantStacks was last cleared.
+    // These are serverStatus collections, not SIGPROF samples, so the reset period does not depend
+    // on cpuProfilingSampleHz: FTDC collects once per second by default, which clears the set about
+    // every 4 hours, however many CPU samples were aggregated in that time.
+    int _numImportantSamples = 0;
+    const int kMaxImportantSamples = 4 * 3600;
+};
+
+}  // namespace mongo
+
+#endif  // defined(__linux__) && defined(MONGO_CONFIG_HAVE_EXECINFO_BACKTRACE)
@@ -0,0 +1,118 @@
+
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/sampling_cpu_profiler.h"
+
+#include "mongo/unittest/unittest.h"
+
+#if defined(__linux__) && defined(MONGO_CONFIG_HAVE_EXECINFO_BACKTRACE)
+
+namespace mongo {
+namespace {
+
+TEST(SamplingCpuProfilerTest, SamplingIntervalKeepsMicrosecondsBelowOneSecond) {
+    timeval interval = SamplingCpuProfiler::samplingInterval(1);
+    ASSERT_EQ(interval.tv_sec, 1);
+    ASSERT_EQ(interval.tv_usec, 0);
+
+    interval = SamplingCpuProfiler::samplingInterval(19);
+    ASSERT_EQ(interval.tv_sec, 0);
+    ASSERT_EQ(interval.tv_usec, 52631);
+
+    interval = SamplingCpuProfiler::samplingInterval(1000);
+    ASSERT_EQ(interval.tv_sec, 0);
+    ASSERT_EQ(interval.tv_usec, 1000);
+}
+
+BSONObj generateSection(SamplingCpuProfiler& profiler) {
+    BSONObjBuilder builder;
+    profiler.generateServerStatusSection(true, builder);
+    return builder.obj();
+}
+
+long long sumFoldedSamples(const BSONObj& section) {
+    long long total = 0;
+    for (const auto& elem : section["folded"].Obj()) {
+        const std::string folded = elem.String();
+        const auto space = folded.rfind(' ');
+        ASSERT_NE(space, std::string::npos);
+        ASSERT_GT(space, 0U);
+        total += std::stoll(folded.substr(space + 1));
+    }
+    return total;
+}
+
+TEST(SamplingCpuProfilerTest, SamplesAreAggregatedIntoStacks) {
+    SamplingCpuProfiler profiler(19);
+    const int kSamples = 10;
+    for (int i = 0; i < kSamples; i++) {
+        profiler.recordSample();
+    }
+
+    BSONObj section = generateSection(profiler);
+    BSONObj stats = section["stats"].Obj();
+    ASSERT_EQ(stats["sampleHz"].numberLong(), 19);
+    ASSERT_EQ(stats["samples"].numberLong(), kSamples);
+    ASSERT_EQ(stats["droppedSamples"].numberLong(), 0);
+    ASSERT_GTE(stats["numStacks"].numberLong(), 1);
+    ASSERT_FALSE(section["stacks"].Obj().isEmpty());
+    ASSERT_EQ(sumFoldedSamples(section), kSamples);
+
+    // Counts are cumulative across generations of the section.
+    profiler.recordSample();
+    section = generateSection(profiler);
+    ASSERT_EQ(section["stats"]["samples"].numberLong(), kSamples + 1);
+    ASSERT_EQ(sumFoldedSamples(section), kSamples + 1);
+}
+
+TEST(SamplingCpuProfilerTest, SamplesTakenWhileRingIsFullAreDropped) {
+    SamplingCpuProfiler profiler(19);
+    const int kExtraSamples = 5;
+    for (int i = 0; i < SamplingCpuProfiler::kNumSampleSlots + kExtraSamples; i++) {
+        profiler.recordSample();
+    }
+
+    BSONObj stats = generateSection(profiler)["stats"].Obj();
+    ASSERT_EQ(stats["samples"].numberLong(), SamplingCpuProfiler::kNumSampleSlots);
+    ASSERT_EQ(stats["droppedSamples"].numberLong(), kExtraSamples);
+
+    // Draining freed the ring for new samples.
+    profiler.recordSample();
+    stats = generateSection(profiler)["stats"].Obj();
+    ASSERT_EQ(stats["samples"].numberLong(), SamplingCpuProfiler::kNumSampleSlots + 1);
+    ASSERT_EQ(stats["droppedSamples"].numberLong(), kExtraSamples);
+}
+
+}  // namespace
+}  // namespace mongo
+
+#endif  // defined(__linux__) && defined(MONGO_CONFIG_HAVE_EXECINFO_BACKTRACE)